@@ -4,14 +4,25 @@
 
 #include "components/menu_system.h"
 #include "processes/astro.h"
+#include "processes/astro_sequencer.h"
 #include "screens/astro_screen.h"
 #include "transport/ble_device.h"
 #include "transport/ble_remote_server.h"
+#include "utils/astro_clock.h"
+#include "utils/checkpoint_store.h"
 #include "utils/colors.h"
+#include "utils/deep_sleep.h"
 #include "utils/preferences.h"
 
 class Application {
 public:
+    // A scheduled start sleeps once the buttons have been left alone this long.
+    static constexpr uint32_t SLEEP_IDLE_MS = 30UL * 1000UL;
+    // Inside the wake lead: how often to retry the camera until it is back.
+    static constexpr uint32_t SCHEDULE_RECONNECT_MS = 15UL * 1000UL;
+    // The same once the camera is advertising (BLEDeviceManager's presence scan).
+    static constexpr uint32_t SCHEDULE_RECONNECT_SEEN_MS = 1000;
+
     Application() = default;
 
     void setup() {
@@ -19,6 +30,7 @@ public:
 
         // Initialize preferences first
         PreferencesManager::init();
+        AstroClock::init();
 
         // Setup display
         M5.Display.setRotation(0);
@@ -30,7 +42,11 @@ public:
         M5.Display.setTextDatum(middle_center);
         M5.Display.drawString("Astro Remote", M5.Display.width() / 2, M5.Display.height() / 2);
 
-        delay(1000);
+        // Waking for a scheduled start: no splash, it may go straight back to sleep.
+        wokeFromTimer_ = DeepSleep::wokeFromTimer();
+        if (!wokeFromTimer_) {
+            delay(1000);
+        }
 
         M5.Display.setTextSize(1.25);
         M5.Display.setBrightness(PreferencesManager::getBrightness());
@@ -42,23 +58,81 @@ public:
         BLERemoteServer::init("M5Remote");
         RemoteControlManager::init();
 
-        // Register astro observers (BLE status push) once, up front.
+        // Register astro observers (BLE status push) once, up front, then hand
+        // the sequence timeline to its own task so the UI loop cannot stall it.
         AstroProcess::instance().init();
+        // A sequence cut short by a reset comes back from its checkpoint
+        // before the sequencer runs; it continues once the camera is back.
+        const bool recovered = AstroProcess::instance().restoreCheckpoint();
+        AstroSequencer::start();
 
         // Initialize menu system
         MenuSystem::init();
         MenuSystem::setScreen(new AstroScreen());
+
+        if (recovered) {
+            // Reconnect to the active camera straight away (in the
+            // background) rather than wait for the user; AstroScreen hands
+            // off to the run screen once the sequence resumes.
+            BLEDeviceManager::connectToSavedDevice();
+        }
     }
 
     void loop() {
         BLEDeviceManager::update();      // Update BLE state
+        AstroClock::update();            // RTC discipline of the sequence timebase
+        CheckpointStore::service();      // Flash mirror of the sequence checkpoint
         RemoteControlManager::update();  // Update remote control state
+        BLERemoteServer::update();       // Next window of any bulk transfer
 
-        // Feed live camera-connection state, then tick the astro sequence
-        // state machine so a running sequence actually advances.
+        // Feed live camera-connection state to the astro sequence. The
+        // sequence itself advances on the AstroSequencer task, not here.
         AstroProcess::instance().setCameraConnected(BLEDeviceManager::isConnected());
-        AstroProcess::instance().update();
+        AstroProcess::instance().setLinkRssi(BLEDeviceManager::getLinkRssi());
+        // And the other way: the sequence's timeline picks the link's profile.
+        BLEDeviceManager::setNextToggleIn(AstroProcess::instance().msUntilNextToggle());
+        BLEDeviceManager::setReconnectUrgent(AstroProcess::instance().getStatus().state ==
+                                             AstroProcess::State::EXPOSING);
 
+        serviceScheduledStart();
         MenuSystem::update();  // This will handle input internally
     }
+
+private:
+    // While a scheduled start is armed: deep sleep through the wait, then stay
+    // up for the last DeepSleep::WAKE_LEAD_SEC to reconnect the camera.
+    // AstroProcess itself starts the run on time.
+    void serviceScheduledStart() {
+        auto& astro = AstroProcess::instance();
+        if (!astro.getScheduledStart()) {
+            return;
+        }
+        const uint32_t now = millis();
+        const uint32_t sleepSec = DeepSleep::sleepSecFor(astro.secondsUntilScheduledStart());
+        if (sleepSec) {
+            // Not while someone is at the buttons or on the remote link. A
+            // timer wake with nobody around goes straight back to sleep.
+            const uint32_t lastActivity = RemoteControlManager::getLastActivityMs();
+            const bool idle = lastActivity ? now - lastActivity >= SLEEP_IDLE_MS
+                                           : wokeFromTimer_ || now >= SLEEP_IDLE_MS;
+            if (idle && !BLERemoteServer::isConnected()) {
+                DeepSleep::sleepFor(sleepSec);
+            }
+            return;
+        }
+        // Straight away once the camera advertises; blind, now and then, in
+        // case the presence scan misses it.
+        const bool advertising =
+            BLEDeviceManager::isCameraAdvertising(BLEDeviceManager::getActiveCameraAddress());
+        const uint32_t retryMs = advertising ? SCHEDULE_RECONNECT_SEEN_MS : SCHEDULE_RECONNECT_MS;
+        if (BLEDeviceManager::isPaired() && !BLEDeviceManager::isConnected() &&
+            !BLEDeviceManager::isConnecting() &&
+            (lastReconnectMs_ == 0 || now - lastReconnectMs_ >= retryMs)) {
+            lastReconnectMs_ = now;
+            BLEDeviceManager::connectToSavedDevice();
+        }
+    }
+
+    bool wokeFromTimer_ = false;
+    uint32_t lastReconnectMs_ = 0;
 };
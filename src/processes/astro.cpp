@@ -2,7 +2,31 @@
 
 #include <Arduino.h>
 
+#include <type_traits>
+
+#include "debug.h"
 #include "transport/ble_astro_observer.h"
+#include "utils/astro_clock.h"
+#include "utils/checkpoint_store.h"
+
+static_assert(sizeof(AstroProcess::Checkpoint) <= CheckpointStore::CAPACITY,
+              "checkpoint must fit the RTC slot");
+static_assert(std::is_trivially_copyable<AstroProcess::Checkpoint>::value,
+              "checkpoint is stored byte for byte");
+
+namespace {
+// Wrap-safe "has now reached deadline" for AstroClock::nowMs() timestamps.
+bool deadlineReached(uint32_t nowMs, uint32_t deadlineMs) {
+    return static_cast<int32_t>(nowMs - deadlineMs) >= 0;
+}
+
+// Unix time in ms for the schedule: disciplined when referenced, else the
+// whole-second RTC reading from boot (right after a wake). 0 if unknown.
+uint64_t scheduleEpochMs() {
+    const uint64_t epochMs = AstroClock::epochMs();
+    return epochMs ? epochMs : static_cast<uint64_t>(AstroClock::coarseEpochSec()) * 1000ULL;
+}
+}  // namespace
 
 void AstroProcess::initializeObservers() {
     // Register BLE observer
@@ -10,7 +34,12 @@ void AstroProcess::initializeObservers() {
 }
 
 void AstroProcess::start() {
-    if (!params_.validate()) {
+    Transaction txn(*this);
+
+    if (!planLoaded_) {
+        syncPlanFromParameters();
+    }
+    if (!plan_.validate() || (!planLoaded_ && !params_.validate())) {
         status_.errorCode = 1;  // Invalid parameters
         setState(State::ERROR);
         return;
@@ -22,16 +51,33 @@ void AstroProcess::start() {
         return;
     }
 
-    status_.sequenceStartTime = millis() / 1000;  // Convert to seconds
+    const uint32_t now = AstroClock::nowMs();
+    sequenceStartMs_ = now;
+    status_.sequenceStartTime = AstroClock::epochSec();
     status_.completedFrames = 0;
-    status_.totalFrames = params_.subframeCount;
+    status_.totalFrames = plan_.totalFrames();
+    enterSegment(0);
+    status_.openErrorMs = 0;
+    status_.maxOpenErrorMs = 0;
+    status_.measuredExposureMs = 0;
+    status_.framesPerHour = 0;
+    status_.wakeToFirstFrameMs = 0;
     pausePending_ = false;
-    updateTimings();
+    journal_.clear();
+    journalOpen_ = false;
+    CameraCommands::resetTriggerSkew();
+    refreshLatency();
+
+    // Frame N opens at originMs_ + N * period, whatever the loop is doing.
+    originMs_ = now + plan_.initialDelaySec * 1000UL;
+    enterPhase(now, originMs_);
     setState(State::INITIAL_DELAY);
 }
 
 void AstroProcess::pause() {
-    if (!isRunning() || status_.state == State::PAUSED) {
+    Transaction txn(*this);
+
+    if (!running() || status_.state == State::PAUSED) {
         return;
     }
 
@@ -39,32 +85,54 @@ void AstroProcess::pause() {
         // Deferred pause: never cut a frame short. Flag it and let update()
         // park in PAUSED once the current exposure finishes normally.
         pausePending_ = true;
+        writeCheckpoint(false);
         return;
     }
 
     // Delay/interval: shutter is closed, so pause immediately.
-    pausedAtSec_ = millis() / 1000;
+    pausedAtMs_ = AstroClock::nowMs();
     setState(State::PAUSED);
 }
 
 void AstroProcess::resume() {
+    Transaction txn(*this);
+
     if (status_.state != State::PAUSED) {
         return;
     }
+    if (recovering_) {
+        // Resumed by hand before the camera came back; an exposure left open
+        // by the reset is still closed first.
+        recovering_ = false;
+        closeOrphanedExposure();
+    }
+    resumeTimeline(AstroClock::nowMs());
+}
 
+void AstroProcess::resumeTimeline(uint32_t nowMs) {
     // Shift the timeline forward by however long we were paused, so elapsed and
     // per-frame timing stay continuous, then wait out a fresh interval before
-    // the next frame. completedFrames is preserved (no restart).
-    uint32_t now = millis() / 1000;
-    uint32_t pausedDuration = now - pausedAtSec_;
-    status_.sequenceStartTime += pausedDuration;
-    status_.currentFrameStartTime = now;
+    // the next frame. completedFrames is preserved (no restart). The remaining
+    // frames are re-planned on a grid anchored at that next open. The same
+    // applies to a pause-for-user break between segments and to a recovered
+    // checkpoint.
+    sequenceStartMs_ += nowMs - pausedAtMs_;
+    firstOpenMs_ += nowMs - pausedAtMs_;
+    status_.currentFrameStartTime = AstroClock::epochSec();
+    const uint32_t nextOpenMs = nowMs + segment().intervalSec * 1000UL;
+    originMs_ = nextOpenMs - segmentFrame_ * segment().getFramePeriodMs();
+    enterPhase(nowMs, nextOpenMs);
     setState(State::INTERVAL);
 }
 
 void AstroProcess::stop() {
-    if (isRunning()) {
-        if (status_.state == State::EXPOSING) {
+    Transaction txn(*this);
+
+    if (running()) {
+        if (recovering_) {
+            closeOrphanedExposure();
+            recovering_ = false;
+        } else if (status_.state == State::EXPOSING) {
             stopExposure();
         }
         setState(State::STOPPED);
@@ -72,28 +140,234 @@ void AstroProcess::stop() {
 }
 
 void AstroProcess::reset() {
+    Transaction txn(*this);
+
     stopExposure();
     status_.completedFrames = 0;
     status_.sequenceStartTime = 0;
     status_.currentFrameStartTime = 0;
     status_.elapsedSec = 0;
     status_.remainingSec = 0;
-    status_.totalFrames = params_.subframeCount;
+    status_.totalFrames = plan_.totalFrames();
+    enterSegment(0);
+    status_.openErrorMs = 0;
+    status_.maxOpenErrorMs = 0;
+    status_.measuredExposureMs = 0;
+    status_.framesPerHour = 0;
     status_.errorCode = 0;
+    if (status_.scheduledStartTime) {
+        status_.scheduledStartTime = 0;  // Reset also disarms a scheduled start
+        CheckpointStore::clear();
+    }
+    scheduledRun_ = false;
     pausePending_ = false;
+    recovering_ = false;
+    orphanClose_ = false;
+    journalOpen_ = false;  // Records stay for review until the next start()
+    awaiting_ = Awaiting::NONE;
+    closePending_ = false;
     setState(State::IDLE);
 }
 
-void AstroProcess::setParameters(const Parameters& params) {
-    if (status_.state == State::IDLE || status_.state == State::STOPPED) {
-        params_ = params;
-        updateTimings();
+bool AstroProcess::restoreCheckpoint() {
+    Transaction txn(*this);
+
+    Checkpoint cp;
+    if (running() || !CheckpointStore::load(&cp, sizeof(cp))) {
+        return false;
+    }
+    if (cp.version == Checkpoint::VERSION && cp.state == State::IDLE && cp.scheduledStartSec &&
+        cp.plan.validate()) {
+        // A scheduled start we slept through the wait for: re-arm it. Nothing
+        // to recover, so the app decides whether to sleep again or wake the
+        // camera (false).
+        const uint64_t nowEpochMs = scheduleEpochMs();
+        if (nowEpochMs > (cp.scheduledStartSec + SCHEDULE_GRACE_SEC) * 1000ULL) {
+            LOG_APP("[Astro] Scheduled start missed, discarding");
+            CheckpointStore::clear();
+            return false;
+        }
+        params_ = cp.params;
+        plan_ = cp.plan;
+        planLoaded_ = cp.planLoaded;
+        status_.totalFrames = plan_.totalFrames();
+        enterSegment(0);
+        status_.scheduledStartTime = cp.scheduledStartSec;
+        wokeForSchedule_ = true;
+        wakeMs_ = AstroClock::fromMillis(0);
         notifyParametersChanged();
+        notifyStatusObservers();
+        LOG_APP("[Astro] Scheduled start re-armed for %lu",
+                static_cast<unsigned long>(cp.scheduledStartSec));
+        return false;
+    }
+    if (cp.version != Checkpoint::VERSION || !isRunningState(cp.state) || !cp.plan.validate() ||
+        cp.segment >= cp.plan.segmentCount || cp.segmentFrame >= cp.plan.segments[cp.segment].count ||
+        cp.completedFrames >= cp.plan.totalFrames()) {
+        CheckpointStore::clear();
+        return false;
     }
+    // Only a run that was actually going is resumed on its own, and only if
+    // the gap is short enough that the night is still worth continuing.
+    const bool userPaused = cp.state == State::PAUSED || cp.pausePending;
+    const uint32_t nowEpochSec = AstroClock::coarseEpochSec();
+    const int32_t ageSec = static_cast<int32_t>(nowEpochSec - cp.savedEpochSec);
+    if (!userPaused && cp.savedEpochSec && nowEpochSec &&
+        ageSec > static_cast<int32_t>(RECOVERY_MAX_AGE_SEC)) {
+        LOG_APP("[Astro] Checkpoint is %ld s old, not resuming", static_cast<long>(ageSec));
+        CheckpointStore::clear();
+        return false;
+    }
+
+    params_ = cp.params;
+    plan_ = cp.plan;
+    planLoaded_ = cp.planLoaded;
+    status_.totalFrames = plan_.totalFrames();
+    status_.completedFrames = cp.completedFrames;
+    enterSegment(cp.segment);
+    segmentFrame_ = cp.segmentFrame;
+    status_.segmentCompletedFrames = segmentFrame_;
+    status_.sequenceStartTime = cp.sequenceStartTime;
+    status_.currentFrameStartTime = 0;
+    status_.framesPerHour = cp.framesPerHour;
+    status_.openErrorMs = 0;
+    status_.maxOpenErrorMs = 0;
+    status_.measuredExposureMs = 0;
+    status_.errorCode = 0;
+    refreshLatency();
+
+    // Rebuild the timeline as if paused right now; resumeTimeline() re-plans
+    // the remaining frames from whenever the run continues.
+    const uint32_t now = AstroClock::nowMs();
+    pausedAtMs_ = now;
+    sequenceStartMs_ = now - cp.elapsedMs;
+    firstOpenMs_ = cp.framesPerHour
+                       ? now - static_cast<uint32_t>(cp.completedFrames * 3600000ULL /
+                                                     cp.framesPerHour)
+                       : sequenceStartMs_ + plan_.initialDelaySec * 1000UL;
+    uint32_t remainingMs = (segment().count - segmentFrame_) * segment().getFramePeriodMs();
+    for (uint8_t i = segment_ + 1; i < plan_.segmentCount; i++) {
+        remainingMs += plan_.segments[i].getDurationMs();
+    }
+    status_.elapsedSec = cp.elapsedMs / 1000;
+    status_.remainingSec = remainingMs / 1000;
+
+    exposureActive_ = cp.shutterOpen;
+    awaiting_ = Awaiting::NONE;
+    closePending_ = false;
+    pausePending_ = false;
+    recovering_ = true;
+    recoveryResume_ = !userPaused;
+    recoveryLinked_ = false;
+
+    // Set directly, not through setState(): the stored checkpoint stays as it
+    // was until the run really continues, so a second reset recovers the same.
+    status_.state = State::PAUSED;
+    notifyParametersChanged();
+    notifyStatusObservers();
+    LOG_APP("[Astro] Recovered sequence at frame %d/%d (%s%s)", status_.completedFrames + 1,
+            status_.totalFrames, cp.shutterOpen ? "exposure interrupted, " : "",
+            recoveryResume_ ? "resuming" : "paused");
+    return true;
+}
+
+bool AstroProcess::scheduleStart(uint32_t startEpochSec) {
+    Transaction txn(*this);
+
+    if (running()) {
+        return false;
+    }
+    if (startEpochSec == 0) {
+        if (status_.scheduledStartTime) {
+            status_.scheduledStartTime = 0;
+            writeCheckpoint(false);  // Nothing armed: clears it
+            notifyStatusObservers();
+            LOG_APP("[Astro] Scheduled start cancelled");
+        }
+        return true;
+    }
+
+    if (!planLoaded_) {
+        syncPlanFromParameters();
+    }
+    const uint32_t nowSec = static_cast<uint32_t>(scheduleEpochMs() / 1000);
+    if (!plan_.validate() || (!planLoaded_ && !params_.validate()) || nowSec == 0 ||
+        startEpochSec < nowSec + SCHEDULE_MIN_LEAD_SEC ||
+        startEpochSec - nowSec > SCHEDULE_MAX_AHEAD_SEC) {
+        return false;
+    }
+    status_.scheduledStartTime = startEpochSec;
+    wokeForSchedule_ = false;
+    writeCheckpoint(true);
+    notifyStatusObservers();
+    LOG_APP("[Astro] Start scheduled in %lu s", static_cast<unsigned long>(startEpochSec - nowSec));
+    return true;
+}
+
+uint32_t AstroProcess::secondsUntilScheduledStart() const {
+    const uint64_t startMs = getScheduledStart() * 1000ULL;
+    const uint64_t nowEpochMs = scheduleEpochMs();
+    return nowEpochMs && startMs > nowEpochMs
+               ? static_cast<uint32_t>((startMs - nowEpochMs + 999) / 1000)
+               : 0;
+}
+
+uint32_t AstroProcess::msUntilNextToggle() const {
+    const Status status = getStatus();
+    switch (status.state) {
+        case State::INITIAL_DELAY:
+        case State::EXPOSING:
+        case State::INTERVAL:
+            return status.phaseRemainingMs;
+        default:
+            break;
+    }
+    if (!status.scheduledStartTime) {
+        return UINT32_MAX;
+    }
+    const uint32_t sec = secondsUntilScheduledStart();
+    return sec < UINT32_MAX / 1000 ? sec * 1000 : UINT32_MAX - 1;
+}
+
+void AstroProcess::serviceSchedule() {
+    const uint64_t startMs = status_.scheduledStartTime * 1000ULL;
+    const uint64_t nowEpochMs = scheduleEpochMs();
+    if (nowEpochMs < startMs) {
+        return;
+    }
+    // Due. The app woke early to reconnect the camera; if it is still not
+    // back, give it a little longer before starting into errorCode 2.
+    const uint32_t lateMs = static_cast<uint32_t>(nowEpochMs - startMs);
+    if (!status_.isCameraConnected && lateMs < SCHEDULE_GRACE_SEC * 1000UL) {
+        return;
+    }
+    status_.scheduledStartTime = 0;
+    LOG_APP("[Astro] Scheduled start, %lu ms late", static_cast<unsigned long>(lateMs));
+    start();
+    scheduledRun_ = running();
+}
+
+bool AstroProcess::setParameters(const Parameters& params) {
+    Transaction txn(*this);
+
+    if (status_.state != State::IDLE && status_.state != State::STOPPED) {
+        return false;
+    }
+    params_ = params;
+    syncPlanFromParameters();
+    status_.totalFrames = plan_.totalFrames();
+    updateTimings(AstroClock::nowMs());
+    if (status_.scheduledStartTime) {
+        writeCheckpoint(true);  // The armed start runs the edited plan
+    }
+    notifyParametersChanged();
+    return true;
 }
 
 bool AstroProcess::setParameter(const std::string& name, uint16_t value) {
-    if (isRunning()) {
+    Transaction txn(*this);
+
+    if (running()) {
         return false;  // Can't modify parameters while running
     }
 
@@ -106,6 +380,10 @@ bool AstroProcess::setParameter(const std::string& name, uint16_t value) {
         newParams.subframeCount = value;
     } else if (name == "intervalSec") {
         newParams.intervalSec = value;
+    } else if (name == "adaptiveInterval") {
+        newParams.adaptiveInterval = value != 0;
+    } else if (name == "settleMs") {
+        newParams.settleMs = value;
     } else {
         return false;  // Unknown parameter
     }
@@ -115,36 +393,96 @@ bool AstroProcess::setParameter(const std::string& name, uint16_t value) {
     }
 
     params_ = newParams;
-    status_.totalFrames = params_.subframeCount;
-    updateTimings();
+    syncPlanFromParameters();
+    status_.totalFrames = plan_.totalFrames();
+    updateTimings(AstroClock::nowMs());
+    if (status_.scheduledStartTime) {
+        writeCheckpoint(true);
+    }
+    notifyParametersChanged();
+    return true;
+}
+
+bool AstroProcess::setPlan(const AstroPlan& plan) {
+    Transaction txn(*this);
+
+    if (running() || !plan.validate()) {
+        return false;
+    }
+    plan_ = plan;
+    planLoaded_ = true;
+    status_.totalFrames = plan_.totalFrames();
+    enterSegment(0);
+    updateTimings(AstroClock::nowMs());
+    if (status_.scheduledStartTime) {
+        writeCheckpoint(true);
+    }
     notifyParametersChanged();
+    LOG_APP("[Astro] Plan loaded: %d segments, %d frames", plan_.segmentCount,
+            status_.totalFrames);
     return true;
 }
 
+AstroPlan AstroProcess::planFromParameters(const Parameters& params) {
+    AstroPlan plan;
+    plan.initialDelaySec = params.initialDelaySec;
+    plan.adaptiveInterval = params.adaptiveInterval;
+    plan.settleMs = params.settleMs;
+    plan.segmentCount = 1;
+    plan.segments[0].exposureSec = params.exposureSec;
+    plan.segments[0].count = params.subframeCount;
+    plan.segments[0].intervalSec = params.intervalSec;
+    return plan;
+}
+
+void AstroProcess::syncPlanFromParameters() {
+    plan_ = planFromParameters(params_);
+    planLoaded_ = false;
+}
+
+void AstroProcess::enterSegment(uint8_t index) {
+    segment_ = index;
+    segmentFrame_ = 0;
+    status_.segmentIndex = index;
+    status_.segmentCount = plan_.segmentCount;
+    status_.segmentCompletedFrames = 0;
+    status_.segmentTotalFrames = plan_.segments[index].count;
+}
+
 void AstroProcess::update() {
-    uint32_t currentTime = millis() / 1000;  // Convert to seconds
-    uint32_t deltaTime = currentTime - lastUpdateTime_;
-    lastUpdateTime_ = currentTime;
+    Transaction txn(*this);
+    const uint32_t now = AstroClock::nowMs();
+
+    // Confirmation outlives the sequence: the closing toggle of the last frame
+    // (or of a stop) must still be confirmed, and retried, after STOPPED.
+    serviceShutterConfirm(now);
 
-    if (!isRunning())
+    if (recovering_) {
+        serviceRecovery(now);
+        return;
+    }
+
+    if (status_.scheduledStartTime && !running()) {
+        serviceSchedule();
+    }
+    if (!running())
         return;
 
     // While PAUSED the clock is frozen: don't advance timings or the state
-    // machine. resume() shifts sequenceStartTime past the paused span so the
+    // machine. resume() shifts the timeline past the paused span so the
     // elapsed/remaining figures stay continuous.
     if (status_.state == State::PAUSED) {
         return;
     }
 
-    // Update timings
-    status_.elapsedSec = currentTime - status_.sequenceStartTime;
-    updateTimings();
-
-    // State machine
+    // State machine. Each phase ends at its planned deadline; the next phase
+    // starts from that deadline (not from `now`), so a late tick only delays
+    // the toggle it fires, never the rest of the timeline.
     switch (status_.state) {
         case State::INITIAL_DELAY:
-            if (status_.elapsedSec >= params_.initialDelaySec) {
-                if (!startExposure()) {
+        case State::INTERVAL:
+            if (deadlineReached(now, phaseDeadlineMs_)) {
+                if (!startExposure(now)) {
                     setState(State::ERROR);
                     return;
                 }
@@ -152,48 +490,51 @@ void AstroProcess::update() {
             }
             break;
 
-        case State::EXPOSING: {
-            uint32_t exposureElapsed = currentTime - status_.currentFrameStartTime;
-            if (exposureElapsed >= params_.exposureSec) {
+        case State::EXPOSING:
+            if (deadlineReached(now, phaseDeadlineMs_)) {
                 stopExposure();
                 status_.completedFrames++;
+                segmentFrame_++;
+                status_.segmentCompletedFrames = segmentFrame_;
+
+                // Segment done: the next one starts one interval after this
+                // close, on a fresh grid of its own.
+                bool segmentBreak = false;
+                if (segmentFrame_ >= segment().count && segment_ + 1 < plan_.segmentCount) {
+                    const uint32_t nextOpenMs = phaseDeadlineMs_ + segment().intervalSec * 1000UL;
+                    enterSegment(segment_ + 1);
+                    originMs_ = nextOpenMs;
+                    segmentBreak = segment().pauseBefore;
+                }
 
-                if (status_.completedFrames >= params_.subframeCount) {
+                if (status_.completedFrames >= status_.totalFrames) {
                     setState(State::STOPPED);
-                } else if (pausePending_) {
-                    // Deferred pause takes effect now that the frame is done.
+                } else if (pausePending_ || segmentBreak) {
+                    // Deferred pause (or the plan's pause-for-user step) takes
+                    // effect now that the frame is done.
                     pausePending_ = false;
-                    pausedAtSec_ = currentTime;
+                    pausedAtMs_ = now;
                     setState(State::PAUSED);
                 } else {
-                    status_.currentFrameStartTime = currentTime;
+                    status_.currentFrameStartTime = AstroClock::epochSec();
+                    enterPhase(phaseDeadlineMs_, plannedOpenMs(segmentFrame_));
                     setState(State::INTERVAL);
                 }
             }
             break;
-        }
-
-        case State::INTERVAL: {
-            uint32_t intervalElapsed = currentTime - status_.currentFrameStartTime;
-            if (intervalElapsed >= params_.intervalSec) {
-                if (!startExposure()) {
-                    setState(State::ERROR);
-                    return;
-                }
-                setState(State::EXPOSING);
-            }
-            break;
-        }
 
         default:
             break;
     }
 
+    updateTimings(now);
+
     // Periodic status notification, throttled to 1 Hz. State transitions above
     // notify immediately via setState(), so this only covers the ticking
     // elapsed/remaining timers while the state is unchanged.
-    if (currentTime != lastNotifySec_) {
-        lastNotifySec_ = currentTime;
+    const uint32_t currentSec = now / 1000;
+    if (currentSec != lastNotifySec_) {
+        lastNotifySec_ = currentSec;
         notifyStatusObservers();
     }
 }
@@ -201,55 +542,120 @@ void AstroProcess::update() {
 void AstroProcess::setState(State newState) {
     if (status_.state != newState) {
         status_.state = newState;
-        // A transition is always important — notify immediately and reset the
-        // throttle window so the next periodic tick doesn't double-fire.
-        lastNotifySec_ = millis() / 1000;
+        // Checkpoint after the transition's toggle has gone out, so it never
+        // delays one. The RTC-memory copy is a memcpy and a CRC; the flash
+        // mirror is left to the UI loop, nudged on start, pause and segment
+        // changes and cleared once the run is over.
+        writeCheckpoint(newState == State::INITIAL_DELAY || newState == State::PAUSED ||
+                        segmentFrame_ == 0);
+        // A transition is always important — notify immediately (with fresh
+        // phase timings) and reset the throttle window so the next periodic
+        // tick doesn't double-fire.
+        const uint32_t now = AstroClock::nowMs();
+        updateTimings(now);
+        lastNotifySec_ = now / 1000;
         notifyStatusObservers();
     }
 }
 
-void AstroProcess::updateTimings() {
+void AstroProcess::writeCheckpoint(bool mirrorNow) {
+    const bool armed = !running() && status_.scheduledStartTime;
+    if (!running() && !armed) {
+        CheckpointStore::clear();
+        return;
+    }
+    Checkpoint cp;
+    cp.state = armed ? State::IDLE : status_.state;
+    cp.scheduledStartSec = armed ? status_.scheduledStartTime : 0;
+    cp.shutterOpen = exposureActive_ || closePending_;
+    cp.pausePending = pausePending_;
+    cp.planLoaded = planLoaded_;
+    cp.segment = segment_;
+    cp.segmentFrame = segmentFrame_;
+    cp.completedFrames = status_.completedFrames;
+    cp.framesPerHour = status_.framesPerHour;
+    cp.sequenceStartTime = status_.sequenceStartTime;
+    const uint32_t sequenceNowMs =
+        status_.state == State::PAUSED ? pausedAtMs_ : AstroClock::nowMs();
+    cp.elapsedMs = sequenceNowMs - sequenceStartMs_;
+    cp.savedEpochSec = AstroClock::epochSec();
+    cp.params = params_;
+    cp.plan = plan_;
+    CheckpointStore::save(&cp, sizeof(cp), mirrorNow);
+}
+
+void AstroProcess::serviceRecovery(uint32_t nowMs) {
+    if (!status_.isCameraConnected) {
+        recoveryLinked_ = false;
+        return;
+    }
+    if (!recoveryLinked_) {
+        recoveryLinked_ = true;
+        recoveryLinkedMs_ = nowMs;
+    }
+    // Give the reconnected camera a moment to report its shutter state; a
+    // SHUTTER_ACTIVE report ends the wait early.
+    if (!CameraCommands::isShutterActive() && nowMs - recoveryLinkedMs_ < RECOVERY_STATUS_WAIT_MS) {
+        return;
+    }
+
+    recovering_ = false;
+    closeOrphanedExposure();
+    if (recoveryResume_) {
+        resumeTimeline(nowMs);
+    } else {
+        notifyStatusObservers();
+    }
+}
+
+void AstroProcess::closeOrphanedExposure() {
+    if (!exposureActive_) {
+        return;
+    }
+    // stopExposure() only toggles if the camera reports the shutter open;
+    // otherwise the camera already ended the exposure (or it never opened).
+    LOG_APP("[Astro] Interrupted frame: shutter %s",
+            CameraCommands::isShutterActive() ? "left open, closing" : "already closed");
+    stopExposure();
+    orphanClose_ = awaiting_ == Awaiting::CLOSE;  // Its open was never timed
+}
+
+void AstroProcess::enterPhase(uint32_t startMs, uint32_t deadlineMs) {
+    phaseStartMs_ = startMs;
+    phaseDeadlineMs_ = deadlineMs;
+}
+
+void AstroProcess::updateTimings(uint32_t nowMs) {
     if (status_.state == State::IDLE || status_.state == State::STOPPED) {
         status_.remainingSec = 0;
         status_.phaseRemainingSec = 0;
         status_.phaseTotalSec = 0;
+        status_.phaseRemainingMs = 0;
+        status_.phaseTotalMs = 0;
         return;
     }
-
-    // Whole-series remaining.
-    uint32_t totalTime = params_.getTotalDurationSec();
-    if (status_.elapsedSec > totalTime) {
-        status_.remainingSec = 0;
-    } else {
-        status_.remainingSec = totalTime - status_.elapsedSec;
+    if (status_.state != State::INITIAL_DELAY && status_.state != State::EXPOSING &&
+        status_.state != State::INTERVAL) {
+        return;  // PAUSED, ERROR — leave frozen.
     }
 
-    // Time left in the current phase. currentTime is reconstructed from the
-    // just-updated elapsedSec (= currentTime - sequenceStartTime) so this stays
-    // a pure function of status_/params_.
-    uint32_t currentTime = status_.sequenceStartTime + status_.elapsedSec;
-    switch (status_.state) {
-        case State::INITIAL_DELAY:
-            status_.phaseTotalSec = params_.initialDelaySec;
-            status_.phaseRemainingSec = status_.elapsedSec < params_.initialDelaySec
-                                            ? params_.initialDelaySec - status_.elapsedSec
-                                            : 0;
-            break;
-        case State::EXPOSING: {
-            uint32_t e = currentTime - status_.currentFrameStartTime;
-            status_.phaseTotalSec = params_.exposureSec;
-            status_.phaseRemainingSec = e < params_.exposureSec ? params_.exposureSec - e : 0;
-            break;
-        }
-        case State::INTERVAL: {
-            uint32_t e = currentTime - status_.currentFrameStartTime;
-            status_.phaseTotalSec = params_.intervalSec;
-            status_.phaseRemainingSec = e < params_.intervalSec ? params_.intervalSec - e : 0;
-            break;
-        }
-        default:  // PAUSED, etc. — leave frozen.
-            break;
+    // Whole-series elapsed/remaining. The end is taken from the current
+    // segment's frame grid (which an adaptive interval pulls in frame by
+    // frame) plus the planned length of the segments after it.
+    status_.elapsedSec = (nowMs - sequenceStartMs_) / 1000;
+    uint32_t endMs = plannedOpenMs(segment().count);
+    for (uint8_t i = segment_ + 1; i < plan_.segmentCount; i++) {
+        endMs += plan_.segments[i].getDurationMs();
     }
+    status_.remainingSec = deadlineReached(nowMs, endMs) ? 0 : (endMs - nowMs) / 1000;
+
+    // Time left in the current phase, straight from its planned deadline. The
+    // whole-second figures round up so a countdown reads 1 until it hits 0.
+    status_.phaseTotalMs = phaseDeadlineMs_ - phaseStartMs_;
+    status_.phaseRemainingMs =
+        deadlineReached(nowMs, phaseDeadlineMs_) ? 0 : phaseDeadlineMs_ - nowMs;
+    status_.phaseTotalSec = (status_.phaseTotalMs + 999) / 1000;
+    status_.phaseRemainingSec = (status_.phaseRemainingMs + 999) / 1000;
 }
 
 void AstroProcess::notifyParametersChanged() {
@@ -259,6 +665,8 @@ void AstroProcess::notifyParametersChanged() {
 }
 
 void AstroProcess::setCameraConnected(bool connected) {
+    Transaction txn(*this);
+
     if (status_.isCameraConnected == connected) {
         return;
     }
@@ -268,27 +676,81 @@ void AstroProcess::setCameraConnected(bool connected) {
     notifyStatusObservers();
 }
 
+void AstroProcess::publishSnapshot() {
+    std::lock_guard<std::mutex> lock(snapshotMutex_);
+    snapshot_ = status_;
+    snapshotPausePending_ = pausePending_;
+    snapshotRecovering_ = recovering_;
+}
+
 void AstroProcess::notifyStatusObservers() {
     for (auto* observer : observers_) {
         observer->onAstroStatusChanged(status_);
     }
 }
 
-bool AstroProcess::startExposure() {
+bool AstroProcess::startExposure(uint32_t nowMs) {
     if (!status_.isCameraConnected)
         return false;
 
-    status_.currentFrameStartTime = millis() / 1000;
+    // Score the open against the plan. The close is timed from the planned
+    // open until the camera confirms the real one (serviceShutterConfirm).
+    const uint32_t plannedMs = plannedOpenMs(segmentFrame_);
+    status_.openErrorMs = static_cast<int32_t>(nowMs - plannedMs);
+    const uint32_t absErrorMs =
+        status_.openErrorMs < 0 ? -status_.openErrorMs : status_.openErrorMs;
+    if (absErrorMs > status_.maxOpenErrorMs) {
+        status_.maxOpenErrorMs = absErrorMs;
+    }
+    status_.currentFrameStartTime = AstroClock::epochSec();
+    enterPhase(plannedMs, plannedMs + segment().exposureSec * 1000UL);
+
+    FrameRecord& record = journal_.append();
+    record.plannedOpenMs = plannedMs;
+    record.openSentMs = nowMs;
+    record.plannedCloseMs = phaseDeadlineMs_;
+    record.frame = status_.completedFrames;
+    record.segment = segment_;
+    record.rssi = linkRssi_.load(std::memory_order_relaxed);
+    journalOpen_ = true;
+
+    // Achieved cadence: completedFrames full frame slots since frame 0 opened
+    // (segment breaks included, pauses excluded).
+    if (status_.completedFrames == 0) {
+        firstOpenMs_ = nowMs;
+        if (scheduledRun_ && wokeForSchedule_) {
+            status_.wakeToFirstFrameMs = nowMs - wakeMs_;
+            LOG_APP("[Astro] Wake to first frame: %lu ms",
+                    static_cast<unsigned long>(status_.wakeToFirstFrameMs));
+        }
+        scheduledRun_ = false;
+    } else if (nowMs != firstOpenMs_) {
+        const uint64_t rate =
+            static_cast<uint64_t>(status_.completedFrames) * 3600000ULL / (nowMs - firstOpenMs_);
+        status_.framesPerHour = rate > UINT16_MAX ? UINT16_MAX : static_cast<uint16_t>(rate);
+    }
 
     // Bulb is a toggle: only open if the shutter is actually closed. If it is
     // already open (desync), toggling would CLOSE it and the frame would never
-    // expose — so adopt the open shutter as this exposure instead.
+    // expose — so adopt the open shutter as this exposure instead. The rig
+    // cameras open with the toggle, or on their own if there is none.
+    CameraCommands::armRigToggle(true);
     if (!CameraCommands::isShutterActive()) {
         if (!CameraCommands::triggerBulb()) {  // open toggle
-            status_.errorCode = 3;             // Failed to start exposure
+            CameraCommands::disarmRigToggle();
+            status_.errorCode = 3;  // Failed to start exposure
+            record.errorCode = status_.errorCode;
+            journalOpen_ = false;
             return false;
         }
+        awaitShutter(Awaiting::OPEN, nowMs);
+    } else {
+        openConfirmedMs_ = nowMs;
+        awaiting_ = Awaiting::NONE;
+        record.flags |= FrameRecord::ADOPTED;
+        record.openConfirmedMs = nowMs;
     }
+    record.flags |= FrameRecord::OPENED;
     exposureActive_ = true;
     return true;
 }
@@ -298,10 +760,154 @@ void AstroProcess::stopExposure() {
     // started. Guard on the camera's reported shutter state — if it is already
     // closed (external stop, timeout, missed toggle), toggling again would
     // re-OPEN it, so skip. Only toggle when the shutter is actually open.
-    if (exposureActive_) {
-        if (CameraCommands::isShutterActive()) {
-            CameraCommands::triggerBulb();  // close toggle
+    if (!exposureActive_) {
+        return;
+    }
+    exposureActive_ = false;
+    if (awaiting_ == Awaiting::OPEN) {
+        // Not open *yet* reads the same as closed without us. The close goes
+        // out once the open confirms (serviceShutterConfirm), so a late open
+        // cannot leave the shutter open.
+        closePending_ = true;
+        return;
+    }
+    if (CameraCommands::isShutterActive()) {
+        sendClose(AstroClock::nowMs());
+    } else {
+        CameraCommands::armRigToggle(false);  // Each rig camera by its own shutter
+        awaiting_ = Awaiting::NONE;
+        journalOpen_ = false;  // Closed without us; no close times to record
+    }
+}
+
+void AstroProcess::sendClose(uint32_t nowMs) {
+    CameraCommands::armRigToggle(false);  // Each rig camera by its own shutter
+    CameraCommands::triggerBulb();        // close toggle
+    awaitShutter(Awaiting::CLOSE, nowMs);
+    if (journalOpen_) {
+        journal_.back().closeSentMs = nowMs;
+    }
+}
+
+void AstroProcess::awaitShutter(Awaiting edge, uint32_t nowMs) {
+    awaiting_ = edge;
+    toggleSentMs_ = nowMs;
+    toggleRetries_ = 0;
+}
+
+void AstroProcess::serviceShutterConfirm(uint32_t nowMs) {
+    // Edges in arrival order: an open/close shorter than a tick still shows
+    // up, where the level alone would already be back where it started.
+    // Edges from before the toggle (or with nothing awaited) are stale.
+    const bool wantOpen = awaiting_ == Awaiting::OPEN;
+    bool edgeSeen = false;
+    uint32_t edgeMs = 0;
+    CameraCommands::ShutterEdge edge;
+    while (!edgeSeen && CameraCommands::nextShutterEdge(edge)) {
+        const uint32_t atMs = AstroClock::fromMillis(edge.atMs);
+        if (awaiting_ != Awaiting::NONE && edge.open == wantOpen &&
+            static_cast<int32_t>(atMs - toggleSentMs_) >= 0) {
+            edgeSeen = true;
+            edgeMs = atMs;
         }
-        exposureActive_ = false;
     }
+    if (awaiting_ == Awaiting::NONE) {
+        return;
+    }
+
+    if (edgeSeen || CameraCommands::isShutterActive() == wantOpen) {
+        // Confirmed. Use the notification's own timestamp, not this tick's.
+        uint32_t confirmedMs =
+            edgeSeen ? edgeMs : AstroClock::fromMillis(CameraCommands::getShutterChangeTime());
+        if (static_cast<int32_t>(confirmedMs - toggleSentMs_) < 0) {
+            confirmedMs = nowMs;
+        }
+        awaiting_ = Awaiting::NONE;
+        refreshLatency();
+        if (wantOpen && closePending_) {
+            // Its close deadline has already passed: close straight away.
+            closePending_ = false;
+            openConfirmedMs_ = confirmedMs;
+            if (journalOpen_) {
+                journal_.back().openConfirmedMs = confirmedMs;
+            }
+            LOG_APP("[Astro] Shutter opened after its close deadline, closing");
+            sendClose(nowMs);
+        } else if (wantOpen) {
+            // Time the close from the real open, sending the toggle one
+            // close-latency early so the shutter is open for exactly exposureSec.
+            openConfirmedMs_ = confirmedMs;
+            const uint32_t exposureMs = segment().exposureSec * 1000UL;
+            const uint32_t leadMs =
+                status_.closeLatencyMs < exposureMs ? status_.closeLatencyMs : 0;
+            enterPhase(confirmedMs, confirmedMs + exposureMs - leadMs);
+            if (journalOpen_) {
+                journal_.back().openConfirmedMs = confirmedMs;
+                journal_.back().plannedCloseMs = phaseDeadlineMs_;
+            }
+        } else {
+            if (!orphanClose_) {
+                status_.measuredExposureMs = confirmedMs - openConfirmedMs_;
+            }
+            orphanClose_ = false;
+            if (journalOpen_) {
+                journal_.back().closeConfirmedMs = confirmedMs;
+                journalOpen_ = false;
+            }
+            if (plan_.adaptiveInterval && status_.state == State::INTERVAL) {
+                // Camera is ready again: open after the settle margin instead
+                // of waiting out the full interval (which stays the cap), and
+                // pull the rest of the grid in with it.
+                const uint32_t readyOpenMs = confirmedMs + plan_.settleMs;
+                if (static_cast<int32_t>(readyOpenMs - phaseDeadlineMs_) < 0) {
+                    originMs_ -= phaseDeadlineMs_ - readyOpenMs;
+                    enterPhase(phaseStartMs_, readyOpenMs);
+                }
+            }
+        }
+        return;
+    }
+
+    if (nowMs - toggleSentMs_ < CONFIRM_TIMEOUT_MS) {
+        return;
+    }
+    if (toggleRetries_ < CONFIRM_MAX_RETRIES) {
+        // Status still shows the old state, so re-toggling cannot invert it.
+        toggleRetries_++;
+        toggleSentMs_ = nowMs;
+        if (journalOpen_) {
+            journal_.back().flags |=
+                wantOpen ? FrameRecord::OPEN_RETRIED : FrameRecord::CLOSE_RETRIED;
+        }
+        LOG_APP("[Astro] Shutter %s not confirmed, retrying toggle",
+                wantOpen ? "open" : "close");
+        CameraCommands::triggerBulb();
+        return;
+    }
+
+    LOG_APP("[Astro] Shutter %s not confirmed, giving up", wantOpen ? "open" : "close");
+    awaiting_ = Awaiting::NONE;
+    closePending_ = false;  // Never opened: nothing to close
+    orphanClose_ = false;
+    exposureActive_ = false;
+    status_.errorCode = wantOpen ? 4 : 5;  // Shutter did not confirm open / close
+    if (journalOpen_) {
+        journal_.back().errorCode = status_.errorCode;
+        journalOpen_ = false;
+    }
+    setState(State::ERROR);
+}
+
+void AstroProcess::refreshLatency() {
+    const CameraCommands::ShutterLatency latency = CameraCommands::getShutterLatency();
+    status_.openLatencyMs = latency.openMs;
+    // Until a close has been timed, assume it behaves like the open.
+    status_.closeLatencyMs = latency.closeSamples ? latency.closeMs : latency.openMs;
+    // The rig's last cameras report after the active one, so a toggle's skew
+    // shows from the next confirmation on.
+    const CameraCommands::TriggerSkewReport skew = CameraCommands::getTriggerSkew();
+    status_.openSkewMs = skew.open.lastMs;
+    status_.maxOpenSkewMs = skew.open.maxMs;
+    status_.closeSkewMs = skew.close.lastMs;
+    status_.maxCloseSkewMs = skew.close.maxMs;
 }
@@ -1,9 +1,14 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
+#include <mutex>
 #include <string>
 #include <vector>
 
+#include "processes/astro_plan.h"
+#include "processes/frame_journal.h"
 #include "transport/ble_remote_server.h"
 #include "transport/camera_commands.h"
 
@@ -39,23 +44,38 @@ public:
         static constexpr uint16_t INTERVAL_MIN = 3;  // 3s guardrail between exposures
         static constexpr uint16_t INTERVAL_MAX = 60;
 
+        // Adaptive interval: margin after SHUTTER_READY before the next open.
+        static constexpr uint16_t SETTLE_DEFAULT_MS = 500;
+        static constexpr uint16_t SETTLE_STEP_MS = 100;
+        static constexpr uint16_t SETTLE_MAX_MS = 3000;
+
         // Parameter values
         uint16_t initialDelaySec = INITIAL_DELAY_DEFAULT;  // Initial delay in seconds
         uint16_t exposureSec = EXPOSURE_DEFAULT;           // Exposure time in seconds
         uint16_t subframeCount = SUBFRAME_COUNT_DEFAULT;   // Number of exposures
         uint16_t intervalSec = INTERVAL_DEFAULT;           // Delay between exposures
+        // Next frame opens settleMs after the camera reports SHUTTER_READY,
+        // with intervalSec kept as the upper bound on the gap.
+        bool adaptiveInterval = false;
+        uint16_t settleMs = SETTLE_DEFAULT_MS;
 
         bool validate() const {
             return initialDelaySec % INITIAL_DELAY_STEP == 0 && exposureSec >= EXPOSURE_MIN &&
                    exposureSec <= EXPOSURE_MAX && exposureSec % EXPOSURE_STEP == 0 &&
                    subframeCount >= SUBFRAME_COUNT_MIN && subframeCount <= SUBFRAME_COUNT_MAX &&
                    subframeCount % SUBFRAME_COUNT_STEP == 0 && intervalSec >= INTERVAL_MIN &&
-                   intervalSec <= INTERVAL_MAX;
+                   intervalSec <= INTERVAL_MAX && settleMs <= SETTLE_MAX_MS &&
+                   settleMs % SETTLE_STEP_MS == 0;
         }
 
         uint32_t getTotalDurationSec() const {
             return initialDelaySec + subframeCount * (exposureSec + intervalSec);
         }
+
+        // One frame's slot on the timeline: exposure plus the interval after it.
+        uint32_t getFramePeriodMs() const {
+            return (static_cast<uint32_t>(exposureSec) + intervalSec) * 1000UL;
+        }
     };
 
     struct Status {
@@ -63,16 +83,80 @@ public:
         uint16_t completedFrames = 0;
         uint16_t totalFrames =
             Parameters::SUBFRAME_COUNT_DEFAULT;  // Total number of frames in sequence
-        uint32_t sequenceStartTime = 0;          // Unix timestamp
-        uint32_t currentFrameStartTime = 0;      // Unix timestamp
+        uint32_t sequenceStartTime = 0;          // Unix timestamp (AstroClock); 0 if unknown
+        uint32_t currentFrameStartTime = 0;      // Unix timestamp (AstroClock); 0 if unknown
         uint32_t elapsedSec = 0;
         uint32_t remainingSec = 0;
         uint32_t phaseRemainingSec = 0;  // Time left in the current phase (delay/exposure/interval)
         uint32_t phaseTotalSec = 0;      // Full length of the current phase; 0 when idle/stopped
+        uint32_t phaseRemainingMs = 0;   // phaseRemainingSec at millisecond resolution
+        uint32_t phaseTotalMs = 0;       // phaseTotalSec at millisecond resolution
+        int32_t openErrorMs = 0;         // Latest frame: actual minus planned open (>0 = late)
+        uint32_t maxOpenErrorMs = 0;     // Worst |openErrorMs| seen this sequence
+        uint32_t openLatencyMs = 0;      // Camera's toggle -> shutter-open report (estimate)
+        uint32_t closeLatencyMs = 0;     // Camera's toggle -> shutter-closed report (estimate)
+        uint32_t measuredExposureMs = 0; // Latest frame, confirmed open -> confirmed close
+        uint16_t framesPerHour = 0;      // Achieved open-to-open cadence; 0 until frame 2
+        uint8_t segmentIndex = 0;        // Plan segment being run (0-based)
+        uint8_t segmentCount = 1;
+        uint16_t segmentCompletedFrames = 0;
+        uint16_t segmentTotalFrames = Parameters::SUBFRAME_COUNT_DEFAULT;
+        uint32_t scheduledStartTime = 0;  // Armed "start at" (Unix time); 0 if none
+        uint32_t wakeToFirstFrameMs = 0;  // Scheduled run: boot from sleep -> first open
+        // Rig only: spread of the cameras' shutter edges per toggle, this sequence.
+        uint16_t openSkewMs = 0;  // Latest measured open
+        uint16_t maxOpenSkewMs = 0;
+        uint16_t closeSkewMs = 0;  // Latest measured close
+        uint16_t maxCloseSkewMs = 0;
         bool isCameraConnected = false;
         uint8_t errorCode = 0;
     };
 
+    // Closed-loop shutter confirmation: after each bulb toggle, wait this long
+    // for the camera's matching shutter-status notification, re-toggle up to
+    // CONFIRM_MAX_RETRIES times (only while the status still shows the old
+    // state, so a retry can never invert the shutter), then give up with
+    // errorCode 4 (open) or 5 (close).
+    static constexpr uint32_t CONFIRM_TIMEOUT_MS = 1200;
+    static constexpr uint8_t CONFIRM_MAX_RETRIES = 1;
+    static_assert(AstroPlan::EXPOSURE_MIN * 1000UL > CONFIRM_TIMEOUT_MS,
+                  "A plan exposure must outlast the open confirmation");
+
+    // Reboot recovery (see restoreCheckpoint). Once the camera is back, wait
+    // this long for it to report its shutter state before deciding whether an
+    // exposure was left open. Checkpoints older than RECOVERY_MAX_AGE_SEC (by
+    // the RTC) are discarded rather than resumed.
+    static constexpr uint32_t RECOVERY_STATUS_WAIT_MS = 1500;
+    static constexpr uint32_t RECOVERY_MAX_AGE_SEC = 30UL * 60UL;
+
+    // Scheduled start (see scheduleStart). Closer than SCHEDULE_MIN_LEAD_SEC
+    // is refused (just press Start). Once due, the start waits up to
+    // SCHEDULE_GRACE_SEC for the camera, then runs anyway and reports it missing.
+    static constexpr uint32_t SCHEDULE_MIN_LEAD_SEC = 60;
+    static constexpr uint32_t SCHEDULE_MAX_AHEAD_SEC = 24UL * 60UL * 60UL;
+    static constexpr uint32_t SCHEDULE_GRACE_SEC = 120;
+
+    // What survives a reset: written to CheckpointStore on every phase
+    // transition. Plain data, copied byte for byte.
+    struct Checkpoint {
+        static constexpr uint8_t VERSION = 2;
+        uint8_t version = VERSION;
+        State state = State::IDLE;  // Phase entered at the last transition
+        bool shutterOpen = false;   // One of our exposures was open
+        bool pausePending = false;
+        bool planLoaded = false;
+        uint8_t segment = 0;
+        uint16_t segmentFrame = 0;
+        uint16_t completedFrames = 0;
+        uint16_t framesPerHour = 0;
+        uint32_t sequenceStartTime = 0;  // Status::sequenceStartTime
+        uint32_t elapsedMs = 0;          // Sequence time at the transition (pauses excluded)
+        uint32_t savedEpochSec = 0;      // AstroClock::epochSec() at the transition; 0 if unknown
+        uint32_t scheduledStartSec = 0;  // IDLE with a start armed (nothing else running)
+        Parameters params;
+        AstroPlan plan;
+    };
+
     // Singleton access
     static AstroProcess& instance() {
         static AstroProcess instance;
@@ -81,6 +165,7 @@ public:
 
     // Initialization - should be called after construction
     void init() {
+        Transaction txn(*this);
         if (!initialized_) {
             initializeObservers();
             initialized_ = true;
@@ -96,26 +181,100 @@ public:
     void stop();
     void reset();
 
-    // Parameter management
-    void setParameters(const Parameters& params);
+    // Boot: pick up a sequence interrupted by a reset or power loss. The
+    // sequence comes back PAUSED at the frame it was on; once the camera is
+    // connected, an exposure left open is closed (through the usual shutter-
+    // status guard) and, unless the user had paused, the run resumes on its
+    // own. The interrupted frame is not counted. Call after init(), before
+    // AstroSequencer::start(). False if there was nothing to restore.
+    bool restoreCheckpoint();
+
+    // "Start at": arm start() for a Unix time. The plan and the schedule are
+    // checkpointed like a running sequence, so they outlive the deep sleep the
+    // app takes while waiting; restoreCheckpoint() re-arms them on wake. Needs
+    // the clock set (RTC or remote sync). 0 cancels. False if running, the
+    // plan is invalid, or the time is too soon / too far ahead.
+    bool scheduleStart(uint32_t startEpochSec);
+    uint32_t getScheduledStart() const {
+        std::lock_guard<std::mutex> lock(snapshotMutex_);
+        return snapshot_.scheduledStartTime;
+    }
+    // Time left on the armed start, by the best clock available; 0 if none or due.
+    uint32_t secondsUntilScheduledStart() const;
+    // Time to the next planned bulb toggle (the end of the current delay,
+    // exposure or interval, else the armed start); UINT32_MAX if none. Lets
+    // the camera link speed up ahead of it.
+    uint32_t msUntilNextToggle() const;
+
+    // Parameter management. False (nothing changed) while a sequence runs.
+    bool setParameters(const Parameters& params);
     const Parameters& getParameters() const { return params_; }
     bool setParameter(const std::string& name, uint16_t value);
 
+    // Multi-segment plan (lights -> darks -> flats ...) from the remote link.
+    // Replaces the single block described by Parameters until the parameters
+    // are edited again. Rejected while running or if invalid.
+    bool setPlan(const AstroPlan& plan);
+    const AstroPlan& getPlan() const { return plan_; }  // The plan start() runs
+    bool hasCustomPlan() const { return planLoaded_; }
+
     // Live camera-connection state, fed from the app loop each tick. Notifies
     // status observers on a change so the remote link sees camera connect/
     // disconnect even while the sequence is idle (no periodic ticks then).
     void setCameraConnected(bool connected);
 
-    // Status access
-    const Status& getStatus() const { return status_; }
-    bool isRunning() const {
-        return status_.state != State::IDLE && status_.state != State::STOPPED &&
-               status_.state != State::ERROR;
+    // Camera link RSSI (dBm, 0 = unknown), fed from the app loop; stamped into
+    // each frame's journal record. Lock-free, so it never waits on a tick.
+    void setLinkRssi(int8_t dbm) { linkRssi_.store(dbm, std::memory_order_relaxed); }
+
+    // Per-frame timing journal of the current (or last) run. Both hold the
+    // process lock while they run, so keep fn short.
+    FrameJournal::Stats getJournalStats() {
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        return journal_.stats();
+    }
+    template <typename Fn>
+    void forEachJournalRecord(Fn fn) {
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        journal_.forEach(fn);
+    }
+    // Sequence-addressed access for paging the journal out in pieces (see
+    // FrameJournal::find). getJournalRecord() is false once the record is gone.
+    void getJournalRange(uint32_t& first, uint32_t& end) {
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        first = journal_.firstSequence();
+        end = journal_.endSequence();
+    }
+    bool getJournalRecord(uint32_t sequence, FrameRecord& out) {
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        const FrameRecord* record = journal_.find(sequence);
+        if (record) {
+            out = *record;
+        }
+        return record != nullptr;
     }
 
+    // Status access. Returns a copy of the snapshot published at the end of
+    // the last sequencer tick or command, so any task can read it without
+    // waiting on the sequencer (which may be in the middle of a bulb toggle).
+    Status getStatus() const {
+        std::lock_guard<std::mutex> lock(snapshotMutex_);
+        return snapshot_;
+    }
+    bool isRunning() const { return isRunningState(getStatus().state); }
+
     // True after pause() during an exposure, until the frame finishes and the
     // sequence parks in PAUSED. Lets the UI show a "pausing" hint.
-    bool isPausePending() const { return pausePending_; }
+    bool isPausePending() const {
+        std::lock_guard<std::mutex> lock(snapshotMutex_);
+        return snapshotPausePending_;
+    }
+
+    // True from restoreCheckpoint() until the recovered run resumes.
+    bool isRecovering() const {
+        std::lock_guard<std::mutex> lock(snapshotMutex_);
+        return snapshotRecovering_;
+    }
 
     // Observer interface for UI updates
     class Observer {
@@ -126,6 +285,7 @@ public:
     };
 
     void addObserver(Observer* observer) {
+        Transaction txn(*this);
         if (observer) {
             observers_.push_back(observer);
             // Send current state immediately
@@ -135,26 +295,92 @@ public:
     }
 
     void removeObserver(Observer* observer) {
+        Transaction txn(*this);
         observers_.erase(std::remove(observers_.begin(), observers_.end(), observer),
                          observers_.end());
     }
 
-    // Update loop - call this regularly
+    // Advance the sequence timeline. Driven every AstroSequencer::TICK_MS by
+    // the sequencer task; not called from the UI loop.
     void update();
 
 private:
+    // Scope guard for every entry point: serialises the sequencer task against
+    // UI/remote callers, and republishes the status snapshot on the way out
+    // (while still locked) so readers always see a consistent Status.
+    class Transaction {
+    public:
+        explicit Transaction(AstroProcess& process) : process_(process), lock_(process.mutex_) {}
+        ~Transaction() { process_.publishSnapshot(); }
+
+    private:
+        AstroProcess& process_;
+        std::lock_guard<std::recursive_mutex> lock_;
+    };
+
+    static bool isRunningState(State state) {
+        return state != State::IDLE && state != State::STOPPED && state != State::ERROR;
+    }
+    bool running() const { return isRunningState(status_.state); }  // Caller holds mutex_.
+    void publishSnapshot();
+
     void notifyParametersChanged();
     void notifyStatusObservers();  // Fan status_ out to all observers now.
 
     // Member variables
+    std::recursive_mutex mutex_;  // Guards everything below except the snapshot.
+    mutable std::mutex snapshotMutex_;
+    Status snapshot_;             // Published copy of status_ for readers.
+    bool snapshotPausePending_ = false;
+    bool snapshotRecovering_ = false;
     Parameters params_;
     Status status_;
+    AstroPlan plan_ = planFromParameters(Parameters{});
+    bool planLoaded_ = false;  // plan_ came from setPlan(), not params_
+    uint8_t segment_ = 0;      // Index into plan_.segments
+    uint16_t segmentFrame_ = 0;  // Frames completed in the current segment
     std::vector<Observer*> observers_;
-    uint32_t lastUpdateTime_ = 0;
     uint32_t lastNotifySec_ = 0;  // Throttles periodic status notifications to ~1 Hz.
     bool exposureActive_ = false;
     bool pausePending_ = false;   // Pause requested mid-exposure; park after frame ends.
-    uint32_t pausedAtSec_ = 0;    // When PAUSED began, to shift the timeline on resume.
+
+    // Restored from a checkpoint, waiting for the camera (serviceRecovery).
+    bool recovering_ = false;
+    bool recoveryResume_ = false;   // Resume once recovered (not a user pause)
+    bool recoveryLinked_ = false;   // Camera seen connected since restore
+    uint32_t recoveryLinkedMs_ = 0;
+    bool orphanClose_ = false;      // Awaited close is of an exposure opened before the reset
+
+    // Scheduled start (status_.scheduledStartTime holds the armed time).
+    bool scheduledRun_ = false;     // This run was started by the schedule
+    bool wokeForSchedule_ = false;  // The schedule was restored at boot (we slept)
+    uint32_t wakeMs_ = 0;           // Boot, in AstroClock::nowMs()
+
+    // Toggle awaiting its shutter-status confirmation (see CONFIRM_TIMEOUT_MS).
+    enum class Awaiting : uint8_t { NONE, OPEN, CLOSE };
+    Awaiting awaiting_ = Awaiting::NONE;
+    uint32_t toggleSentMs_ = 0;
+    uint8_t toggleRetries_ = 0;
+    uint32_t openConfirmedMs_ = 0;  // When the camera reported this frame open
+    // The close deadline passed while the open was still unconfirmed: close
+    // as soon as it confirms, drop it if the open gives up.
+    bool closePending_ = false;
+
+    FrameJournal journal_;
+    bool journalOpen_ = false;  // journal_.back() is the frame in progress
+    std::atomic<int8_t> linkRssi_{0};
+
+    // Timeline, all in AstroClock::nowMs() (millis() disciplined against the
+    // RTC / remote time, so a drifting crystal does not stretch the night).
+    // Every phase boundary is an absolute deadline derived from the sequence
+    // start, never from the tick that noticed the previous boundary, so loop
+    // jitter cannot accumulate across frames.
+    uint32_t sequenceStartMs_ = 0;  // start(); shifted forward by paused spans
+    uint32_t originMs_ = 0;         // Planned open of the segment's frame 0 (rebased on resume)
+    uint32_t phaseStartMs_ = 0;     // Planned start of the current phase
+    uint32_t phaseDeadlineMs_ = 0;  // Planned end of the current phase
+    uint32_t pausedAtMs_ = 0;       // When PAUSED began, to shift the timeline on resume.
+    uint32_t firstOpenMs_ = 0;      // Frame 0's open; shifted by paused spans
 
     void initializeObservers();  // Defined in cpp
     bool initialized_ = false;
@@ -167,7 +393,25 @@ private:
 
     // State management
     void setState(State newState);
-    void updateTimings();
-    bool startExposure();
+    void updateTimings(uint32_t nowMs);
+    void enterPhase(uint32_t startMs, uint32_t deadlineMs);
+    // Frame grid of the current segment; frame counts from the segment start.
+    uint32_t plannedOpenMs(uint16_t frame) const {
+        return originMs_ + static_cast<uint32_t>(frame) * segment().getFramePeriodMs();
+    }
+    const AstroPlan::Segment& segment() const { return plan_.segments[segment_]; }
+    void enterSegment(uint8_t index);
+    static AstroPlan planFromParameters(const Parameters& params);
+    void syncPlanFromParameters();
+    bool startExposure(uint32_t nowMs);
     void stopExposure();
+    void sendClose(uint32_t nowMs);
+    void awaitShutter(Awaiting edge, uint32_t nowMs);
+    void serviceShutterConfirm(uint32_t nowMs);
+    void refreshLatency();
+    void resumeTimeline(uint32_t nowMs);
+    void writeCheckpoint(bool mirrorNow);
+    void serviceRecovery(uint32_t nowMs);
+    void closeOrphanedExposure();
+    void serviceSchedule();
 };
\ No newline at end of file
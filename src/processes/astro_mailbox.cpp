@@ -0,0 +1,114 @@
+#include "processes/astro_mailbox.h"
+
+#include <Arduino.h>
+
+#include "debug.h"
+
+SpscRing<AstroMailbox::Command, AstroMailbox::CAPACITY> AstroMailbox::ring_;
+std::atomic<uint16_t> AstroMailbox::applied_{0};
+std::atomic<uint16_t> AstroMailbox::rejected_{0};
+std::atomic<uint32_t> AstroMailbox::lastLatencyUs_{0};
+std::atomic<uint32_t> AstroMailbox::maxLatencyUs_{0};
+
+bool AstroMailbox::post(const Command& command) {
+    Command stamped = command;
+    stamped.postedUs = micros();
+    return ring_.push(stamped);
+}
+
+size_t AstroMailbox::drain() {
+    size_t count = 0;
+    Command command;
+    while (ring_.pop(command)) {
+        const CommandStatus status = apply(command);
+        const uint32_t latencyUs = micros() - command.postedUs;
+        lastLatencyUs_.store(latencyUs, std::memory_order_relaxed);
+        if (latencyUs > maxLatencyUs_.load(std::memory_order_relaxed)) {
+            maxLatencyUs_.store(latencyUs, std::memory_order_relaxed);
+        }
+        (status == CommandStatus::SUCCESS ? applied_ : rejected_)
+            .fetch_add(1, std::memory_order_relaxed);
+        LOG_APP("[Astro] Remote command 0x%04X -> %d in %lu us", command.cmd,
+                static_cast<int>(status), static_cast<unsigned long>(latencyUs));
+        BLERemoteServer::sendFeedback(status);
+        count++;
+    }
+    return count;
+}
+
+AstroMailbox::Stats AstroMailbox::stats() {
+    Stats stats;
+    stats.applied = applied_.load(std::memory_order_relaxed);
+    stats.rejected = rejected_.load(std::memory_order_relaxed);
+    stats.dropped = ring_.dropped();
+    stats.lastLatencyUs = lastLatencyUs_.load(std::memory_order_relaxed);
+    stats.maxLatencyUs = maxLatencyUs_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+CommandStatus AstroMailbox::apply(const Command& command) {
+    auto& astro = AstroProcess::instance();
+    const AstroProcess::State state = astro.getStatus().state;
+
+    switch (command.cmd) {
+        case RemoteCmd::ASTRO_START:
+            if (state == AstroProcess::State::PAUSED) {
+                astro.resume();  // The protocol has no resume: start picks a paused run back up
+                return CommandStatus::SUCCESS;
+            }
+            if (astro.isRunning()) {
+                return CommandStatus::BUSY;
+            }
+            astro.start();
+            return astro.isRunning() ? CommandStatus::SUCCESS : CommandStatus::ASTRO_ERROR;
+
+        case RemoteCmd::ASTRO_PAUSE:
+            if (!astro.isRunning()) {
+                return CommandStatus::INVALID;
+            }
+            astro.pause();  // Mid-exposure it parks once the frame ends
+            return CommandStatus::SUCCESS;
+
+        case RemoteCmd::ASTRO_STOP:
+            if (!astro.isRunning()) {
+                return CommandStatus::INVALID;
+            }
+            astro.stop();
+            return CommandStatus::SUCCESS;
+
+        case RemoteCmd::ASTRO_RESET:
+            astro.reset();
+            return CommandStatus::SUCCESS;
+
+        case RemoteCmd::ASTRO_SET_PARAMS:
+            if (!command.params.validate()) {
+                return CommandStatus::INVALID;
+            }
+            return astro.setParameters(command.params) ? CommandStatus::SUCCESS
+                                                       : CommandStatus::BUSY;
+
+        case RemoteCmd::ASTRO_SCHEDULE:
+            if (astro.scheduleStart(command.startSec)) {
+                return CommandStatus::SUCCESS;
+            }
+            return astro.isRunning() ? CommandStatus::BUSY : CommandStatus::INVALID;
+
+        case RemoteCmd::ASTRO_SET_PLAN: {
+            if (astro.setPlan(command.plan)) {
+                return CommandStatus::SUCCESS;  // Republished through BLEAstroObserver
+            }
+            // The write replaced the characteristic's value; put the active plan back.
+            uint8_t blob[AstroPlan::MAX_BLOB_BYTES];
+            BLERemoteServer::sendAstroPlan(blob, astro.getPlan().encode(blob, sizeof(blob)));
+            return command.plan.validate() ? CommandStatus::BUSY : CommandStatus::INVALID;
+        }
+
+        case RemoteCmd::ASTRO_STATUS_FORMAT:
+            BLERemoteServer::setAstroStatusFormat(command.statusVersion, command.statusFlags,
+                                                  command.statusPayload);
+            return CommandStatus::SUCCESS;
+
+        default:
+            return CommandStatus::INVALID;
+    }
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "processes/astro.h"
+#include "utils/spsc_ring.h"
+
+// Remote astro commands (RemoteCmd::ASTRO_*, plan writes included), handed
+// from the BLE task to the AstroSequencer task. The write callback only
+// validates and posts; the sequencer drains the mailbox at the top of its
+// tick, so AstroProcess and the status format are only ever changed from its
+// own task, never from inside Bluedroid. Each command's real outcome goes back
+// on the feedback characteristic once it has run.
+//
+// One producer (the BLE task) and one consumer (the sequencer), lock-free.
+class AstroMailbox {
+public:
+    static constexpr size_t CAPACITY = 8;
+
+    struct Command {
+        uint16_t cmd = 0;                 // RemoteCmd::ASTRO_*
+        AstroProcess::Parameters params;  // ASTRO_SET_PARAMS
+        uint32_t startSec = 0;            // ASTRO_SCHEDULE
+        AstroPlan plan;                   // ASTRO_SET_PLAN (plan characteristic write)
+        uint8_t statusVersion = 0;        // ASTRO_STATUS_FORMAT
+        uint8_t statusFlags = 0;
+        uint16_t statusPayload = 0;       // ATT payload of the link it came on
+        uint32_t postedUs = 0;            // micros() at post
+    };
+
+    struct Stats {
+        uint16_t applied = 0;        // Ran and took effect
+        uint16_t rejected = 0;       // Ran and was refused (busy, invalid, error)
+        uint32_t dropped = 0;        // Posted into a full mailbox
+        uint32_t lastLatencyUs = 0;  // Post -> outcome of the latest command
+        uint32_t maxLatencyUs = 0;
+    };
+
+    // Producer side. False if the mailbox is full; the caller answers BUSY.
+    static bool post(const Command& command);
+
+    // Consumer side: runs every waiting command against AstroProcess in order
+    // and reports each outcome. Returns how many ran.
+    static size_t drain();
+
+    static Stats stats();
+
+    // What a command did to AstroProcess, as reported on the feedback
+    // characteristic. Public for the native tests.
+    static CommandStatus apply(const Command& command);
+
+private:
+    static SpscRing<Command, CAPACITY> ring_;
+    // Written by the consumer only; read from any task.
+    static std::atomic<uint16_t> applied_;
+    static std::atomic<uint16_t> rejected_;
+    static std::atomic<uint32_t> lastLatencyUs_;
+    static std::atomic<uint32_t> maxLatencyUs_;
+};
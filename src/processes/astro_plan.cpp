@@ -0,0 +1,99 @@
+#include "processes/astro_plan.h"
+
+namespace {
+uint16_t readU16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+void writeU16(uint8_t* p, uint16_t value) {
+    p[0] = static_cast<uint8_t>(value & 0xFF);
+    p[1] = static_cast<uint8_t>(value >> 8);
+}
+
+constexpr uint8_t FLAG_ADAPTIVE = 0x01;
+constexpr uint8_t FLAG_PAUSE_BEFORE = 0x01;
+}  // namespace
+
+bool AstroPlan::validate() const {
+    if (segmentCount == 0 || segmentCount > MAX_SEGMENTS || initialDelaySec > INITIAL_DELAY_MAX ||
+        settleMs > SETTLE_MAX_MS) {
+        return false;
+    }
+    for (uint8_t i = 0; i < segmentCount; i++) {
+        const Segment& s = segments[i];
+        if (static_cast<uint8_t>(s.type) > static_cast<uint8_t>(FrameType::BIAS) ||
+            s.exposureSec < EXPOSURE_MIN || s.exposureSec > EXPOSURE_MAX || s.count == 0 ||
+            s.count > COUNT_MAX || s.intervalSec < INTERVAL_MIN || s.intervalSec > INTERVAL_MAX) {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint16_t AstroPlan::totalFrames() const {
+    uint32_t total = 0;
+    for (uint8_t i = 0; i < segmentCount && i < MAX_SEGMENTS; i++) {
+        total += segments[i].count;
+    }
+    return static_cast<uint16_t>(total);  // <= MAX_SEGMENTS * COUNT_MAX
+}
+
+uint32_t AstroPlan::getTotalDurationSec() const {
+    uint32_t totalMs = initialDelaySec * 1000UL;
+    for (uint8_t i = 0; i < segmentCount && i < MAX_SEGMENTS; i++) {
+        totalMs += segments[i].getDurationMs();
+    }
+    return totalMs / 1000;
+}
+
+bool AstroPlan::decode(const uint8_t* data, size_t length) {
+    if (!data || length < HEADER_BYTES || data[0] != BLOB_VERSION) {
+        return false;
+    }
+    const uint8_t count = data[1];
+    if (count == 0 || count > MAX_SEGMENTS || length != HEADER_BYTES + count * SEGMENT_BYTES) {
+        return false;
+    }
+
+    AstroPlan plan;
+    plan.segmentCount = count;
+    plan.initialDelaySec = readU16(data + 2);
+    plan.adaptiveInterval = (data[4] & FLAG_ADAPTIVE) != 0;
+    plan.settleMs = readU16(data + 5);
+    for (uint8_t i = 0; i < count; i++) {
+        const uint8_t* p = data + HEADER_BYTES + i * SEGMENT_BYTES;
+        Segment& s = plan.segments[i];
+        s.type = static_cast<FrameType>(p[0]);
+        s.pauseBefore = (p[1] & FLAG_PAUSE_BEFORE) != 0;
+        s.exposureSec = readU16(p + 2);
+        s.count = readU16(p + 4);
+        s.intervalSec = readU16(p + 6);
+    }
+    if (!plan.validate()) {
+        return false;
+    }
+    *this = plan;
+    return true;
+}
+
+size_t AstroPlan::encode(uint8_t* out, size_t capacity) const {
+    const size_t length = HEADER_BYTES + segmentCount * SEGMENT_BYTES;
+    if (!out || segmentCount > MAX_SEGMENTS || capacity < length) {
+        return 0;
+    }
+    out[0] = BLOB_VERSION;
+    out[1] = segmentCount;
+    writeU16(out + 2, initialDelaySec);
+    out[4] = adaptiveInterval ? FLAG_ADAPTIVE : 0;
+    writeU16(out + 5, settleMs);
+    for (uint8_t i = 0; i < segmentCount; i++) {
+        uint8_t* p = out + HEADER_BYTES + i * SEGMENT_BYTES;
+        const Segment& s = segments[i];
+        p[0] = static_cast<uint8_t>(s.type);
+        p[1] = s.pauseBefore ? FLAG_PAUSE_BEFORE : 0;
+        writeU16(p + 2, s.exposureSec);
+        writeU16(p + 4, s.count);
+        writeU16(p + 6, s.intervalSec);
+    }
+    return length;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// A night's sequence as an ordered list of segments (e.g. lights, then darks,
+// then flats), each a block of identical bulb frames. AstroProcess runs the
+// segments back to back on one timeline. A single-block AstroProcess::
+// Parameters config is just a one-segment plan.
+//
+// Fixed capacity, no heap: the whole plan is a POD that can be copied under
+// the AstroProcess lock and round-trips through a compact binary blob (the
+// remote link's ASTRO_PLAN_CHAR_UUID; layout below, little-endian).
+//
+//   header   u8 version | u8 segmentCount | u16 initialDelaySec |
+//            u8 flags (bit0 adaptive interval) | u16 settleMs
+//   segment  u8 frameType | u8 flags (bit0 pause before) |
+//            u16 exposureSec | u16 count | u16 intervalSec      (x segmentCount)
+struct AstroPlan {
+    static constexpr uint8_t MAX_SEGMENTS = 8;
+    static constexpr uint8_t BLOB_VERSION = 1;
+    static constexpr size_t HEADER_BYTES = 7;
+    static constexpr size_t SEGMENT_BYTES = 8;
+    static constexpr size_t MAX_BLOB_BYTES = HEADER_BYTES + MAX_SEGMENTS * SEGMENT_BYTES;
+
+    // Per-segment limits. Wider than the device menu's (which steps a light
+    // block in 30 s), since darks/flats use other exposures. The shortest
+    // exposure still outlasts AstroProcess::CONFIRM_TIMEOUT_MS, so a lost open
+    // toggle is retried before the frame's close is due.
+    static constexpr uint16_t EXPOSURE_MIN = 2;
+    static constexpr uint16_t EXPOSURE_MAX = 600;
+    static constexpr uint16_t COUNT_MAX = 480;
+    static constexpr uint16_t INTERVAL_MIN = 3;
+    static constexpr uint16_t INTERVAL_MAX = 60;
+    static constexpr uint16_t INITIAL_DELAY_MAX = 3600;
+    static constexpr uint16_t SETTLE_MAX_MS = 3000;
+
+    enum class FrameType : uint8_t { LIGHT, DARK, FLAT, BIAS };
+
+    struct Segment {
+        FrameType type = FrameType::LIGHT;
+        // Park in PAUSED before this segment until the user resumes (cap the
+        // lens for darks, mount the flat panel). Ignored on segment 0.
+        bool pauseBefore = false;
+        uint16_t exposureSec = 0;
+        uint16_t count = 0;
+        uint16_t intervalSec = 0;
+
+        uint32_t getFramePeriodMs() const {
+            return (static_cast<uint32_t>(exposureSec) + intervalSec) * 1000UL;
+        }
+        uint32_t getDurationMs() const { return count * getFramePeriodMs(); }
+    };
+
+    uint16_t initialDelaySec = 0;
+    bool adaptiveInterval = false;  // See AstroProcess::Parameters
+    uint16_t settleMs = 0;
+    uint8_t segmentCount = 0;
+    Segment segments[MAX_SEGMENTS];
+
+    bool validate() const;
+    uint16_t totalFrames() const;
+    uint32_t getTotalDurationSec() const;
+
+    // Blob codec. decode() leaves *this untouched on failure.
+    bool decode(const uint8_t* data, size_t length);
+    size_t encode(uint8_t* out, size_t capacity) const;  // 0 if it does not fit
+};
@@ -0,0 +1,39 @@
+#include "processes/astro_sequencer.h"
+
+#include <Arduino.h>
+
+#include "processes/astro.h"
+#include "processes/astro_mailbox.h"
+#include "transport/camera_commands.h"
+
+TaskHandle_t AstroSequencer::task_ = nullptr;
+
+void AstroSequencer::start() {
+    if (task_ != nullptr) {
+        return;
+    }
+    if (xTaskCreatePinnedToCore(taskMain, "astro_seq", TASK_STACK_BYTES, nullptr, TASK_PRIORITY,
+                                &task_, TASK_CORE) != pdPASS) {
+        task_ = nullptr;
+        LOG_APP("[Astro] Failed to start sequencer task");
+        return;
+    }
+    LOG_APP("[Astro] Sequencer task started (prio %d, core %d, %lu ms tick)", TASK_PRIORITY,
+            TASK_CORE, (unsigned long)TICK_MS);
+}
+
+void AstroSequencer::tick() {
+    AstroMailbox::drain();         // Remote commands posted by the BLE task
+    CameraCommands::pollStatus();  // Shutter edges up to now, before acting on them
+    AstroProcess::instance().update();
+}
+
+void AstroSequencer::taskMain(void*) {
+    // vTaskDelayUntil keeps a fixed cadence: time spent inside tick() (e.g. a
+    // bulb toggle's BLE write) is absorbed rather than added to the period.
+    TickType_t lastWake = xTaskGetTickCount();
+    for (;;) {
+        tick();
+        vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(TICK_MS));
+    }
+}
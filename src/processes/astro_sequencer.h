@@ -0,0 +1,31 @@
+#pragma once
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include <cstdint>
+
+// Runs the AstroProcess timeline on its own FreeRTOS task, pinned to the app
+// core at a priority above the Arduino loop task. The loop can then sit in a
+// blocking reconnect or camera write for seconds without stretching an
+// exposure: the sequencer preempts it to fire each bulb toggle on its deadline.
+// The UI only reads AstroProcess's published status snapshot.
+class AstroSequencer {
+public:
+    static constexpr uint32_t TICK_MS = 10;          // Sequencer period
+    static constexpr UBaseType_t TASK_PRIORITY = 3;  // Arduino loopTask runs at 1
+    static constexpr BaseType_t TASK_CORE = 1;       // App core; BLE host lives on 0
+    static constexpr uint32_t TASK_STACK_BYTES = 6144;
+
+    // Create the task (once). Call after AstroProcess::init().
+    static void start();
+    static bool isStarted() { return task_ != nullptr; }
+
+    // One sequencer pass — what the task runs every TICK_MS. Public so the
+    // native tests can drive it from a stubbed scheduler.
+    static void tick();
+
+private:
+    static void taskMain(void* arg);
+    static TaskHandle_t task_;
+};
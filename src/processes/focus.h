@@ -101,15 +101,14 @@ public:
         if (!state.focusing)
             return;
 
+        // The command queue holds the release back for the step length.
         if (increment > 0) {
             CameraCommands::sendCommand24(CameraCommands::Cmd::FOCUS_OUT_PRESS,
                                           static_cast<uint8_t>(state.sensitivity));
-            delay(30);
             CameraCommands::sendCommand24(CameraCommands::Cmd::FOCUS_OUT_RELEASE, 0x00);
         } else if (increment < 0) {
             CameraCommands::sendCommand24(CameraCommands::Cmd::FOCUS_IN_PRESS,
                                           static_cast<uint8_t>(state.sensitivity));
-            delay(30);
             CameraCommands::sendCommand24(CameraCommands::Cmd::FOCUS_IN_RELEASE, 0x00);
         }
     }
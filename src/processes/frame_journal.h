@@ -0,0 +1,158 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// What actually happened to each frame of an astro run, for post-run review:
+// one fixed-size FrameRecord per frame in a preallocated ring (the oldest are
+// overwritten past CAPACITY). No heap; appending is a few stores. Owned by
+// AstroProcess and only touched under its lock.
+//
+// Times are AstroClock::nowMs(); a confirmation or close time of 0 means it
+// did not happen (never confirmed, never sent).
+struct FrameRecord {
+    enum Flags : uint8_t {
+        OPENED = 0x01,        // The frame opened (toggle sent or adopted)
+        ADOPTED = 0x02,       // Shutter was already open; no open toggle sent
+        OPEN_RETRIED = 0x04,  // Open toggle re-sent after a missed confirmation
+        CLOSE_RETRIED = 0x08,
+    };
+
+    uint32_t plannedOpenMs = 0;
+    uint32_t openSentMs = 0;        // Open toggle written
+    uint32_t openConfirmedMs = 0;   // Camera's SHUTTER_ACTIVE notification
+    uint32_t plannedCloseMs = 0;    // Close deadline (latency-compensated)
+    uint32_t closeSentMs = 0;
+    uint32_t closeConfirmedMs = 0;  // Camera's SHUTTER_READY notification
+    uint16_t frame = 0;             // Index across the whole plan
+    uint8_t segment = 0;
+    uint8_t flags = 0;
+    int8_t rssi = 0;                // Camera link RSSI (dBm) at the open; 0 if unknown
+    uint8_t errorCode = 0;          // Status::errorCode if the frame failed
+
+    int32_t openErrorMs() const { return static_cast<int32_t>(openSentMs - plannedOpenMs); }
+    // Confirmed open -> confirmed close; 0 unless both were seen.
+    uint32_t exposureMs() const {
+        return openConfirmedMs && closeConfirmedMs ? closeConfirmedMs - openConfirmedMs : 0;
+    }
+
+    // Wire form for the remote link's bulk channel: the fields above in
+    // declaration order, little-endian, no padding.
+    static constexpr size_t WIRE_BYTES = 30;
+    void encode(uint8_t* out) const {
+        const uint32_t times[] = {plannedOpenMs, openSentMs,     openConfirmedMs,
+                                  plannedCloseMs, closeSentMs, closeConfirmedMs};
+        for (uint32_t t : times) {
+            for (int i = 0; i < 4; i++) {
+                *out++ = static_cast<uint8_t>(t >> (8 * i));
+            }
+        }
+        *out++ = static_cast<uint8_t>(frame);
+        *out++ = static_cast<uint8_t>(frame >> 8);
+        *out++ = segment;
+        *out++ = flags;
+        *out++ = static_cast<uint8_t>(rssi);
+        *out++ = errorCode;
+    }
+};
+
+class FrameJournal {
+public:
+    static constexpr size_t CAPACITY = 512;  // A full night of 60 s subs
+
+    struct Stats {
+        uint16_t frames = 0;          // Records that opened
+        uint16_t failed = 0;          // Records with an errorCode
+        int32_t meanOpenErrorMs = 0;  // Signed: >0 opens ran late on average
+        uint32_t maxOpenErrorMs = 0;  // Worst |open error|
+        uint32_t meanExposureMs = 0;  // Over frames with both edges confirmed
+    };
+
+    void clear() {
+        head_ = 0;
+        size_ = 0;  // appended_ keeps counting, so cleared sequences stay dead
+    }
+
+    // Start a new record (overwriting the oldest when full) and return it for
+    // the caller to fill in as the frame progresses.
+    FrameRecord& append() {
+        FrameRecord& record = records_[head_];
+        record = FrameRecord{};
+        head_ = (head_ + 1) % CAPACITY;
+        if (size_ < CAPACITY) {
+            size_++;
+        }
+        appended_++;
+        return record;
+    }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    // i = 0 is the oldest record kept.
+    const FrameRecord& at(size_t i) const {
+        return records_[(head_ + CAPACITY - size_ + i) % CAPACITY];
+    }
+    FrameRecord& back() { return records_[(head_ + CAPACITY - 1) % CAPACITY]; }
+
+    // Records are also addressed by sequence number (the count of append()s
+    // before it), which stays valid across wraps: a reader paging through the
+    // journal can tell a record from the one that later overwrote its slot.
+    // Held records are [firstSequence(), endSequence()).
+    uint32_t firstSequence() const { return appended_ - static_cast<uint32_t>(size_); }
+    uint32_t endSequence() const { return appended_; }
+    // nullptr once the record has been overwritten or cleared.
+    const FrameRecord* find(uint32_t sequence) const {
+        const uint32_t age = appended_ - sequence;  // 1 = newest
+        if (age == 0 || age > size_) {
+            return nullptr;
+        }
+        return &records_[(head_ + CAPACITY - age) % CAPACITY];
+    }
+
+    // Calls fn(const FrameRecord&) oldest first.
+    template <typename Fn>
+    void forEach(Fn fn) const {
+        for (size_t i = 0; i < size_; i++) {
+            fn(at(i));
+        }
+    }
+
+    Stats stats() const {
+        Stats s;
+        int64_t openErrorSum = 0;
+        uint64_t exposureSum = 0;
+        uint16_t exposures = 0;
+        forEach([&](const FrameRecord& r) {
+            if (r.errorCode) {
+                s.failed++;
+            }
+            if (!(r.flags & FrameRecord::OPENED)) {
+                return;
+            }
+            s.frames++;
+            const int32_t error = r.openErrorMs();
+            const uint32_t absError = error < 0 ? -error : error;
+            openErrorSum += error;
+            if (absError > s.maxOpenErrorMs) {
+                s.maxOpenErrorMs = absError;
+            }
+            if (r.exposureMs()) {
+                exposureSum += r.exposureMs();
+                exposures++;
+            }
+        });
+        if (s.frames) {
+            s.meanOpenErrorMs = static_cast<int32_t>(openErrorSum / s.frames);
+        }
+        if (exposures) {
+            s.meanExposureMs = static_cast<uint32_t>(exposureSum / exposures);
+        }
+        return s;
+    }
+
+private:
+    FrameRecord records_[CAPACITY];
+    size_t head_ = 0;  // Next slot to write
+    size_t size_ = 0;
+    uint32_t appended_ = 0;  // Sequence number of the next append()
+};
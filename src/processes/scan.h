@@ -11,32 +11,42 @@ public:
         Status status;
         bool isScanning;
         bool isConnecting;
-        const std::vector<DeviceInfo>& discoveredDevices;
+        size_t deviceCount;
     };
 
     static bool startScan(int duration = 5) { return BLEDeviceManager::startScan(duration); }
+    // After a scan that found nothing: listen on, mostly at low duty, and stop
+    // at the first camera that turns up.
+    static bool waitForCamera(int duration = 30) {
+        return BLEDeviceManager::scanForFirstCamera(duration);
+    }
 
     static ScanState getState() {
         Status status;
         bool isScanning = BLEDeviceManager::isScanning();
-        const auto& devices = BLEDeviceManager::getDiscoveredDevices();
+        const size_t deviceCount = BLEDeviceManager::getScanTable().size();
 
         if (isScanning) {
             status = Status::Scanning;
-        } else if (devices.empty()) {
+        } else if (deviceCount == 0) {
             status = Status::NoDevices;
         } else {
             status = Status::DevicesFound;
         }
 
-        return ScanState{status, isScanning, false, devices};
+        return ScanState{status, isScanning, false, deviceCount};
     }
 
-    static bool connectToDevice(const BLEAdvertisedDevice* device) {
-        if (!device) {
-            return false;
-        }
-        return BLEDeviceManager::connectToCamera(device);
+    // Devices found or changed since `version` (see ScanTable::changedSince).
+    static size_t pollDevices(uint32_t& version, ScanTable::Entry* out, size_t max,
+                              bool& reset) {
+        return BLEDeviceManager::getScanTable().changedSince(version, out, max, reset);
+    }
+
+    // Pairing ends any scan still running.
+    static bool connectToDevice(const ScanTable::Entry& device) {
+        BLEDeviceManager::stopScan();
+        return BLEDeviceManager::connectToCamera(device.address, device.name);
     }
 
     static void clearDevices() { BLEDeviceManager::clearDiscoveredDevices(); }
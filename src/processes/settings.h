@@ -32,12 +32,8 @@ public:
     // avoid an NVS brightness read every frame.
     static int getBatteryLevel() { return M5.Power.getBatteryLevel(); }
 
-    static bool connectToDevice() {
-        if (BLEDeviceManager::connectToSavedDevice()) {
-            return true;
-        }
-        return false;
-    }
+    // Starts the connect; BLEDeviceManager finishes it in the background.
+    static bool connectToDevice() { return BLEDeviceManager::connectToSavedDevice(); }
 
     static void disconnectDevice() { BLEDeviceManager::disconnect(); }
 
@@ -203,10 +203,36 @@ void AstroRunScreen::draw() {
         M5.Display.setTextDatum(middle_center);
         const bool ok = status.state == AstroProcess::State::STOPPED &&
                         status.completedFrames >= status.totalFrames;
-        M5.Display.drawString(ok ? "Complete" : "Stopped", w / 2, h / 2 - 12);
-        char buf[16];
+        M5.Display.drawString(ok ? "Complete" : "Stopped", w / 2, h / 2 - 30);
+        char buf[24];
         snprintf(buf, sizeof(buf), "%d/%d", status.completedFrames, status.totalFrames);
-        M5.Display.drawString(buf, w / 2, h / 2 + 6);
+        M5.Display.drawString(buf, w / 2, h / 2 - 12);
+
+        // Timing review from the frame journal: how far the opens landed from
+        // their planned deadlines, and the exposure the camera confirmed.
+        const FrameJournal::Stats stats = AstroProcess::instance().getJournalStats();
+        if (stats.frames > 0) {
+            M5.Display.setTextColor(colors::get(colors::GRAY_200));
+            snprintf(buf, sizeof(buf), "Open avg %+ldms", static_cast<long>(stats.meanOpenErrorMs));
+            M5.Display.drawString(buf, w / 2, h / 2 + 12);
+            snprintf(buf, sizeof(buf), "Open max %lums",
+                     static_cast<unsigned long>(stats.maxOpenErrorMs));
+            M5.Display.drawString(buf, w / 2, h / 2 + 28);
+            if (stats.meanExposureMs > 0) {
+                snprintf(buf, sizeof(buf), "Exp %lu.%02lus",
+                         static_cast<unsigned long>(stats.meanExposureMs / 1000),
+                         static_cast<unsigned long>(stats.meanExposureMs % 1000 / 10));
+                M5.Display.drawString(buf, w / 2, h / 2 + 44);
+            }
+        }
+        // Scheduled run that slept: wake (boot) to the first open.
+        if (status.wakeToFirstFrameMs > 0) {
+            M5.Display.setTextColor(colors::get(colors::GRAY_200));
+            snprintf(buf, sizeof(buf), "Wake %lu.%lus",
+                     static_cast<unsigned long>(status.wakeToFirstFrameMs / 1000),
+                     static_cast<unsigned long>(status.wakeToFirstFrameMs % 1000 / 100));
+            M5.Display.drawString(buf, w / 2, h / 2 + 60);
+        }
         return;
     }
     drawTop();
@@ -235,7 +261,6 @@ void AstroRunScreen::drawTop() {
 
 void AstroRunScreen::drawBottom() {
     const auto& status = AstroProcess::instance().getStatus();
-    const auto& params = AstroProcess::instance().getParameters();
     const int w = botCanvas_.width();
     const int h = botCanvas_.height();
     const int barH = STATUS_BAR_HEIGHT;
@@ -265,7 +290,13 @@ void AstroRunScreen::drawBottom() {
     };
 
     char value[16];
-    snprintf(value, sizeof(value), "%d/%d", status.completedFrames + 1, params.subframeCount);
+    if (status.segmentCount > 1) {
+        // Multi-segment plan: frame within the current segment.
+        snprintf(value, sizeof(value), "S%d %d/%d", status.segmentIndex + 1,
+                 status.segmentCompletedFrames + 1, status.segmentTotalFrames);
+    } else {
+        snprintf(value, sizeof(value), "%d/%d", status.completedFrames + 1, status.totalFrames);
+    }
     infoRow("Frame", value);
     snprintf(value, sizeof(value), "%02d:%02d:%02d", status.elapsedSec / 3600,
              (status.elapsedSec % 3600) / 60, status.elapsedSec % 60);
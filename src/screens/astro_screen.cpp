@@ -9,8 +9,14 @@
 #include "screens/scan_screen.h"
 #include "transport/ble_device.h"
 #include "transport/remote_control_manager.h"
+#include "utils/astro_clock.h"
 #include "utils/colors.h"
 
+namespace {
+constexpr uint16_t START_OFFSET_STEP_MIN = 15;
+constexpr uint16_t START_OFFSET_MAX_MIN = 12 * 60;
+}  // namespace
+
 uint16_t clamp(uint16_t value, uint16_t min, uint16_t max) {
     if (value > max)
         return max;
@@ -44,16 +50,31 @@ void AstroScreen::updateMenuItems() {
         menuItems.addItem(AstroMenuItem::Connect, "Connect");
     }
 
+    char buffer[32];
     if (status.state == AstroProcess::State::PAUSED) {
         menuItems.addItem(AstroMenuItem::Start, "Resume");
         menuItems.addItem(AstroMenuItem::Stop, "Stop");
+    } else if (status.scheduledStartTime) {
+        menuItems.addItem(AstroMenuItem::Start, "Cancel start");
     } else {
-        menuItems.addItem(AstroMenuItem::Start, "Start");
+        menuItems.addItem(AstroMenuItem::Start, startOffsetMin ? "Schedule" : "Start");
+        if (startOffsetMin) {
+            snprintf(buffer, sizeof(buffer), "+%d:%02d", startOffsetMin / 60, startOffsetMin % 60);
+        }
+        menuItems.addItem(AstroMenuItem::StartAt, "Start at", startOffsetMin ? buffer : "Now",
+                          true);
     }
     menuItems.addItem(AstroMenuItem::Focus, "Focus");
     menuItems.addSeparator();
 
-    char buffer[32];
+    // A plan loaded from the remote replaces the block below until any of its
+    // values is edited here.
+    if (astro.hasCustomPlan()) {
+        const auto& plan = astro.getPlan();
+        snprintf(buffer, sizeof(buffer), "%d seg, %d fr", plan.segmentCount, plan.totalFrames());
+        menuItems.addItem(AstroMenuItem::Plan, "Plan", buffer, false);
+    }
+
     snprintf(buffer, sizeof(buffer), "%ds", params.initialDelaySec);
     menuItems.addItem(AstroMenuItem::InitialDelay, "Delay", buffer, false);
 
@@ -65,23 +86,38 @@ void AstroScreen::updateMenuItems() {
 
     snprintf(buffer, sizeof(buffer), "%ds", params.intervalSec);
     menuItems.addItem(AstroMenuItem::DelayBetweenExposures, "Interval", buffer, true);
+
+    // Adaptive mode: Interval above becomes the cap, not the gap.
+    menuItems.addItem(AstroMenuItem::IntervalMode, "Next frame",
+                      params.adaptiveInterval ? "On ready" : "Fixed", true);
+    if (params.adaptiveInterval) {
+        snprintf(buffer, sizeof(buffer), "%dms", params.settleMs);
+        menuItems.addItem(AstroMenuItem::SettleMargin, "Settle", buffer, true);
+    }
 }
 
 void AstroScreen::drawContent() {
     auto& astro = AstroProcess::instance();
-    const auto& params = astro.getParameters();
 
-    if (astro.getStatus().state == AstroProcess::State::PAUSED) {
+    if (astro.isRecovering()) {
+        setStatusText(BLEDeviceManager::isConnected() ? "Recovering..." : "Recovering: connect");
+        setStatusBgColor(colors::get(colors::IN_PROGRESS));
+    } else if (astro.getStatus().state == AstroProcess::State::PAUSED) {
         setStatusText("Paused");
         setStatusBgColor(colors::get(colors::WARNING));
+    } else if (astro.getStatus().scheduledStartTime) {
+        setCountdownStatus(astro.secondsUntilScheduledStart());
     } else if (!BLEDeviceManager::isConnected()) {
         // No camera: surface it, since a sequence cannot start without one.
         setStatusText(BLEDeviceManager::isPaired() ? "Not connected" : "No camera paired");
         setStatusBgColor(colors::get(colors::ERROR));
     } else {
         char buffer[64];
-        uint32_t totalSec = params.getTotalDurationSec();
-        snprintf(buffer, sizeof(buffer), "Total: %02d:%02d:%02d", totalSec / 3600,
+        // The plan mirrors the parameters unless one was loaded remotely.
+        const auto& plan = astro.getPlan();
+        uint32_t totalSec = plan.getTotalDurationSec();
+        snprintf(buffer, sizeof(buffer), "%s: %02d:%02d:%02d",
+                 plan.adaptiveInterval ? "Max" : "Total", totalSec / 3600,
                  (totalSec % 3600) / 60, totalSec % 60);
         setStatusText(buffer);
         setStatusBgColor(colors::get(colors::SUCCESS));
@@ -91,8 +127,18 @@ void AstroScreen::drawContent() {
     menuItems.draw();
 }
 
+void AstroScreen::setCountdownStatus(uint32_t sec) {
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "Starts in %lu:%02lu:%02lu",
+             static_cast<unsigned long>(sec / 3600), static_cast<unsigned long>((sec % 3600) / 60),
+             static_cast<unsigned long>(sec % 60));
+    setStatusText(buffer);
+    setStatusBgColor(colors::get(colors::IN_PROGRESS));
+}
+
 void AstroScreen::update() {
     auto& astro = AstroProcess::instance();
+    serviceConnectWatch();
 
     // Handle button inputs
     if (RemoteControlManager::wasButtonPressed(ButtonId::BTN_B) ||
@@ -127,11 +173,37 @@ void AstroScreen::update() {
         adjustParameter(-1);
     }
 
-    // Redraw when the camera connection state flips, so the Connect item and
-    // status text stay in sync without a button press.
+    // A sequence recovered at boot parks here as PAUSED and resumes on its
+    // own once the camera is back: follow it to the run screen.
+    const bool recovering = astro.isRecovering();
+    if (wasRecovering && !recovering && astro.isRunning() &&
+        astro.getStatus().state != AstroProcess::State::PAUSED) {
+        MenuSystem::setScreen(new AstroRunScreen());
+        return;
+    }
+
+    // Likewise when a scheduled start fires; until then, tick the countdown.
+    const bool scheduled = astro.getScheduledStart() != 0;
+    if (wasScheduled && !scheduled && astro.isRunning()) {
+        MenuSystem::setScreen(new AstroRunScreen());
+        return;
+    }
+    if (scheduled != wasScheduled) {
+        wasScheduled = scheduled;
+        updateMenuItems();
+        draw();
+    } else if (scheduled && astro.secondsUntilScheduledStart() != shownCountdownSec) {
+        shownCountdownSec = astro.secondsUntilScheduledStart();
+        setCountdownStatus(shownCountdownSec);
+        drawStatusBar();
+    }
+
+    // Redraw when the camera connection state (or recovery) flips, so the
+    // Connect item and status text stay in sync without a button press.
     const bool connected = BLEDeviceManager::isConnected();
-    if (connected != wasConnected) {
+    if (connected != wasConnected || recovering != wasRecovering) {
         wasConnected = connected;
+        wasRecovering = recovering;
         updateMenuItems();
         draw();
     }
@@ -143,6 +215,14 @@ void AstroScreen::adjustParameter(uint16_t delta) {
     auto selectedItem = menuItems.getSelectedId();
 
     switch (selectedItem) {
+        case AstroMenuItem::StartAt: {
+            // Steps of 15 min, wrapping between Now and the 12 h limit.
+            const int next = startOffsetMin + START_OFFSET_STEP_MIN * static_cast<int16_t>(delta);
+            startOffsetMin = next < 0                      ? START_OFFSET_MAX_MIN
+                             : next > START_OFFSET_MAX_MIN ? 0
+                                                           : static_cast<uint16_t>(next);
+            break;
+        }
         case AstroMenuItem::ExposureTime:
             if (!astro.isRunning()) {
                 auto newExp = clamp(
@@ -169,6 +249,23 @@ void AstroScreen::adjustParameter(uint16_t delta) {
                 astro.setParameter("intervalSec", newInterval);
             }
             break;
+
+        case AstroMenuItem::IntervalMode:
+            if (!astro.isRunning()) {
+                astro.setParameter("adaptiveInterval", params.adaptiveInterval ? 0 : 1);
+            }
+            break;
+
+        case AstroMenuItem::SettleMargin:
+            if (!astro.isRunning()) {
+                // Min is 0, so step signed: a wrapped -1 would clamp to max.
+                const int newSettle = params.settleMs + AstroProcess::Parameters::SETTLE_STEP_MS *
+                                                            static_cast<int16_t>(delta);
+                astro.setParameter("settleMs",
+                                   newSettle < 0 ? 0 : clamp(newSettle, 0,
+                                                             AstroProcess::Parameters::SETTLE_MAX_MS));
+            }
+            break;
     }
     updateMenuItems();
     draw();
@@ -181,20 +278,9 @@ bool AstroScreen::handleSelect() {
     switch (selectedItem) {
         case AstroMenuItem::Connect:
             if (BLEDeviceManager::isPaired()) {
-                // Known device: try a direct reconnect, staying on this screen.
-                setStatusText("Connecting...");
-                setStatusBgColor(colors::get(colors::IN_PROGRESS));
-                drawStatusBar();
-
-                if (BLEDeviceManager::connectToSavedDevice()) {
-                    setStatusText("Connected!");
-                    setStatusBgColor(colors::get(colors::SUCCESS));
-                } else {
-                    setStatusText("Failed to connect!");
-                    setStatusBgColor(colors::get(colors::ERROR));
-                }
-                updateMenuItems();
-                draw();
+                // Known device: reconnect in the background, staying on this
+                // screen; update() reports the outcome.
+                watchConnect(BLEDeviceManager::connectToSavedDevice());
             } else {
                 // No saved device: go discover/pair one.
                 MenuSystem::setScreen(new ScanScreen());
@@ -211,6 +297,24 @@ bool AstroScreen::handleSelect() {
             // in-progress screen which owns the live display.
             if (astro.getStatus().state == AstroProcess::State::PAUSED) {
                 astro.resume();
+            } else if (astro.getStatus().scheduledStartTime) {
+                astro.scheduleStart(0);
+                updateMenuItems();
+                draw();
+                break;
+            } else if (startOffsetMin) {
+                // Armed: stay here on the countdown; the app sleeps through it.
+                const uint32_t nowSec = AstroClock::coarseEpochSec();
+                if (!nowSec || !astro.scheduleStart(nowSec + startOffsetMin * 60UL)) {
+                    setStatusText(nowSec ? "Cannot schedule" : "Clock not set");
+                    setStatusBgColor(colors::get(colors::ERROR));
+                    drawStatusBar();
+                    break;
+                }
+                startOffsetMin = 0;
+                updateMenuItems();
+                draw();
+                break;
             } else if (!astro.isRunning()) {
                 astro.start();
             }
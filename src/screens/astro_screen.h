@@ -8,12 +8,16 @@ enum class AstroMenuItem {
     Connect,
     Focus,
     Start,
+    StartAt,
     Pause,
     Stop,
     ExposureTime,
     SubframeCount,
     DelayBetweenExposures,
+    IntervalMode,
+    SettleMargin,
     InitialDelay,
+    Plan,
 };
 
 // Config screen for astro sequences: connection, Start/Resume, Focus, and the
@@ -30,6 +34,7 @@ public:
 
 private:
     void drawContent();
+    void setCountdownStatus(uint32_t sec);
     void updateMenuItems();
     void adjustParameter(uint16_t delta);
     void selectMenuItem() { handleSelect(); }  // BaseScreen hook
@@ -37,4 +42,10 @@ private:
     // deleted — the caller must not touch any member afterwards).
     bool handleSelect();
     int selectedItem = 0;
+    bool wasRecovering = false;  // Restored sequence awaiting its camera
+    // "Start at" offset from now, in minutes; 0 starts straight away. The
+    // stick has no timezone, so a relative time is what it can offer.
+    uint16_t startOffsetMin = 0;
+    bool wasScheduled = false;
+    uint32_t shownCountdownSec = 0;
 };
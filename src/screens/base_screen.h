@@ -48,13 +48,20 @@ public:
     void checkConnection();
 
 protected:
+    // A connect started from this screen runs in the background; watch it
+    // and report the outcome in the status bar. `started` is the connect
+    // call's result. Screens that watch call serviceConnectWatch() from
+    // update(); it returns true on the pass that reported the outcome.
+    void watchConnect(bool started);
+    bool serviceConnectWatch();
+
     SelectableList<MenuItemType> menuItems;
     const char* screenName;
     std::string statusText;
     uint32_t statusBgColor;
     unsigned long lastConnectionCheck = 0;
     bool wasConnected = false;
-    int reconnectAttempts = 0;
+    uint32_t watchedConnect = 0;  // BLEDeviceManager::getConnectAttempt(); 0 if none
 };
 
 #include "base_screen.tpp"
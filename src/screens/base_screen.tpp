@@ -65,38 +65,66 @@ void BaseScreen<MenuItemType>::checkConnection() {
     }
     lastConnectionCheck = millis();
 
-    if (!BLEDeviceManager::isConnected()) {
-        if (BLEDeviceManager::isPaired() && !BLEDeviceManager::wasManuallyDisconnected()) {
-            setStatusText("Reconnecting...");
-            setStatusBgColor(colors::get(colors::GRAY_500));
-            drawStatusBar();
+    // Reconnects are BLEDeviceManager's (it retries a dropped link with
+    // backoff on any screen); this only reports.
+    const bool connected = BLEDeviceManager::isConnected();
+    if (connected) {
+        setStatusText("Connected");
+        setStatusBgColor(colors::get(colors::SUCCESS));
+    } else if (BLEDeviceManager::isReconnecting() || BLEDeviceManager::isConnecting()) {
+        char text[24];
+        snprintf(text, sizeof(text), "Reconnecting (%u)...",
+                 BLEDeviceManager::getReconnectAttempts());
+        setStatusText(BLEDeviceManager::isReconnecting() ? text : "Connecting...");
+        setStatusBgColor(colors::get(colors::GRAY_500));
+    } else {
+        setStatusText("Not connected");
+        setStatusBgColor(colors::get(colors::ERROR));
+    }
 
-            if (reconnectAttempts < 10) {
-                if (BLEDeviceManager::connectToSavedDevice()) {
-                    // Connection restored
-                    reconnectAttempts = 0;
-                    setStatusText("Connected");
-                    setStatusBgColor(colors::get(colors::SUCCESS));
-                    updateMenuItems();
-                    draw();
-                } else {
-                    reconnectAttempts++;
-                }
-            } else {
-                // Max attempts reached, show error and update menu
-                setStatusText("Connection lost");
-                setStatusBgColor(colors::get(colors::ERROR));
-                reconnectAttempts++;  // Increment to avoid showing this message again
-                updateMenuItems();
-                BLEDeviceManager::disconnect();
-                draw();
-            }
-        } else {
-            setStatusText("Not connected");
-            setStatusBgColor(colors::get(colors::ERROR));
-        }
+    if (connected != wasConnected) {
+        wasConnected = connected;
+        updateMenuItems();
+        draw();
     } else {
-        setStatusText("Connected");
+        drawStatusBar();
+    }
+}
+
+template <typename MenuItemType>
+void BaseScreen<MenuItemType>::watchConnect(bool started) {
+    if (started) {
+        watchedConnect = BLEDeviceManager::getConnectAttempt();
+        setStatusText("Connecting...");
+        setStatusBgColor(colors::get(colors::IN_PROGRESS));
+    } else {
+        watchedConnect = 0;
+        setStatusText("Failed to connect!");
+        setStatusBgColor(colors::get(colors::ERROR));
+    }
+    drawStatusBar();
+}
+
+template <typename MenuItemType>
+bool BaseScreen<MenuItemType>::serviceConnectWatch() {
+    if (watchedConnect == 0 || (BLEDeviceManager::isConnecting() &&
+                                BLEDeviceManager::getConnectAttempt() == watchedConnect)) {
+        return false;
+    }
+    watchedConnect = 0;
+    if (BLEDeviceManager::isConnected()) {
+        // Show how long the connect took; "*" marks a reconnect on saved handles.
+        char text[24];
+        snprintf(text, sizeof(text), "Connected %lums%s",
+                 static_cast<unsigned long>(BLEDeviceManager::getLastConnectMs()),
+                 BLEDeviceManager::lastConnectUsedCache() ? "*" : "");
+        setStatusText(text);
         setStatusBgColor(colors::get(colors::SUCCESS));
+    } else {
+        setStatusText("Failed to connect!");
+        setStatusBgColor(colors::get(colors::ERROR));
     }
+    updateMenuItems();
+    draw();
+    return true;
 }
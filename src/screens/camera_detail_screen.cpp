@@ -33,6 +33,12 @@ void CameraDetailScreen::updateMenuItems() {
     } else {
         menuItems.addItem(CameraDetailMenuItem::Connect, "Connect");
     }
+    // The active camera leads the rig rather than joining it.
+    if (BLEDeviceManager::isRigCamera(cameraAddress)) {
+        menuItems.addItem(CameraDetailMenuItem::LeaveRig, "Leave rig");
+    } else if (!isActive) {
+        menuItems.addItem(CameraDetailMenuItem::JoinRig, "Add to rig");
+    }
     menuItems.addItem(CameraDetailMenuItem::Forget, "Forget");
 }
 
@@ -42,6 +48,8 @@ void CameraDetailScreen::drawContent() {
 }
 
 void CameraDetailScreen::update() {
+    serviceConnectWatch();
+
     if (RemoteControlManager::wasButtonPressed(ButtonId::BTN_B) ||
         RemoteControlManager::wasButtonPressed(ButtonId::DOWN)) {
         nextMenuItem();
@@ -60,18 +68,7 @@ void CameraDetailScreen::update() {
 void CameraDetailScreen::selectMenuItem() {
     switch (menuItems.getSelectedId()) {
         case CameraDetailMenuItem::Connect:
-            setStatusText("Connecting...");
-            setStatusBgColor(colors::get(colors::NORMAL));
-            draw();
-            if (BLEDeviceManager::connectToAddress(cameraAddress)) {
-                setStatusText("Connected!");
-                setStatusBgColor(colors::get(colors::SUCCESS));
-            } else {
-                setStatusText("Failed to connect!");
-                setStatusBgColor(colors::get(colors::ERROR));
-            }
-            updateMenuItems();
-            draw();
+            watchConnect(BLEDeviceManager::connectToAddress(cameraAddress));
             break;
 
         case CameraDetailMenuItem::Disconnect:
@@ -82,6 +79,18 @@ void CameraDetailScreen::selectMenuItem() {
             draw();
             break;
 
+        case CameraDetailMenuItem::JoinRig:
+        case CameraDetailMenuItem::LeaveRig: {
+            const bool join = menuItems.getSelectedId() == CameraDetailMenuItem::JoinRig;
+            const bool done = join ? BLEDeviceManager::addRigCamera(cameraAddress)
+                                   : BLEDeviceManager::removeRigCamera(cameraAddress);
+            setStatusText(!done ? "Rig full" : join ? "Added to rig" : "Left rig");
+            setStatusBgColor(colors::get(done ? colors::NORMAL : colors::WARNING));
+            updateMenuItems();
+            draw();
+            break;
+        }
+
         case CameraDetailMenuItem::Forget:
             // Deletes this camera; return to the list. Do not touch any member
             // after navigating away — setScreen deletes this screen.
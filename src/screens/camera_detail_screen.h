@@ -4,10 +4,10 @@
 
 #include "screens/base_screen.h"
 
-enum class CameraDetailMenuItem { Connect, Disconnect, Forget };
+enum class CameraDetailMenuItem { Connect, Disconnect, JoinRig, LeaveRig, Forget };
 
 // Per-camera submenu for a single Saved camera (glossary): connect/disconnect
-// it and forget it. Reached from CameraListScreen. Holds the camera's address
+// it, add it to or take it out of the rig (ADR 0008), and forget it. Reached from CameraListScreen. Holds the camera's address
 // so its actions target that specific camera, not just the active one.
 class CameraDetailScreen : public BaseScreen<CameraDetailMenuItem> {
 public:
@@ -22,12 +22,19 @@ void CameraListScreen::updateMenuItems() {
     for (const auto& cam : BLEDeviceManager::getSavedCameras()) {
         std::string label = cam.name.empty() ? cam.address : cam.name;
 
-        // Marker: '*' = connected, 'o' = active but not connected, blank
-        // otherwise. ASCII because the M5 font lacks the circle glyphs
-        // (U+25CF/U+25CB rendered as tofu on-device).
+        // Marker: '*' = connected, 'o' = active but not connected, '&' = rig
+        // camera linked, 'r' = rig camera not linked yet, '+' = another
+        // camera heard advertising, blank otherwise. ASCII because the M5
+        // font lacks the circle glyphs (U+25CF/U+25CB rendered as tofu
+        // on-device).
         std::string marker = " ";
+        const int rigIndex = BLEDeviceManager::getRig().indexOf(cam.address);
         if (cam.address == activeAddr) {
             marker = connected ? "*" : "o";
+        } else if (rigIndex >= 0) {
+            marker = BLEDeviceManager::getRig().camera(rigIndex).linked ? "&" : "r";
+        } else if (BLEDeviceManager::isCameraAdvertising(cam.address)) {
+            marker = "+";
         }
         menuItems.addItem(cam.address, label, marker, true);
     }
@@ -25,15 +25,12 @@ MainScreen::MainScreen() : BaseScreen<MainMenuItem>("Main") {
     // Try to auto-connect on startup if enabled
     if (BLEDeviceManager::isAutoConnectEnabled() && BLEDeviceManager::isPaired() &&
         !BLEDeviceManager::wasManuallyDisconnected()) {
-        setStatusText("Auto-connecting...");
-        setStatusBgColor(colors::get(colors::WARNING));
-        drawStatusBar();
-
+        // Runs in the background; update() reports when it lands.
         if (BLEDeviceManager::connectToSavedDevice()) {
-            setStatusText("Connected");
-            setStatusBgColor(colors::get(colors::SUCCESS));
-            updateMenuItems();
-            draw();
+            watchConnect(true);
+            setStatusText("Auto-connecting...");
+            setStatusBgColor(colors::get(colors::WARNING));
+            drawStatusBar();
         }
     }
 }
@@ -76,29 +73,16 @@ void MainScreen::update() {
         prevMenuItem();
     }
 
-    checkConnection();
+    if (!serviceConnectWatch()) {
+        checkConnection();
+    }
 }
 
 void MainScreen::selectMenuItem() {
     switch (menuItems.getSelectedId()) {
         case MainMenuItem::Connect:
 
-            setStatusText("Connecting...");
-            setStatusBgColor(colors::get(colors::IN_PROGRESS));
-            drawStatusBar();
-
-            if (BLEDeviceManager::connectToSavedDevice()) {
-                setStatusText("Connected!");
-                setStatusBgColor(colors::get(colors::SUCCESS));
-                drawStatusBar();
-
-            } else {
-                setStatusText("Failed to connect!");
-                setStatusBgColor(colors::get(colors::ERROR));
-                drawStatusBar();
-            }
-            updateMenuItems();
-            draw();
+            watchConnect(BLEDeviceManager::connectToSavedDevice());
             break;
         case MainMenuItem::Disconnect:
             BLEDeviceManager::disconnect();
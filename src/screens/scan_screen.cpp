@@ -23,16 +23,45 @@ ScanScreen::ScanScreen()
     menuItems.setTitle("Scan");
 }
 
+bool ScanScreen::pollDevices() {
+    ScanTable::Entry changed[ScanTable::CAPACITY];
+    bool reset;
+    const size_t count = ScanProcess::pollDevices(scanVersion, changed, ScanTable::CAPACITY, reset);
+    if (reset) {
+        deviceCount = 0;
+    }
+    for (size_t i = 0; i < count; i++) {
+        size_t j = 0;
+        while (j < deviceCount && devices[j].address != changed[i].address) {
+            j++;
+        }
+        if (j == deviceCount) {
+            if (deviceCount == ScanTable::CAPACITY) {
+                continue;
+            }
+            deviceCount++;
+        }
+        devices[j] = changed[i];
+    }
+    return reset || count > 0;
+}
+
+void ScanScreen::forgetDevices() {
+    ScanProcess::clearDevices();
+    deviceCount = 0;
+}
+
 void ScanScreen::updateMenuItems() {
+    // Devices only ever append, so the selection stays on the same one.
+    const int selected = menuItems.getSelectedIndex();
     menuItems.clear();
 
     const auto& state = ScanProcess::getState();
-    const auto& devices = state.discoveredDevices;
 
     if (state.isScanning) {
         setStatusText(ScanProcess::getStatusText(ScanProcess::Status::Scanning));
         setStatusBgColor(ScanProcess::getStatusColor(ScanProcess::Status::Scanning));
-    } else if (devices.empty()) {
+    } else if (deviceCount == 0) {
         setStatusText(ScanProcess::getStatusText(ScanProcess::Status::NoDevices));
         setStatusBgColor(ScanProcess::getStatusColor(ScanProcess::Status::NoDevices));
     } else {
@@ -40,12 +69,15 @@ void ScanScreen::updateMenuItems() {
         setStatusBgColor(ScanProcess::getStatusColor(ScanProcess::Status::DevicesFound));
     }
 
-    for (const auto& device : devices) {
-        std::string label = device.getName();
-        if (label.empty()) {
-            label = device.getAddress();
-        }
-        menuItems.addItem(device.getAddress(), label, true);
+    for (size_t i = 0; i < deviceCount; i++) {
+        const ScanTable::Entry& device = devices[i];
+        const std::string address = device.address.toString();
+        char rssi[8];
+        snprintf(rssi, sizeof(rssi), "%d", device.rssi);
+        menuItems.addItem(address, device.name[0] ? device.name : address, rssi, true);
+    }
+    if (selected > 0 && static_cast<size_t>(selected) < deviceCount) {
+        menuItems.setSelectedIndex(selected);
     }
 }
 
@@ -62,16 +94,16 @@ void ScanScreen::drawContent() {
         int centerX = M5.Display.width() / 2;
         int centerY = M5.Display.height() / 2;
         M5.Display.drawString("Wait...", centerX, centerY);
-    } else if (state.discoveredDevices.empty()) {
+    } else if (deviceCount == 0) {
         M5.Display.setTextDatum(middle_center);
         int centerX = M5.Display.width() / 2;
         int centerY = M5.Display.height() / 2;
 
         M5.Display.drawString("Not found", centerX, centerY);
 
-        // Restart scan after a brief delay if not already scanning
+        // Keep waiting for a camera to be switched on
         if (!state.isScanning) {
-            if (!ScanProcess::startScan(5)) {
+            if (!ScanProcess::waitForCamera()) {
                 setStatusText(ScanProcess::getStatusText(ScanProcess::Status::Failed));
                 setStatusBgColor(ScanProcess::getStatusColor(ScanProcess::Status::Failed));
             }
@@ -86,35 +118,62 @@ void ScanScreen::drawContent() {
 }
 
 void ScanScreen::update() {
+    // Pairing runs in the background (BLEDeviceManager::update()); wait for
+    // its outcome without blocking the loop.
+    if (isConnecting) {
+        if (BLEDeviceManager::isConnecting()) {
+            return;
+        }
+        isConnecting = false;
+        if (BLEDeviceManager::isConnected()) {
+            MenuSystem::goHome();  // Main shows the connected camera
+            return;
+        }
+        setStatusText(ScanProcess::getStatusText(ScanProcess::Status::Failed));
+        setStatusBgColor(ScanProcess::getStatusColor(ScanProcess::Status::Failed));
+        forgetDevices();
+        updateMenuItems();
+        draw();
+        failedAtMs = millis();
+        return;
+    }
+    if (failedAtMs != 0) {
+        if (millis() - failedAtMs < 1000) {
+            return;  // Show the error briefly
+        }
+        failedAtMs = 0;
+        if (!ScanProcess::startScan(5)) {
+            setStatusText(ScanProcess::getStatusText(ScanProcess::Status::Failed));
+        }
+        draw();
+    }
+
     auto state = ScanProcess::getState();
 
-    // Check if scanning state changed
-    if (lastScanning != state.isScanning) {
+    // New devices and RSSI changes as they are heard, and the scan ending.
+    const bool devicesChanged = pollDevices();
+    if (devicesChanged || lastScanning != state.isScanning) {
         lastScanning = state.isScanning;
-        if (!lastScanning) {    // Scan just finished
-            updateMenuItems();  // Update the menu with any found devices
-        }
+        updateMenuItems();
         draw();
         return;
     }
 
-    if (!state.isScanning && !isConnecting) {
-        if ((RemoteControlManager::wasButtonPressed(ButtonId::BTN_A) ||
-             RemoteControlManager::wasButtonPressed(ButtonId::CONFIRM)) &&
-            !state.discoveredDevices.empty()) {
+    // A camera can be picked as soon as it shows up; picking ends the scan.
+    if (deviceCount > 0) {
+        if (RemoteControlManager::wasButtonPressed(ButtonId::BTN_A) ||
+            RemoteControlManager::wasButtonPressed(ButtonId::CONFIRM)) {
             LOG_PERIPHERAL("[ScanScreen] [Btn] Confirm Button Clicked");
             selectMenuItem();
         }
 
-        if ((RemoteControlManager::wasButtonPressed(ButtonId::BTN_B) ||
-             RemoteControlManager::wasButtonPressed(ButtonId::DOWN)) &&
-            !state.discoveredDevices.empty()) {
+        if (RemoteControlManager::wasButtonPressed(ButtonId::BTN_B) ||
+            RemoteControlManager::wasButtonPressed(ButtonId::DOWN)) {
             LOG_PERIPHERAL("[ScanScreen] [Btn] Next Button Clicked");
             nextMenuItem();
         }
 
-        if (RemoteControlManager::wasButtonPressed(ButtonId::UP) &&
-            !state.discoveredDevices.empty()) {
+        if (RemoteControlManager::wasButtonPressed(ButtonId::UP)) {
             LOG_PERIPHERAL("[ScanScreen] [Btn] Prev Button Clicked");
             prevMenuItem();
         }
@@ -126,30 +185,21 @@ void ScanScreen::selectMenuItem() {
     isConnecting = true;
     draw();
 
-    const auto& devices = ScanProcess::getState().discoveredDevices;
-    auto it = std::find_if(devices.begin(), devices.end(), [&selectedId](const DeviceInfo& dev) {
-        return dev.getAddress() == selectedId;
-    });
+    const ScanTable::Entry* device = nullptr;
+    for (size_t i = 0; i < deviceCount && !device; i++) {
+        if (devices[i].address.toString() == selectedId) {
+            device = &devices[i];
+        }
+    }
 
-    if (it != devices.end() && ScanProcess::connectToDevice(it->device)) {
-        setStatusText(ScanProcess::getStatusText(ScanProcess::Status::Connected));
-        setStatusBgColor(ScanProcess::getStatusColor(ScanProcess::Status::Connected));
-        draw();
-        delay(500);  // Show success message briefly
-        isConnecting = false;
-        MenuSystem::goHome();  // Return to previous screen
-    } else {
+    // Only starts the pairing; update() follows it to the outcome.
+    if (!device || !ScanProcess::connectToDevice(*device)) {
         isConnecting = false;
         setStatusText(ScanProcess::getStatusText(ScanProcess::Status::Failed));
         setStatusBgColor(ScanProcess::getStatusColor(ScanProcess::Status::Failed));
-        ScanProcess::clearDevices();
-        draw();
-        delay(1000);  // Show error message
-
-        if (!ScanProcess::startScan(5)) {
-            setStatusText(ScanProcess::getStatusText(ScanProcess::Status::Failed));
-        }
+        forgetDevices();
         draw();
+        failedAtMs = millis();
     }
 }
 
@@ -18,7 +18,16 @@ public:
     void prevMenuItem() override;
 
 private:
+    // Merge what the scan table heard since the last poll; true if anything
+    // changed. Devices show up while the scan is still running.
+    bool pollDevices();
+    void forgetDevices();
+
     bool lastScanning;
     bool isConnecting;
+    uint32_t failedAtMs = 0;  // Pairing failed: rescan once the message has shown
     SelectableList<std::string> menuItems;
+    ScanTable::Entry devices[ScanTable::CAPACITY];  // Discovery order
+    size_t deviceCount = 0;
+    uint32_t scanVersion = 0;
 };
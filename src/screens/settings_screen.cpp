@@ -42,6 +42,8 @@ void SettingsScreen::drawContent() {
 }
 
 void SettingsScreen::update() {
+    serviceConnectWatch();
+
     if (RemoteControlManager::wasButtonPressed(ButtonId::BTN_B) ||
         RemoteControlManager::wasButtonPressed(ButtonId::DOWN)) {
         LOG_PERIPHERAL("[SettingsScreen] [Btn] Next Button Clicked");
@@ -63,15 +65,7 @@ void SettingsScreen::update() {
 void SettingsScreen::selectMenuItem() {
     switch (menuItems.getSelectedId()) {
         case SettingsMenuItem::Connect:
-            if (SettingsProcess::connectToDevice()) {
-                setStatusText("Connected!");
-                setStatusBgColor(colors::get(colors::SUCCESS));
-            } else {
-                setStatusText("Failed to connect!");
-                setStatusBgColor(colors::get(colors::ERROR));
-            }
-            updateMenuItems();
-            draw();
+            watchConnect(SettingsProcess::connectToDevice());
             break;
 
         case SettingsMenuItem::Cameras:
@@ -0,0 +1,222 @@
+#include "transport/astro_status_stream.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "transport/ble_remote_server.h"
+
+static_assert(sizeof(AstroStatusPacket) == AstroStatusStream::V1_BYTES,
+              "AstroStatusPacket changed: update the v2 field table and astro-status.js");
+
+namespace {
+// Bytes of each AstroStatusPacket field, in declaration order.
+constexpr uint8_t FIELD_BYTES[AstroStatusStream::FIELD_COUNT] = {
+    1, 2, 2, 4, 4, 4, 4, 4, 4, 1, 1, 2, 1, 1, 2, 2, 4, 4, 2, 2, 2, 2};
+
+// Fields a delta may leave out when they moved by exactly dt seconds.
+constexpr size_t ELAPSED = 5;          // +dt
+constexpr size_t REMAINING = 6;        // -dt
+constexpr size_t PHASE_REMAINING = 7;  // -dt
+constexpr size_t ELAPSED_OFFSET = 13;
+
+constexpr size_t MAX_MASK_BYTES = 4;  // LEB128 of FULL_MASK
+
+uint32_t readU32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+void writeU32(uint8_t* p, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        p[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+// Where a derived field lands if it is left out of a record.
+uint32_t predicted(size_t field, uint32_t previous, uint8_t dt) {
+    return field == ELAPSED ? previous + dt : previous - dt;
+}
+
+bool isDerived(size_t field) {
+    return field == ELAPSED || field == REMAINING || field == PHASE_REMAINING;
+}
+
+// Record of the v1 byte image `image` against `base` (nullptr: full).
+size_t encodeImage(const uint8_t* image, const uint8_t* base, uint8_t seq, uint8_t* out) {
+    uint32_t mask = AstroStatusStream::FULL_MASK;
+    uint8_t dt = 0;
+    if (base) {
+        const uint32_t step = readU32(image + ELAPSED_OFFSET) - readU32(base + ELAPSED_OFFSET);
+        dt = step <= UINT8_MAX ? static_cast<uint8_t>(step) : 0;
+        mask = 0;
+        size_t offset = 0;
+        for (size_t i = 0; i < AstroStatusStream::FIELD_COUNT; i++) {
+            const bool changed =
+                isDerived(i)
+                    ? readU32(image + offset) != predicted(i, readU32(base + offset), dt)
+                    : memcmp(image + offset, base + offset, FIELD_BYTES[i]) != 0;
+            mask |= changed ? 1UL << i : 0;
+            offset += FIELD_BYTES[i];
+        }
+    }
+
+    size_t n = 0;
+    out[n++] = seq;
+    out[n++] = dt;
+    uint32_t bits = mask;
+    do {
+        const uint8_t low = bits & 0x7F;
+        bits >>= 7;
+        out[n++] = bits ? (low | 0x80) : low;
+    } while (bits);
+
+    size_t offset = 0;
+    for (size_t i = 0; i < AstroStatusStream::FIELD_COUNT; i++) {
+        if (mask & (1UL << i)) {
+            memcpy(out + n, image + offset, FIELD_BYTES[i]);
+            n += FIELD_BYTES[i];
+        }
+        offset += FIELD_BYTES[i];
+    }
+    return n;
+}
+}  // namespace
+
+void AstroStatusStream::configure(bool batch, size_t payloadLimit) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    batch_ = batch;
+    payloadLimit_ = std::min(std::max(payloadLimit, MIN_PAYLOAD), MAX_FRAME_BYTES);
+}
+
+void AstroStatusStream::restart() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    hasBase_ = false;
+    pendingLength_ = 0;
+}
+
+size_t AstroStatusStream::push(const AstroStatusPacket& status, uint32_t nowMs, uint8_t* out) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    memcpy(latest_, &status, V1_BYTES);
+    hasLatest_ = true;
+
+    // A state change resets the client's picture with a full snapshot.
+    const bool full = !hasBase_ || latest_[0] != base_[0];
+    uint8_t record[MAX_RECORD_BYTES];
+    const size_t length = encodeImage(latest_, full ? nullptr : base_, seq_++, record);
+    memcpy(base_, latest_, V1_BYTES);
+    hasBase_ = true;
+    stats_.records++;
+    stats_.snapshots += full ? 1 : 0;
+
+    if (!batch_ || full) {
+        // A snapshot supersedes any deltas still held.
+        pendingLength_ = 0;
+        out[0] = FRAME_V2;
+        memcpy(out + 1, record, length);
+        stats_.notifications++;
+        stats_.bytes += 1 + length;
+        return 1 + length;
+    }
+
+    size_t sent = 0;
+    if (pendingLength_ && pendingLength_ + length > payloadLimit_) {
+        sent = takePending(out);
+    }
+    if (!pendingLength_) {
+        pending_[0] = FRAME_V2;
+        pendingLength_ = 1;
+        pendingSinceMs_ = nowMs;
+    }
+    memcpy(pending_ + pendingLength_, record, length);
+    pendingLength_ += length;
+    if (!sent && nowMs - pendingSinceMs_ >= BATCH_WINDOW_MS) {
+        sent = takePending(out);
+    }
+    return sent;
+}
+
+size_t AstroStatusStream::flush(uint32_t nowMs, uint8_t* out) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!pendingLength_ || nowMs - pendingSinceMs_ < BATCH_WINDOW_MS) {
+        return 0;
+    }
+    return takePending(out);
+}
+
+size_t AstroStatusStream::snapshot(uint8_t* out) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!hasLatest_) {
+        return 0;
+    }
+    // Numbered as the latest record, so deltas after it follow on.
+    out[0] = FRAME_V2;
+    return 1 + encodeImage(latest_, nullptr, static_cast<uint8_t>(seq_ - 1), out + 1);
+}
+
+AstroStatusStream::Stats AstroStatusStream::stats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+size_t AstroStatusStream::takePending(uint8_t* out) {
+    const size_t length = pendingLength_;
+    memcpy(out, pending_, length);
+    pendingLength_ = 0;
+    stats_.notifications++;
+    stats_.bytes += length;
+    return length;
+}
+
+size_t AstroStatusStream::encodeRecord(const AstroStatusPacket& status,
+                                       const AstroStatusPacket* base, uint8_t seq,
+                                       uint8_t* out) {
+    uint8_t image[V1_BYTES];
+    uint8_t previous[V1_BYTES];
+    memcpy(image, &status, V1_BYTES);
+    if (base) {
+        memcpy(previous, base, V1_BYTES);
+    }
+    return encodeImage(image, base ? previous : nullptr, seq, out);
+}
+
+size_t AstroStatusStream::decodeRecord(const uint8_t* in, size_t length,
+                                       AstroStatusPacket& status, bool hasBase) {
+    if (length < 3) {
+        return 0;
+    }
+    const uint8_t dt = in[1];
+    size_t n = 2;
+    uint32_t mask = 0;
+    for (size_t shift = 0;; shift += 7) {
+        if (n >= length || shift >= 7 * MAX_MASK_BYTES) {
+            return 0;
+        }
+        const uint8_t byte = in[n++];
+        mask |= static_cast<uint32_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            break;
+        }
+    }
+    const bool full = mask == FULL_MASK;
+    if ((mask & ~FULL_MASK) || (!full && !hasBase)) {
+        return 0;
+    }
+
+    uint8_t image[V1_BYTES];
+    memcpy(image, &status, V1_BYTES);
+    size_t offset = 0;
+    for (size_t i = 0; i < FIELD_COUNT; i++) {
+        if (mask & (1UL << i)) {
+            if (n + FIELD_BYTES[i] > length) {
+                return 0;
+            }
+            memcpy(image + offset, in + n, FIELD_BYTES[i]);
+            n += FIELD_BYTES[i];
+        } else if (isDerived(i)) {
+            writeU32(image + offset, predicted(i, readU32(image + offset), dt));
+        }
+        offset += FIELD_BYTES[i];
+    }
+    memcpy(&status, image, V1_BYTES);
+    return n;
+}
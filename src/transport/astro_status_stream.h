@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+struct AstroStatusPacket;
+
+// Version 2 of the astro-status notification: change-masked records instead
+// of the full 55-byte AstroStatusPacket every second. Independent of the BLE
+// stack so it runs natively. Everything is little-endian:
+//
+//   frame   u8 0xA2 | record...            (a v1 packet starts with its state, 0..6)
+//   record  u8 seq | u8 dt | mask | present fields
+//
+// `mask` is a LEB128 varint with bit i set when field i of AstroStatusPacket
+// (declaration order, v1 widths) follows. A record with every bit set is a
+// full snapshot; anything else is a delta on the previous record. elapsedSec,
+// remainingSec and phaseRemainingSec are left out when they moved by exactly
+// `dt` seconds (+dt, -dt, -dt) since then, so a tick mid-exposure carries no
+// fields at all. `seq` counts records; a client that sees a gap drops its
+// state and reads the characteristic, whose value is always a full snapshot.
+//
+// A full snapshot goes out first after restart() (connect, format change) and
+// on every state change. With batching on, deltas are held and packed into
+// one notification up to the link payload, flushed after BATCH_WINDOW_MS,
+// when the next record would not fit, or with a snapshot.
+//
+// Thread-safe: statuses arrive from the sequencer task, flushes from the app
+// loop and restarts from the BLE task.
+class AstroStatusStream {
+public:
+    static constexpr uint8_t FRAME_V2 = 0xA2;
+    static constexpr size_t FIELD_COUNT = 22;
+    static constexpr uint32_t FULL_MASK = (1UL << FIELD_COUNT) - 1;
+    static constexpr size_t V1_BYTES = 55;  // sizeof(AstroStatusPacket)
+    static constexpr size_t MAX_RECORD_BYTES = 2 + 4 + V1_BYTES;
+    static constexpr size_t MAX_FRAME_BYTES = 244;  // Batch cap; one LE data PDU at 251
+    static constexpr size_t MIN_PAYLOAD = 20;       // Default ATT MTU 23 - 3
+    static constexpr uint32_t BATCH_WINDOW_MS = 5000;
+
+    struct Stats {
+        uint32_t records = 0;
+        uint32_t snapshots = 0;      // Full records among them
+        uint32_t notifications = 0;  // Frames handed out
+        uint32_t bytes = 0;          // Frame bytes handed out
+    };
+
+    // Batching, and the most one notification may carry (ATT MTU - 3).
+    void configure(bool batch, size_t payloadLimit);
+    // Fresh stream: pending records dropped, the next record a full snapshot.
+    void restart();
+
+    // Adds `status` and writes into `out` (MAX_FRAME_BYTES) the frame to
+    // notify now, if any. Returns its length; 0 while a batch is held.
+    size_t push(const AstroStatusPacket& status, uint32_t nowMs, uint8_t* out);
+    // App loop: a held batch once its window has passed. Returns its length.
+    size_t flush(uint32_t nowMs, uint8_t* out);
+    // Full-snapshot frame of the latest status (the READ value); 0 if none yet.
+    size_t snapshot(uint8_t* out);
+
+    Stats stats();
+
+    // One record of `status` against `base` (nullptr: a full snapshot).
+    static size_t encodeRecord(const AstroStatusPacket& status, const AstroStatusPacket* base,
+                               uint8_t seq, uint8_t* out);
+    // Applies the record at `in` onto `status`. Returns the bytes it took, 0
+    // if malformed or a delta with no base (`hasBase` false).
+    static size_t decodeRecord(const uint8_t* in, size_t length, AstroStatusPacket& status,
+                               bool hasBase);
+
+private:
+    size_t takePending(uint8_t* out);  // Caller holds mutex_
+
+    std::mutex mutex_;
+    bool batch_ = false;
+    size_t payloadLimit_ = MIN_PAYLOAD;
+    bool hasBase_ = false;  // base_ is what the client holds
+    uint8_t base_[V1_BYTES] = {};
+    bool hasLatest_ = false;
+    uint8_t latest_[V1_BYTES] = {};
+    uint8_t seq_ = 0;
+    uint8_t pending_[MAX_FRAME_BYTES] = {};
+    size_t pendingLength_ = 0;  // 0, or the marker plus held records
+    uint32_t pendingSinceMs_ = 0;
+    Stats stats_;
+};
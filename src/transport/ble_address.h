@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+// A 48-bit Bluetooth device address, packed, in the order BLEAddress keeps
+// it (getNative()) and prints it: bytes[0] is the "aa" of "aa:bb:cc:dd:ee:ff".
+// Cheap to copy and compare, so the scan path can key tables by it without
+// building strings per advertisement.
+struct BleAddress {
+    static constexpr size_t BYTES = 6;
+    static constexpr size_t TEXT_BYTES = 18;  // "aa:bb:cc:dd:ee:ff" + NUL
+
+    uint8_t bytes[BYTES] = {};
+
+    static BleAddress fromNative(const uint8_t* native) {
+        BleAddress address;
+        memcpy(address.bytes, native, BYTES);
+        return address;
+    }
+
+    // Parses "aa:bb:cc:dd:ee:ff" (either case). False if malformed.
+    static bool parse(const std::string& text, BleAddress& out) {
+        unsigned int b[BYTES];
+        char tail;
+        if (text.size() != TEXT_BYTES - 1 ||
+            sscanf(text.c_str(), "%2x:%2x:%2x:%2x:%2x:%2x%c", &b[0], &b[1], &b[2], &b[3], &b[4],
+                   &b[5], &tail) != static_cast<int>(BYTES)) {
+            return false;
+        }
+        for (size_t i = 0; i < BYTES; i++) {
+            out.bytes[i] = static_cast<uint8_t>(b[i]);
+        }
+        return true;
+    }
+
+    // Lower case, as BLEAddress::toString() and the saved-camera list have it.
+    void format(char (&out)[TEXT_BYTES]) const {
+        snprintf(out, TEXT_BYTES, "%02x:%02x:%02x:%02x:%02x:%02x", bytes[0], bytes[1], bytes[2],
+                 bytes[3], bytes[4], bytes[5]);
+    }
+    std::string toString() const {
+        char text[TEXT_BYTES];
+        format(text);
+        return text;
+    }
+
+    bool operator==(const BleAddress& o) const { return memcmp(bytes, o.bytes, BYTES) == 0; }
+    bool operator!=(const BleAddress& o) const { return !(*this == o); }
+};
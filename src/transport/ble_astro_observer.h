@@ -19,8 +19,15 @@ public:
         packet.exposureSec = params.exposureSec;
         packet.subframeCount = params.subframeCount;
         packet.intervalSec = params.intervalSec;
+        packet.adaptiveInterval = params.adaptiveInterval ? 1 : 0;
+        packet.settleMs = params.settleMs;
 
         BLERemoteServer::sendAstroParams(packet);
+
+        // The plan start() will run: the block above, or a remote-loaded plan.
+        uint8_t blob[AstroPlan::MAX_BLOB_BYTES];
+        const size_t length = AstroProcess::instance().getPlan().encode(blob, sizeof(blob));
+        BLERemoteServer::sendAstroPlan(blob, length);
     }
 
     void onAstroStatusChanged(const AstroProcess::Status& status) override {
@@ -40,6 +47,17 @@ public:
         packet.phaseTotalSec = status.phaseTotalSec;
         packet.isCameraConnected = status.isCameraConnected;
         packet.errorCode = status.errorCode;
+        packet.framesPerHour = status.framesPerHour;
+        packet.segmentIndex = status.segmentIndex;
+        packet.segmentCount = status.segmentCount;
+        packet.segmentCompletedFrames = status.segmentCompletedFrames;
+        packet.segmentTotalFrames = status.segmentTotalFrames;
+        packet.scheduledStartTime = status.scheduledStartTime;
+        packet.wakeToFirstFrameMs = status.wakeToFirstFrameMs;
+        packet.openSkewMs = status.openSkewMs;
+        packet.maxOpenSkewMs = status.maxOpenSkewMs;
+        packet.closeSkewMs = status.closeSkewMs;
+        packet.maxCloseSkewMs = status.maxCloseSkewMs;
 
         BLERemoteServer::sendAstroStatus(packet);
     }
@@ -1,5 +1,7 @@
 #include "transport/ble_device.h"
 
+#include <algorithm>
+
 #include "transport/camera_commands.h"
 
 // Client callbacks implementation
@@ -15,61 +17,298 @@ class ClientCallback : public BLEClientCallbacks {
     }
 };
 
+namespace {
+ClientCallback clientCallback;  // Shared by every client we create
+}  // namespace
+
+void MySecurity::onAuthenticationComplete(esp_ble_auth_cmpl_t auth_cmpl) {
+    LOG_PERIPHERAL("[BLE] Authentication %s", auth_cmpl.success ? "Success" : "Failure");
+    BLEDeviceManager::onAuthenticationComplete(auth_cmpl.bd_addr, auth_cmpl.success);
+}
+
 // Initialize static members
-BLEClient* BLEDeviceManager::pClient = nullptr;
+CameraLink BLEDeviceManager::links[MAX_LINKS];
+RetiredClient BLEDeviceManager::retired[MAX_RETIRED];
 BLEAdvertisedDevice* BLEDeviceManager::pDevice = nullptr;
-BLERemoteCharacteristic* BLEDeviceManager::pRemoteControlChar = nullptr;
-BLERemoteCharacteristic* BLEDeviceManager::pRemoteStatusChar = nullptr;
-BLERemoteService* BLEDeviceManager::pRemoteService = nullptr;
 bool BLEDeviceManager::initialized = false;
-bool BLEDeviceManager::connected = false;
 bool BLEDeviceManager::scanning = false;
 bool BLEDeviceManager::manuallyDisconnected = false;
 bool BLEDeviceManager::autoConnectEnabled = false;
-unsigned long BLEDeviceManager::scanEndTime = 0;
+int8_t BLEDeviceManager::linkRssi = 0;
+unsigned long BLEDeviceManager::lastRssiPollTime = 0;
 BLEScan* BLEDeviceManager::pBLEScan = nullptr;
 std::string BLEDeviceManager::lastDeviceAddress = "";
-std::vector<DeviceInfo> BLEDeviceManager::discoveredDevices;
+ScanTable BLEDeviceManager::scanTable;
+ScanPlan BLEDeviceManager::scanPlan;
+bool BLEDeviceManager::scanBurst = false;
+std::atomic<bool> BLEDeviceManager::scanHit{false};
+std::string BLEDeviceManager::findingAddress;
 Preferences BLEDeviceManager::preferences;
 std::string BLEDeviceManager::cachedAddress = "";
+BleAddress BLEDeviceManager::activeKey;
+std::mutex BLEDeviceManager::activeKeyMutex;
 CameraStore BLEDeviceManager::cameraStore;
+uint32_t BLEDeviceManager::connectAttempt = 0;
+std::mutex BLEDeviceManager::eventMutex;
+QueueHandle_t BLEDeviceManager::linkJobs = nullptr;
+TaskHandle_t BLEDeviceManager::linkTask = nullptr;
+volatile bool BLEDeviceManager::linkJobRunning = false;
+CameraRig BLEDeviceManager::rig;
+LinkWriteTarget BLEDeviceManager::writeTargets[MAX_LINKS];
+std::mutex BLEDeviceManager::writeTargetMutex;
+bool BLEDeviceManager::rigSoloRelease = false;
+uint32_t BLEDeviceManager::lastConnectMs = 0;
+bool BLEDeviceManager::lastConnectCached = false;
+LinkProfilePolicy BLEDeviceManager::linkPolicy;
+std::atomic<LinkProfile> BLEDeviceManager::linkProfile{LinkProfile::BALANCED};
+uint32_t BLEDeviceManager::nextToggleInMs = LinkProfilePolicy::NO_TOGGLE;
+std::atomic<uint32_t> BLEDeviceManager::lastCommandMs{0};
+ReconnectSupervisor BLEDeviceManager::reconnect;
+bool BLEDeviceManager::reconnectUrgent = false;
+std::atomic<bool> BLEDeviceManager::linkDropped{false};
+PresenceTracker BLEDeviceManager::presence;
+bool BLEDeviceManager::presenceScanning = false;
+bool BLEDeviceManager::presenceUrgent = false;
+uint32_t BLEDeviceManager::presenceStartMs = 0;
 
 void BLEDeviceManager::onConnect(BLEClient* client) {
-    connected = true;
+    // Only the link is open; the connect sequence still has MTU, encryption
+    // and discovery ahead before it counts as connected.
     LOG_PERIPHERAL("[BLE] Device connected");
+}
 
-    // Save the device address if it's not already saved
-    if (pDevice && !cachedAddress.empty()) {
-        saveDeviceAddress(pDevice->getAddress().toString());
+void BLEDeviceManager::onDisconnect(BLEClient* client) {
+    const int index = linkFor(client);
+    if (index < 0) {
+        // A client we already let go of: update() may delete it now.
+        for (auto& slot : retired) {
+            if (client != nullptr && slot.client.load() == client) {
+                slot.closed.store(true);
+            }
+        }
+        return;
     }
+    CameraLink& link = links[index];
+    LOG_PERIPHERAL("[BLE] Device %s disconnected", link.address.c_str());
+    withdrawWriteTarget(index);
+    if (index == ACTIVE_LINK) {
+        if (link.connected) {
+            noteDrop();  // Not one we closed ourselves
+        }
+        CameraCommands::onLinkLost();
+    } else {
+        const int camera = rig.indexOf(link.address);
+        if (camera >= 0) {
+            rig.setLinked(camera, false);
+        }
+    }
+    link.connected = false;
+    link.binding = false;
+    postLinkEvent(index, ConnectSequence::Event::DISCONNECTED);
 }
 
-void BLEDeviceManager::onDisconnect(BLEClient* client) {
-    connected = false;
-    LOG_PERIPHERAL("[BLE] Device disconnected");
+void BLEDeviceManager::noteDrop() {
+    CameraCommands::linkStats().recordDrop();
+    linkDropped = true;
+}
 
-    // Clean up characteristics
-    pRemoteControlChar = nullptr;
-    pRemoteStatusChar = nullptr;
-    pRemoteService = nullptr;
+void BLEDeviceManager::postLinkEvent(size_t link, ConnectSequence::Event event) {
+    std::lock_guard<std::mutex> lock(eventMutex);
+    CameraLink& target = links[link];
+    if (target.eventCount < CameraLink::EVENT_QUEUE) {
+        target.events[target.eventCount++] = event;
+    }
 }
 
-class MyAdvertisedDeviceCallbacks : public BLEAdvertisedDeviceCallbacks {
-    void onResult(BLEAdvertisedDevice advertisedDevice) {
-        if (advertisedDevice.haveManufacturerData()) {
-            std::string data = advertisedDevice.getManufacturerData();
-            if (data.length() >= 3) {
-                uint16_t manufacturer = (uint8_t)data[0] | ((uint8_t)data[1] << 8);
-                uint8_t type = (uint8_t)data[2];
-
-                if (manufacturer == SONY_COMPANY_ID && type == SONY_CAMERA_TYPE) {
-                    LOG_PERIPHERAL("[BLE] Found Sony camera: %s\n",
-                                   advertisedDevice.toString().c_str());
-                    BLEDeviceManager::addDiscoveredDevice(
-                        new BLEAdvertisedDevice(advertisedDevice));
+void BLEDeviceManager::onAuthenticationComplete(const esp_bd_addr_t address, bool success) {
+    // A rig camera's own link if it is one of theirs; otherwise the active
+    // camera's, which may know the camera by another address while pairing.
+    size_t index = ACTIVE_LINK;
+    for (size_t i = ACTIVE_LINK + 1; i < MAX_LINKS; i++) {
+        if (links[i].sequence.busy() &&
+            memcmp(BLEAddress(links[i].address).getNative(), address, sizeof(esp_bd_addr_t)) ==
+                0) {
+            index = i;
+        }
+    }
+    postLinkEvent(index, success ? ConnectSequence::Event::ENCRYPTED
+                                 : ConnectSequence::Event::AUTH_FAILED);
+}
+
+int BLEDeviceManager::linkFor(esp_gatt_if_t gattcIf) {
+    for (size_t i = 0; i < MAX_LINKS; i++) {
+        BLEClient* client = links[i].client;
+        if (client != nullptr && client->getGattcIf() == gattcIf) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+int BLEDeviceManager::linkFor(const BLEClient* client) {
+    for (size_t i = 0; i < MAX_LINKS; i++) {
+        if (client != nullptr && links[i].client == client) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+int BLEDeviceManager::rigLinkFor(const std::string& address) {
+    for (size_t i = ACTIVE_LINK + 1; i < MAX_LINKS; i++) {
+        if (links[i].address == address) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+void BLEDeviceManager::gattcEvent(esp_gattc_cb_event_t event, esp_gatt_if_t gattcIf,
+                                  esp_ble_gattc_cb_param_t* param) {
+    // Each client registers its own interface, which says whose link it is.
+    const int index = linkFor(gattcIf);
+    if (index < 0) {
+        return;
+    }
+    CameraLink& link = links[index];
+    const bool active = index == ACTIVE_LINK;
+    // BLEClient starts the MTU exchange itself when the link opens; its answer
+    // completes the EXCHANGING_MTU step.
+    switch (event) {
+        case ESP_GATTC_CFG_MTU_EVT:
+            LOG_PERIPHERAL("[BLE] MTU %d (status %d)", param->cfg_mtu.mtu, param->cfg_mtu.status);
+            postLinkEvent(index, ConnectSequence::Event::MTU_DONE);
+            break;
+
+        // Binding cached handles: the CCCD write, then the status read.
+        case ESP_GATTC_WRITE_DESCR_EVT:
+            if (!link.binding || param->write.handle != link.handles.statusCccd) {
+                break;
+            }
+            if (param->write.status != ESP_GATT_OK) {
+                finishBind(index, false);
+            } else if (!link.handles.statusRead) {
+                finishBind(index, true);
+            } else if (esp_ble_gattc_read_char(gattcIf, param->write.conn_id,
+                                               link.handles.statusRead,
+                                               ESP_GATT_AUTH_REQ_NONE) != ESP_OK) {
+                finishBind(index, false);
+            }
+            break;
+        // The initial status read, from a bind or from discovery. Either way
+        // it lands here, so this task stays the status ring's only producer.
+        case ESP_GATTC_READ_CHAR_EVT:
+            if (!link.handles.statusRead || param->read.handle != link.handles.statusRead) {
+                break;
+            }
+            if (param->read.status == ESP_GATT_OK && param->read.value_len) {
+                if (active) {
+                    CameraCommands::onStatusNotification(param->read.value,
+                                                         param->read.value_len);
+                } else {
+                    onRigStatus(index, param->read.value, param->read.value_len);
                 }
             }
+            if (link.binding) {
+                finishBind(index, param->read.status == ESP_GATT_OK);
+            }
+            break;
+
+        // The response to a command write frees the link for the next one.
+        // A rig camera's writes are not queued; only a refusal matters.
+        case ESP_GATTC_WRITE_CHAR_EVT:
+            if (!link.handles.control || param->write.handle != link.handles.control) {
+                break;
+            }
+            if (active) {
+                CameraCommands::onControlWriteAck(param->write.status == ESP_GATT_OK);
+            } else if (param->write.status != ESP_GATT_OK) {
+                const int camera = rig.indexOf(link.address);
+                if (camera >= 0) {
+                    rig.writeFailed(camera);
+                }
+            }
+            break;
+
+        // Status notifications are dispatched by handle whichever way the
+        // handles were learnt, so there is one path into CameraCommands.
+        case ESP_GATTC_NOTIFY_EVT:
+            if (!link.handles.status || param->notify.handle != link.handles.status) {
+                break;
+            }
+            if (active) {
+                CameraCommands::onStatusNotification(param->notify.value,
+                                                     param->notify.value_len);
+                onLeaderStatus(param->notify.value, param->notify.value_len);
+            } else {
+                onRigStatus(index, param->notify.value, param->notify.value_len);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+void BLEDeviceManager::onLeaderStatus(const uint8_t* data, size_t length) {
+    // Stamped here, on the same clock and task as the rig cameras' edges.
+    if (rig.size() && length >= 3 && data[0] == 0x02 &&
+        data[1] == CameraCommands::Status::SHUTTER_TYPE) {
+        rig.onLeaderShutter(data[2] == CameraCommands::Status::SHUTTER_ACTIVE, millis());
+    }
+}
+
+void BLEDeviceManager::onRigStatus(size_t link, const uint8_t* data, size_t length) {
+    // Only the shutter matters for a rig camera: 0x02 A0 00 / 20.
+    if (length < 3 || data[0] != 0x02 || data[1] != CameraCommands::Status::SHUTTER_TYPE) {
+        return;
+    }
+    const int camera = rig.indexOf(links[link].address);
+    if (camera >= 0) {
+        rig.onShutter(camera, data[2] == CameraCommands::Status::SHUTTER_ACTIVE, millis());
+    }
+}
+
+void BLEDeviceManager::finishBind(size_t link, bool bound) {
+    links[link].binding = false;
+    postLinkEvent(link, bound ? ConnectSequence::Event::BOUND
+                              : ConnectSequence::Event::BIND_FAILED);
+}
+
+void BLEDeviceManager::queueLinkJob(size_t link, LinkJob job) {
+    const LinkRequest request = {job, static_cast<uint8_t>(link)};
+    xQueueSend(linkJobs, &request, 0);
+}
+
+void BLEDeviceManager::linkTaskMain(void*) {
+    LinkRequest request;
+    for (;;) {
+        if (xQueueReceive(linkJobs, &request, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+        linkJobRunning = true;
+        CameraLink& link = links[request.link];
+        if (request.job == LinkJob::OPEN) {
+            // Returns on the GATTC open event (or its failure), no fixed wait.
+            BLEClient* client = link.client;
+            const bool opened = client->connect(BLEAddress(link.address));
+            if (opened && client != link.client) {
+                client->disconnect();  // Cancelled while opening: nobody owns this link
+            } else {
+                postLinkEvent(request.link, opened ? ConnectSequence::Event::OPENED
+                                                   : ConnectSequence::Event::OPEN_FAILED);
+            }
+        } else {
+            const bool discovered = initConnection();
+            postLinkEvent(request.link, discovered ? ConnectSequence::Event::DISCOVERED
+                                                   : ConnectSequence::Event::DISCOVERY_FAILED);
         }
+        linkJobRunning = false;
+    }
+}
+
+class MyAdvertisedDeviceCallbacks : public BLEAdvertisedDeviceCallbacks {
+    void onResult(BLEAdvertisedDevice advertisedDevice) {
+        BLEDeviceManager::onAdvertisement(advertisedDevice);
     }
 };
 
@@ -100,15 +339,22 @@ void BLEDeviceManager::init() {
     BLEDevice::setEncryptionLevel(ESP_BLE_SEC_ENCRYPT);
 
     // Create client
-    pClient = BLEDevice::createClient();
-    pClient->setClientCallbacks(new ClientCallback());
+    links[ACTIVE_LINK].client = BLEDevice::createClient();
+    links[ACTIVE_LINK].client->setClientCallbacks(&clientCallback);
+    BLEDevice::setCustomGattcHandler(gattcEvent);
+
+    linkJobs = xQueueCreate(2 * MAX_LINKS, sizeof(LinkRequest));
+    if (xTaskCreatePinnedToCore(linkTaskMain, "ble_link", LINK_TASK_STACK_BYTES, nullptr,
+                                LINK_TASK_PRIORITY, &linkTask, LINK_TASK_CORE) != pdPASS) {
+        linkTask = nullptr;
+        LOG_PERIPHERAL("[BLE] Failed to start link task");
+    }
 
     // Create scan
     pBLEScan = BLEDevice::getScan();
-    pBLEScan->setAdvertisedDeviceCallbacks(new MyAdvertisedDeviceCallbacks());
-    pBLEScan->setActiveScan(true);
-    pBLEScan->setInterval(100);
-    pBLEScan->setWindow(99);
+    // Every advertisement, repeats included, and none kept in the scan's own
+    // result list: presence needs each one, and the device list dedups.
+    pBLEScan->setAdvertisedDeviceCallbacks(new MyAdvertisedDeviceCallbacks(), true);
 
     // Initialize preferences and load the saved-camera list
     preferences.begin("sony-camera", false);
@@ -119,14 +365,27 @@ void BLEDeviceManager::init() {
 
 void BLEDeviceManager::loadDeviceAddress() {
     String addr = preferences.getString("device_address", "");
-    cachedAddress = addr.c_str();
+    setActiveAddress(addr.c_str());
+}
+
+void BLEDeviceManager::setActiveAddress(const std::string& address) {
+    cachedAddress = address;
+    BleAddress key;
+    BleAddress::parse(address, key);  // Stays zero if there is none
+    std::lock_guard<std::mutex> lock(activeKeyMutex);
+    activeKey = key;
+}
+
+BleAddress BLEDeviceManager::activeCameraKey() {
+    std::lock_guard<std::mutex> lock(activeKeyMutex);
+    return activeKey;
 }
 
 void BLEDeviceManager::saveDeviceAddress(const std::string& address) {
     // Record the connected camera as saved + active, then persist the list.
     cameraStore.add(address, "");
     cameraStore.setActive(address);
-    cachedAddress = address;
+    setActiveAddress(address);
     saveCameraStore();
 }
 
@@ -140,13 +399,61 @@ void BLEDeviceManager::loadCameraStore() {
         String name = preferences.getString(nameKey.c_str(), "");
         if (addr.length() > 0) {
             cameraStore.add(addr.c_str(), name.c_str());
+            GattHandles handles;
+            std::string gattKey = "cam_gatt_" + std::to_string(i);
+            if (preferences.getBytesLength(gattKey.c_str()) == sizeof(handles)) {
+                preferences.getBytes(gattKey.c_str(), &handles, sizeof(handles));
+                cameraStore.setHandles(addr.c_str(), handles);
+            }
         }
     }
     String active = preferences.getString("active", "");
     if (active.length() > 0) {
         cameraStore.setActive(active.c_str());
     }
-    cachedAddress = cameraStore.activeAddress();
+    setActiveAddress(cameraStore.activeAddress());
+    presence.track(cameraStore.cameras());
+    loadRig();
+}
+
+void BLEDeviceManager::loadRig() {
+    rig.clear();
+    uint8_t count = preferences.getUChar("rig_count", 0);
+    for (uint8_t i = 0; i < count && i < CameraRig::MAX_CAMERAS; i++) {
+        std::string addrKey = "rig_addr_" + std::to_string(i);
+        String addr = preferences.getString(addrKey.c_str(), "");
+        // Only saved cameras other than the active one.
+        if (cameraStore.find(addr.c_str()) != nullptr && cachedAddress != addr.c_str()) {
+            rig.add(addr.c_str());
+        }
+    }
+}
+
+void BLEDeviceManager::saveRig() {
+    preferences.putUChar("rig_count", (uint8_t)rig.size());
+    for (size_t i = 0; i < rig.size(); i++) {
+        std::string addrKey = "rig_addr_" + std::to_string(i);
+        preferences.putString(addrKey.c_str(), rig.camera(i).address.c_str());
+    }
+}
+
+bool BLEDeviceManager::addRigCamera(const std::string& address) {
+    if (address == cachedAddress || cameraStore.find(address) == nullptr || !rig.add(address)) {
+        return false;
+    }
+    LOG_PERIPHERAL("[BLE] %s joins the rig", address.c_str());
+    saveRig();
+    return true;
+}
+
+bool BLEDeviceManager::removeRigCamera(const std::string& address) {
+    if (!rig.remove(address)) {
+        return false;
+    }
+    // serviceRig() closes its link.
+    LOG_PERIPHERAL("[BLE] %s leaves the rig", address.c_str());
+    saveRig();
+    return true;
 }
 
 void BLEDeviceManager::saveCameraStore() {
@@ -157,8 +464,11 @@ void BLEDeviceManager::saveCameraStore() {
         std::string nameKey = "cam_name_" + std::to_string(i);
         preferences.putString(addrKey.c_str(), cams[i].address.c_str());
         preferences.putString(nameKey.c_str(), cams[i].name.c_str());
+        std::string gattKey = "cam_gatt_" + std::to_string(i);
+        preferences.putBytes(gattKey.c_str(), &cams[i].handles, sizeof(GattHandles));
     }
     preferences.putString("active", cameraStore.activeAddress().c_str());
+    presence.track(cams);  // Every change to the list comes through here
 }
 
 const std::vector<SavedCamera>& BLEDeviceManager::getSavedCameras() {
@@ -170,19 +480,23 @@ bool BLEDeviceManager::hasSavedCameras() {
 }
 
 bool BLEDeviceManager::connectToAddress(const std::string& address) {
-    // Point the active/reconnect target at this camera, then reuse the
-    // address-only reconnect path. On success it becomes the active camera.
-    std::string previous = cachedAddress;
-    cachedAddress = address;
+    // Same path as a reconnect; completeConnection() makes it the active
+    // camera, so a failed attempt leaves the persisted active camera alone.
     setManuallyDisconnected(false);
-    if (connectToSavedDevice()) {
-        cameraStore.setActive(address);
-        saveCameraStore();
-        return true;
+    BleAddress target;
+    if (isConnecting() || isConnected() || presence.isPresent(address, millis()) ||
+        !BleAddress::parse(address, target)) {
+        return beginConnect(address, "", false);
     }
-    // Failed: leave the persisted active camera untouched.
-    cachedAddress = previous;
-    return false;
+    // Not heard lately: look for it first. A saved camera's name is known,
+    // so the scan only listens.
+    if (!beginScan(ScanPlan::Goal::ADDRESS, target, true, FIND_CAMERA_MS)) {
+        return false;
+    }
+    LOG_PERIPHERAL("[BLE] Looking for %s before connecting", address.c_str());
+    findingAddress = address;
+    connectAttempt++;  // The find is this attempt's first step
+    return true;
 }
 
 void BLEDeviceManager::forgetCamera(const std::string& address) {
@@ -191,8 +505,9 @@ void BLEDeviceManager::forgetCamera(const std::string& address) {
         disconnectCamera();
         setManuallyDisconnected(true);
     }
+    removeRigCamera(address);
     cameraStore.forget(address);
-    cachedAddress = cameraStore.activeAddress();  // cleared if we forgot active
+    setActiveAddress(cameraStore.activeAddress());  // cleared if we forgot active
     saveCameraStore();
 }
 
@@ -205,6 +520,15 @@ void BLEDeviceManager::unpairCamera() {
 }
 
 bool BLEDeviceManager::startScan(int duration) {
+    return beginScan(ScanPlan::Goal::LIST, BleAddress(), false, duration * 1000);
+}
+
+bool BLEDeviceManager::scanForFirstCamera(int duration) {
+    return beginScan(ScanPlan::Goal::FIRST_SONY, BleAddress(), false, duration * 1000);
+}
+
+bool BLEDeviceManager::beginScan(ScanPlan::Goal goal, const BleAddress& target, bool nameKnown,
+                                 uint32_t durationMs) {
     LOG_PERIPHERAL("[BLE] Starting BLE scan...");
     if (pBLEScan == nullptr) {
         LOG_PERIPHERAL("[BLE] BLE Scan not initialized!");
@@ -216,16 +540,30 @@ bool BLEDeviceManager::startScan(int duration) {
         stopScan();
     }
 
+    stopPresenceScan();
     clearDiscoveredDevices();
     pBLEScan->clearResults();
+    scanHit = false;
+    scanPlan.begin(goal, target, nameKnown, durationMs, millis());
     scanning = true;
-    scanEndTime = millis() + (duration * 1000);
-
-    pBLEScan->start(duration, false);
+    startScanRadio();
     LOG_PERIPHERAL("[BLE] Scan started");
     return true;
 }
 
+void BLEDeviceManager::startScanRadio() {
+    // Interval and window only take effect when a scan starts.
+    const uint32_t now = millis();
+    const ScanPlan::Duty duty = scanPlan.duty(now);
+    scanBurst = scanPlan.inBurst(now);
+    pBLEScan->setActiveScan(duty.active);
+    pBLEScan->setInterval(duty.intervalMs);
+    pBLEScan->setWindow(duty.windowMs);
+    // Without a completion callback the start returns at once; results stream
+    // into the scan table and serviceScan() ends the scan.
+    pBLEScan->start(0, nullptr, false);
+}
+
 void BLEDeviceManager::stopScan() {
     if (!scanning) {
         return;
@@ -234,128 +572,345 @@ void BLEDeviceManager::stopScan() {
     pBLEScan->stop();
     pBLEScan->clearResults();
     scanning = false;
-    scanEndTime = 0;
+    findingAddress.clear();  // A find cut short fails its connect
 }
 
-void BLEDeviceManager::update() {
-    if (scanning && millis() >= scanEndTime) {
-        LOG_PERIPHERAL("[BLE] Scan timeout reached");
-        stopScan();
+void BLEDeviceManager::serviceScan() {
+    if (!scanning) {
+        return;
     }
-
-    // Check if we're still connected by trying to read a characteristic
-    if (connected && pRemoteService != nullptr) {
-        if (!pRemoteService->getClient()->isConnected()) {
-            LOG_PERIPHERAL("[BLE] Connection lost detected in update");
-            connected = false;
-            pRemoteControlChar = nullptr;
-            pRemoteStatusChar = nullptr;
-            pRemoteService = nullptr;
+    const uint32_t now = millis();
+    const bool hit = scanHit.exchange(false);
+    if (!hit && !scanPlan.expired(now)) {
+        if (scanBurst && !scanPlan.inBurst(now)) {
+            pBLEScan->stop();  // Burst over: carry on at the low duty
+            startScanRadio();
         }
+        return;
+    }
+    LOG_PERIPHERAL("[BLE] Scan %s", hit ? "target found" : "timeout reached");
+    const std::string address = findingAddress;
+    stopScan();
+    if (address.empty()) {
+        return;
+    }
+    if (!hit) {
+        LOG_PERIPHERAL("[BLE] %s not advertising, connect abandoned", address.c_str());
+        return;
+    }
+    // Same attempt as the find, for whoever is watching it.
+    const uint32_t attempt = connectAttempt;
+    if (beginConnect(address, "", false)) {
+        connectAttempt = attempt;
     }
 }
 
-void BLEDeviceManager::clearDiscoveredDevices() {
-    for (auto& deviceInfo : discoveredDevices) {
-        delete deviceInfo.device;
+void BLEDeviceManager::processLinkEvents(size_t index) {
+    // Carry the connect sequence forward: events first, then step timeouts.
+    CameraLink& link = links[index];
+    ConnectSequence::Event events[CameraLink::EVENT_QUEUE];
+    size_t eventCount;
+    {
+        std::lock_guard<std::mutex> lock(eventMutex);
+        eventCount = link.eventCount;
+        std::copy(link.events, link.events + eventCount, events);
+        link.eventCount = 0;
     }
-    discoveredDevices.clear();
+    for (size_t i = 0; i < eventCount; i++) {
+        runAction(index, link.sequence.handle(events[i], millis()));
+    }
+    runAction(index, link.sequence.poll(millis()));
 }
 
-void BLEDeviceManager::addDiscoveredDevice(BLEAdvertisedDevice* device) {
-    // Check if device already exists
-    for (const auto& deviceInfo : discoveredDevices) {
-        if (deviceInfo.device->getAddress().equals(device->getAddress())) {
-            delete device;
-            return;
-        }
+void BLEDeviceManager::update() {
+    for (size_t i = 0; i < MAX_LINKS; i++) {
+        processLinkEvents(i);
     }
+    CameraCommands::service();  // Timed releases and lost acks
+    reapRetiredClients(millis());
 
-    DeviceInfo info(device);
-    discoveredDevices.push_back(info);
-}
+    serviceScan();
 
-const std::vector<DeviceInfo>& BLEDeviceManager::getDiscoveredDevices() {
-    return discoveredDevices;
-}
+    CameraLink& link = links[ACTIVE_LINK];
+    if (link.connected && (link.client == nullptr || !link.client->isConnected())) {
+        LOG_PERIPHERAL("[BLE] Connection lost detected in update");
+        withdrawWriteTarget(ACTIVE_LINK);
+        noteDrop();
+        link.connected = false;
+    }
 
-bool BLEDeviceManager::isScanning() {
-    return scanning;
+    // RSSI is a GAP round trip, so poll it here on the loop and cache it.
+    if (!link.connected || link.client == nullptr) {
+        linkRssi = 0;
+    } else if (millis() - lastRssiPollTime >= RSSI_POLL_INTERVAL_MS) {
+        lastRssiPollTime = millis();
+        linkRssi = static_cast<int8_t>(link.client->getRssi());
+        if (linkRssi != 0) {
+            CameraCommands::linkStats().recordRssi(linkRssi);
+        }
+    }
+    serviceLinkProfile();
+    servicePresenceScan();
+    serviceReconnect();
+    serviceRig();
 }
 
-bool BLEDeviceManager::connectToSavedDevice() {
-    if (cachedAddress.empty()) {
-        LOG_PERIPHERAL("[BLE] No saved device address");
-        return false;
+void BLEDeviceManager::serviceRig() {
+    const uint32_t now = millis();
+    // Close the links of cameras that have left the rig, and notice the
+    // ones that dropped.
+    for (size_t i = ACTIVE_LINK + 1; i < MAX_LINKS; i++) {
+        CameraLink& link = links[i];
+        if (link.address.empty()) {
+            continue;
+        }
+        const int camera = rig.indexOf(link.address);
+        if (camera < 0) {
+            link.sequence.cancel();
+            dropLink(i);
+            link.address.clear();
+        } else if (link.connected && (link.client == nullptr || !link.client->isConnected())) {
+            LOG_PERIPHERAL("[BLE] Rig camera %s lost", link.address.c_str());
+            dropLink(i);
+        }
     }
 
-    LOG_PERIPHERAL("[BLE] Attempting to connect to saved device: %s\n", cachedAddress.c_str());
-
-    // Create a client
-    if (pClient != nullptr) {
-        LOG_PERIPHERAL("[BLE] Cleaning up old client");
-        delete pClient;
-        pClient = nullptr;
+    const size_t timedOut = rig.poll(now);
+    if (timedOut) {
+        LOG_PERIPHERAL("[BLE] %u rig toggle(s) unconfirmed", (unsigned)timedOut);
+    }
+    // A toggle the active camera's press did not carry (its own shutter
+    // needed none) goes out on its own, released on the next pass.
+    if (rigSoloRelease) {
+        rigSoloRelease = false;
+        writeRigToggle(rig.takeRelease(), false, micros());
+    }
+    if (rig.armExpired(now)) {
+        writeRigToggle(rig.takePress(now, false), true, micros());
+        rigSoloRelease = true;
     }
 
-    pClient = BLEDevice::createClient();
-    if (!pClient) {
-        LOG_PERIPHERAL("[BLE] Failed to create client");
-        return false;
+    // Link one rig camera at a time, and only while the active camera is up
+    // and nothing else wants the radio or the link task.
+    if (!isConnected() || scanning || linkJobRunning || linkTask == nullptr) {
+        return;
+    }
+    for (size_t i = 0; i < MAX_LINKS; i++) {
+        if (links[i].sequence.busy()) {
+            return;
+        }
+    }
+    for (size_t camera = 0; camera < rig.size(); camera++) {
+        const CameraRig::Camera member = rig.camera(camera);
+        const SavedCamera* saved = cameraStore.find(member.address);
+        if (member.linked || saved == nullptr || !saved->handles.valid() ||
+            member.address == links[ACTIVE_LINK].address) {
+            continue;
+        }
+        int index = rigLinkFor(member.address);
+        if (index < 0) {
+            index = rigLinkFor("");  // A free link
+            if (index < 0) {
+                continue;
+            }
+        } else if (now - links[index].attemptMs < RIG_RETRY_MS) {
+            continue;
+        }
+        LOG_PERIPHERAL("[BLE] Linking rig camera %s", member.address.c_str());
+        startLink(index, member.address, saved->name, saved->handles, false);
+        return;
     }
+}
 
-    // Connect directly using the address
-    BLEAddress bleAddress(cachedAddress);
-    if (!pClient->connect(bleAddress)) {
-        LOG_PERIPHERAL("[BLE] Failed to connect to saved device");
-        delete pClient;
-        pClient = nullptr;
-        return false;
+void BLEDeviceManager::writeRigToggle(uint8_t cameras, bool press, uint32_t startUs) {
+    if (!cameras) {
+        return;
+    }
+    using namespace CameraCommands;
+    const uint16_t cmd = press ? Cmd::SHUTTER_FULL_DOWN : Cmd::SHUTTER_FULL_UP;
+    uint8_t frame[] = {static_cast<uint8_t>(cmd >> 8), static_cast<uint8_t>(cmd & 0xFF)};
+    BleAddress addresses[CameraRig::MAX_CAMERAS];
+    const size_t count = rig.size();
+    for (size_t camera = 0; camera < count; camera++) {
+        if (cameras & (1u << camera)) {
+            BleAddress::parse(rig.camera(camera).address, addresses[camera]);
+        }
     }
 
-    LOG_PERIPHERAL("[BLE] Connected to saved device!");
+    // Held across the burst: the loop withdraws a target before it closes or
+    // replaces the link, so no write goes out on a connection being torn down.
+    std::lock_guard<std::mutex> lock(writeTargetMutex);
+    uint32_t lastUs = startUs;
+    for (size_t camera = 0; camera < count; camera++) {
+        if (!(cameras & (1u << camera))) {
+            continue;
+        }
+        const LinkWriteTarget* target = nullptr;
+        for (size_t i = ACTIVE_LINK + 1; i < MAX_LINKS; i++) {
+            if (writeTargets[i].ready && writeTargets[i].address == addresses[camera]) {
+                target = &writeTargets[i];
+                break;
+            }
+        }
+        // Without response where the camera allows it: nothing to wait for
+        // between one camera's write and the next.
+        if (target == nullptr ||
+            esp_ble_gattc_write_char(target->gattcIf, target->connId, target->control,
+                                     sizeof(frame), frame,
+                                     target->noResponse ? ESP_GATT_WRITE_TYPE_NO_RSP
+                                                        : ESP_GATT_WRITE_TYPE_RSP,
+                                     ESP_GATT_AUTH_REQ_NONE) != ESP_OK) {
+            rig.writeFailed(camera);
+            continue;
+        }
+        lastUs = micros();
+    }
+    if (press) {
+        rig.recordBurst(lastUs - startUs);
+    }
+}
 
-    // Initialize the connection (set up service and characteristics)
-    if (!initConnection()) {
-        LOG_PERIPHERAL("[BLE] Failed to initialize connection");
-        disconnectCamera();
-        return false;
+void BLEDeviceManager::publishWriteTarget(size_t index) {
+    const CameraLink& link = links[index];
+    LinkWriteTarget target;
+    if (link.client == nullptr || !link.handles.control ||
+        !BleAddress::parse(link.address, target.address)) {
+        return;
     }
+    target.gattcIf = link.client->getGattcIf();
+    target.connId = link.client->getConnId();
+    target.control = link.handles.control;
+    target.noResponse = link.handles.controlWriteNoResponse;
+    target.ready = true;
+    std::lock_guard<std::mutex> lock(writeTargetMutex);
+    writeTargets[index] = target;
+}
 
-    return true;
+void BLEDeviceManager::withdrawWriteTarget(size_t index) {
+    std::lock_guard<std::mutex> lock(writeTargetMutex);
+    writeTargets[index] = LinkWriteTarget{};
 }
 
-bool BLEDeviceManager::connectToCamera(const BLEAdvertisedDevice* device) {
-    if (!device) {
-        LOG_PERIPHERAL("[BLE] No device provided for connection");
-        return false;
+void BLEDeviceManager::servicePresenceScan() {
+    const bool wanted = pBLEScan != nullptr && !scanning && !links[ACTIVE_LINK].connected &&
+                        !links[ACTIVE_LINK].sequence.busy() &&
+                        !manuallyDisconnected && cameraStore.count() > 0;
+    if (presenceScanning && (!wanted || presenceUrgent != reconnectUrgent)) {
+        stopPresenceScan();
+    }
+    const uint32_t now = millis();
+    if (wanted && !presenceScanning) {
+        presenceUrgent = reconnectUrgent;
+        pBLEScan->setActiveScan(false);  // Listen only; no scan requests on air
+        pBLEScan->setInterval(presenceUrgent ? PresenceTracker::URGENT_SCAN_INTERVAL_MS
+                                             : PresenceTracker::SCAN_INTERVAL_MS);
+        pBLEScan->setWindow(presenceUrgent ? PresenceTracker::URGENT_SCAN_WINDOW_MS
+                                           : PresenceTracker::SCAN_WINDOW_MS);
+        presenceScanning = pBLEScan->start(0, nullptr, false);  // Until stopped
+        presenceStartMs = now;
+    }
+    // Absence only counts once the scan has had time to hear the camera.
+    if (presenceScanning) {
+        const bool present = presence.isPresent(cachedAddress, now);
+        if (present || now - presenceStartMs >= PresenceTracker::PRESENT_TTL_MS) {
+            reconnect.setTargetPresent(present);
+        }
     }
+}
 
-    // Clean up any existing connection
-    disconnectCamera();
+void BLEDeviceManager::stopPresenceScan() {
+    if (presenceScanning) {
+        pBLEScan->stop();
+        presenceScanning = false;
+    }
+}
 
-    BLEAddress address = const_cast<BLEAdvertisedDevice*>(device)->getAddress();
-    LOG_PERIPHERAL("[BLE] Connecting to camera: %s\n", address.toString().c_str());
+void BLEDeviceManager::serviceReconnect() {
+    const uint32_t now = millis();
+    if (linkDropped.exchange(false) && !manuallyDisconnected && !cachedAddress.empty()) {
+        LOG_PERIPHERAL("[BLE] Link dropped, reconnecting");
+        reconnect.linkLost(now);
+    }
+    // With auto-connect off, only a frame's shutter is worth chasing.
+    if (links[ACTIVE_LINK].connected || isConnecting() ||
+        (!autoConnectEnabled && !reconnectUrgent) ||
+        !reconnect.due(now, reconnectUrgent)) {
+        return;
+    }
+    reconnect.attempted(now, reconnectUrgent, esp_random());
+    LOG_PERIPHERAL("[BLE] Reconnect attempt %u%s%s", reconnect.attempts(),
+                   reconnectUrgent ? " (mid-exposure)" : "",
+                   presence.isPresent(cachedAddress, now) ? "" : " (not advertising)");
+    connectToSavedDevice();
+}
 
-    pClient = BLEDevice::createClient();
-    if (!pClient) {
-        LOG_PERIPHERAL("[BLE] Failed to create client");
-        return false;
+void BLEDeviceManager::serviceLinkProfile() {
+    LinkProfile profile;
+    if (!links[ACTIVE_LINK].connected || links[ACTIVE_LINK].client == nullptr ||
+        !linkPolicy.next(millis(), lastCommandMs.load(), nextToggleInMs, profile)) {
+        return;
     }
+    // Asked of the camera; it may settle on other values within the range.
+    const ConnParams& p = LinkProfilePolicy::params(profile);
+    esp_ble_conn_update_params_t update = {};
+    BLEAddress address(cachedAddress);
+    memcpy(update.bda, address.getNative(), sizeof(esp_bd_addr_t));
+    update.min_int = p.minInterval;
+    update.max_int = p.maxInterval;
+    update.latency = p.latency;
+    update.timeout = p.timeout;
+    if (esp_ble_gap_update_conn_params(&update) != ESP_OK) {
+        LOG_PERIPHERAL("[BLE] Connection parameter update refused");
+    } else {
+        LOG_PERIPHERAL("[BLE] Link profile %s", LinkProfilePolicy::name(profile));
+    }
+    // Either way: a refused request is retried after the switch interval.
+    linkPolicy.requested(profile, millis());
+    linkProfile = profile;
+}
 
-    pClient->setClientCallbacks(new ClientCallback());
+void BLEDeviceManager::onAdvertisement(BLEAdvertisedDevice& device) {
+    // Straight from the raw payload into fixed tables: nothing allocated here
+    // per advertisement.
+    const BleAddress address = BleAddress::fromNative(*device.getAddress().getNative());
+    const int8_t rssi = static_cast<int8_t>(device.getRSSI());
+    const uint32_t now = millis();
+    presence.observe(address, rssi, now);
+    if (!scanning) {
+        return;  // Presence scan: nothing to list
+    }
+    AdvertisementInfo info;
+    parseAdvertisement(device.getPayload(), device.getPayloadLength(), info);
+    const bool sonyCamera = info.hasManufacturer && info.companyId == SONY_COMPANY_ID &&
+                            info.companyType == SONY_CAMERA_TYPE;
+    if (scanPlan.isTarget(address, sonyCamera)) {
+        scanHit = true;
+    }
+    ScanTable::Entry known;
+    if (!sonyCamera && !scanTable.find(address, known)) {
+        return;  // A camera's scan response carries its name but no Sony header
+    }
+    if (scanTable.observe(address, info.name, rssi, now) == ScanTable::Change::ADDED) {
+        LOG_PERIPHERAL("[BLE] Found Sony camera %s (%d dBm)", address.toString().c_str(), rssi);
+    }
+}
+
+bool BLEDeviceManager::isScanning() {
+    return scanning;
+}
 
-    // Set connection parameters using GAP API
-    esp_ble_conn_update_params_t connParams;
-    memset(&connParams, 0, sizeof(connParams));
-    memcpy(connParams.bda, address.getNative(), sizeof(esp_bd_addr_t));
-    connParams.latency = 0;
-    connParams.max_int = 0x20;  // 40ms interval
-    connParams.min_int = 0x10;  // 20ms interval
-    connParams.timeout = 400;   // 4s timeout
+bool BLEDeviceManager::connectToSavedDevice() {
+    if (cachedAddress.empty()) {
+        LOG_PERIPHERAL("[BLE] No saved device address");
+        return false;
+    }
+    return beginConnect(cachedAddress, "", false);
+}
 
-    // Set the connection parameters before connecting
-    esp_ble_gap_update_conn_params(&connParams);
+bool BLEDeviceManager::connectToCamera(const BleAddress& address, const std::string& name) {
+    if (isConnected() || links[ACTIVE_LINK].sequence.busy()) {
+        disconnectCamera();  // Pairing replaces any current link
+    }
 
     // Set security level to just require bonding without MITM
     esp_ble_auth_req_t auth_req = ESP_LE_AUTH_BOND;
@@ -369,147 +924,382 @@ bool BLEDeviceManager::connectToCamera(const BLEAdvertisedDevice* device) {
     esp_ble_gap_set_security_param(ESP_BLE_SM_SET_INIT_KEY, &init_key, sizeof(uint8_t));
     esp_ble_gap_set_security_param(ESP_BLE_SM_SET_RSP_KEY, &rsp_key, sizeof(uint8_t));
 
-    // Connect with security
-    LOG_PERIPHERAL("[BLE] Attempting connection...");
-    if (!pClient->connect(address)) {
-        LOG_PERIPHERAL("[BLE] Connection failed");
-        delete pClient;
-        pClient = nullptr;
+    return beginConnect(address.toString(), name, true);
+}
+
+bool BLEDeviceManager::beginConnect(const std::string& address, const std::string& name,
+                                    bool pairing) {
+    CameraLink& link = links[ACTIVE_LINK];
+    if (link.sequence.busy()) {
+        return address == link.address;  // Already on its way
+    }
+    if (isConnected() && address == cachedAddress) {
+        return true;
+    }
+    if (linkJobRunning || linkTask == nullptr) {
+        // A timed-out open or discovery has not returned yet; the caller
+        // retries on its next pass.
+        LOG_PERIPHERAL("[BLE] Link task busy, connect deferred");
         return false;
     }
+    if (isConnected()) {
+        disconnectCamera();
+    }
+    // A rig camera being made active gives up its rig link first.
+    const int rigLink = rigLinkFor(address);
+    if (rigLink >= 0) {
+        links[rigLink].sequence.cancel();
+        dropLink(rigLink);
+        links[rigLink].address.clear();
+    }
 
-    LOG_PERIPHERAL("[BLE] Connected to camera!");
+    LOG_PERIPHERAL("[BLE] Connecting to %s%s", address.c_str(), pairing ? " (pairing)" : "");
+    stopPresenceScan();  // Out of the open's way
+    // A bonded camera we have connected before: skip discovery.
+    const SavedCamera* saved = pairing ? nullptr : cameraStore.find(address);
+    if (!startLink(ACTIVE_LINK, address, name, saved ? saved->handles : GattHandles{},
+                   pairing)) {
+        return false;
+    }
+    connectAttempt++;
+    return true;
+}
+
+bool BLEDeviceManager::startLink(size_t index, const std::string& address,
+                                 const std::string& name, const GattHandles& handles,
+                                 bool pairing) {
+    CameraLink& link = links[index];
+    withdrawWriteTarget(index);
+    // A fresh client per attempt, as Bluedroid does not always reopen a
+    // client that has been closed.
+    delete link.client;
+    link.client = BLEDevice::createClient();
+    if (!link.client) {
+        LOG_PERIPHERAL("[BLE] Failed to create client");
+        return false;
+    }
+    link.client->setClientCallbacks(&clientCallback);
+
+    {
+        std::lock_guard<std::mutex> lock(eventMutex);
+        link.eventCount = 0;  // Nothing from an earlier link applies to this one
+    }
+    link.address = address;
+    link.name = name;
+    link.attemptMs = millis();
+    // Every link opens on the balanced profile; update() moves the active
+    // camera's from there.
+    const ConnParams& params = LinkProfilePolicy::params(LinkProfile::BALANCED);
+    BLEAddress bleAddress(address);
+    esp_bd_addr_t bdAddr;
+    memcpy(bdAddr, bleAddress.getNative(), sizeof(esp_bd_addr_t));
+    esp_ble_gap_set_prefer_conn_params(bdAddr, params.minInterval, params.maxInterval,
+                                       params.latency, params.timeout);
+    link.handles = handles;
+    link.binding = false;
+    runAction(index, link.sequence.begin(pairing, millis(), link.handles.valid()));
+    return true;
+}
+
+void BLEDeviceManager::runAction(size_t index, ConnectSequence::Action action) {
+    using Action = ConnectSequence::Action;
+    CameraLink& link = links[index];
+    switch (action) {
+        case Action::NONE:
+            return;
+        case Action::OPEN:
+            queueLinkJob(index, LinkJob::OPEN);
+            return;
+        case Action::REQUEST_MTU:
+            // No per-camera setMTU: it would lower the global local MTU the
+            // web remote's bulk transfers rely on. The camera's answer caps
+            // this link. The exchange may already have finished while the
+            // open returned.
+            if (link.client->getMTU() > DEFAULT_ATT_MTU) {
+                postLinkEvent(index, ConnectSequence::Event::MTU_DONE);
+            }
+            return;
+        case Action::ENCRYPT: {
+            BLEAddress address(link.address);
+            esp_bd_addr_t bdAddr;
+            memcpy(bdAddr, address.getNative(), sizeof(esp_bd_addr_t));
+            esp_ble_set_encryption(bdAddr, ESP_BLE_SEC_ENCRYPT);
+            return;
+        }
+        case Action::DISCOVER:
+            if (index != ACTIVE_LINK) {
+                // Rig cameras join by their saved handles only; the next time
+                // the camera is connected as the active one refreshes them.
+                LOG_PERIPHERAL("[BLE] Rig camera %s needs rediscovery", link.address.c_str());
+                postLinkEvent(index, ConnectSequence::Event::DISCOVERY_FAILED);
+                return;
+            }
+            if (link.sequence.cacheMissed()) {
+                LOG_PERIPHERAL("[BLE] Saved GATT handles did not match, rediscovering");
+                if (cameraStore.setHandles(link.address, GattHandles{})) {
+                    saveCameraStore();
+                }
+            }
+            link.handles = GattHandles{};  // initConnection() fills them in
+            queueLinkJob(index, LinkJob::DISCOVER);
+            return;
+        case Action::BIND:
+            bindHandles(index);
+            return;
+        case Action::ABORT:
+            LOG_PERIPHERAL("[BLE] Connect to %s failed at %s", link.address.c_str(),
+                           ConnectSequence::stepName(link.sequence.failedStep()));
+            if (index == ACTIVE_LINK) {
+                CameraCommands::linkStats().recordConnectFailure();
+            }
+            dropLink(index);
+            return;
+        case Action::COMPLETE:
+            if (index == ACTIVE_LINK) {
+                completeConnection();
+                return;
+            }
+            link.connected = true;
+            publishWriteTarget(index);
+            if (rig.indexOf(link.address) >= 0) {
+                rig.setLinked(rig.indexOf(link.address), true);
+            }
+            LOG_PERIPHERAL("[BLE] Rig camera %s linked in %lu ms", link.address.c_str(),
+                           static_cast<unsigned long>(link.sequence.connectMs()));
+            return;
+    }
+}
 
-    // Set MTU and wait for completion
-    LOG_PERIPHERAL("[BLE] Setting MTU...");
-    pClient->setMTU(185);  // Sony cameras typically use smaller MTU
-    delay(500);            // Wait for MTU exchange
+void BLEDeviceManager::completeConnection() {
+    CameraLink& link = links[ACTIVE_LINK];
+    link.connected = true;
+    publishWriteTarget(ACTIVE_LINK);
+    // The camera we reached becomes the saved, active one, and so is no
+    // longer one of the rig's.
+    cameraStore.add(link.address, link.name);
+    cameraStore.setActive(link.address);
+    setActiveAddress(link.address);
+    removeRigCamera(link.address);
+    if (!link.sequence.usedCache() && link.handles.valid()) {
+        cameraStore.setHandles(link.address, link.handles);
+    }
+    saveCameraStore();
+    lastConnectMs = link.sequence.connectMs();
+    lastConnectCached = link.sequence.usedCache();
+    CameraCommands::linkStats().recordConnect();
+    linkPolicy.reset(millis());
+    linkProfile = linkPolicy.current();
+    manuallyDisconnected = false;  // Connected again: drops are retried again
+    if (reconnect.active()) {
+        const uint16_t attempts = reconnect.attempts();
+        const uint32_t outageMs = reconnect.recovered(millis());
+        CameraCommands::linkStats().recordRecovery(outageMs, attempts);
+        LOG_PERIPHERAL("[BLE] Link recovered after %lu ms (%u attempts)",
+                       static_cast<unsigned long>(outageMs), attempts);
+    }
+    LOG_PERIPHERAL("[BLE] Connected to %s in %lu ms (%s)", link.address.c_str(),
+                   static_cast<unsigned long>(lastConnectMs),
+                   lastConnectCached ? "cached handles" : "discovery");
+}
 
-    // Set encryption using the correct address type
-    LOG_PERIPHERAL("[BLE] Setting up encryption...");
+void BLEDeviceManager::bindHandles(size_t index) {
+    // Everything by handle and asynchronous; gattcEvent() sees the CCCD write
+    // and the status read complete and posts BOUND or BIND_FAILED.
+    CameraLink& link = links[index];
+    BLEAddress address(link.address);
     esp_bd_addr_t bdAddr;
     memcpy(bdAddr, address.getNative(), sizeof(esp_bd_addr_t));
-    esp_ble_set_encryption(bdAddr, ESP_BLE_SEC_ENCRYPT);
+    uint8_t enable[] = {0x01, 0x00};
+    link.binding = true;
+    BLEClient* client = link.client;
+    if (esp_ble_gattc_register_for_notify(client->getGattcIf(), bdAddr, link.handles.status) !=
+            ESP_OK ||
+        esp_ble_gattc_write_char_descr(client->getGattcIf(), client->getConnId(),
+                                       link.handles.statusCccd, sizeof(enable), enable,
+                                       ESP_GATT_WRITE_TYPE_RSP, ESP_GATT_AUTH_REQ_NONE) != ESP_OK) {
+        finishBind(index, false);
+    }
+}
 
-    // Give more time for pairing and service discovery
-    LOG_PERIPHERAL("[BLE] Waiting for pairing and service discovery...");
-    delay(2000);  // Reduced delay since we have faster connection parameters
+void BLEDeviceManager::dropLink(size_t index) {
+    CameraLink& link = links[index];
+    withdrawWriteTarget(index);
+    link.connected = false;
+    link.binding = false;
+    if (index == ACTIVE_LINK) {
+        CameraCommands::onLinkLost();
+    } else if (rig.indexOf(link.address) >= 0) {
+        rig.setLinked(rig.indexOf(link.address), false);
+    }
+    if (link.client != nullptr && link.client->isConnected()) {
+        // The close completes asynchronously; the client is retired rather
+        // than deleted under a pending event, and the next connect makes a
+        // new one.
+        BLEClient* client = link.client;
+        link.client = nullptr;
+        retireClient(client);
+        client->disconnect();
+    }
+}
 
-    if (!initConnection()) {
-        LOG_PERIPHERAL("[BLE] Failed to initialize connection");
-        disconnectCamera();
-        return false;
+void BLEDeviceManager::retireClient(BLEClient* client) {
+    for (auto& slot : retired) {
+        if (slot.client.load() == nullptr) {
+            slot.closed.store(false);
+            slot.closedMs = 0;
+            slot.client.store(client);
+            return;
+        }
     }
+    // Only if links keep dropping faster than Bluedroid reports it.
+    LOG_PERIPHERAL("[BLE] No retired-client slot free, client abandoned");
+}
 
-    // Save the camera (with its advertised name) as saved + active.
-    std::string name = const_cast<BLEAdvertisedDevice*>(device)->getName();
-    cameraStore.add(address.toString(), name);
-    cameraStore.setActive(address.toString());
-    cachedAddress = address.toString();
-    saveCameraStore();
-    return true;
+void BLEDeviceManager::reapRetiredClients(uint32_t now) {
+    for (auto& slot : retired) {
+        BLEClient* client = slot.client.load();
+        if (client == nullptr || !slot.closed.load()) {
+            continue;
+        }
+        if (slot.closedMs == 0) {
+            slot.closedMs = now ? now : 1;
+        } else if (now - slot.closedMs >= RETIRE_GRACE_MS) {
+            slot.client.store(nullptr);
+            delete client;
+        }
+    }
 }
 
 void BLEDeviceManager::disconnectCamera() {
     LOG_PERIPHERAL("[BLE] Disconnecting from camera...");
 
-    if (pClient != nullptr) {
-        if (pClient->isConnected()) {
-            pClient->disconnect();
-            delay(100);  // Give it time to disconnect cleanly
-        }
-
-        // Clear all pointers
-        pRemoteService = nullptr;
-        pRemoteControlChar = nullptr;
-        pRemoteStatusChar = nullptr;
-        pClient = nullptr;
+    reconnect.cancel();  // Closed on purpose: nothing to recover
+    if (!findingAddress.empty()) {
+        stopScan();
     }
+    links[ACTIVE_LINK].sequence.cancel();
+    dropLink(ACTIVE_LINK);
 
     LOG_PERIPHERAL("[BLE] Disconnected and cleaned up");
 }
 
 bool BLEDeviceManager::initConnection() {
-    if (!pClient || !pClient->isConnected()) {
+    CameraLink& link = links[ACTIVE_LINK];
+    BLEClient* client = link.client;
+    if (!client || !client->isConnected()) {
         LOG_PERIPHERAL("[BLE] Not connected to device");
         return false;
     }
 
     LOG_PERIPHERAL("[BLE] Looking for Sony Remote service...");
-    pRemoteService = pClient->getService(SONY_REMOTE_SERVICE_UUID);
-    if (pRemoteService == nullptr) {
+    BLERemoteService* service = client->getService(SONY_REMOTE_SERVICE_UUID);
+    if (service == nullptr) {
         LOG_PERIPHERAL("[BLE] Failed to find Sony Remote service");
         return false;
     }
 
     LOG_PERIPHERAL("[BLE] Looking for Remote Control characteristic...");
-    pRemoteControlChar = pRemoteService->getCharacteristic(SONY_REMOTE_CONTROL_CHARACTERISTIC_UUID);
-    if (pRemoteControlChar == nullptr) {
+    BLERemoteCharacteristic* control =
+        service->getCharacteristic(SONY_REMOTE_CONTROL_CHARACTERISTIC_UUID);
+    if (control == nullptr) {
         LOG_PERIPHERAL("[BLE] Failed to find Remote Control characteristic");
         return false;
     }
 
     LOG_PERIPHERAL("[BLE] Looking for Remote Status characteristic...");
-    pRemoteStatusChar = pRemoteService->getCharacteristic(SONY_REMOTE_STATUS_CHARACTERISTIC_UUID);
-    if (pRemoteStatusChar == nullptr) {
+    BLERemoteCharacteristic* status =
+        service->getCharacteristic(SONY_REMOTE_STATUS_CHARACTERISTIC_UUID);
+    if (status == nullptr) {
         LOG_PERIPHERAL("[BLE] Failed to find Status characteristic");
         return false;
     }
+    BLERemoteDescriptor* cccd = status->getDescriptor(BLEUUID((uint16_t)0x2902));
+    BLERemoteCharacteristic* statusRead =
+        service->getCharacteristic(SONY_REMOTE_STATUS_READ_CHARACTERISTIC_UUID);
+
+    // Everything from here on goes by handle, as on a cached reconnect.
+    GattHandles handles;
+    handles.control = control->getHandle();
+    handles.status = status->getHandle();
+    handles.statusCccd = cccd ? cccd->getHandle() : 0;
+    handles.statusRead = statusRead && statusRead->canRead() ? statusRead->getHandle() : 0;
+    handles.controlWriteNoResponse = control->canWriteNoResponse();
+    link.handles = handles;
 
     LOG_PERIPHERAL("[BLE] Registering for status notifications...");
-    if (pRemoteStatusChar->canNotify()) {
-        pRemoteStatusChar->registerForNotify(CameraCommands::onStatusNotification);
+    if (status->canNotify() && cccd) {
+        BLEAddress address(link.address);
+        esp_bd_addr_t bdAddr;
+        memcpy(bdAddr, address.getNative(), sizeof(esp_bd_addr_t));
+        esp_ble_gattc_register_for_notify(client->getGattcIf(), bdAddr, handles.status);
+        uint8_t enable[] = {0x01, 0x00};
+        cccd->writeValue(enable, sizeof(enable), true);
     }
 
+    // Not awaited: the value arrives as ESP_GATTC_READ_CHAR_EVT and goes to
+    // CameraCommands from gattcEvent(), as on a cached reconnect.
     LOG_PERIPHERAL("[BLE] Reading initial camera status...");
-    BLERemoteCharacteristic* pStatusReadChar =
-        pRemoteService->getCharacteristic(SONY_REMOTE_STATUS_READ_CHARACTERISTIC_UUID);
-    if (pStatusReadChar && pStatusReadChar->canRead()) {
-        std::string value = pStatusReadChar->readValue();
-        if (!value.empty()) {
-            uint8_t* data = (uint8_t*)value.data();
-            size_t length = value.length();
-            CameraCommands::onStatusNotification(pStatusReadChar, data, length, false);
-        }
+    if (handles.statusRead &&
+        esp_ble_gattc_read_char(client->getGattcIf(), client->getConnId(), handles.statusRead,
+                                ESP_GATT_AUTH_REQ_NONE) != ESP_OK) {
+        LOG_PERIPHERAL("[BLE] Initial status read not sent");
     }
 
-    LOG_PERIPHERAL("[BLE] Connection initialized successfully");
+    LOG_PERIPHERAL("[BLE] Connection initialized (handles %04X/%04X/%04X/%04X)",
+                   handles.control, handles.status, handles.statusCccd, handles.statusRead);
     return true;
 }
 
-BLERemoteService* BLEDeviceManager::getService() {
-    return pRemoteService;
+bool BLEDeviceManager::writeControl(const uint8_t* data, size_t length, bool withResponse) {
+    // Never waits: a write response arrives as ESP_GATTC_WRITE_CHAR_EVT and
+    // goes to the command queue (gattcEvent()).
+    const uint32_t startUs = micros();
+    bool written = false;
+    {
+        std::lock_guard<std::mutex> lock(writeTargetMutex);
+        const LinkWriteTarget& target = writeTargets[ACTIVE_LINK];
+        if (!target.ready) {
+            return false;
+        }
+        written = esp_ble_gattc_write_char(target.gattcIf, target.connId, target.control, length,
+                                           const_cast<uint8_t*>(data),
+                                           withResponse ? ESP_GATT_WRITE_TYPE_RSP
+                                                        : ESP_GATT_WRITE_TYPE_NO_RSP,
+                                           ESP_GATT_AUTH_REQ_NONE) == ESP_OK;
+    }
+    // The rig's armed toggle rides on the shutter press: its writes follow
+    // this one straight away, and their releases follow its release.
+    const uint16_t cmd = length == 2 ? (data[0] << 8) | data[1] : 0;
+    if (written && cmd == CameraCommands::Cmd::SHUTTER_FULL_DOWN) {
+        writeRigToggle(rig.takePress(millis(), true), true, startUs);
+    } else if (cmd == CameraCommands::Cmd::SHUTTER_FULL_UP) {
+        writeRigToggle(rig.takeRelease(), false, startUs);
+    }
+    return written;
 }
 
-BLERemoteCharacteristic* BLEDeviceManager::getControlCharacteristic() {
-    return pRemoteControlChar;
+bool BLEDeviceManager::controlWritesWithoutResponse() {
+    std::lock_guard<std::mutex> lock(writeTargetMutex);
+    return writeTargets[ACTIVE_LINK].noResponse;
 }
 
-BLERemoteCharacteristic* BLEDeviceManager::getStatusCharacteristic() {
-    return pRemoteStatusChar;
-}
-
-bool BLEDeviceManager::pairCamera(const BLEAdvertisedDevice* device) {
-    if (!device) {
-        return false;
-    }
-
-    // First connect to the camera
-    if (!connectToCamera(device)) {
-        return false;
-    }
-
-    // Save the device address
-    BLEAddress address = const_cast<BLEAdvertisedDevice*>(device)->getAddress();
-    saveDeviceAddress(address.toString());
-    return true;
+bool BLEDeviceManager::pairCamera(const BleAddress& address, const std::string& name) {
+    // Saved as the active camera once the connect completes.
+    return connectToCamera(address, name);
 }
 
 bool BLEDeviceManager::isConnected() {
-    return pClient != nullptr && pClient->isConnected();
+    const CameraLink& link = links[ACTIVE_LINK];
+    return link.connected && link.client != nullptr && link.client->isConnected();
 }
 
 void BLEDeviceManager::disconnect() {
     setManuallyDisconnected(true);
     disconnectCamera();
+    // The rig goes down with the active camera; it comes back with the next
+    // connect.
+    for (size_t i = ACTIVE_LINK + 1; i < MAX_LINKS; i++) {
+        links[i].sequence.cancel();
+        dropLink(i);
+    }
 }
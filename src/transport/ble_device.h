@@ -8,11 +8,24 @@
 #include <BLEServer.h>
 #include <BLEUtils.h>
 #include <Preferences.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
 
+#include <atomic>
+#include <mutex>
 #include <string>
 #include <vector>
 
+#include "transport/ble_address.h"
+#include "transport/camera_rig.h"
 #include "transport/camera_store.h"
+#include "transport/connect_sequence.h"
+#include "transport/link_profile.h"
+#include "transport/presence_tracker.h"
+#include "transport/reconnect_supervisor.h"
+#include "transport/scan_plan.h"
+#include "transport/scan_table.h"
 
 // Sony BLE definitions
 #define SONY_COMPANY_ID 0x012D
@@ -55,60 +68,115 @@ class MySecurity : public BLESecurityCallbacks {
         return true;
     }
 
-    void onAuthenticationComplete(esp_ble_auth_cmpl_t auth_cmpl) {
-        if (auth_cmpl.success) {
-            LOG_PERIPHERAL("[BLE] Authentication Success");
-            delay(1000);
-        } else {
-            LOG_PERIPHERAL("[BLE] Authentication Failure");
-            delay(1000);
-        }
-    }
+    // Completes the connect sequence's ENCRYPTING step (ble_device.cpp).
+    void onAuthenticationComplete(esp_ble_auth_cmpl_t auth_cmpl);
 };
 
-// Device info structure
-struct DeviceInfo {
-    BLEAdvertisedDevice* device;
-    std::string address;
+// One camera link: its client, the connect sequence bringing it up, and the
+// inbox of radio events for update() to apply. BLEDeviceManager keeps one
+// for the active camera and one per rig camera (camera_rig.h).
+struct CameraLink {
+    static constexpr size_t EVENT_QUEUE = 8;
+
+    BLEClient* client = nullptr;
+    bool connected = false;    // READY, not merely open
+    ConnectSequence sequence;  // Loop-owned
+    std::string address;       // Target of the sequence under way / the link's camera
     std::string name;
-    int rssi;
-    bool isSonyCamera;
-
-    DeviceInfo(BLEAdvertisedDevice* d) : device(d) {
-        address = d->getAddress().toString();
-        name = d->getName();
-        rssi = d->getRSSI();
-        isSonyCamera = false;
-    }
+    // The saved handles, or what initConnection() found. Read by
+    // gattcEvent() on the BLE task.
+    GattHandles handles;
+    volatile bool binding = false;  // BIND under way: gattcEvent() completes it
+    ConnectSequence::Event events[EVENT_QUEUE];  // Guarded by the manager's eventMutex
+    size_t eventCount = 0;
+    uint32_t attemptMs = 0;  // Rig links: when the last connect started
+};
 
-    std::string getName() const { return name; }
-    std::string getAddress() const { return address; }
-    int getRSSI() const { return rssi; }
+// A client dropLink() let go of while its close was still pending. Deleted
+// from update() once Bluedroid has reported the disconnect, never under an
+// event still on its way.
+struct RetiredClient {
+    std::atomic<BLEClient*> client{nullptr};
+    std::atomic<bool> closed{false};  // onDisconnect() has run for it (BLE task)
+    uint32_t closedMs = 0;            // Loop: when it was first seen closed
 };
 
+// What a control write needs to reach one link, copied out of the link by
+// the loop once it is READY and withdrawn before the link or its client
+// changes. writeControl() and the rig toggle run off the loop, so they read
+// only these (under writeTargetMutex), never the CameraLink itself.
+struct LinkWriteTarget {
+    bool ready = false;
+    BleAddress address;
+    esp_gatt_if_t gattcIf = 0;
+    uint16_t connId = 0;
+    uint16_t control = 0;
+    bool noResponse = false;
+};
+
+// Camera link. Connecting never blocks the caller: the connect*() calls only
+// start a ConnectSequence, and update() carries it forward as the radio's
+// events come in (see connect_sequence.h). The two Bluedroid calls that
+// block until their own GATTC event — open and discovery — run on a small
+// link task, so neither the UI loop nor the astro sequencer waits on them.
+//
+// Besides the active camera, up to CameraRig::MAX_CAMERAS rig cameras hold
+// links of their own (ADR 0008); three client links fit Bluedroid's default
+// four connections alongside the remote-control server.
 class BLEDeviceManager {
 public:
+    static constexpr uint16_t DEFAULT_ATT_MTU = 23;  // Before the exchange completes
+    static constexpr size_t ACTIVE_LINK = 0;
+    static constexpr size_t MAX_LINKS = 1 + CameraRig::MAX_CAMERAS;
+    static constexpr uint32_t LINK_TASK_STACK_BYTES = 4096;
+    static constexpr UBaseType_t LINK_TASK_PRIORITY = 1;
+    static constexpr BaseType_t LINK_TASK_CORE = 0;  // With the BLE host, off the app core
+
     static void init();
     static bool isInitialized();
+    // The link is up and discovered (READY), not merely open.
     static bool isConnected();
+    // Start a connect to the active camera. True if one was started or is
+    // already under way; completion shows in isConnected() / getConnectStep().
     static bool connectToSavedDevice();
     static bool connectToDevice(BLEAdvertisedDevice* device);
     static void disconnect();
     static void scan();
+    // Full discovery of the Sony service (link task); learns the GATT handles.
     static bool initConnection();
-    static BLERemoteCharacteristic* getControlCharacteristic();
-    static BLERemoteCharacteristic* getStatusCharacteristic();
-    static BLERemoteService* getService();
+    // Write a command to the camera's 0xFF01 characteristic by handle.
+    // Returns once the write is queued; false if there is no usable link.
+    // Only CameraCommands' command queue calls this.
+    static bool writeControl(const uint8_t* data, size_t length, bool withResponse);
+    // The camera's 0xFF01 accepts writes without response.
+    static bool controlWritesWithoutResponse();
     static void onConnect(BLEClient* client);
     static void onDisconnect(BLEClient* client);
     static void onScanComplete();
 
-    // Connection management
-    static bool connectToCamera(const BLEAdvertisedDevice* device);
+    // Connection management. connectToCamera() pairs a newly scanned camera
+    // (with encryption); it is saved and made active once the link is READY.
+    static bool connectToCamera(const BleAddress& address, const std::string& name);
     static void disconnectCamera();
+    // Includes connectToAddress() still looking for its camera.
+    static bool isConnecting() {
+        return links[ACTIVE_LINK].sequence.busy() || !findingAddress.empty();
+    }
+    static ConnectSequence::Step getConnectStep() { return links[ACTIVE_LINK].sequence.step(); }
+    // Bumped by every connect started, so a screen can tell its own attempt's
+    // outcome from an earlier one.
+    static uint32_t getConnectAttempt() { return connectAttempt; }
+    // Duration of the last successful connect, and whether it reused the
+    // camera's saved GATT handles instead of discovering them.
+    static uint32_t getLastConnectMs() { return lastConnectMs; }
+    static bool lastConnectUsedCache() { return lastConnectCached; }
+    // From BLE callbacks and the link task; applied by update().
+    static void postLinkEvent(size_t link, ConnectSequence::Event event);
+    // Encryption outcome (MySecurity), for the link to that camera.
+    static void onAuthenticationComplete(const esp_bd_addr_t address, bool success);
 
     // Pairing management
-    static bool pairCamera(const BLEAdvertisedDevice* device);
+    static bool pairCamera(const BleAddress& address, const std::string& name);
     static void unpairCamera();
     static bool isPaired() { return !cachedAddress.empty(); }
     static const std::string& getPairedDeviceAddress() { return cachedAddress; }
@@ -118,22 +186,85 @@ public:
     static const std::vector<SavedCamera>& getSavedCameras();
     static bool hasSavedCameras();
     static const std::string& getActiveCameraAddress() { return cachedAddress; }
+    // The same camera as a copy, safe from any task (cachedAddress is the
+    // loop's own). Zero when there is none.
+    static BleAddress activeCameraKey();
     // Connect to a specific saved camera by address (reuses the reconnect
-    // path) and make it the active camera on success.
+    // path); it becomes the active camera once connected. A camera not heard
+    // advertising lately is looked for first with a targeted scan: the
+    // connect starts the moment it is heard, and the attempt fails after
+    // FIND_CAMERA_MS instead of waiting out the open timeout.
+    static constexpr uint32_t FIND_CAMERA_MS = 4000;
     static bool connectToAddress(const std::string& address);
     // Forget a specific saved camera. If it is the active camera, disconnect
     // and clear active (no auto-pick).
     static void forgetCamera(const std::string& address);
 
-    // Scanning
+    // Multi-camera rig (camera_rig.h, ADR 0008). Rig cameras are saved
+    // cameras that follow the active camera's bulb frames: while the active
+    // camera is connected, update() links them one at a time (by their saved
+    // handles, so a camera joins once it has been connected as the active
+    // one), retrying a camera that fails every RIG_RETRY_MS. A toggle armed
+    // with armRigToggle() goes out back to back with the active camera's
+    // shutter press in writeControl(). Membership is saved.
+    static constexpr uint32_t RIG_RETRY_MS = 10000;
+    static bool addRigCamera(const std::string& address);
+    static bool removeRigCamera(const std::string& address);
+    static bool isRigCamera(const std::string& address) { return rig.indexOf(address) >= 0; }
+    // Returns how many rig cameras the toggle was armed for.
+    static size_t armRigToggle(bool open) { return rig.arm(open, millis()); }
+    static void disarmRigToggle() { rig.disarm(); }
+    static void resetRigSkew() { rig.resetSkew(); }
+    static const CameraRig& getRig() { return rig; }
+
+    // Scanning (scan_plan.h): a high-duty burst, then a low duty. startScan()
+    // lists the Sony cameras heard in `duration` s; scanForFirstCamera()
+    // stops at the first one.
     static bool startScan(int duration);
+    static bool scanForFirstCamera(int duration);
     static void stopScan();
     static void update();
-    static void clearDiscoveredDevices();
-    static void addDiscoveredDevice(BLEAdvertisedDevice* device);
-    static const std::vector<DeviceInfo>& getDiscoveredDevices();
+    static void clearDiscoveredDevices() { scanTable.clear(); }
+    // Sony cameras heard by the current / last scan, as they are heard.
+    static const ScanTable& getScanTable() { return scanTable; }
     static bool isScanning();
 
+    // Camera link RSSI in dBm (0 while disconnected), refreshed by update()
+    // every RSSI_POLL_INTERVAL_MS. Reading it never touches the radio.
+    static constexpr uint32_t RSSI_POLL_INTERVAL_MS = 5000;
+    static int8_t getLinkRssi() { return linkRssi; }
+
+    // Connection-parameter profile (link_profile.h), re-picked by update().
+    // The app loop feeds the time to the sequence's next bulb toggle
+    // (LinkProfilePolicy::NO_TOGGLE when none); CameraCommands notes every
+    // command it queues, from whichever task sends it.
+    static void setNextToggleIn(uint32_t ms) { nextToggleInMs = ms; }
+    static void noteCommandActivity(uint32_t nowMs) { lastCommandMs.store(nowMs); }
+    // The profile last requested; readable from any task.
+    static LinkProfile getLinkProfile() { return linkProfile.load(); }
+
+    // Reconnects (reconnect_supervisor.h). A ready link that drops on its own
+    // is retried from update() with backoff, whatever screen is up, until it
+    // is back or the user disconnects. Urgent while a frame is exposing (the
+    // app loop sets it): retries then come at least every couple of seconds,
+    // and even with auto-connect off.
+    static void setReconnectUrgent(bool urgent) { reconnectUrgent = urgent; }
+    static bool isReconnecting() { return reconnect.active(); }
+    static uint16_t getReconnectAttempts() { return reconnect.attempts(); }
+
+    // Presence (presence_tracker.h). While the link is down and a camera is
+    // saved, a low-duty passive scan listens for saved cameras advertising;
+    // reconnects wait for the target to show up rather than time out on a
+    // camera that is off. Paused during connects and the user's own scans.
+    static bool isCameraAdvertising(const std::string& address) {
+        return presence.isPresent(address, millis());
+    }
+    // Smoothed advertising RSSI of a saved camera in dBm; 0 if not heard.
+    static int8_t getAdvertisedRssi(const std::string& address) { return presence.rssi(address); }
+    // Every advertisement the scan hears (BLE task): presence, and the scan
+    // table while a discovery scan runs.
+    static void onAdvertisement(BLEAdvertisedDevice& device);
+
     // Auto-connect management
     static void setAutoConnect(bool enable) { autoConnectEnabled = enable; }
     static bool isAutoConnectEnabled() { return autoConnectEnabled; }
@@ -141,26 +272,102 @@ public:
     static bool wasManuallyDisconnected() { return manuallyDisconnected || !autoConnectEnabled; }
 
 private:
-    static BLEClient* pClient;
+    static CameraLink links[MAX_LINKS];
+    // Enough for every link to drop twice within RETIRE_GRACE_MS.
+    static constexpr size_t MAX_RETIRED = 2 * MAX_LINKS;
+    // Left after the disconnect for the client's own handler to finish.
+    static constexpr uint32_t RETIRE_GRACE_MS = 1000;
+    static RetiredClient retired[MAX_RETIRED];
     static BLEAdvertisedDevice* pDevice;
-    static BLERemoteCharacteristic* pRemoteControlChar;
-    static BLERemoteCharacteristic* pRemoteStatusChar;
-    static BLERemoteService* pRemoteService;
     static bool initialized;
-    static bool connected;
     static bool scanning;
     static bool manuallyDisconnected;  // Flag to prevent auto-reconnect after manual disconnect
     static bool autoConnectEnabled;    // Flag to control auto-connect behavior
-    static unsigned long scanEndTime;
+    static int8_t linkRssi;
+    static unsigned long lastRssiPollTime;
     static BLEScan* pBLEScan;
     static std::string lastDeviceAddress;
-    static std::vector<DeviceInfo> discoveredDevices;
+    static ScanTable scanTable;
+    static ScanPlan scanPlan;           // Loop-owned; onAdvertisement() only asks isTarget()
+    static bool scanBurst;              // Running at the burst duty
+    static std::atomic<bool> scanHit;   // Target heard; update() ends the scan
+    static std::string findingAddress;  // connectToAddress() looking before it connects
     static Preferences preferences;
-    static std::string cachedAddress;
+    static std::string cachedAddress;  // Set through setActiveAddress() only
+    static BleAddress activeKey;       // Guarded by activeKeyMutex
+    static std::mutex activeKeyMutex;
     static CameraStore cameraStore;
 
     static void saveDeviceAddress(const std::string& address);
     static void loadDeviceAddress();
+    static void setActiveAddress(const std::string& address);
+    static void serviceLinkProfile();
+    static void serviceReconnect();
+    static bool beginScan(ScanPlan::Goal goal, const BleAddress& target, bool nameKnown,
+                          uint32_t durationMs);
+    static void startScanRadio();
+    static void serviceScan();
+    static void servicePresenceScan();
+    static void stopPresenceScan();
+    static void noteDrop();
+
+    // Connect sequence plumbing, per link.
+    enum class LinkJob : uint8_t { OPEN, DISCOVER };
+    struct LinkRequest {
+        LinkJob job;
+        uint8_t link;
+    };
+    static bool beginConnect(const std::string& address, const std::string& name, bool pairing);
+    static bool startLink(size_t link, const std::string& address, const std::string& name,
+                          const GattHandles& handles, bool pairing);
+    static void queueLinkJob(size_t link, LinkJob job);
+    static void processLinkEvents(size_t link);
+    static void runAction(size_t link, ConnectSequence::Action action);
+    static void completeConnection();
+    static void bindHandles(size_t link);
+    static void finishBind(size_t link, bool bound);
+    static void dropLink(size_t link);
+    static void retireClient(BLEClient* client);
+    static void reapRetiredClients(uint32_t now);
+    static int linkFor(esp_gatt_if_t gattcIf);
+    static int linkFor(const BLEClient* client);
+    static int rigLinkFor(const std::string& address);
+    static void linkTaskMain(void* arg);
+    static void gattcEvent(esp_gattc_cb_event_t event, esp_gatt_if_t gattcIf,
+                           esp_ble_gattc_cb_param_t* param);
+
+    // Rig plumbing.
+    static void serviceRig();
+    static void onRigStatus(size_t link, const uint8_t* data, size_t length);
+    static void onLeaderStatus(const uint8_t* data, size_t length);
+    static void writeRigToggle(uint8_t cameras, bool press, uint32_t startUs);
+    static void publishWriteTarget(size_t link);
+    static void withdrawWriteTarget(size_t link);
+    static void saveRig();
+    static void loadRig();
+
+    static uint32_t connectAttempt;
+    static std::mutex eventMutex;  // Guards the links' event inboxes only
+    static QueueHandle_t linkJobs;
+    static TaskHandle_t linkTask;
+    static volatile bool linkJobRunning;
+    static CameraRig rig;
+    static LinkWriteTarget writeTargets[MAX_LINKS];  // Guarded by writeTargetMutex
+    static std::mutex writeTargetMutex;
+    static bool rigSoloRelease;  // A press went out without the active camera's
+    static uint32_t lastConnectMs;
+    static bool lastConnectCached;
+    static LinkProfilePolicy linkPolicy;          // Loop-owned
+    static std::atomic<LinkProfile> linkProfile;  // linkPolicy.current(), for other tasks
+    static uint32_t nextToggleInMs;
+    static std::atomic<uint32_t> lastCommandMs;
+    static ReconnectSupervisor reconnect;  // Loop-owned
+    static bool reconnectUrgent;
+    static std::atomic<bool> linkDropped;  // Set by noteDrop(), taken by serviceReconnect()
+    static PresenceTracker presence;
+    static bool presenceScanning;
+    static bool presenceUrgent;  // Scanning at the urgent duty
+    static uint32_t presenceStartMs;
 
     // Persist the whole CameraStore (list + active) to NVS under indexed keys.
     static void saveCameraStore();
@@ -3,6 +3,15 @@
 #include <BLE2902.h>
 #include <BLEDevice.h>
 
+#include <algorithm>
+#include <cstring>
+
+#include "processes/astro.h"
+#include "processes/astro_mailbox.h"
+#include "transport/ble_astro_observer.h"
+#include "transport/camera_commands.h"
+#include "utils/astro_clock.h"
+
 // Static member initialization
 BLEServer* BLERemoteServer::pServer = nullptr;
 BLEService* BLERemoteServer::pService = nullptr;
@@ -11,24 +20,100 @@ BLECharacteristic* BLERemoteServer::pFeedbackChar = nullptr;
 BLECharacteristic* BLERemoteServer::pAstroStatusChar = nullptr;
 BLECharacteristic* BLERemoteServer::pAstroControlChar = nullptr;
 BLECharacteristic* BLERemoteServer::pAstroParamsChar = nullptr;
+BLECharacteristic* BLERemoteServer::pAstroTimeChar = nullptr;
+BLECharacteristic* BLERemoteServer::pAstroPlanChar = nullptr;
+BLECharacteristic* BLERemoteServer::pBulkControlChar = nullptr;
+BLECharacteristic* BLERemoteServer::pBulkDataChar = nullptr;
 BLERemoteServer::CommandCallback BLERemoteServer::commandCallback = nullptr;
 bool BLERemoteServer::deviceConnected = false;
 std::map<ButtonId, bool> BLERemoteServer::buttonStates;
 BLERemoteServer::ServerCallbacks BLERemoteServer::serverCallbacks;
 BLERemoteServer::ControlCharCallbacks BLERemoteServer::controlCharCallbacks;
+BLERemoteServer::AstroTimeCharCallbacks BLERemoteServer::astroTimeCharCallbacks;
+BLERemoteServer::AstroPlanCharCallbacks BLERemoteServer::astroPlanCharCallbacks;
+BLERemoteServer::BulkCharCallbacks BLERemoteServer::bulkCharCallbacks;
+BulkTransfer BLERemoteServer::bulkTransfer(
+    [](const uint8_t* data, size_t length) { return notifyBulk(pBulkDataChar, data, length); },
+    [](const uint8_t* data, size_t length) { return notifyBulk(pBulkControlChar, data, length); });
+bool BLERemoteServer::bulkNotifyAccepted = false;
+AstroStatusStream BLERemoteServer::astroStatusStream;
+std::atomic<bool> BLERemoteServer::astroStatusV2{false};
+
+namespace {
+// The frame journal, paged out by sequence number: records appended while a
+// transfer runs wait for the next one, and a record overwritten mid-transfer
+// fails the read rather than being sent in its place.
+class JournalBulkSource : public BulkSource {
+public:
+    uint32_t open() override {
+        uint32_t end = 0;
+        AstroProcess::instance().getJournalRange(first_, end);
+        return (end - first_) * FrameRecord::WIRE_BYTES;
+    }
+
+    size_t read(uint32_t offset, uint8_t* out, size_t max) override {
+        size_t copied = 0;
+        while (copied < max) {
+            const uint32_t index = (offset + copied) / FrameRecord::WIRE_BYTES;
+            const size_t skip = (offset + copied) % FrameRecord::WIRE_BYTES;
+            FrameRecord record;
+            if (!AstroProcess::instance().getJournalRecord(first_ + index, record)) {
+                return 0;
+            }
+            uint8_t wire[FrameRecord::WIRE_BYTES];
+            record.encode(wire);
+            const size_t length = std::min(FrameRecord::WIRE_BYTES - skip, max - copied);
+            memcpy(out + copied, wire + skip, length);
+            copied += length;
+        }
+        return copied;
+    }
+
+private:
+    uint32_t first_ = 0;
+};
+
+JournalBulkSource journalBulkSource;
+
+// Camera-link telemetry, snapshotted when the transfer opens so every window
+// comes from the same moment.
+class LinkStatsBulkSource : public BulkSource {
+public:
+    uint32_t open() override {
+        LinkStats::encode(CameraCommands::linkStats().snapshot(), wire_);
+        return sizeof(wire_);
+    }
+
+    size_t read(uint32_t offset, uint8_t* out, size_t max) override {
+        const size_t length = std::min<size_t>(sizeof(wire_) - offset, max);
+        memcpy(out, wire_ + offset, length);
+        return length;
+    }
+
+private:
+    uint8_t wire_[LinkStats::WIRE_BYTES];
+};
+
+LinkStatsBulkSource linkStatsBulkSource;
+}  // namespace
 
 void BLERemoteServer::init(const char* deviceName) {
     // Initialize BLE
     BLEDevice::init(deviceName);
+    // Offer the largest ATT MTU so bulk chunks can fill whatever the client
+    // negotiates. The local MTU is global: the camera links request it too,
+    // and each camera answers with its own (Sony bodies offer less), so the
+    // smaller applies per link.
+    BLEDevice::setMTU(BulkTransfer::MAX_ATT_MTU);
 
     // Create server
     pServer = BLEDevice::createServer();
     pServer->setCallbacks(&serverCallbacks);
 
-    // Create service. The default handle budget (15) is too small for our five
+    // Create service. The default handle budget (15) is too small for our
     // characteristics once each notify char's CCCD descriptor is counted — the
     // last one (params) then fails to register. Request enough handles up front.
-    pService = pServer->createService(BLEUUID(REMOTE_SERVICE_UUID), 30, 0);
+    pService = pServer->createService(BLEUUID(REMOTE_SERVICE_UUID), 40, 0);
 
     // Create characteristics
     pControlChar =
@@ -57,6 +142,37 @@ void BLERemoteServer::init(const char* deviceName) {
         BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_NOTIFY);
     pAstroParamsChar->addDescriptor(new BLE2902());
 
+    // Wall-clock sync from the remote (AstroTimeSyncPacket) — disciplines the
+    // sequence timebase and sets the RTC.
+    pAstroTimeChar =
+        pService->createCharacteristic(ASTRO_TIME_CHAR_UUID, BLECharacteristic::PROPERTY_WRITE);
+    pAstroTimeChar->setCallbacks(&astroTimeCharCallbacks);
+
+    // Whole sequence plan as one AstroPlan blob: WRITE to load it (acked on
+    // the feedback char), READ/NOTIFY for the plan that start() will run.
+    pAstroPlanChar = pService->createCharacteristic(
+        ASTRO_PLAN_CHAR_UUID, BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_WRITE |
+                                  BLECharacteristic::PROPERTY_NOTIFY);
+    pAstroPlanChar->addDescriptor(new BLE2902());
+    pAstroPlanChar->setCallbacks(&astroPlanCharCallbacks);
+
+    // Bulk transfer (BulkTransfer): requests and events on the control char,
+    // the streamed bytes on the data char. WRITE_NR so credit grants do not
+    // cost the client a round trip each.
+    pBulkControlChar = pService->createCharacteristic(
+        BULK_CONTROL_CHAR_UUID, BLECharacteristic::PROPERTY_WRITE |
+                                    BLECharacteristic::PROPERTY_WRITE_NR |
+                                    BLECharacteristic::PROPERTY_NOTIFY);
+    pBulkControlChar->addDescriptor(new BLE2902());
+    pBulkControlChar->setCallbacks(&bulkCharCallbacks);
+
+    pBulkDataChar =
+        pService->createCharacteristic(BULK_DATA_CHAR_UUID, BLECharacteristic::PROPERTY_NOTIFY);
+    pBulkDataChar->addDescriptor(new BLE2902());
+    pBulkDataChar->setCallbacks(&bulkCharCallbacks);
+    bulkTransfer.setSource(BulkSourceId::FRAME_JOURNAL, &journalBulkSource);
+    bulkTransfer.setSource(BulkSourceId::LINK_STATS, &linkStatsBulkSource);
+
     // Start service and advertising
     pService->start();
     BLEAdvertising* pAdvertising = BLEDevice::getAdvertising();
@@ -88,6 +204,12 @@ void BLERemoteServer::sendAstroStatus(const AstroStatusPacket& status) {
         return;
     }
 
+    if (astroStatusV2) {
+        uint8_t frame[AstroStatusStream::MAX_FRAME_BYTES];
+        publishAstroStatus(frame, astroStatusStream.push(status, millis(), frame));
+        return;
+    }
+
     // Always refresh the value so a READ (poll) returns current data even when
     // no client is connected; only notify when one is.
     pAstroStatusChar->setValue((uint8_t*)&status, sizeof(status));
@@ -96,6 +218,40 @@ void BLERemoteServer::sendAstroStatus(const AstroStatusPacket& status) {
     }
 }
 
+void BLERemoteServer::publishAstroStatus(const uint8_t* frame, size_t length) {
+    if (length && deviceConnected) {
+        pAstroStatusChar->setValue(const_cast<uint8_t*>(frame), length);
+        pAstroStatusChar->notify();
+    }
+    // A READ always gets a full snapshot, never a delta.
+    uint8_t snapshot[AstroStatusStream::MAX_FRAME_BYTES];
+    const size_t snapshotLength = astroStatusStream.snapshot(snapshot);
+    if (snapshotLength) {
+        pAstroStatusChar->setValue(snapshot, snapshotLength);
+    }
+}
+
+void BLERemoteServer::setAstroStatusFormat(uint8_t version, uint8_t flags, size_t payload) {
+    astroStatusV2 = version == 2;
+    astroStatusStream.configure((flags & RemoteCmd::STATUS_FLAG_BATCH) != 0, payload);
+    astroStatusStream.restart();
+    LOG_PERIPHERAL("[BLE] Astro status format v%d%s", version,
+                   (flags & RemoteCmd::STATUS_FLAG_BATCH) ? ", batched" : "");
+    // Current status straight away in the new format (v2: a full snapshot).
+    BLEAstroObserver::instance().onAstroStatusChanged(AstroProcess::instance().getStatus());
+}
+
+void BLERemoteServer::sendAstroPlan(const uint8_t* blob, size_t length) {
+    if (!pAstroPlanChar) {
+        return;
+    }
+
+    pAstroPlanChar->setValue(const_cast<uint8_t*>(blob), length);
+    if (deviceConnected) {
+        pAstroPlanChar->notify();
+    }
+}
+
 void BLERemoteServer::sendAstroParams(const AstroParamPacket& params) {
     if (!pAstroParamsChar) {
         return;
@@ -107,6 +263,33 @@ void BLERemoteServer::sendAstroParams(const AstroParamPacket& params) {
     }
 }
 
+void BLERemoteServer::update() {
+    if (deviceConnected) {
+        bulkTransfer.pump(BULK_CHUNKS_PER_UPDATE);
+    }
+    if (astroStatusV2 && pAstroStatusChar) {
+        uint8_t frame[AstroStatusStream::MAX_FRAME_BYTES];
+        const size_t length = astroStatusStream.flush(millis(), frame);
+        if (length) {
+            publishAstroStatus(frame, length);
+        }
+    }
+}
+
+bool BLERemoteServer::notifyBulk(BLECharacteristic* pCharacteristic, const uint8_t* data,
+                                 size_t length) {
+    if (!pCharacteristic || !deviceConnected) {
+        return false;
+    }
+    // notify() reports the outcome through onStatus() before it returns; a
+    // congested or unsubscribed link leaves bulkNotifyAccepted false, so the
+    // transfer offers the same packet again on a later update().
+    bulkNotifyAccepted = false;
+    pCharacteristic->setValue(const_cast<uint8_t*>(data), length);
+    pCharacteristic->notify();
+    return bulkNotifyAccepted;
+}
+
 bool BLERemoteServer::isConnected() {
     return deviceConnected;
 }
@@ -121,6 +304,9 @@ void BLERemoteServer::stop() {
         pFeedbackChar = nullptr;
         pAstroStatusChar = nullptr;
         pAstroControlChar = nullptr;
+        pBulkControlChar = nullptr;
+        pBulkDataChar = nullptr;
+        bulkTransfer.reset();
         deviceConnected = false;
         LOG_PERIPHERAL("[BLE] Server stopped");
     }
@@ -128,6 +314,7 @@ void BLERemoteServer::stop() {
 
 void BLERemoteServer::ServerCallbacks::onConnect(BLEServer* pServer) {
     deviceConnected = true;
+    astroStatusV2 = false;  // Until this client asks for it
     // Keep advertising while connected. The ESP32 stops advertising on connect
     // by default; if a client goes away uncleanly (tab closed, phone slept) the
     // onDisconnect that would re-advertise may never fire, leaving the stick
@@ -140,6 +327,8 @@ void BLERemoteServer::ServerCallbacks::onConnect(BLEServer* pServer) {
 void BLERemoteServer::ServerCallbacks::onDisconnect(BLEServer* pServer) {
     deviceConnected = false;
     buttonStates.clear();
+    bulkTransfer.reset();
+    astroStatusV2 = false;
     pServer->startAdvertising();
     LOG_PERIPHERAL("[BLE] Client disconnected");
 }
@@ -215,18 +404,99 @@ void BLERemoteServer::ControlCharCallbacks::onWrite(BLECharacteristic* pCharacte
     sendFeedback(CommandStatus::SUCCESS);
 }
 
+void BLERemoteServer::AstroTimeCharCallbacks::onWrite(BLECharacteristic* pCharacteristic) {
+    std::string value = pCharacteristic->getValue();
+    if (value.length() != sizeof(AstroTimeSyncPacket)) {
+        LOG_PERIPHERAL("[BLE] Invalid time sync length: %d", value.length());
+        return;
+    }
+    AstroTimeSyncPacket packet;
+    memcpy(&packet, value.data(), sizeof(packet));
+    AstroClock::sync(packet.epochMs);
+}
+
+void BLERemoteServer::AstroPlanCharCallbacks::onWrite(BLECharacteristic* pCharacteristic) {
+    std::string value = pCharacteristic->getValue();
+    // Posted even if it does not decode: the empty plan left in its place
+    // never validates, so the sequencer answers INVALID and puts the active
+    // plan back on the characteristic the write overwrote.
+    AstroMailbox::Command command;
+    command.cmd = RemoteCmd::ASTRO_SET_PLAN;
+    if (!command.plan.decode(reinterpret_cast<const uint8_t*>(value.data()), value.length())) {
+        LOG_PERIPHERAL("[BLE] Astro plan does not decode (%d bytes)", value.length());
+    }
+    if (!AstroMailbox::post(command)) {
+        LOG_PERIPHERAL("[BLE] Astro mailbox full, plan dropped");
+        sendFeedback(CommandStatus::BUSY);
+    }
+}
+
+void BLERemoteServer::BulkCharCallbacks::onWrite(BLECharacteristic* pCharacteristic) {
+    std::string value = pCharacteristic->getValue();
+    // By the first request the client has finished its MTU exchange; an OPEN
+    // sizes its chunks from it.
+    const uint16_t mtu = pServer->getPeerMTU(pServer->getConnId());
+    bulkTransfer.post(reinterpret_cast<const uint8_t*>(value.data()), value.length(), mtu);
+}
+
+void BLERemoteServer::BulkCharCallbacks::onStatus(BLECharacteristic* pCharacteristic, Status s,
+                                                  uint32_t code) {
+    bulkNotifyAccepted = s == Status::SUCCESS_NOTIFY;
+}
+
 void BLERemoteServer::handleAstroCommand(uint16_t cmd, const uint8_t* data, size_t length) {
     LOG_PERIPHERAL("[BLE] Processing astro command: 0x%04X", cmd);
 
+    // Only validated and posted here, on the BLE task; the sequencer task
+    // runs it and answers on the feedback characteristic with the outcome.
+    AstroMailbox::Command command;
+    command.cmd = cmd;
+
     switch (cmd) {
-        case RemoteCmd::ASTRO_SET_PARAMS:
+        case RemoteCmd::ASTRO_SET_PARAMS: {
             if (length != sizeof(AstroParamPacket)) {
                 LOG_PERIPHERAL("[BLE] Invalid astro params size");
                 sendFeedback(CommandStatus::INVALID);
                 return;
             }
+            AstroParamPacket packet;
+            memcpy(&packet, data, sizeof(packet));
+            command.params.initialDelaySec = packet.initialDelaySec;
+            command.params.exposureSec = packet.exposureSec;
+            command.params.subframeCount = packet.subframeCount;
+            command.params.intervalSec = packet.intervalSec;
+            command.params.adaptiveInterval = packet.adaptiveInterval != 0;
+            command.params.settleMs = packet.settleMs;
+            break;
+        }
+
+        case RemoteCmd::ASTRO_SCHEDULE:
+            if (length != sizeof(uint32_t)) {
+                LOG_PERIPHERAL("[BLE] Invalid astro schedule size");
+                sendFeedback(CommandStatus::INVALID);
+                return;
+            }
+            command.startSec = static_cast<uint32_t>(data[0]) |
+                               (static_cast<uint32_t>(data[1]) << 8) |
+                               (static_cast<uint32_t>(data[2]) << 16) |
+                               (static_cast<uint32_t>(data[3]) << 24);
             break;
 
+        case RemoteCmd::ASTRO_STATUS_FORMAT: {
+            if (length != 2 || data[0] < 1 || data[0] > 2) {
+                LOG_PERIPHERAL("[BLE] Invalid astro status format");
+                sendFeedback(CommandStatus::INVALID);
+                return;
+            }
+            command.statusVersion = data[0];
+            command.statusFlags = data[1];
+            // By now the client has finished its MTU exchange; a batch fills it.
+            const uint16_t mtu = pServer->getPeerMTU(pServer->getConnId());
+            command.statusPayload =
+                mtu > BulkTransfer::ATT_OVERHEAD ? mtu - BulkTransfer::ATT_OVERHEAD : 0;
+            break;
+        }
+
         case RemoteCmd::ASTRO_START:
         case RemoteCmd::ASTRO_PAUSE:
         case RemoteCmd::ASTRO_STOP:
@@ -244,11 +514,10 @@ void BLERemoteServer::handleAstroCommand(uint16_t cmd, const uint8_t* data, size
             return;
     }
 
-    if (commandCallback) {
-        commandCallback(cmd, data, length);
+    if (!AstroMailbox::post(command)) {
+        LOG_PERIPHERAL("[BLE] Astro mailbox full, command 0x%04X dropped", cmd);
+        sendFeedback(CommandStatus::BUSY);
     }
-
-    sendFeedback(CommandStatus::SUCCESS);
 }
 
 bool BLERemoteServer::validateButtonTransition(uint16_t cmd, ButtonId button) {
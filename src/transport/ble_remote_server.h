@@ -4,10 +4,13 @@
 #include <BLEServer.h>
 #include <BLEUtils.h>
 
+#include <atomic>
 #include <functional>
 #include <map>
 
+#include "astro_status_stream.h"
 #include "button_id.h"
+#include "bulk_transfer.h"
 #include "remote_control_manager.h"
 
 // Service and Characteristic UUIDs
@@ -17,6 +20,16 @@
 #define ASTRO_STATUS_CHAR_UUID "180F1003-1234-5678-90AB-CDEF12345678"
 #define ASTRO_CONTROL_CHAR_UUID "180F1004-1234-5678-90AB-CDEF12345678"
 #define ASTRO_PARAMS_CHAR_UUID "180F1005-1234-5678-90AB-CDEF12345678"
+#define ASTRO_TIME_CHAR_UUID "180F1006-1234-5678-90AB-CDEF12345678"
+#define ASTRO_PLAN_CHAR_UUID "180F1007-1234-5678-90AB-CDEF12345678"
+#define BULK_CONTROL_CHAR_UUID "180F1008-1234-5678-90AB-CDEF12345678"
+#define BULK_DATA_CHAR_UUID "180F1009-1234-5678-90AB-CDEF12345678"
+
+// What the bulk channel (BulkTransfer) can stream, by OPEN source id.
+namespace BulkSourceId {
+constexpr uint8_t FRAME_JOURNAL = 0;  // FrameRecord::encode() records, oldest first
+constexpr uint8_t LINK_STATS = 1;     // LinkStats::encode() of the camera link
+}  // namespace BulkSourceId
 
 // Command format (16-bit base command + optional parameters)
 namespace RemoteCmd {
@@ -35,6 +48,14 @@ constexpr uint16_t ASTRO_PAUSE = 0x0201;       // No params
 constexpr uint16_t ASTRO_STOP = 0x0202;        // No params
 constexpr uint16_t ASTRO_RESET = 0x0203;       // No params
 constexpr uint16_t ASTRO_SET_PARAMS = 0x0204;  // + AstroParamPacket
+constexpr uint16_t ASTRO_SCHEDULE = 0x0205;    // + u32 start (Unix sec, LE); 0 cancels
+// + u8 version (1: AstroStatusPacket, 2: AstroStatusStream) + u8 flags. Per
+// connection; every client starts on version 1.
+constexpr uint16_t ASTRO_STATUS_FORMAT = 0x0206;
+constexpr uint8_t STATUS_FLAG_BATCH = 0x01;  // v2: pack deltas into MTU-sized notifications
+// Internal: a write to the astro plan characteristic, as posted to
+// AstroMailbox. Not accepted on the control characteristic.
+constexpr uint16_t ASTRO_SET_PLAN = 0x02F0;
 
 // Helper functions
 constexpr uint8_t getType(uint16_t cmd) {
@@ -61,6 +82,14 @@ struct __attribute__((packed)) AstroParamPacket {
     uint16_t exposureSec;
     uint16_t subframeCount;
     uint16_t intervalSec;
+    uint8_t adaptiveInterval;  // 1 = next frame on SHUTTER_READY + settleMs
+    uint16_t settleMs;
+};
+
+// Wall-clock sync written by the remote to ASTRO_TIME_CHAR_UUID: Unix time
+// in ms (little-endian) at the moment of the write. Feeds AstroClock.
+struct __attribute__((packed)) AstroTimeSyncPacket {
+    uint64_t epochMs;
 };
 
 // Astro status packet structure (sent via notification)
@@ -76,6 +105,17 @@ struct __attribute__((packed)) AstroStatusPacket {
     uint32_t phaseTotalSec;      // Full length of the current phase; 0 when idle/stopped
     uint8_t isCameraConnected;
     uint8_t errorCode;
+    uint16_t framesPerHour;  // Achieved frame cadence; 0 until the second frame opens
+    uint8_t segmentIndex;    // Plan segment being run (0-based)
+    uint8_t segmentCount;
+    uint16_t segmentCompletedFrames;
+    uint16_t segmentTotalFrames;
+    uint32_t scheduledStartTime;  // Armed "start at" (Unix sec); 0 if none
+    uint32_t wakeToFirstFrameMs;  // Scheduled run that slept: wake -> first open
+    uint16_t openSkewMs;          // Rig: latest shutter-open spread across cameras
+    uint16_t maxOpenSkewMs;
+    uint16_t closeSkewMs;
+    uint16_t maxCloseSkewMs;
 };
 
 class BLERemoteServer {
@@ -89,6 +129,13 @@ public:
     static void sendFeedback(CommandStatus status);
     static void sendAstroStatus(const AstroStatusPacket& status);
     static void sendAstroParams(const AstroParamPacket& params);
+    static void sendAstroPlan(const uint8_t* blob, size_t length);  // AstroPlan blob
+    // Switches this connection's astro status notifications to `version`
+    // (RemoteCmd::ASTRO_STATUS_FORMAT) and sends the current status in it.
+    // Sequencer task, from AstroMailbox; `payload` is the link's ATT payload.
+    static void setAstroStatusFormat(uint8_t version, uint8_t flags, size_t payload);
+    // Drive from the app loop: sends the next window of any bulk transfer.
+    static void update();
     static bool isConnected();
     static bool sendCommand16(uint16_t cmd);
     static bool sendCommand24(uint16_t cmd, uint8_t param);
@@ -103,6 +150,10 @@ private:
     static BLECharacteristic* pAstroStatusChar;
     static BLECharacteristic* pAstroControlChar;
     static BLECharacteristic* pAstroParamsChar;
+    static BLECharacteristic* pAstroTimeChar;
+    static BLECharacteristic* pAstroPlanChar;
+    static BLECharacteristic* pBulkControlChar;
+    static BLECharacteristic* pBulkDataChar;
     static CommandCallback commandCallback;
     static bool deviceConnected;
     static std::map<ButtonId, bool> buttonStates;
@@ -121,9 +172,39 @@ private:
         void onWrite(BLECharacteristic* pCharacteristic) override;
     };
 
+    class AstroTimeCharCallbacks : public BLECharacteristicCallbacks {
+        void onWrite(BLECharacteristic* pCharacteristic) override;
+    };
+
+    class AstroPlanCharCallbacks : public BLECharacteristicCallbacks {
+        void onWrite(BLECharacteristic* pCharacteristic) override;
+    };
+
+    // Both bulk chars: requests arrive on the control char's onWrite; onStatus
+    // reports whether each notify made it into the stack (see notifyBulk).
+    class BulkCharCallbacks : public BLECharacteristicCallbacks {
+        void onWrite(BLECharacteristic* pCharacteristic) override;
+        void onStatus(BLECharacteristic* pCharacteristic, Status s, uint32_t code) override;
+    };
+
     static void handleAstroCommand(uint16_t cmd, const uint8_t* data, size_t length);
     static bool validateButtonTransition(uint16_t cmd, ButtonId button);
+    static bool notifyBulk(BLECharacteristic* pCharacteristic, const uint8_t* data, size_t length);
+    static void publishAstroStatus(const uint8_t* frame, size_t length);
 
     static ServerCallbacks serverCallbacks;
     static ControlCharCallbacks controlCharCallbacks;
+    static AstroTimeCharCallbacks astroTimeCharCallbacks;
+    static AstroPlanCharCallbacks astroPlanCharCallbacks;
+    static BulkCharCallbacks bulkCharCallbacks;
+
+    // Chunks per update(): bounds the loop time spent notifying and keeps the
+    // stack's transmit queue from overflowing between connection events.
+    static constexpr size_t BULK_CHUNKS_PER_UPDATE = 4;
+    static BulkTransfer bulkTransfer;
+    static bool bulkNotifyAccepted;
+
+    // Astro status notifications once the client has asked for version 2.
+    static AstroStatusStream astroStatusStream;
+    static std::atomic<bool> astroStatusV2;  // Set by the sequencer, reset on (dis)connect
 };
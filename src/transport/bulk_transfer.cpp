@@ -0,0 +1,178 @@
+#include "transport/bulk_transfer.h"
+
+#include <algorithm>
+
+namespace {
+uint16_t readU16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t readU32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+void writeU16(uint8_t* p, uint16_t value) {
+    p[0] = static_cast<uint8_t>(value);
+    p[1] = static_cast<uint8_t>(value >> 8);
+}
+
+void writeU32(uint8_t* p, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        p[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+constexpr size_t OPEN_BYTES = 8;
+constexpr size_t CREDIT_BYTES = 3;
+constexpr uint16_t MIN_ATT_MTU = 23;  // BLE default before any exchange
+}  // namespace
+
+void BulkTransfer::setSource(uint8_t id, BulkSource* source) {
+    if (id < MAX_SOURCES) {
+        sources_[id] = source;
+    }
+}
+
+void BulkTransfer::post(const uint8_t* data, size_t length, uint16_t attMtu) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const uint8_t op = data && length ? data[0] : 0;
+    if (op == OP_OPEN && length == OPEN_BYTES) {
+        // A new OPEN supersedes anything queued before it.
+        pending_ = Pending{};
+        pending_.open = true;
+        pending_.sourceId = data[1];
+        pending_.offset = readU32(data + 2);
+        pending_.credits = readU16(data + 6);
+        pending_.attMtu = attMtu;
+    } else if (op == OP_CREDIT && length == CREDIT_BYTES) {
+        pending_.credits += readU16(data + 1);
+    } else if (op == OP_ABORT && length == 1) {
+        pending_ = Pending{};
+        pending_.abort = true;
+    } else {
+        pending_.malformed = true;
+    }
+}
+
+void BulkTransfer::reset() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_ = Pending{};
+    }
+    active_ = false;
+    source_ = nullptr;
+    eventLength_ = 0;
+}
+
+size_t BulkTransfer::pump(size_t maxChunks) {
+    applyPending();
+
+    // Events go out ahead of any further data: OPENED must reach the client
+    // before the first chunk, DONE only after the last.
+    if (eventLength_) {
+        if (!sendControl_(event_, eventLength_)) {
+            return 0;
+        }
+        eventLength_ = 0;
+    }
+    if (!active_) {
+        return 0;
+    }
+
+    uint8_t chunk[MAX_ATT_MTU - ATT_OVERHEAD];
+    size_t sent = 0;
+    while (sent < maxChunks && credits_ > 0 && offset_ < total_) {
+        const size_t want = std::min<size_t>(chunkPayload_, total_ - offset_);
+        const size_t length = source_->read(offset_, chunk + DATA_HEADER_BYTES, want);
+        if (length == 0) {
+            fail(Error::SOURCE_FAILED);
+            return sent;
+        }
+        writeU32(chunk, offset_);
+        if (!sendData_(chunk, DATA_HEADER_BYTES + length)) {
+            return sent;  // Congested: this chunk is read and offered again next pump
+        }
+        offset_ += length;
+        credits_--;
+        sent++;
+    }
+
+    if (offset_ >= total_) {
+        uint8_t done[5] = {EVT_DONE};
+        writeU32(done + 1, total_);
+        active_ = false;
+        source_ = nullptr;
+        sendEvent(done, sizeof(done));
+    }
+    return sent;
+}
+
+void BulkTransfer::applyPending() {
+    Pending request;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        request = pending_;
+        pending_ = Pending{};
+    }
+
+    if (request.malformed) {
+        fail(Error::BAD_REQUEST);
+    }
+    if (request.abort) {
+        active_ = false;
+        source_ = nullptr;
+    }
+    if (request.open) {
+        openTransfer(request);
+    } else if (active_) {
+        credits_ = std::min<uint32_t>(credits_ + request.credits, MAX_CREDITS);
+    }
+}
+
+void BulkTransfer::openTransfer(const Pending& request) {
+    active_ = false;
+    BulkSource* source = request.sourceId < MAX_SOURCES ? sources_[request.sourceId] : nullptr;
+    if (!source) {
+        fail(Error::UNKNOWN_SOURCE);
+        return;
+    }
+    const uint32_t total = source->open();
+    if (request.offset > total) {
+        fail(Error::BAD_OFFSET);
+        return;
+    }
+
+    const uint16_t mtu =
+        std::max(MIN_ATT_MTU, std::min<uint16_t>(request.attMtu, MAX_ATT_MTU));
+    active_ = true;
+    source_ = source;
+    sourceId_ = request.sourceId;
+    total_ = total;
+    offset_ = request.offset;
+    credits_ = std::min<uint32_t>(request.credits, MAX_CREDITS);
+    chunkPayload_ = mtu - ATT_OVERHEAD - DATA_HEADER_BYTES;
+
+    uint8_t opened[8] = {EVT_OPENED, sourceId_};
+    writeU32(opened + 2, total_);
+    writeU16(opened + 6, static_cast<uint16_t>(chunkPayload_));
+    sendEvent(opened, sizeof(opened));
+}
+
+bool BulkTransfer::sendEvent(const uint8_t* event, size_t length) {
+    std::copy(event, event + length, event_);
+    eventLength_ = length;
+    // Try straight away; pump() retries a congested event before more data.
+    if (!sendControl_(event_, eventLength_)) {
+        return false;
+    }
+    eventLength_ = 0;
+    return true;
+}
+
+void BulkTransfer::fail(Error error) {
+    active_ = false;
+    source_ = nullptr;
+    const uint8_t event[2] = {EVT_ERROR, static_cast<uint8_t>(error)};
+    sendEvent(event, sizeof(event));
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+
+// Something the bulk channel can stream: a byte image of fixed length,
+// frozen by open() and read back in arbitrary slices.
+class BulkSource {
+public:
+    virtual ~BulkSource() = default;
+    // Start of a transfer: fix the content and return its length in bytes.
+    virtual uint32_t open() = 0;
+    // Copy up to `max` bytes at `offset` (< the length open() returned).
+    // Returns the bytes copied; 0 if the content is no longer available.
+    virtual size_t read(uint32_t offset, uint8_t* out, size_t max) = 0;
+};
+
+// Windowed bulk transfer over a pair of notify channels (the remote link's
+// BULK_CONTROL / BULK_DATA characteristics), independent of the BLE stack so
+// it runs natively against a loopback link.
+//
+// The client opens a source at a byte offset with an initial credit window;
+// every data chunk spends one credit and the client grants more as it drains
+// them, so the stick never outruns the client. Chunks fill the negotiated ATT
+// MTU. Requests arrive on the BLE task and are only queued; pump(), called
+// from the app loop, applies them and sends at most `maxChunks` per call, so
+// neither side blocks. Everything is little-endian:
+//
+//   request  OPEN    u8 0x01 | u8 sourceId | u32 offset | u16 credits
+//            CREDIT  u8 0x02 | u16 credits
+//            ABORT   u8 0x03
+//   event    OPENED  u8 0x81 | u8 sourceId | u32 totalBytes | u16 chunkPayload
+//            DONE    u8 0x82 | u32 totalBytes
+//            ERROR   u8 0x83 | u8 BulkTransfer::Error
+//   data     u32 offset | payload (<= chunkPayload bytes)
+//
+// A client that loses the link re-OPENs at the first offset it is missing.
+class BulkTransfer {
+public:
+    // Called with a finished packet; false if the link did not take it
+    // (congested), in which case the same packet is offered again later.
+    using SendFn = std::function<bool(const uint8_t* data, size_t length)>;
+
+    enum class Error : uint8_t {
+        NONE,
+        BAD_REQUEST,     // Malformed or unknown request
+        UNKNOWN_SOURCE,  // No source registered under that id
+        BAD_OFFSET,      // OPEN offset past the end of the source
+        SOURCE_FAILED,   // The content changed under the transfer (e.g. overwritten)
+    };
+
+    static constexpr uint8_t OP_OPEN = 0x01;
+    static constexpr uint8_t OP_CREDIT = 0x02;
+    static constexpr uint8_t OP_ABORT = 0x03;
+    static constexpr uint8_t EVT_OPENED = 0x81;
+    static constexpr uint8_t EVT_DONE = 0x82;
+    static constexpr uint8_t EVT_ERROR = 0x83;
+
+    static constexpr size_t MAX_SOURCES = 4;
+    static constexpr size_t DATA_HEADER_BYTES = 4;  // u32 offset
+    static constexpr uint16_t ATT_OVERHEAD = 3;     // Notification opcode + handle
+    static constexpr uint16_t MAX_ATT_MTU = 517;
+    static constexpr uint16_t MAX_CREDITS = 255;  // Outstanding window cap
+
+    BulkTransfer(SendFn sendData, SendFn sendControl)
+        : sendData_(std::move(sendData)), sendControl_(std::move(sendControl)) {}
+
+    void setSource(uint8_t id, BulkSource* source);
+
+    // BLE task: queue a client request. attMtu is the link's negotiated MTU
+    // at the time (sizes the chunks of an OPEN).
+    void post(const uint8_t* data, size_t length, uint16_t attMtu);
+    // Client gone: drop the transfer and anything queued.
+    void reset();
+
+    // App loop: apply queued requests, then send up to maxChunks data chunks
+    // (plus any due event). Returns the data chunks the link accepted.
+    size_t pump(size_t maxChunks);
+
+    bool isActive() const { return active_; }
+
+private:
+    struct Pending {
+        bool open = false;
+        bool abort = false;
+        bool malformed = false;
+        uint8_t sourceId = 0;
+        uint32_t offset = 0;
+        uint16_t attMtu = 0;
+        uint32_t credits = 0;  // From OPEN plus every CREDIT since
+    };
+
+    void applyPending();
+    void openTransfer(const Pending& request);
+    bool sendEvent(const uint8_t* event, size_t length);
+    void fail(Error error);
+
+    SendFn sendData_;
+    SendFn sendControl_;
+    BulkSource* sources_[MAX_SOURCES] = {};
+
+    std::mutex mutex_;  // Guards pending_ only; the rest is app-loop state
+    Pending pending_;
+
+    bool active_ = false;
+    BulkSource* source_ = nullptr;
+    uint8_t sourceId_ = 0;
+    uint32_t total_ = 0;
+    uint32_t offset_ = 0;
+    uint32_t credits_ = 0;
+    size_t chunkPayload_ = 0;
+    // One event (OPENED/DONE/ERROR) waiting for the control link.
+    uint8_t event_[8] = {};
+    size_t eventLength_ = 0;
+};
@@ -2,91 +2,307 @@
 
 #include <Arduino.h>
 
+#include <atomic>
+#include <mutex>
+
 #include "transport/ble_device.h"
+#include "transport/command_queue.h"
+#include "utils/spsc_ring.h"
 
 namespace CameraCommands {
-// Static variables
-static uint8_t focusStatus = Status::FOCUS_LOST;
-static uint8_t shutterStatus = Status::SHUTTER_READY;
-static uint8_t recordingStatus = Status::RECORD_STOPPED;
+// Camera state as of the last status event pollStatus() applied. Written by
+// whichever task polls, read by the UI loop and the sequencer.
+static std::atomic<uint8_t> focusStatus{Status::FOCUS_LOST};
+static std::atomic<uint8_t> shutterStatus{Status::SHUTTER_READY};
+static std::atomic<uint8_t> recordingStatus{Status::RECORD_STOPPED};
 static FocusMode currentMode = FocusMode::AUTO_FOCUS;
 static bool focusHeld = false;
-static uint32_t lastMessageTime = 0;
-static uint32_t lastCheck = 0;
-static bool statusNotificationEnabled = false;
+static std::atomic<uint32_t> lastMessageTime{0};
+
+// Notifications leave the BLE callback as timestamped events (producer: the
+// BLE task, consumer: pollStatus() under statusMutex). Shutter edges go on to
+// the sequencer through their own ring (consumer: nextShutterEdge()).
+struct StatusEvent {
+    uint32_t atMs;
+    uint8_t length;  // Of the notification; only the first 3 bytes are kept
+    uint8_t bytes[3];
+};
+static SpscRing<StatusEvent, 32> statusEvents;
+static SpscRing<ShutterEdge, 16> shutterEdges;
+static std::mutex statusMutex;
+
+// Shutter timing. A bulb toggle stamps toggleSentAt; the next shutter status
+// edge is its confirmation and feeds the active camera's latency estimate.
+static std::atomic<uint32_t> shutterChangedAt{0};
+static std::atomic<uint32_t> toggleSentAt{0};
+static std::atomic<bool> toggleAwaitingStatus{false};
+// takePhoto() holds the shutter until the camera reports the capture done.
+static std::atomic<bool> photoAwaitingCapture{false};
+// emergencyStop() and how long its confirmation from the camera may take.
+static EmergencyState emergencyState = EmergencyState::NONE;
+static uint32_t emergencyAt = 0;
+constexpr uint32_t EMERGENCY_CONFIRM_MS = 1000;
+
+using Lane = CommandQueue::Lane;
+using Outcome = CommandQueue::Outcome;
+
+// Every command to the camera goes through here (see command_queue.h).
+static CommandQueue commandQueue([](const uint8_t* data, size_t length, bool withResponse) {
+    return BLEDeviceManager::writeControl(data, length, withResponse);
+});
+
+// Button hold times, timed by the queue between a press and its release.
+constexpr uint16_t LENS_HOLD_MS = 30;  // Sets the size of a focus/zoom step
+constexpr uint16_t RECORD_HOLD_MS = 100;
+constexpr uint16_t PHOTO_MAX_HOLD_MS = 2000;  // Release anyway if the capture goes unreported
+
+static Lane laneFor(uint16_t cmd) {
+    if (cmd >= Cmd::SHUTTER_HALF_UP && cmd <= Cmd::SHUTTER_FULL_DOWN) {
+        return Lane::SHUTTER;
+    }
+    if (cmd >= Cmd::ZOOM_TELE_RELEASE) {
+        return Lane::LENS;  // Zoom and focus
+    }
+    return Lane::CONTROL;
+}
 
-// Command sending implementation
-bool sendCommand16(uint16_t cmd) {
-    if (!BLEDeviceManager::isConnected()) {
-        LOG_PERIPHERAL("[Camera] Not connected");
-        return false;
+static LinkStats stats;
+using CommandClass = LinkStats::CommandClass;
+
+// The telemetry class a command is timed under; false for ones not tracked
+// (C1).
+static bool classFor(uint16_t cmd, CommandClass& out) {
+    switch (cmd) {
+        case Cmd::SHUTTER_FULL_UP:
+        case Cmd::SHUTTER_FULL_DOWN:
+            out = CommandClass::SHUTTER;
+            return true;
+        case Cmd::SHUTTER_HALF_UP:
+        case Cmd::SHUTTER_HALF_DOWN:
+        case Cmd::AF_ON_UP:
+        case Cmd::AF_ON_DOWN:
+            out = CommandClass::FOCUS;
+            return true;
+        case Cmd::RECORD_UP:
+        case Cmd::RECORD_DOWN:
+            out = CommandClass::RECORD;
+            return true;
+        default:
+            break;
+    }
+    if (cmd >= Cmd::ZOOM_TELE_RELEASE && cmd <= Cmd::ZOOM_WIDE_PRESS) {
+        out = CommandClass::ZOOM;
+        return true;
+    }
+    if (cmd >= Cmd::FOCUS_IN_RELEASE && cmd <= Cmd::FOCUS_OUT_PRESS) {
+        out = CommandClass::FOCUS;
+        return true;
     }
+    return false;
+}
 
-    BLERemoteCharacteristic* pChar = BLEDeviceManager::getControlCharacteristic();
-    if (!pChar) {
-        LOG_PERIPHERAL("[Camera] Control characteristic not available");
-        return false;
+// Presses the camera answers with a status notification (onStatusNotification
+// reports them back to the stats).
+static bool expectsStatus(uint16_t cmd) {
+    switch (cmd) {
+        case Cmd::SHUTTER_FULL_DOWN:
+        case Cmd::RECORD_DOWN:
+            return true;
+        case Cmd::SHUTTER_HALF_DOWN:
+        case Cmd::AF_ON_DOWN:
+            return focusStatus != Status::FOCUS_ACQUIRED;  // Already acquired: nothing to report
+        default:
+            return false;
     }
+}
 
-    // Simple 2-byte format: [CMD_MSB CMD_LSB]
-    uint8_t cmdBuffer[] = {
-        (uint8_t)(cmd >> 8),   // Command MSB
-        (uint8_t)(cmd & 0xFF)  // Command LSB
+// Times a command for the link stats, chaining its own completion. Held
+// releases only count sent / failed: their hold is not link latency.
+static void track(CommandQueue::Command& command, uint32_t now) {
+    const uint16_t cmd = command.bytes[0] << 8 | command.bytes[1];
+    CommandClass cls;
+    if (!classFor(cmd, cls)) {
+        return;
+    }
+    stats.recordSubmit(cls, now, expectsStatus(cmd));
+    const bool timed = command.holdMs == 0;
+    command.done = [cls, now, timed, done = std::move(command.done)](Outcome outcome) {
+        if (outcome == Outcome::FAILED) {
+            stats.recordWrite(cls, false, 0);
+        } else if (outcome == Outcome::WRITTEN && timed) {
+            stats.recordWrite(cls, true, millis() - now);
+        }
+        if (done) {
+            done(outcome);
+        }
     };
+}
 
-    // Debug output
-    char logText[64];
-    snprintf(logText, sizeof(logText), "[Camera] Sending command 0x%04X: [", cmd);
-    for (size_t i = 0; i < sizeof(cmdBuffer); i++) {
-        snprintf(logText + strlen(logText), sizeof(logText) - strlen(logText), "%02X%s",
-                 cmdBuffer[i], i < sizeof(cmdBuffer) - 1 ? " " : "");
+static uint16_t holdFor(uint16_t cmd) {
+    switch (cmd) {
+        case Cmd::ZOOM_TELE_RELEASE:
+        case Cmd::ZOOM_WIDE_RELEASE:
+        case Cmd::FOCUS_IN_RELEASE:
+        case Cmd::FOCUS_OUT_RELEASE:
+            return LENS_HOLD_MS;
+        case Cmd::RECORD_UP:
+            return RECORD_HOLD_MS;
+        default:
+            return 0;
     }
-    strcat(logText, "]");
-    LOG_PERIPHERAL("%s", logText);
+}
 
-    // Try writing with response
-    try {
-        pChar->writeValue(cmdBuffer, sizeof(cmdBuffer), true);
-        LOG_PERIPHERAL("[Camera] Command 0x%04X sent successfully", cmd);
-        return true;
-    } catch (const std::exception& e) {
-        LOG_PERIPHERAL("[Camera] Failed to send command: %s", e.what());
-        return false;
-    }
+// param < 0: a 2-byte command.
+static CommandQueue::Command makeCommand(uint16_t cmd, int param, bool withResponse) {
+    CommandQueue::Command command;
+    command.bytes[0] = static_cast<uint8_t>(cmd >> 8);
+    command.bytes[1] = static_cast<uint8_t>(cmd & 0xFF);
+    command.length = 2;
+    if (param >= 0) {
+        command.bytes[command.length++] = static_cast<uint8_t>(param);
+    }
+    command.withResponse = withResponse;
+    command.holdMs = holdFor(cmd);
+    return command;
 }
 
-bool sendCommand24(uint16_t cmd, uint8_t param) {
+// Queue commands on the first one's lane, all or nothing.
+static bool submit(CommandQueue::Command* commands, size_t count) {
     if (!BLEDeviceManager::isConnected()) {
         LOG_PERIPHERAL("[Camera] Not connected");
         return false;
     }
-
-    BLERemoteCharacteristic* pChar = BLEDeviceManager::getControlCharacteristic();
-    if (!pChar) {
-        LOG_PERIPHERAL("[Camera] Control characteristic not available");
+    const uint16_t first = commands[0].bytes[0] << 8 | commands[0].bytes[1];
+    const uint32_t now = millis();
+    BLEDeviceManager::noteCommandActivity(now);  // Holds the link on low latency
+    for (size_t i = 0; i < count; i++) {
+        track(commands[i], now);
+    }
+    if (!commandQueue.submit(laneFor(first), commands, count, now)) {
+        LOG_PERIPHERAL("[Camera] Command queue full, 0x%04X dropped", first);
+        for (size_t i = 0; i < count; i++) {
+            CommandClass cls;
+            if (classFor(commands[i].bytes[0] << 8 | commands[i].bytes[1], cls)) {
+                stats.recordWrite(cls, false, 0);
+            }
+        }
         return false;
     }
+    return true;
+}
 
-    uint8_t cmdBuffer[] = {
-        (uint8_t)(cmd >> 8),    // Command MSB
-        (uint8_t)(cmd & 0xFF),  // Command LSB
-        param                   // Parameter
-    };
+// A button press and its release. When the camera takes writes without
+// response the pair leaves in one go, with no round trip between them.
+static bool submitPress(uint16_t press, int pressParam, uint16_t release, int releaseParam,
+                        CommandQueue::DoneFn pressDone = nullptr) {
+    const bool withResponse = !BLEDeviceManager::controlWritesWithoutResponse();
+    CommandQueue::Command pair[] = {makeCommand(press, pressParam, withResponse),
+                                    makeCommand(release, releaseParam, withResponse)};
+    pair[0].done = std::move(pressDone);
+    return submit(pair, 2);
+}
 
-    // Debug output
-    char logText[128];
-    snprintf(logText, sizeof(logText), "[Camera] Sending command [0x%02X 0x%02X 0x%02X]",
-             cmdBuffer[0], cmdBuffer[1], cmdBuffer[2]);
-    LOG_PERIPHERAL("%s", logText);
+struct CameraLatency {
+    BleAddress address;
+    bool used = false;
+    ShutterLatency latency;
+};
+// Guarded by statusMutex: timed in pollStatus(), read by the sequencer.
+static CameraLatency latencies[CameraStore::MAX_CAMERAS];
 
-    try {
-        pChar->writeValue(cmdBuffer, sizeof(cmdBuffer), true);
-    } catch (const std::exception& e) {
-        LOG_PERIPHERAL("[Camera] Error sending command: %s", e.what());
-        return false;
+// EWMA weight 1/4: settles in a handful of frames, shrugs off one slow event.
+static uint32_t smoothLatency(uint32_t estimate, uint16_t samples, uint32_t sample) {
+    return samples == 0 ? sample : (estimate * 3 + sample) / 4;
+}
+
+// `address`'s slot, or nullptr if it has none yet. Caller holds statusMutex.
+static CameraLatency* findLatency(const BleAddress& address) {
+    for (auto& entry : latencies) {
+        if (entry.used && entry.address == address) {
+            return &entry;
+        }
     }
+    return nullptr;
+}
 
-    return true;
+// `address`'s slot, claiming (or recycling the oldest) one if new. Caller
+// holds statusMutex.
+static ShutterLatency& claimLatency(const BleAddress& address) {
+    if (CameraLatency* entry = findLatency(address)) {
+        return entry->latency;
+    }
+    for (auto& entry : latencies) {
+        if (!entry.used) {
+            entry = CameraLatency{address, true, ShutterLatency{}};
+            return entry.latency;
+        }
+    }
+    for (size_t i = CameraStore::MAX_CAMERAS - 1; i > 0; i--) {
+        latencies[i] = latencies[i - 1];
+    }
+    latencies[0] = CameraLatency{address, true, ShutterLatency{}};
+    return latencies[0].latency;
+}
+
+static void recordShutterChange(uint8_t newStatus, uint32_t now) {
+    shutterChangedAt = now;
+    if (!toggleAwaitingStatus) {
+        return;  // Camera-side change (e.g. physical shutter), not ours to time.
+    }
+    toggleAwaitingStatus = false;
+    ShutterLatency& l = claimLatency(BLEDeviceManager::activeCameraKey());
+    const uint32_t sample = now - toggleSentAt;
+    if (newStatus == Status::SHUTTER_ACTIVE) {
+        l.openMs = smoothLatency(l.openMs, l.openSamples, sample);
+        if (l.openSamples < UINT16_MAX) {
+            l.openSamples++;
+        }
+    } else {
+        l.closeMs = smoothLatency(l.closeMs, l.closeSamples, sample);
+        if (l.closeSamples < UINT16_MAX) {
+            l.closeSamples++;
+        }
+    }
+    LOG_PERIPHERAL("[Camera] Shutter %s after %lu ms",
+                   newStatus == Status::SHUTTER_ACTIVE ? "opened" : "closed",
+                   (unsigned long)sample);
+}
+
+// Command sending implementation
+bool sendCommand16(uint16_t cmd) {
+    LOG_PERIPHERAL("[Camera] Sending command 0x%04X", cmd);
+    CommandQueue::Command command = makeCommand(cmd, -1, true);
+    return submit(&command, 1);
+}
+
+bool sendCommand24(uint16_t cmd, uint8_t param) {
+    LOG_PERIPHERAL("[Camera] Sending command 0x%04X 0x%02X", cmd, param);
+    CommandQueue::Command command = makeCommand(cmd, param, true);
+    return submit(&command, 1);
+}
+
+static void serviceEmergency(uint32_t now);
+
+void service() {
+    pollStatus();
+    const uint32_t now = millis();
+    commandQueue.pump(now);
+    serviceEmergency(now);
+}
+
+void onControlWriteAck(bool ok) {
+    if (!ok) {
+        LOG_PERIPHERAL("[Camera] Command rejected by camera");
+    }
+    commandQueue.onWriteAck(ok, millis());
+}
+
+void onLinkLost() {
+    commandQueue.clear();
+    photoAwaitingCapture = false;
+    if (emergencyState == EmergencyState::CONFIRMING) {
+        emergencyState = EmergencyState::UNCONFIRMED;
+    }
 }
 
 // State change handlers
@@ -123,29 +339,18 @@ void handleRecordingStateChange(uint8_t prevState, uint8_t newState) {
 bool takePhoto() {
     LOG_PERIPHERAL("[Camera] Take photo");
 
-    // Step 1: Press shutter
-    if (!sendCommand16(Cmd::SHUTTER_FULL_DOWN)) {
+    // Full press, held until the camera reports the capture (the shutter
+    // going ready again), when onStatusNotification() releases it early.
+    const bool withResponse = !BLEDeviceManager::controlWritesWithoutResponse();
+    CommandQueue::Command pair[] = {makeCommand(Cmd::SHUTTER_FULL_DOWN, -1, withResponse),
+                                    makeCommand(Cmd::SHUTTER_FULL_UP, -1, withResponse)};
+    pair[1].holdMs = PHOTO_MAX_HOLD_MS;
+    photoAwaitingCapture = true;
+    if (!submit(pair, 2)) {
+        photoAwaitingCapture = false;
         LOG_PERIPHERAL("[Camera] Failed to press shutter");
         return false;
     }
-
-    // Step 2: Wait for shutter active notification
-    while (!isShutterActive()) {
-        delay(10);
-    }
-
-    // Step 3: Wait for shutter ready notification
-    while (isShutterActive()) {
-        delay(10);
-    }
-
-    // Step 4: Release shutter
-    if (!sendCommand16(Cmd::SHUTTER_FULL_UP)) {
-        LOG_PERIPHERAL("[Camera] Failed to release shutter");
-        return false;
-    }
-
-    LOG_PERIPHERAL("[Camera] Photo taken successfully");
     return true;
 };
 
@@ -155,148 +360,136 @@ bool triggerBulb() {
     // astro sequence calls this once to start a frame and once to end it.
     LOG_PERIPHERAL("[Camera] Trigger bulb (toggle)");
 
-    if (!sendCommand16(Cmd::SHUTTER_FULL_DOWN)) {
-        LOG_PERIPHERAL("[Camera] Failed to press shutter");
-        return false;
-    }
-
-    if (!sendCommand16(Cmd::SHUTTER_FULL_UP)) {
-        LOG_PERIPHERAL("[Camera] Failed to release shutter");
+    toggleSentAt = millis();
+    toggleAwaitingStatus = true;
+    const bool queued = submitPress(Cmd::SHUTTER_FULL_DOWN, -1, Cmd::SHUTTER_FULL_UP, -1,
+                                    [](Outcome outcome) {
+                                        if (outcome != Outcome::WRITTEN) {
+                                            toggleAwaitingStatus = false;
+                                            LOG_PERIPHERAL("[Camera] Failed to press shutter");
+                                        }
+                                    });
+    if (!queued) {
+        toggleAwaitingStatus = false;
         return false;
     }
-
-    LOG_PERIPHERAL("[Camera] Bulb toggle sent");
     return true;
 };
 
+size_t armRigToggle(bool open) {
+    return BLEDeviceManager::armRigToggle(open);
+}
+
+void disarmRigToggle() {
+    BLEDeviceManager::disarmRigToggle();
+}
+
+TriggerSkewReport getTriggerSkew() {
+    const CameraRig& rig = BLEDeviceManager::getRig();
+    return TriggerSkewReport{rig.openSkew(), rig.closeSkew()};
+}
+
+void resetTriggerSkew() {
+    BLEDeviceManager::resetRigSkew();
+}
+
 bool recordStart() {
     LOG_PERIPHERAL("[Camera] Starting recording");
-    // Press record button
-    if (!sendCommand16(Cmd::RECORD_DOWN)) {
-        LOG_PERIPHERAL("[Camera] Failed to start recording - DOWN failed");
-        return false;
-    }
-    delay(100);  // Small delay between down and up
-    // Release record button
-    if (!sendCommand16(Cmd::RECORD_UP)) {
-        LOG_PERIPHERAL("[Camera] Failed to start recording - UP failed");
-        return false;
-    }
-    return true;
+    return submitPress(Cmd::RECORD_DOWN, -1, Cmd::RECORD_UP, -1);
 }
 
 bool recordStop() {
     LOG_PERIPHERAL("[Camera] Stopping recording");
-    // Press record button again
-    if (!sendCommand16(Cmd::RECORD_DOWN)) {
-        LOG_PERIPHERAL("[Camera] Failed to stop recording - DOWN failed");
-        return false;
-    }
-    delay(100);  // Small delay between down and up
-    // Release record button
-    if (!sendCommand16(Cmd::RECORD_UP)) {
-        LOG_PERIPHERAL("[Camera] Failed to stop recording - UP failed");
-        return false;
-    }
-    return true;
+    // Same button again
+    return submitPress(Cmd::RECORD_DOWN, -1, Cmd::RECORD_UP, -1);
 }
 
+// The hold between press and release (LENS_HOLD_MS) sets how far one step
+// moves at the given sensitivity.
 bool zoomOut(uint8_t sensitivity) {
-    // Send zoom out press command
-    if (!sendCommand24(Cmd::ZOOM_WIDE_PRESS, sensitivity)) {
-        LOG_PERIPHERAL("[Camera] Failed to send zoom out press command");
-        return false;
-    }
-
-    delay(30);  // This delay determines the length of the change with the specified sensitivity
-
-    // Send zoom out release command
-    if (!sendCommand24(Cmd::ZOOM_WIDE_RELEASE, 0x00)) {
-        LOG_PERIPHERAL("[Camera] Failed to send zoom out release command");
-        return false;
-    }
-
-    return true;
+    return submitPress(Cmd::ZOOM_WIDE_PRESS, sensitivity, Cmd::ZOOM_WIDE_RELEASE, 0x00);
 }
 
 bool zoomIn(uint8_t sensitivity) {
-    // Send zoom in press command
-    if (!sendCommand24(Cmd::ZOOM_TELE_PRESS, sensitivity)) {
-        LOG_PERIPHERAL("[Camera] Failed to send zoom in press command");
-        return false;
-    }
-
-    delay(30);  // This delay determines the length of the change with the specified sensitivity
-
-    // Send zoom in release command
-    if (!sendCommand24(Cmd::ZOOM_TELE_RELEASE, 0x00)) {
-        LOG_PERIPHERAL("[Camera] Failed to send zoom in release command");
-        return false;
-    }
-
-    return true;
+    return submitPress(Cmd::ZOOM_TELE_PRESS, sensitivity, Cmd::ZOOM_TELE_RELEASE, 0x00);
 }
 
 bool focusIn(uint8_t sensitivity) {
     LOG_PERIPHERAL("[Camera] Sending focus in command");
-
-    if (!sendCommand24(Cmd::FOCUS_IN_PRESS, sensitivity)) {
-        LOG_PERIPHERAL("[Camera] Failed to send focus in press command");
-        return false;
-    }
-
-    delay(30);  // This delay determines the length of the change with the specified sensitivity
-
-    if (!sendCommand24(Cmd::FOCUS_IN_RELEASE, 0x00)) {
-        LOG_PERIPHERAL("[Camera] Failed to send focus in release command");
-        return false;
-    }
-
-    return true;
+    return submitPress(Cmd::FOCUS_IN_PRESS, sensitivity, Cmd::FOCUS_IN_RELEASE, 0x00);
 }
 
 bool focusOut(uint8_t sensitivity) {
     LOG_PERIPHERAL("[Camera] Sending focus out command");
+    return submitPress(Cmd::FOCUS_OUT_PRESS, sensitivity, Cmd::FOCUS_OUT_RELEASE, 0x00);
+}
 
-    if (!sendCommand24(Cmd::FOCUS_OUT_PRESS, sensitivity)) {
-        LOG_PERIPHERAL("[Camera] Failed to send focus out press command");
-        return false;
-    }
-
-    delay(30);  // This delay determines the length of the change with the specified sensitivity
+// Every button release, built once: emergencyStop() only sets the write type.
+// Shutter first, then the rest in order of harm done by a stuck button.
+static CommandQueue::Command releaseFrames[] = {makeCommand(Cmd::SHUTTER_FULL_UP, -1, false),
+                                                makeCommand(Cmd::SHUTTER_HALF_UP, -1, false),
+                                                makeCommand(Cmd::RECORD_UP, -1, false),
+                                                makeCommand(Cmd::AF_ON_UP, -1, false),
+                                                makeCommand(Cmd::ZOOM_TELE_RELEASE, 0, false),
+                                                makeCommand(Cmd::ZOOM_WIDE_RELEASE, 0, false),
+                                                makeCommand(Cmd::FOCUS_IN_RELEASE, 0, false),
+                                                makeCommand(Cmd::FOCUS_OUT_RELEASE, 0, false),
+                                                makeCommand(Cmd::C1_UP, -1, false)};
+constexpr size_t RELEASE_FRAME_COUNT = sizeof(releaseFrames) / sizeof(releaseFrames[0]);
 
-    if (!sendCommand24(Cmd::FOCUS_OUT_RELEASE, 0x00)) {
-        LOG_PERIPHERAL("[Camera] Failed to send focus out release command");
+bool emergencyStop() {
+    if (!BLEDeviceManager::isConnected()) {
+        LOG_PERIPHERAL("[Camera] Emergency stop: not connected");
         return false;
     }
+    // Back to back ahead of anything queued, without waiting on any response.
+    // A camera that refuses writes without response still gets them
+    // pipelined; their responses are ignored.
+    const bool withResponse = !BLEDeviceManager::controlWritesWithoutResponse();
+    for (auto& frame : releaseFrames) {
+        frame.withResponse = withResponse;  // preempt() ignores the lens holds
+    }
+    const uint32_t startUs = micros();
+    const size_t sent = commandQueue.preempt(releaseFrames, RELEASE_FRAME_COUNT, millis());
+    const uint32_t elapsedUs = micros() - startUs;
+    BLEDeviceManager::noteCommandActivity(millis());
+
+    photoAwaitingCapture = false;
+    toggleAwaitingStatus = false;
+    emergencyState = EmergencyState::CONFIRMING;
+    emergencyAt = millis();
+    // Handed to the stack here; on air at the next connection event, which
+    // on the power-save profile can be a whole slow interval away.
+    const LinkProfile profile = BLEDeviceManager::getLinkProfile();
+    LOG_PERIPHERAL("[Camera] Emergency stop: %u/%u releases sent in %lu us, on air in %lu ms (%s)",
+                   (unsigned)sent, (unsigned)RELEASE_FRAME_COUNT, (unsigned long)elapsedUs,
+                   (unsigned long)LinkProfilePolicy::maxEventGapMs(profile),
+                   LinkProfilePolicy::name(profile));
+    return sent == RELEASE_FRAME_COUNT;
+}
 
-    return true;
+EmergencyState getEmergencyState() {
+    return emergencyState;
 }
 
-// Emergency stop for zoom/focus
-bool emergencyStop() {
-    LOG_PERIPHERAL("[Camera] Emergency stop - sending all possible release commands");
-
-    // Send all possible release commands
-    const uint16_t RELEASE_COMMANDS[] = {Cmd::SHUTTER_HALF_UP,
-                                         Cmd::SHUTTER_FULL_UP,
-                                         Cmd::RECORD_UP,
-                                         Cmd::AF_ON_UP,
-                                         Cmd::C1_UP,
-                                         Cmd::ZOOM_TELE_RELEASE,
-                                         Cmd::ZOOM_WIDE_RELEASE,
-                                         Cmd::FOCUS_IN_RELEASE,
-                                         Cmd::FOCUS_OUT_RELEASE};
-
-    for (uint16_t cmd : RELEASE_COMMANDS) {
-        LOG_PERIPHERAL("[Camera] Sending release command 0x%04X", cmd);
-        if (!sendCommand24(cmd, 0x00)) {
-            LOG_PERIPHERAL("[Camera] Failed to send release command");
-        }
-        delay(100);
+// Confirms an emergency stop from the camera's own status: the shutter back
+// to ready (notifications only come on change, so one already ready counts).
+static void serviceEmergency(uint32_t now) {
+    if (emergencyState != EmergencyState::CONFIRMING) {
+        return;
     }
-
-    return true;
+    if (shutterStatus == Status::SHUTTER_READY) {
+        emergencyState = EmergencyState::CONFIRMED;
+    } else if (now - emergencyAt >= EMERGENCY_CONFIRM_MS) {
+        emergencyState = EmergencyState::UNCONFIRMED;
+    } else {
+        return;
+    }
+    LOG_PERIPHERAL("[Camera] Emergency stop %s after %lu ms: shutter %s, %s",
+                   emergencyState == EmergencyState::CONFIRMED ? "confirmed" : "NOT confirmed",
+                   (unsigned long)(now - emergencyAt),
+                   shutterStatus == Status::SHUTTER_READY ? "ready" : "active",
+                   recordingStatus == Status::RECORD_STARTED ? "still recording" : "not recording");
 }
 
 void init() {
@@ -304,53 +497,17 @@ void init() {
     focusStatus = Status::FOCUS_LOST;
     shutterStatus = Status::SHUTTER_READY;
     recordingStatus = Status::RECORD_STOPPED;
-    statusNotificationEnabled = false;
     focusHeld = false;
     currentMode = FocusMode::AUTO_FOCUS;
     lastMessageTime = 0;
+    shutterChangedAt = 0;
+    toggleAwaitingStatus = false;
+    photoAwaitingCapture = false;
+    emergencyState = EmergencyState::NONE;
 
     LOG_PERIPHERAL("[Camera] Initialized");
 }
 
-void update() {
-    // Add periodic status check
-    if (millis() - lastCheck > 1000) {  // Check every second
-        lastCheck = millis();
-        if (BLEDeviceManager::isConnected() && !statusNotificationEnabled) {
-            LOG_DEBUG("[Camera] Attempting to re-enable notifications...");
-            // Register for status notifications
-            BLERemoteCharacteristic* pChar = BLEDeviceManager::getStatusCharacteristic();
-            if (pChar) {
-                // Enable notifications explicitly
-                if (pChar->canNotify()) {
-                    LOG_DEBUG("[Camera] Enabling notifications...");
-
-                    // Try to enable notifications
-                    if (!pChar->getDescriptor(BLEUUID((uint16_t)0x2902))) {
-                        LOG_DEBUG("[Camera] Warning: Could not find CCCD descriptor");
-                    }
-
-                    // Register callback and enable
-                    pChar->registerForNotify(onStatusNotification);
-                    try {
-                        pChar->getDescriptor(BLEUUID((uint16_t)0x2902))
-                            ->writeValue((uint8_t*)"\x01\x00", 2, true);
-                        statusNotificationEnabled = true;
-                        LOG_DEBUG("[Camera] Status notifications enabled successfully");
-                    } catch (const std::exception& e) {
-                        LOG_DEBUG("[Camera] Failed to enable notifications: %s", e.what());
-                    }
-                } else {
-                    LOG_DEBUG(
-                        "[Camera] Error: Status characteristic does not support notifications!");
-                }
-            } else {
-                LOG_DEBUG("[Camera] Error: Status characteristic not available!");
-            }
-        }
-    }
-}
-
 bool isFocusAcquired() {
     return focusStatus == Status::FOCUS_ACQUIRED;
 }
@@ -363,71 +520,107 @@ bool isRecording() {
     return recordingStatus == Status::RECORD_STARTED;
 }
 
+uint32_t getShutterChangeTime() {
+    return shutterChangedAt;
+}
+
+ShutterLatency getShutterLatency() {
+    const BleAddress address = BLEDeviceManager::activeCameraKey();
+    std::lock_guard<std::mutex> lock(statusMutex);
+    const CameraLatency* entry = findLatency(address);
+    return entry ? entry->latency : ShutterLatency{};
+}
+
+LinkStats& linkStats() {
+    return stats;
+}
+
 uint32_t getLastMessageTime() {
     return lastMessageTime;
 }
 
-void onStatusNotification(BLERemoteCharacteristic* pChar, uint8_t* pData, size_t length,
-                          bool isNotify) {
-    // Debug: Print raw notification data
-    char logText[128];
-    snprintf(logText, sizeof(logText), "[Camera] Raw notification received from %s: [",
-             pChar->getUUID().toString().c_str());
-    for (size_t i = 0; i < length; i++) {
-        snprintf(logText + strlen(logText), sizeof(logText) - strlen(logText), "%02X%s", pData[i],
-                 i < length - 1 ? " " : "");
-    }
-    strcat(logText, "]");
-    LOG_DEBUG("%s", logText);
+void onStatusNotification(const uint8_t* pData, size_t length) {
+    // BLE task: stamp and hand off, nothing else (see pollStatus()).
+    StatusEvent event{millis(), static_cast<uint8_t>(length > UINT8_MAX ? UINT8_MAX : length), {}};
+    memcpy(event.bytes, pData, length < sizeof(event.bytes) ? length : sizeof(event.bytes));
+    statusEvents.push(event);
+}
 
-    // Update last message time
-    lastMessageTime = millis();
+static void applyStatus(const StatusEvent& event) {
+    LOG_DEBUG("[Camera] Status at %lu: %02X %02X %02X (%u bytes)", (unsigned long)event.atMs,
+              event.bytes[0], event.bytes[1], event.bytes[2], event.length);
+    lastMessageTime = event.atMs;
 
     // Process RemoteCommand 0xFF02 responses
-    if (length >= 3 && pData[0] == 0x02) {
-        uint8_t statusType = pData[1];
-        uint8_t statusValue = pData[2];
-
-        switch (statusType) {
-            case Status::FOCUS_TYPE:  // 0x3F
-                if (statusValue == Status::FOCUS_LOST) {
-                    LOG_PERIPHERAL("[Camera] Focus lost");
-                    focusStatus = Status::FOCUS_LOST;
-                } else if (statusValue == Status::FOCUS_ACQUIRED) {
-                    LOG_PERIPHERAL("[Camera] Focus acquired");
-                    focusStatus = Status::FOCUS_ACQUIRED;
-                }
-                break;
+    if (event.length < 3 || event.bytes[0] != 0x02) {
+        return;  // Other notifications are only logged
+    }
+    const uint8_t statusType = event.bytes[1];
+    const uint8_t statusValue = event.bytes[2];
+
+    switch (statusType) {
+        case Status::FOCUS_TYPE:  // 0x3F
+            if (statusValue == Status::FOCUS_LOST) {
+                LOG_PERIPHERAL("[Camera] Focus lost");
+                focusStatus = Status::FOCUS_LOST;
+            } else if (statusValue == Status::FOCUS_ACQUIRED) {
+                LOG_PERIPHERAL("[Camera] Focus acquired");
+                focusStatus = Status::FOCUS_ACQUIRED;
+                stats.recordStatus(CommandClass::FOCUS, event.atMs);
+            }
+            break;
 
-            case Status::SHUTTER_TYPE:  // 0xA0
-                if (statusValue == Status::SHUTTER_READY) {
-                    LOG_PERIPHERAL("[Camera] Shutter ready");
-                    shutterStatus = Status::SHUTTER_READY;
-                } else if (statusValue == Status::SHUTTER_ACTIVE) {
-                    LOG_PERIPHERAL("[Camera] Shutter active");
-                    shutterStatus = Status::SHUTTER_ACTIVE;
-                }
+        case Status::SHUTTER_TYPE:  // 0xA0
+            if (statusValue != Status::SHUTTER_READY && statusValue != Status::SHUTTER_ACTIVE) {
                 break;
-
-            case Status::RECORD_TYPE:  // 0xD5
-                if (statusValue == Status::RECORD_STOPPED) {
-                    LOG_PERIPHERAL("[Camera] Recording stopped");
-                    recordingStatus = Status::RECORD_STOPPED;
-                } else if (statusValue == Status::RECORD_STARTED) {
-                    LOG_PERIPHERAL("[Camera] Recording started");
-                    recordingStatus = Status::RECORD_STARTED;
+            }
+            LOG_PERIPHERAL("[Camera] Shutter %s",
+                           statusValue == Status::SHUTTER_ACTIVE ? "active" : "ready");
+            if (shutterStatus != statusValue) {
+                shutterStatus = statusValue;
+                recordShutterChange(statusValue, event.atMs);
+                stats.recordStatus(CommandClass::SHUTTER, event.atMs);
+                shutterEdges.push({event.atMs, statusValue == Status::SHUTTER_ACTIVE});
+                if (statusValue == Status::SHUTTER_READY && photoAwaitingCapture) {
+                    photoAwaitingCapture = false;
+                    commandQueue.expedite(Lane::SHUTTER);
+                    commandQueue.pump(millis());
                 }
-                break;
+            }
+            break;
 
-            default:
-                LOG_DEBUG("[Camera] Unknown status type: 0x%02X value: 0x%02X", statusType,
-                          statusValue);
-                break;
-        }
-    } else {
-        // Just log other notifications for debugging
-        LOG_DEBUG("[Camera] Other notification from %s, length=%d",
-                  pChar->getUUID().toString().c_str(), length);
+        case Status::RECORD_TYPE:  // 0xD5
+            if (statusValue != recordingStatus) {
+                stats.recordStatus(CommandClass::RECORD, event.atMs);
+            }
+            if (statusValue == Status::RECORD_STOPPED) {
+                LOG_PERIPHERAL("[Camera] Recording stopped");
+                recordingStatus = Status::RECORD_STOPPED;
+            } else if (statusValue == Status::RECORD_STARTED) {
+                LOG_PERIPHERAL("[Camera] Recording started");
+                recordingStatus = Status::RECORD_STARTED;
+            }
+            break;
+
+        default:
+            LOG_DEBUG("[Camera] Unknown status type: 0x%02X value: 0x%02X", statusType,
+                      statusValue);
+            break;
     }
 }
+
+size_t pollStatus() {
+    std::lock_guard<std::mutex> lock(statusMutex);
+    size_t applied = 0;
+    StatusEvent event;
+    while (statusEvents.pop(event)) {
+        applyStatus(event);
+        applied++;
+    }
+    return applied;
+}
+
+bool nextShutterEdge(ShutterEdge& edge) {
+    return shutterEdges.pop(edge);
+}
 }  // namespace CameraCommands
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "transport/ble_device.h"
+#include "transport/link_stats.h"
+#include "transport/trigger_skew.h"
 
 namespace CameraCommands {
 // Command codes (2-byte format)
@@ -58,17 +60,54 @@ constexpr uint8_t RECORD_STARTED = 0x20;  // 0x02 D5 20
 // Focus modes
 enum class FocusMode { AUTO_FOCUS, MANUAL_FOCUS };
 
+// Rolling estimate of how long the active camera takes to report a bulb
+// toggle: from the SHUTTER_FULL_DOWN write to the matching 0x02 A0 status
+// notification. Kept per saved camera; 0 samples means no estimate yet.
+struct ShutterLatency {
+    uint32_t openMs = 0;   // toggle -> SHUTTER_ACTIVE
+    uint32_t closeMs = 0;  // toggle -> SHUTTER_READY
+    uint16_t openSamples = 0;
+    uint16_t closeSamples = 0;
+};
+
+// Outcome of the last emergencyStop(), from the camera's status notifications.
+enum class EmergencyState { NONE, CONFIRMING, CONFIRMED, UNCONFIRMED };
+
 // Interface functions
 void init();
-void update();
 bool takePhoto();
 bool triggerBulb();  // One bulb toggle (open OR close); call twice per frame.
+// Have the rig cameras (ADR 0008) follow the next bulb toggle toward `open`:
+// their toggles go out with the active camera's press, or on their own
+// shortly after if it needs none. Returns how many rig cameras will toggle.
+size_t armRigToggle(bool open);
+// Call off an armed rig toggle whose bulb toggle was not sent.
+void disarmRigToggle();
+// How far apart the rig's shutters moved on each toggle (trigger_skew.h),
+// since the last reset; AstroProcess resets it per sequence.
+struct TriggerSkewReport {
+    TriggerSkew::Stats open;
+    TriggerSkew::Stats close;
+};
+TriggerSkewReport getTriggerSkew();
+void resetTriggerSkew();
 bool recordStart();
 bool recordStop();
 bool isFocusAcquired();
 bool isShutterActive();
 bool isRecording();
 
+// millis() of the latest shutter status change (open or close notification).
+uint32_t getShutterChangeTime();
+// Latency estimate for the active camera (see ShutterLatency).
+ShutterLatency getShutterLatency();
+
+// Link telemetry since boot: per-class command latency histograms (submit ->
+// write ack, submit -> matching status), RSSI and connect / drop counts. The
+// transport feeds the link samples; the web remote reads it over the bulk
+// channel.
+LinkStats& linkStats();
+
 // Focus control functions
 bool focusIn(uint8_t sensitivity = 0x25);   // sensitivity: 0x01 (min) to 0x7F (max)
 bool focusOut(uint8_t sensitivity = 0x25);  // sensitivity: 0x01 (min) to 0x7F (max)
@@ -77,16 +116,45 @@ bool focusOut(uint8_t sensitivity = 0x25);  // sensitivity: 0x01 (min) to 0x7F (
 bool zoomIn(uint8_t sensitivity = 0x10);   // sensitivity: 0x10 (min) to 0x7F (max)
 bool zoomOut(uint8_t sensitivity = 0x10);  // sensitivity: 0x10 (min) to 0x7F (max)
 
-// Status notification handler
-void onStatusNotification(BLERemoteCharacteristic* pChar, uint8_t* pData, size_t length,
-                          bool isNotify);
-
-// Internal functions
+// A shutter status change, stamped with millis() when its notification
+// arrived.
+struct ShutterEdge {
+    uint32_t atMs;
+    bool open;  // SHUTTER_ACTIVE; false = back to SHUTTER_READY
+};
+
+// Status handler: 0xFF02 notifications and the 0xCC05 read on connect. Runs
+// on the BLE task and only queues a timestamped event, lock-free.
+void onStatusNotification(const uint8_t* pData, size_t length);
+// Apply the queued status events in order: update the state the is*()
+// getters report and queue the shutter edges. Called by service() on the UI
+// loop and by the astro sequencer before each tick; returns the events applied.
+size_t pollStatus();
+// Next shutter edge in arrival order, so a short open/close between two polls
+// is not lost. Single consumer: the astro sequencer.
+bool nextShutterEdge(ShutterEdge& edge);
+
+// Commands never block: they are queued (transport/command_queue.h) and go
+// out as the link allows. True if queued; a camera-side failure shows up in
+// the log and in the missing status change. A release sent on its own is
+// held the usual time after its lane's previous command (e.g. focus steps).
 bool sendCommand16(uint16_t cmd);
 bool sendCommand24(uint16_t cmd, uint8_t param);
+
+// Transport hooks (BLEDeviceManager): drive timed releases and ack timeouts,
+// report a command write's response, and drop the queue with the link.
+void service();
+void onControlWriteAck(bool ok);
+void onLinkLost();
+
+// Internal functions
 void handleFocusStateChange(uint8_t prevState, uint8_t newState);
 void handleShutterStateChange(uint8_t prevState, uint8_t newState);
 void handleRecordingStateChange(uint8_t prevState, uint8_t newState);
 
+// Every button release, back to back ahead of anything queued and without
+// waiting on responses (CommandQueue::preempt). True if the link took them
+// all; getEmergencyState() then follows the camera's confirmation.
 bool emergencyStop();
+EmergencyState getEmergencyState();
 };  // namespace CameraCommands
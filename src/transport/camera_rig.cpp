@@ -0,0 +1,206 @@
+#include "transport/camera_rig.h"
+
+bool CameraRig::add(const std::string& address) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < count_; i++) {
+        if (cameras_[i].address == address) {
+            return false;
+        }
+    }
+    if (count_ == MAX_CAMERAS) {
+        return false;
+    }
+    cameras_[count_] = Camera{};
+    cameras_[count_].address = address;
+    count_++;
+    return true;
+}
+
+bool CameraRig::remove(const std::string& address) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < count_; i++) {
+        if (cameras_[i].address != address) {
+            continue;
+        }
+        for (size_t j = i + 1; j < count_; j++) {
+            cameras_[j - 1] = cameras_[j];
+        }
+        count_--;
+        // Indexes moved: nothing armed or pressed still means the same camera.
+        armed_ = 0;
+        pressed_ = 0;
+        return true;
+    }
+    return false;
+}
+
+void CameraRig::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    count_ = 0;
+    armed_ = 0;
+    pressed_ = 0;
+}
+
+int CameraRig::indexOf(const std::string& address) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < count_; i++) {
+        if (cameras_[i].address == address) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+size_t CameraRig::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return count_;
+}
+
+CameraRig::Camera CameraRig::camera(size_t index) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return index < count_ ? cameras_[index] : Camera{};
+}
+
+void CameraRig::setLinked(size_t index, bool linked) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (index >= count_) {
+        return;
+    }
+    Camera& camera = cameras_[index];
+    camera.linked = linked;
+    camera.shutter = Shutter::UNKNOWN;
+    camera.awaiting = false;
+    armed_ &= ~(1u << index);
+    pressed_ &= ~(1u << index);
+}
+
+void CameraRig::onShutter(size_t index, bool open, uint32_t nowMs) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (index >= count_) {
+        return;
+    }
+    Camera& camera = cameras_[index];
+    camera.shutter = open ? Shutter::OPEN : Shutter::CLOSED;
+    if (camera.awaiting && camera.awaitingOpen == open) {
+        camera.awaiting = false;
+        camera.latencyMs = nowMs - camera.toggleMs;
+    }
+    skew_.onEdge(index + 1, open, nowMs);
+}
+
+void CameraRig::onLeaderShutter(bool open, uint32_t nowMs) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    skew_.onEdge(0, open, nowMs);
+}
+
+size_t CameraRig::arm(bool open, uint32_t nowMs) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint8_t mask = 0;
+    size_t armed = 0;
+    for (size_t i = 0; i < count_; i++) {
+        const Camera& camera = cameras_[i];
+        const bool isOpen = camera.shutter == Shutter::OPEN;
+        if (camera.linked && isOpen != open) {
+            mask |= 1u << i;
+            armed++;
+        }
+    }
+    armed_ = mask;
+    armedOpen_ = open;
+    armedMs_ = nowMs;
+    return armed;
+}
+
+void CameraRig::disarm() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    armed_ = 0;
+}
+
+uint8_t CameraRig::takePress(uint32_t nowMs, bool withLeader) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const uint8_t mask = armed_;
+    armed_ = 0;
+    for (size_t i = 0; i < count_; i++) {
+        if (mask & (1u << i)) {
+            Camera& camera = cameras_[i];
+            camera.awaiting = true;
+            camera.awaitingOpen = armedOpen_;
+            camera.toggleMs = nowMs;
+            camera.toggles++;
+        }
+    }
+    pressed_ |= mask;
+    if (mask) {
+        skew_.begin(armedOpen_, static_cast<uint8_t>(mask << 1 | (withLeader ? 1 : 0)), nowMs);
+    }
+    return mask;
+}
+
+bool CameraRig::armExpired(uint32_t nowMs) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return armed_ != 0 && nowMs - armedMs_ >= ARM_TIMEOUT_MS;
+}
+
+uint8_t CameraRig::takeRelease() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const uint8_t mask = pressed_;
+    pressed_ = 0;
+    return mask;
+}
+
+void CameraRig::writeFailed(size_t index) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (index >= count_) {
+        return;
+    }
+    cameras_[index].awaiting = false;
+    cameras_[index].failures++;
+}
+
+size_t CameraRig::poll(uint32_t nowMs) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t timedOut = 0;
+    for (size_t i = 0; i < count_; i++) {
+        Camera& camera = cameras_[i];
+        if (camera.awaiting && nowMs - camera.toggleMs >= CONFIRM_TIMEOUT_MS) {
+            camera.awaiting = false;
+            camera.failures++;
+            timedOut++;
+        }
+    }
+    skew_.poll(nowMs);
+    return timedOut;
+}
+
+TriggerSkew::Stats CameraRig::openSkew() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return skew_.opens();
+}
+
+TriggerSkew::Stats CameraRig::closeSkew() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return skew_.closes();
+}
+
+void CameraRig::resetSkew() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    skew_.reset();
+}
+
+void CameraRig::recordBurst(uint32_t spreadUs) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    lastSpreadUs_ = spreadUs;
+    if (spreadUs > maxSpreadUs_) {
+        maxSpreadUs_ = spreadUs;
+    }
+}
+
+uint32_t CameraRig::lastSpreadUs() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lastSpreadUs_;
+}
+
+uint32_t CameraRig::maxSpreadUs() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return maxSpreadUs_;
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+#include "transport/trigger_skew.h"
+
+// The other cameras of a multi-camera rig: saved cameras that follow the
+// active camera's bulb frames over links of their own (ADR 0008). Each one
+// keeps its own link state, shutter state (from its status notifications)
+// and toggle outcomes, so one camera failing does not hold up the others.
+//
+// A toggle is armed for the whole rig ahead of the active camera's and goes
+// out in the same burst as the active camera's press: arm() picks the
+// cameras to toggle, takePress() / takeRelease() hand them to the writes.
+// Each camera gets a toggle only when its reported shutter is not already
+// where the toggle is heading (ADR 0003); a camera not heard from yet counts
+// as closed, so it is opened but never closed blind. Its next status
+// notification confirms the toggle, or CONFIRM_TIMEOUT_MS counts a failure.
+// Each toggle's skew (trigger_skew.h) is measured across the rig cameras and
+// the active camera, as camera 0, when the press went out with its own.
+//
+// Links report from the BLE task, toggles are armed from the sequencer and
+// written wherever the active camera's command queue pumps; a mutex covers
+// all of it. Pure (no BLE types).
+class CameraRig {
+public:
+    static constexpr size_t MAX_CAMERAS = 2;  // Besides the active camera
+    static constexpr uint32_t CONFIRM_TIMEOUT_MS = 3000;
+    // An armed toggle the active camera's press has not carried by then goes
+    // out on its own (the active camera's shutter needed no toggle).
+    static constexpr uint32_t ARM_TIMEOUT_MS = 250;
+
+    enum class Shutter : uint8_t { UNKNOWN, CLOSED, OPEN };
+
+    struct Camera {
+        std::string address;
+        bool linked = false;
+        Shutter shutter = Shutter::UNKNOWN;
+        bool awaiting = false;  // Toggled; its status has not confirmed it yet
+        bool awaitingOpen = false;
+        uint32_t toggleMs = 0;
+        uint16_t toggles = 0;
+        uint16_t failures = 0;   // Refused writes and unconfirmed toggles
+        uint32_t latencyMs = 0;  // Last toggle to its confirmation
+    };
+
+    // Membership. add() is false if the camera is already in or the rig is
+    // full; indexes are positions, shifted down by remove().
+    bool add(const std::string& address);
+    bool remove(const std::string& address);
+    void clear();
+    int indexOf(const std::string& address) const;  // -1 if not in the rig
+    size_t size() const;
+    Camera camera(size_t index) const;
+
+    // Link up or down. Either way the shutter is unknown until the camera
+    // reports it, and a toggle still awaited is dropped.
+    void setLinked(size_t index, bool linked);
+    // A shutter status notification from the camera.
+    void onShutter(size_t index, bool open, uint32_t nowMs);
+    // One from the active camera, for the skew.
+    void onLeaderShutter(bool open, uint32_t nowMs);
+
+    // Arm a toggle heading `open` for every linked camera that needs one.
+    // Returns how many were armed; 0 leaves nothing armed.
+    size_t arm(bool open, uint32_t nowMs);
+    void disarm();
+    // The cameras (bitmask by index) to press now, as the active camera's
+    // press goes out (withLeader) or the arm times out; they are then
+    // awaiting their confirmation and due a release. 0 if nothing is armed.
+    uint8_t takePress(uint32_t nowMs, bool withLeader);
+    bool armExpired(uint32_t nowMs) const;
+    // The cameras pressed and not yet released.
+    uint8_t takeRelease();
+    // A camera's press or release did not reach it.
+    void writeFailed(size_t index);
+    // Confirmation timeouts; returns how many toggles timed out.
+    size_t poll(uint32_t nowMs);
+
+    // Shutter-edge skew per toggle, opens and closes apart.
+    TriggerSkew::Stats openSkew() const;
+    TriggerSkew::Stats closeSkew() const;
+    void resetSkew();
+
+    // Spread of the last press burst, in µs, from the first write handed to
+    // the radio to the last; and the worst seen.
+    void recordBurst(uint32_t spreadUs);
+    uint32_t lastSpreadUs() const;
+    uint32_t maxSpreadUs() const;
+
+private:
+    mutable std::mutex mutex_;
+    Camera cameras_[MAX_CAMERAS];
+    size_t count_ = 0;
+    uint8_t armed_ = 0;
+    bool armedOpen_ = false;
+    uint32_t armedMs_ = 0;
+    uint8_t pressed_ = 0;
+    uint32_t lastSpreadUs_ = 0;
+    uint32_t maxSpreadUs_ = 0;
+    TriggerSkew skew_;  // Camera 0 is the active camera, rig camera i is i + 1
+};
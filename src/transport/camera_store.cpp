@@ -29,7 +29,7 @@ bool CameraStore::add(const std::string& address, const std::string& name) {
     if (isFull()) {
         return false;
     }
-    list.push_back(SavedCamera{address, name});
+    list.push_back(SavedCamera{address, name, GattHandles{}});
     return true;
 }
 
@@ -50,3 +50,12 @@ void CameraStore::setActive(const std::string& address) {
         activeAddr = address;
     }
 }
+
+bool CameraStore::setHandles(const std::string& address, const GattHandles& handles) {
+    SavedCamera* cam = findMutable(address);
+    if (!cam || cam->handles == handles) {
+        return false;
+    }
+    cam->handles = handles;
+    return true;
+}
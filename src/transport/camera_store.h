@@ -1,14 +1,36 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 #include <string>
 #include <vector>
 
+// ATT handles of the Sony remote service, as discovered on a camera. A
+// camera's GATT layout does not change between connections, so a reconnect
+// binds these directly instead of rediscovering; 0 = unknown.
+struct GattHandles {
+    uint16_t control = 0;     // 0xFF01, commands
+    uint16_t status = 0;      // 0xFF02, status notifications
+    uint16_t statusCccd = 0;  // 0xFF02's client configuration descriptor
+    uint16_t statusRead = 0;  // 0xCC05, readable status (optional)
+    bool controlWriteNoResponse = false;  // 0xFF01 also takes writes without response
+
+    // Enough to drive the camera without discovery.
+    bool valid() const { return control && status && statusCccd; }
+    bool operator==(const GattHandles& o) const {
+        return control == o.control && status == o.status && statusCccd == o.statusCccd &&
+               statusRead == o.statusRead && controlWriteNoResponse == o.controlWriteNoResponse;
+    }
+    bool operator!=(const GattHandles& o) const { return !(*this == o); }
+};
+
 // A remembered Sony camera: its BLE address plus the advertised name captured
-// when it was first paired. (Glossary: "Saved camera".)
+// when it was first paired, and its GATT handles once a connect has
+// discovered them. (Glossary: "Saved camera".)
 struct SavedCamera {
     std::string address;
     std::string name;
+    GattHandles handles;
 };
 
 // Pure in-memory model of the remote's remembered cameras and which one is
@@ -34,6 +56,10 @@ public:
     // Point "active" at a saved camera. Ignored if the address is not saved.
     void setActive(const std::string& address);
 
+    // Record (or, with GattHandles{}, drop) a saved camera's handles. Returns
+    // true only if the stored handles changed, i.e. the store needs saving.
+    bool setHandles(const std::string& address, const GattHandles& handles);
+
     bool hasActive() const { return !activeAddr.empty(); }
     const std::string& activeAddress() const { return activeAddr; }
 
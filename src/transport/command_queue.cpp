@@ -0,0 +1,180 @@
+#include "transport/command_queue.h"
+
+bool CommandQueue::submit(Lane lane, const Command* commands, size_t count, uint32_t nowMs) {
+    Completion completions[MAX_COMPLETIONS];
+    size_t completed = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        LaneState& state = lanes_[static_cast<size_t>(lane)];
+        if (state.size + count > LANE_CAPACITY) {
+            return false;
+        }
+        for (size_t i = 0; i < count; i++) {
+            state.ring[(state.head + state.size) % LANE_CAPACITY] = commands[i];
+            state.size++;
+        }
+        pumpLocked(nowMs, completions, completed);
+    }
+    finish(completions, completed);
+    return true;
+}
+
+size_t CommandQueue::pump(uint32_t nowMs) {
+    Completion completions[MAX_COMPLETIONS];
+    size_t completed = 0;
+    size_t sent;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (inFlight_ && nowMs - inFlightSentMs_ >= ACK_TIMEOUT_MS) {
+            // The ack never came; give up on it so the queue keeps moving.
+            inFlight_ = false;
+            completions[completed++] = {std::move(inFlightDone_), Outcome::FAILED};
+        }
+        sent = pumpLocked(nowMs, completions, completed);
+    }
+    finish(completions, completed);
+    return sent;
+}
+
+void CommandQueue::onWriteAck(bool ok, uint32_t nowMs) {
+    Completion completions[MAX_COMPLETIONS];
+    size_t completed = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (staleAcks_ && nowMs - staleSinceMs_ < ACK_TIMEOUT_MS) {
+            staleAcks_--;  // Answers a write preempt() abandoned or fired
+            return;
+        }
+        staleAcks_ = 0;
+        if (!inFlight_) {
+            return;  // Already timed out or dropped
+        }
+        inFlight_ = false;
+        completions[completed++] = {std::move(inFlightDone_),
+                                    ok ? Outcome::WRITTEN : Outcome::FAILED};
+        // The request slot is free: the next write goes now, not on the next pump.
+        pumpLocked(nowMs, completions, completed);
+    }
+    finish(completions, completed);
+}
+
+void CommandQueue::expedite(Lane lane) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    LaneState& state = lanes_[static_cast<size_t>(lane)];
+    if (state.size) {
+        state.ring[state.head].holdMs = 0;
+    }
+}
+
+void CommandQueue::clear() {
+    Completion completions[MAX_COMPLETIONS];
+    size_t completed = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        staleAcks_ = 0;
+        dropLocked(completions, completed);
+    }
+    finish(completions, completed);
+}
+
+size_t CommandQueue::preempt(const Command* commands, size_t count, uint32_t nowMs) {
+    Completion completions[MAX_COMPLETIONS];
+    size_t completed = 0;
+    size_t sent = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        staleSinceMs_ = nowMs;
+        if (inFlight_) {
+            staleAcks_++;  // Its ack may still come; it must not free the slot
+        }
+        dropLocked(completions, completed);
+        for (size_t i = 0; i < count; i++) {
+            if (write_(commands[i].bytes, commands[i].length, commands[i].withResponse)) {
+                sent++;
+                if (commands[i].withResponse) {
+                    staleAcks_++;
+                }
+            }
+        }
+    }
+    finish(completions, completed);
+    return sent;
+}
+
+size_t CommandQueue::pending() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t total = 0;
+    for (const LaneState& state : lanes_) {
+        total += state.size;
+    }
+    return total;
+}
+
+bool CommandQueue::awaitingAck() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return inFlight_;
+}
+
+size_t CommandQueue::pumpLocked(uint32_t nowMs, Completion* completions, size_t& completed) {
+    size_t sent = 0;
+    for (;;) {
+        // Highest-priority lane whose head is due and can go on the link now.
+        LaneState* next = nullptr;
+        for (LaneState& state : lanes_) {
+            if (!state.size) {
+                continue;
+            }
+            const Command& head = state.ring[state.head];
+            if (nowMs - state.lastSentMs < head.holdMs || (head.withResponse && inFlight_)) {
+                continue;
+            }
+            next = &state;
+            break;
+        }
+        if (!next) {
+            return sent;
+        }
+
+        Command command = std::move(next->ring[next->head]);
+        next->ring[next->head] = Command{};
+        next->head = (next->head + 1) % LANE_CAPACITY;
+        next->size--;
+        next->lastSentMs = nowMs;
+
+        if (!write_(command.bytes, command.length, command.withResponse)) {
+            completions[completed++] = {std::move(command.done), Outcome::FAILED};
+            continue;
+        }
+        sent++;
+        if (command.withResponse) {
+            inFlight_ = true;
+            inFlightSentMs_ = nowMs;
+            inFlightDone_ = std::move(command.done);
+        } else {
+            completions[completed++] = {std::move(command.done), Outcome::WRITTEN};
+        }
+    }
+}
+
+void CommandQueue::dropLocked(Completion* completions, size_t& completed) {
+    if (inFlight_) {
+        inFlight_ = false;
+        completions[completed++] = {std::move(inFlightDone_), Outcome::DROPPED};
+    }
+    for (LaneState& state : lanes_) {
+        for (; state.size; state.size--) {
+            Command& command = state.ring[state.head];
+            completions[completed++] = {std::move(command.done), Outcome::DROPPED};
+            command = Command{};
+            state.head = (state.head + 1) % LANE_CAPACITY;
+        }
+    }
+}
+
+void CommandQueue::finish(Completion* completions, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        if (completions[i].done) {
+            completions[i].done(completions[i].outcome);
+        }
+    }
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+
+// Bounded queue of camera commands in front of the control characteristic,
+// independent of the BLE stack so the ordering rules run natively.
+//
+// Commands go into one of three lanes, each FIFO. Whenever the link can take
+// a write, the highest-priority lane with a due head goes first, so a shutter
+// toggle never waits behind focus or zoom steps that are still queued. A
+// command's holdMs is the minimum gap after the previous command of its lane
+// went out: a button release is queued straight behind its press and the
+// queue times the hold, instead of the caller sleeping through it.
+//
+// ATT allows one write request in flight; a write-with-response holds the
+// link's request slot until onWriteAck() (or ACK_TIMEOUT_MS). Writes without
+// response need no slot and go out back to back.
+//
+// Thread-safe: commands are submitted from the UI loop and the sequencer
+// task, acks arrive on the BLE task. The write function is called under the
+// queue's lock and must not block or call back into the queue; completion
+// callbacks run after the lock is released.
+class CommandQueue {
+public:
+    enum class Lane : uint8_t {
+        SHUTTER,  // Highest: half/full press and release
+        CONTROL,  // Record, AF-ON, custom buttons
+        LENS,     // Focus and zoom steps
+    };
+
+    enum class Outcome : uint8_t {
+        WRITTEN,  // Acknowledged (with response) or handed to the link (without)
+        FAILED,   // The link refused the write, or the camera rejected / never acked it
+        DROPPED,  // Link lost before it went out
+    };
+
+    // Issue one write; false if the link did not take it.
+    using WriteFn = std::function<bool(const uint8_t* data, size_t length, bool withResponse)>;
+    using DoneFn = std::function<void(Outcome)>;
+
+    struct Command {
+        uint8_t bytes[3] = {};
+        uint8_t length = 0;
+        bool withResponse = true;
+        uint16_t holdMs = 0;  // After the lane's previous command went out
+        DoneFn done;          // Optional
+    };
+
+    static constexpr size_t LANES = 3;
+    static constexpr size_t LANE_CAPACITY = 8;
+    static constexpr uint32_t ACK_TIMEOUT_MS = 1000;
+
+    explicit CommandQueue(WriteFn write) : write_(std::move(write)) {}
+
+    // Queue `count` commands on one lane, all or nothing (a press is never
+    // queued without its release), then send whatever is due. False if the
+    // lane has no room.
+    bool submit(Lane lane, const Command* commands, size_t count, uint32_t nowMs);
+    bool submit(Lane lane, const Command& command, uint32_t nowMs) {
+        return submit(lane, &command, 1, nowMs);
+    }
+
+    // Send everything due now; also times out a lost ack. Returns the number
+    // of writes issued.
+    size_t pump(uint32_t nowMs);
+    // The write-with-response in flight completed.
+    void onWriteAck(bool ok, uint32_t nowMs);
+    // Make the lane's head due now, cutting its hold short.
+    void expedite(Lane lane);
+    // Link gone: complete everything queued or in flight as DROPPED.
+    void clear();
+    // Emergency: drop everything queued or in flight, then write `commands`
+    // back to back at once, ahead of any lane, holds and the request slot.
+    // Their acks (if sent with response) are not waited for and are swallowed
+    // along with the abandoned in-flight one, for up to ACK_TIMEOUT_MS.
+    // Returns the writes the link took.
+    size_t preempt(const Command* commands, size_t count, uint32_t nowMs);
+
+    size_t pending() const;
+    bool awaitingAck() const;
+
+private:
+    struct LaneState {
+        Command ring[LANE_CAPACITY];
+        size_t head = 0;
+        size_t size = 0;
+        uint32_t lastSentMs = 0;
+    };
+    struct Completion {
+        DoneFn done;
+        Outcome outcome;
+    };
+    static constexpr size_t MAX_COMPLETIONS = LANES * LANE_CAPACITY + 1;
+
+    // Under the lock: issue due writes, recording completions to run later.
+    size_t pumpLocked(uint32_t nowMs, Completion* completions, size_t& completed);
+    // Under the lock: complete everything queued or in flight as DROPPED.
+    void dropLocked(Completion* completions, size_t& completed);
+    static void finish(Completion* completions, size_t count);
+
+    WriteFn write_;
+    mutable std::mutex mutex_;
+    LaneState lanes_[LANES];
+    bool inFlight_ = false;
+    size_t staleAcks_ = 0;  // Acks still due for writes preempt() stopped tracking
+    uint32_t staleSinceMs_ = 0;
+    uint32_t inFlightSentMs_ = 0;
+    DoneFn inFlightDone_;
+};
@@ -0,0 +1,140 @@
+#include "transport/connect_sequence.h"
+
+ConnectSequence::Action ConnectSequence::begin(bool pairing, uint32_t nowMs,
+                                               bool cachedHandles) {
+    pairing_ = pairing;
+    cached_ = cachedHandles;
+    cacheMissed_ = false;
+    failedStep_ = Step::IDLE;
+    startMs_ = nowMs;
+    readyMs_ = nowMs;
+    return enter(Step::OPENING, nowMs);
+}
+
+ConnectSequence::Action ConnectSequence::handle(Event event, uint32_t nowMs) {
+    if (!busy()) {
+        // A late completion after a timeout or cancel, or a drop of a ready
+        // link. A late open left a link up that nobody wants.
+        if (step_ == Step::READY && event == Event::DISCONNECTED) {
+            step_ = Step::IDLE;
+        }
+        return step_ != Step::READY && event == Event::OPENED ? Action::ABORT : Action::NONE;
+    }
+
+    switch (event) {
+        case Event::OPENED:
+            return step_ == Step::OPENING ? enter(Step::EXCHANGING_MTU, nowMs) : Action::NONE;
+        case Event::MTU_DONE:
+            if (step_ != Step::EXCHANGING_MTU) {
+                return Action::NONE;
+            }
+            return enter(pairing_ ? Step::ENCRYPTING : serviceStep(), nowMs);
+        case Event::ENCRYPTED:
+            return step_ == Step::ENCRYPTING ? enter(serviceStep(), nowMs) : Action::NONE;
+        case Event::DISCOVERED:
+            return step_ == Step::DISCOVERING ? enter(Step::READY, nowMs) : Action::NONE;
+        case Event::BOUND:
+            return step_ == Step::BINDING ? enter(Step::READY, nowMs) : Action::NONE;
+        case Event::BIND_FAILED:
+            return step_ == Step::BINDING ? rediscover(nowMs) : Action::NONE;
+        case Event::OPEN_FAILED:
+        case Event::AUTH_FAILED:
+        case Event::DISCOVERY_FAILED:
+        case Event::DISCONNECTED:
+            return fail(nowMs);
+    }
+    return Action::NONE;
+}
+
+ConnectSequence::Action ConnectSequence::poll(uint32_t nowMs) {
+    if (!busy() || nowMs - stepStartMs_ < timeoutFor(step_)) {
+        return Action::NONE;
+    }
+    if (step_ == Step::EXCHANGING_MTU) {
+        // The camera never answered the exchange: carry on at the default MTU.
+        return handle(Event::MTU_DONE, nowMs);
+    }
+    if (step_ == Step::BINDING) {
+        return rediscover(nowMs);
+    }
+    return fail(nowMs);
+}
+
+ConnectSequence::Action ConnectSequence::enter(Step step, uint32_t nowMs) {
+    step_ = step;
+    stepStartMs_ = nowMs;
+    switch (step) {
+        case Step::OPENING:
+            return Action::OPEN;
+        case Step::EXCHANGING_MTU:
+            return Action::REQUEST_MTU;
+        case Step::ENCRYPTING:
+            return Action::ENCRYPT;
+        case Step::DISCOVERING:
+            return Action::DISCOVER;
+        case Step::BINDING:
+            return Action::BIND;
+        case Step::READY:
+            readyMs_ = nowMs;
+            return Action::COMPLETE;
+        default:
+            return Action::NONE;
+    }
+}
+
+ConnectSequence::Step ConnectSequence::serviceStep() const {
+    return cached_ ? Step::BINDING : Step::DISCOVERING;
+}
+
+ConnectSequence::Action ConnectSequence::rediscover(uint32_t nowMs) {
+    // The saved handles no longer match the camera; learn them again.
+    cached_ = false;
+    cacheMissed_ = true;
+    return enter(Step::DISCOVERING, nowMs);
+}
+
+ConnectSequence::Action ConnectSequence::fail(uint32_t nowMs) {
+    failedStep_ = step_;
+    step_ = Step::FAILED;
+    stepStartMs_ = nowMs;
+    return Action::ABORT;
+}
+
+uint32_t ConnectSequence::timeoutFor(Step step) {
+    switch (step) {
+        case Step::OPENING:
+            return OPEN_TIMEOUT_MS;
+        case Step::EXCHANGING_MTU:
+            return MTU_TIMEOUT_MS;
+        case Step::ENCRYPTING:
+            return ENCRYPT_TIMEOUT_MS;
+        case Step::DISCOVERING:
+            return DISCOVER_TIMEOUT_MS;
+        case Step::BINDING:
+            return BIND_TIMEOUT_MS;
+        default:
+            return UINT32_MAX;
+    }
+}
+
+const char* ConnectSequence::stepName(Step step) {
+    switch (step) {
+        case Step::IDLE:
+            return "idle";
+        case Step::OPENING:
+            return "open";
+        case Step::EXCHANGING_MTU:
+            return "MTU";
+        case Step::ENCRYPTING:
+            return "encrypt";
+        case Step::DISCOVERING:
+            return "discovery";
+        case Step::BINDING:
+            return "bind";
+        case Step::READY:
+            return "ready";
+        case Step::FAILED:
+            return "failed";
+    }
+    return "?";
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstdint>
+
+// The steps of bringing up a camera link, as a state machine fed by the
+// radio's own completion events instead of fixed sleeps:
+//
+//   OPENING -> EXCHANGING_MTU -> [ENCRYPTING] -> DISCOVERING -> READY
+//                                             \-> BINDING ---/
+//
+// ENCRYPTING only runs when pairing a new camera; a bonded camera encrypts
+// from its stored keys as soon as the link opens. A camera whose GATT handles
+// were saved on an earlier connect skips discovery: BINDING enables status
+// notifications and reads the status by handle, and if that fails (the
+// camera's layout changed) the sequence falls back to DISCOVERING. Every step
+// has a timeout, checked by poll(). A failed MTU exchange is not fatal (the
+// link keeps the default MTU); anything else tears the link down.
+//
+// No BLE types here: BLEDeviceManager maps GAP/GATTC callbacks to Events and
+// carries out the returned Actions, and the native tests drive it directly.
+class ConnectSequence {
+public:
+    enum class Step : uint8_t {
+        IDLE,
+        OPENING,
+        EXCHANGING_MTU,
+        ENCRYPTING,
+        DISCOVERING,
+        BINDING,
+        READY,
+        FAILED,
+    };
+
+    enum class Event : uint8_t {
+        OPENED,
+        OPEN_FAILED,
+        MTU_DONE,
+        ENCRYPTED,
+        AUTH_FAILED,
+        DISCOVERED,  // Service + characteristics found, notifications registered
+        DISCOVERY_FAILED,
+        BOUND,        // Cached handles answered: notifications on, status read
+        BIND_FAILED,  // Cached handles rejected; falls back to discovery
+        DISCONNECTED,
+    };
+
+    // What the caller must start next. Each completes with an Event.
+    // ABORT also answers an OPENED that arrives after the sequence gave up,
+    // so a connect that succeeded too late does not leave a stray link.
+    enum class Action : uint8_t {
+        NONE,
+        OPEN,         // -> OPENED / OPEN_FAILED
+        REQUEST_MTU,  // -> MTU_DONE
+        ENCRYPT,      // -> ENCRYPTED / AUTH_FAILED
+        DISCOVER,     // -> DISCOVERED / DISCOVERY_FAILED
+        BIND,         // -> BOUND / BIND_FAILED
+        ABORT,        // Failed: drop the link (no Event expected)
+        COMPLETE,     // READY: the link is usable
+    };
+
+    static constexpr uint32_t OPEN_TIMEOUT_MS = 10000;
+    static constexpr uint32_t MTU_TIMEOUT_MS = 2000;
+    static constexpr uint32_t ENCRYPT_TIMEOUT_MS = 15000;  // Pairing may wait on the user
+    static constexpr uint32_t DISCOVER_TIMEOUT_MS = 10000;
+    static constexpr uint32_t BIND_TIMEOUT_MS = 2000;  // Then discover after all
+
+    // cachedHandles: the caller holds saved GATT handles for this camera.
+    Action begin(bool pairing, uint32_t nowMs, bool cachedHandles = false);
+    Action handle(Event event, uint32_t nowMs);
+    // Step timeouts.
+    Action poll(uint32_t nowMs);
+    // Give up without a link-level failure (e.g. user disconnect); the caller
+    // drops the link itself.
+    void cancel() { step_ = Step::IDLE; }
+
+    Step step() const { return step_; }
+    bool busy() const {
+        return step_ != Step::IDLE && step_ != Step::READY && step_ != Step::FAILED;
+    }
+    bool pairing() const { return pairing_; }
+    // Where a FAILED sequence gave up.
+    Step failedStep() const { return failedStep_; }
+    // begin() -> READY, for the connect-time log.
+    uint32_t connectMs() const { return readyMs_ - startMs_; }
+    // The link came up on cached handles, without discovery.
+    bool usedCache() const { return cached_; }
+    // Cached handles were tried and rejected this sequence.
+    bool cacheMissed() const { return cacheMissed_; }
+
+    static const char* stepName(Step step);
+
+private:
+    Action enter(Step step, uint32_t nowMs);
+    Step serviceStep() const;  // DISCOVERING, or BINDING with cached handles
+    Action rediscover(uint32_t nowMs);
+    Action fail(uint32_t nowMs);
+    static uint32_t timeoutFor(Step step);
+
+    Step step_ = Step::IDLE;
+    Step failedStep_ = Step::IDLE;
+    bool pairing_ = false;
+    bool cached_ = false;
+    bool cacheMissed_ = false;
+    uint32_t startMs_ = 0;
+    uint32_t stepStartMs_ = 0;
+    uint32_t readyMs_ = 0;
+};
@@ -0,0 +1,68 @@
+#include "transport/link_profile.h"
+
+namespace {
+// Indexed by LinkProfile.
+constexpr ConnParams PROFILES[] = {
+    {0x10, 0x20, 0, 400},    // BALANCED: 20-40 ms, 4 s timeout
+    {0x06, 0x0C, 0, 200},    // LOW_LATENCY: 7.5-15 ms, 2 s timeout
+    {0x100, 0x140, 0, 600},  // POWER_SAVE: 320-400 ms, 6 s timeout
+};
+constexpr const char* NAMES[] = {"balanced", "low-latency", "power-save"};
+}  // namespace
+
+const ConnParams& LinkProfilePolicy::params(LinkProfile profile) {
+    return PROFILES[static_cast<uint8_t>(profile)];
+}
+
+const char* LinkProfilePolicy::name(LinkProfile profile) {
+    return NAMES[static_cast<uint8_t>(profile)];
+}
+
+uint32_t LinkProfilePolicy::eventsPerMinute(LinkProfile profile) {
+    // maxInterval is in 1.25 ms units: 60000 / (units * 1.25).
+    return 48000UL / params(profile).maxInterval;
+}
+
+uint32_t LinkProfilePolicy::maxEventGapMs(LinkProfile profile) {
+    return (params(profile).maxInterval * 5UL + 3) / 4;  // 1.25 ms units, rounded up
+}
+
+void LinkProfilePolicy::reset(uint32_t nowMs) {
+    current_ = LinkProfile::BALANCED;
+    lastRequestMs_ = nowMs;
+}
+
+LinkProfile LinkProfilePolicy::desired(uint32_t nowMs, uint32_t lastCommandMs,
+                                       uint32_t nextToggleInMs) const {
+    if (lastCommandMs != 0 && nowMs - lastCommandMs < ACTIVITY_HOLD_MS) {
+        return LinkProfile::LOW_LATENCY;
+    }
+    if (nextToggleInMs == NO_TOGGLE) {
+        return LinkProfile::BALANCED;
+    }
+    if (nextToggleInMs <= TOGGLE_LEAD_MS) {
+        return LinkProfile::LOW_LATENCY;
+    }
+    if (nextToggleInMs >= POWER_SAVE_MIN_MS) {
+        return LinkProfile::POWER_SAVE;
+    }
+    return current_;
+}
+
+bool LinkProfilePolicy::next(uint32_t nowMs, uint32_t lastCommandMs, uint32_t nextToggleInMs,
+                             LinkProfile& out) const {
+    const LinkProfile want = desired(nowMs, lastCommandMs, nextToggleInMs);
+    if (want == current_) {
+        return false;
+    }
+    if (want != LinkProfile::LOW_LATENCY && nowMs - lastRequestMs_ < MIN_SWITCH_MS) {
+        return false;
+    }
+    out = want;
+    return true;
+}
+
+void LinkProfilePolicy::requested(LinkProfile profile, uint32_t nowMs) {
+    current_ = profile;
+    lastRequestMs_ = nowMs;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+
+// Connection-parameter profiles for the camera link, picked by what the link
+// is about to do:
+//
+//   LOW_LATENCY  7.5-15 ms, no slave latency. Around every bulb toggle (from
+//                TOGGLE_LEAD_MS before it until its confirmation is in) and
+//                while commands are flowing (focus / zoom steps, UI buttons).
+//   BALANCED     20-40 ms. Connected with nothing planned; also what every
+//                connect asks for up front.
+//   POWER_SAVE   320-400 ms. The long stretches of an exposure or interval,
+//                when the next toggle is at least POWER_SAVE_MIN_MS away.
+//
+// Switching up is requested TOGGLE_LEAD_MS ahead of the planned toggle: an
+// update takes effect a few connection events after it is agreed, and at the
+// power-save interval those events are slow. Between the lead and
+// POWER_SAVE_MIN_MS the current profile is kept, so short intervals do not
+// bounce. Pure (no BLE types); BLEDeviceManager sends the requests.
+enum class LinkProfile : uint8_t { BALANCED, LOW_LATENCY, POWER_SAVE };
+
+// In Bluetooth units: intervals 1.25 ms, supervision timeout 10 ms.
+struct ConnParams {
+    uint16_t minInterval;
+    uint16_t maxInterval;
+    uint16_t latency;  // Connection events the camera may skip
+    uint16_t timeout;
+};
+
+class LinkProfilePolicy {
+public:
+    static constexpr uint32_t NO_TOGGLE = UINT32_MAX;
+    static constexpr uint32_t TOGGLE_LEAD_MS = 5000;
+    static constexpr uint32_t POWER_SAVE_MIN_MS = 20000;
+    // Low latency after the last command: covers a toggle's confirmation and
+    // the gaps between focus / zoom steps.
+    static constexpr uint32_t ACTIVITY_HOLD_MS = 3000;
+    // Fewest ms between two requests, except a switch to LOW_LATENCY.
+    static constexpr uint32_t MIN_SWITCH_MS = 2000;
+
+    static const ConnParams& params(LinkProfile profile);
+    static const char* name(LinkProfile profile);
+    // Connection events per minute at the profile's longest interval (a
+    // proxy for the radio's duty cycle).
+    static uint32_t eventsPerMinute(LinkProfile profile);
+    // Longest wait for the next connection event at the profile's longest
+    // interval: how long a write handed to the stack (an emergency stop's
+    // releases included) can sit before it goes on air.
+    static uint32_t maxEventGapMs(LinkProfile profile);
+
+    // A new link starts on BALANCED (the connect's preferred parameters).
+    void reset(uint32_t nowMs);
+
+    // The profile the link should be on now. lastCommandMs is the latest
+    // camera command (0 = none yet); nextToggleInMs is the time to the next
+    // planned bulb toggle, NO_TOGGLE when nothing is scheduled.
+    LinkProfile desired(uint32_t nowMs, uint32_t lastCommandMs, uint32_t nextToggleInMs) const;
+    // desired(), rate-limited: true with `out` set when a request should go
+    // out now. The caller sends it and reports back with requested().
+    bool next(uint32_t nowMs, uint32_t lastCommandMs, uint32_t nextToggleInMs,
+              LinkProfile& out) const;
+    void requested(LinkProfile profile, uint32_t nowMs);
+
+    LinkProfile current() const { return current_; }
+
+private:
+    LinkProfile current_ = LinkProfile::BALANCED;
+    uint32_t lastRequestMs_ = 0;
+};
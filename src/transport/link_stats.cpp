@@ -0,0 +1,189 @@
+#include "transport/link_stats.h"
+
+namespace {
+uint8_t* writeU16(uint8_t* p, uint16_t value) {
+    *p++ = static_cast<uint8_t>(value);
+    *p++ = static_cast<uint8_t>(value >> 8);
+    return p;
+}
+
+uint8_t* writeU32(uint8_t* p, uint32_t value) {
+    p = writeU16(p, static_cast<uint16_t>(value));
+    return writeU16(p, static_cast<uint16_t>(value >> 16));
+}
+
+void bump(uint16_t& counter) {
+    if (counter < UINT16_MAX) {
+        counter++;
+    }
+}
+}  // namespace
+
+constexpr uint16_t LatencyHistogram::BOUNDS_MS[];
+
+void LatencyHistogram::add(uint32_t ms) {
+    size_t bucket = 0;
+    while (bucket < BUCKETS - 1 && ms > BOUNDS_MS[bucket]) {
+        bucket++;
+    }
+    bump(counts[bucket]);
+    if (ms > maxMs) {
+        maxMs = ms > UINT16_MAX ? UINT16_MAX : static_cast<uint16_t>(ms);
+    }
+}
+
+uint32_t LatencyHistogram::samples() const {
+    uint32_t total = 0;
+    for (uint16_t count : counts) {
+        total += count;
+    }
+    return total;
+}
+
+uint32_t LatencyHistogram::percentileMs(uint8_t pct) const {
+    const uint32_t total = samples();
+    if (total == 0) {
+        return 0;
+    }
+    // Rank of the sample, rounded up: p95 of 20 samples is the 19th.
+    const uint32_t rank = (total * pct + 99) / 100;
+    uint32_t seen = 0;
+    for (size_t i = 0; i < BUCKETS - 1; i++) {
+        seen += counts[i];
+        if (seen >= rank) {
+            return BOUNDS_MS[i] < maxMs ? BOUNDS_MS[i] : maxMs;
+        }
+    }
+    return maxMs;
+}
+
+void LinkStats::recordSubmit(CommandClass c, uint32_t nowMs, bool expectsStatus) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const size_t i = static_cast<size_t>(c);
+    bump(at(c).sent);
+    if (!expectsStatus) {
+        return;
+    }
+    if (awaiting_[i]) {
+        bump(at(c).noStatus);  // The previous one never got its status
+    }
+    awaiting_[i] = true;
+    awaitingSince_[i] = nowMs;
+}
+
+void LinkStats::recordWrite(CommandClass c, bool ok, uint32_t latencyMs) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (ok) {
+        at(c).ack.add(latencyMs);
+    } else {
+        bump(at(c).failed);
+        awaiting_[static_cast<size_t>(c)] = false;  // No status to wait for
+    }
+}
+
+void LinkStats::recordStatus(CommandClass c, uint32_t nowMs) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const size_t i = static_cast<size_t>(c);
+    if (!awaiting_[i]) {
+        return;  // Camera-side change, not one of ours
+    }
+    awaiting_[i] = false;
+    at(c).status.add(nowMs - awaitingSince_[i]);
+}
+
+void LinkStats::recordRssi(int8_t dbm) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (data_.rssiSamples == UINT16_MAX) {
+        return;  // Mean stays put rather than overflow
+    }
+    if (data_.rssiSamples == 0 || dbm < data_.rssiMin) {
+        data_.rssiMin = dbm;
+    }
+    if (data_.rssiSamples == 0 || dbm > data_.rssiMax) {
+        data_.rssiMax = dbm;
+    }
+    data_.rssiLast = dbm;
+    data_.rssiSum += dbm;
+    data_.rssiSamples++;
+}
+
+void LinkStats::recordConnect() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    bump(data_.connects);
+}
+
+void LinkStats::recordConnectFailure() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    bump(data_.connectFailures);
+}
+
+void LinkStats::recordDrop() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    bump(data_.drops);
+    // Whatever was awaiting a status will not get it on this link.
+    for (bool& awaiting : awaiting_) {
+        awaiting = false;
+    }
+}
+
+void LinkStats::recordRecovery(uint32_t outageMs, uint16_t attempts) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (data_.recoveries == UINT16_MAX) {
+        return;  // Total stays consistent with the count
+    }
+    data_.recoveries++;
+    const uint32_t tries = static_cast<uint32_t>(data_.recoveryAttempts) + attempts;
+    data_.recoveryAttempts = tries > UINT16_MAX ? UINT16_MAX : static_cast<uint16_t>(tries);
+    data_.lastRecoveryMs = outageMs;
+    if (outageMs > data_.maxRecoveryMs) {
+        data_.maxRecoveryMs = outageMs;
+    }
+    const uint64_t total = static_cast<uint64_t>(data_.totalRecoveryMs) + outageMs;
+    data_.totalRecoveryMs = total > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(total);
+}
+
+LinkStats::Data LinkStats::snapshot() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return data_;
+}
+
+void LinkStats::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    data_ = Data{};
+    for (bool& awaiting : awaiting_) {
+        awaiting = false;
+    }
+}
+
+void LinkStats::encode(const Data& data, uint8_t* out) {
+    *out++ = WIRE_VERSION;
+    *out++ = CLASSES;
+    *out++ = LatencyHistogram::BUCKETS;
+    *out++ = static_cast<uint8_t>(data.rssiLast);
+    *out++ = static_cast<uint8_t>(data.rssiMin);
+    *out++ = static_cast<uint8_t>(data.rssiMax);
+    *out++ = static_cast<uint8_t>(data.rssiMean());
+    *out++ = 0;
+    out = writeU16(out, data.rssiSamples);
+    out = writeU16(out, data.connects);
+    out = writeU16(out, data.connectFailures);
+    out = writeU16(out, data.drops);
+    for (const ClassStats& c : data.classes) {
+        out = writeU16(out, c.sent);
+        out = writeU16(out, c.failed);
+        out = writeU16(out, c.noStatus);
+        out = writeU16(out, c.ack.maxMs);
+        out = writeU16(out, c.status.maxMs);
+        for (uint16_t count : c.ack.counts) {
+            out = writeU16(out, count);
+        }
+        for (uint16_t count : c.status.counts) {
+            out = writeU16(out, count);
+        }
+    }
+    out = writeU16(out, data.recoveries);
+    out = writeU16(out, data.recoveryAttempts);
+    out = writeU32(out, data.lastRecoveryMs);
+    out = writeU32(out, data.maxRecoveryMs);
+    writeU32(out, data.totalRecoveryMs);
+}
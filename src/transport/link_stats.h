@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+// Fixed-bucket latency histogram: no allocation, a few stores per sample.
+struct LatencyHistogram {
+    static constexpr size_t BUCKETS = 8;
+    // Upper bound (ms, inclusive) of each bucket; the last one is open-ended.
+    static constexpr uint16_t BOUNDS_MS[BUCKETS - 1] = {10, 20, 50, 100, 200, 500, 1000};
+
+    uint16_t counts[BUCKETS] = {};
+    uint16_t maxMs = 0;  // Saturates at 65535
+
+    void add(uint32_t ms);
+    uint32_t samples() const;
+    // Upper bound of the bucket holding the pct-th percentile sample (maxMs
+    // for the open-ended bucket); 0 with no samples.
+    uint32_t percentileMs(uint8_t pct) const;
+};
+
+// Camera-link telemetry: per command class, how long commands took from
+// submit to the write being acknowledged and to the camera's matching status
+// notification, plus link RSSI, connect / drop counts and how long dropped
+// links took to come back. Enough to tell
+// whether an interval is safe on a given night.
+//
+// Thread-safe: samples arrive from the UI loop, the sequencer task and the
+// BLE task. Pure (no BLE types), so it runs natively.
+class LinkStats {
+public:
+    enum class CommandClass : uint8_t { SHUTTER, FOCUS, ZOOM, RECORD };
+    static constexpr size_t CLASSES = 4;
+
+    struct ClassStats {
+        uint16_t sent = 0;      // Queued for the link
+        uint16_t failed = 0;    // Refused, rejected or never acknowledged
+        uint16_t noStatus = 0;  // Expected a status change that never came
+        LatencyHistogram ack;     // Submit -> write acknowledged
+        LatencyHistogram status;  // Submit -> matching status notification
+    };
+
+    struct Data {
+        ClassStats classes[CLASSES];
+        uint16_t rssiSamples = 0;
+        int8_t rssiLast = 0;
+        int8_t rssiMin = 0;
+        int8_t rssiMax = 0;
+        int32_t rssiSum = 0;
+        uint16_t connects = 0;
+        uint16_t connectFailures = 0;
+        uint16_t drops = 0;             // A ready link lost without being asked to
+        uint16_t recoveries = 0;        // Dropped links the reconnect supervisor brought back
+        uint16_t recoveryAttempts = 0;  // Connect attempts those took
+        uint32_t lastRecoveryMs = 0;    // Drop -> ready again
+        uint32_t maxRecoveryMs = 0;
+        uint32_t totalRecoveryMs = 0;
+
+        int8_t rssiMean() const {
+            return rssiSamples ? static_cast<int8_t>(rssiSum / rssiSamples) : 0;
+        }
+        const ClassStats& of(CommandClass c) const { return classes[static_cast<size_t>(c)]; }
+    };
+
+    // A command was queued. With expectsStatus, the next recordStatus() for
+    // its class times it; one still outstanding counts as noStatus.
+    void recordSubmit(CommandClass c, uint32_t nowMs, bool expectsStatus);
+    // Its write completed (ok = acknowledged / accepted by the link).
+    void recordWrite(CommandClass c, bool ok, uint32_t latencyMs);
+    // The camera reported the status change a command of this class awaits.
+    void recordStatus(CommandClass c, uint32_t nowMs);
+
+    void recordRssi(int8_t dbm);
+    void recordConnect();
+    void recordConnectFailure();
+    void recordDrop();
+    // A dropped link is ready again, outageMs after the drop.
+    void recordRecovery(uint32_t outageMs, uint16_t attempts);
+
+    Data snapshot() const;
+    void reset();
+
+    // Wire form, the remote link's LINK_STATS bulk source. Little-endian:
+    //   u8 version | u8 classes | u8 buckets | i8 rssiLast | i8 rssiMin |
+    //   i8 rssiMax | i8 rssiMean | u8 0 | u16 rssiSamples | u16 connects |
+    //   u16 connectFailures | u16 drops
+    //   then per class (SHUTTER, FOCUS, ZOOM, RECORD):
+    //   u16 sent | u16 failed | u16 noStatus | u16 ackMaxMs | u16 statusMaxMs |
+    //   u16 ack[buckets] | u16 status[buckets]
+    //   then (version 2) u16 recoveries | u16 recoveryAttempts |
+    //   u32 lastRecoveryMs | u32 maxRecoveryMs | u32 totalRecoveryMs
+    static constexpr uint8_t WIRE_VERSION = 2;
+    static constexpr size_t HEADER_BYTES = 16;
+    static constexpr size_t CLASS_BYTES = 10 + 4 * LatencyHistogram::BUCKETS;
+    static constexpr size_t RECOVERY_BYTES = 16;
+    static constexpr size_t WIRE_BYTES = HEADER_BYTES + CLASSES * CLASS_BYTES + RECOVERY_BYTES;
+    static void encode(const Data& data, uint8_t* out);
+
+private:
+    ClassStats& at(CommandClass c) { return data_.classes[static_cast<size_t>(c)]; }
+
+    mutable std::mutex mutex_;
+    Data data_;
+    uint32_t awaitingSince_[CLASSES] = {};  // Submit time of the command awaiting status
+    bool awaiting_[CLASSES] = {};
+};
@@ -0,0 +1,82 @@
+#include "transport/presence_tracker.h"
+
+void PresenceTracker::track(const std::vector<SavedCamera>& cameras) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Entry next[CameraStore::MAX_CAMERAS];
+    size_t count = 0;
+    for (const SavedCamera& camera : cameras) {
+        BleAddress address;
+        if (count == CameraStore::MAX_CAMERAS || !BleAddress::parse(camera.address, address)) {
+            continue;
+        }
+        const Entry* known = find(address);
+        if (known) {
+            next[count] = *known;
+        } else {
+            next[count].address = address;
+        }
+        count++;
+    }
+    for (size_t i = 0; i < count; i++) {
+        entries_[i] = next[i];
+    }
+    count_ = count;
+}
+
+bool PresenceTracker::observe(const BleAddress& address, int8_t rssi, uint32_t nowMs) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Entry* entry = findMutable(address);
+    if (!entry) {
+        return false;
+    }
+    // A quarter of each new sample: steady through one faded advertisement,
+    // still following a camera walked away within a few seconds.
+    const int16_t sampleX16 = static_cast<int16_t>(rssi * 16);
+    entry->rssiX16 = entry->heard ? static_cast<int16_t>(entry->rssiX16 +
+                                                         (sampleX16 - entry->rssiX16) / 4)
+                                  : sampleX16;
+    entry->lastSeenMs = nowMs;
+    entry->heard = true;
+    return true;
+}
+
+bool PresenceTracker::isPresent(const std::string& address, uint32_t nowMs) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const Entry* entry = find(address);
+    return entry && entry->heard && nowMs - entry->lastSeenMs < PRESENT_TTL_MS;
+}
+
+int8_t PresenceTracker::rssi(const std::string& address) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const Entry* entry = find(address);
+    return entry && entry->heard ? static_cast<int8_t>(entry->rssiX16 / 16) : 0;
+}
+
+uint32_t PresenceTracker::lastSeenMs(const std::string& address) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const Entry* entry = find(address);
+    return entry && entry->heard ? entry->lastSeenMs : 0;
+}
+
+PresenceTracker::Entry* PresenceTracker::findMutable(const BleAddress& address) {
+    for (size_t i = 0; i < count_; i++) {
+        if (entries_[i].address == address) {
+            return &entries_[i];
+        }
+    }
+    return nullptr;
+}
+
+const PresenceTracker::Entry* PresenceTracker::find(const BleAddress& address) const {
+    for (size_t i = 0; i < count_; i++) {
+        if (entries_[i].address == address) {
+            return &entries_[i];
+        }
+    }
+    return nullptr;
+}
+
+const PresenceTracker::Entry* PresenceTracker::find(const std::string& address) const {
+    BleAddress packed;
+    return BleAddress::parse(address, packed) ? find(packed) : nullptr;
+}
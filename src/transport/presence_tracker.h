@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "transport/ble_address.h"
+#include "transport/camera_store.h"
+
+// Which saved cameras are advertising, from a low-duty passive scan. Every
+// advertisement from a tracked address refreshes its last-seen time and a
+// smoothed RSSI; a camera counts as present for PRESENT_TTL_MS after the
+// last one. A camera that is off or out of range does not advertise, so the
+// reconnect path waits for presence instead of burning a connect timeout.
+//
+// observe() runs on the BLE task, the rest on the loop; a mutex covers both.
+// Pure (no BLE types).
+class PresenceTracker {
+public:
+    // Scan timing, in ms. The idle duty hears a camera advertising every
+    // 100-300 ms within a scan interval or two; the urgent one (a frame
+    // exposing) within a couple of hundred ms.
+    static constexpr uint16_t SCAN_INTERVAL_MS = 1280;
+    static constexpr uint16_t SCAN_WINDOW_MS = 40;  // ~3% duty
+    static constexpr uint16_t URGENT_SCAN_INTERVAL_MS = 160;
+    static constexpr uint16_t URGENT_SCAN_WINDOW_MS = 80;  // 50% duty
+    // Several idle scan intervals, so one missed advertisement is not a loss.
+    static constexpr uint32_t PRESENT_TTL_MS = 4 * SCAN_INTERVAL_MS;
+
+    // Follow these cameras; what is known about ones still listed is kept.
+    void track(const std::vector<SavedCamera>& cameras);
+    // An advertisement. False (ignored) if the address is not tracked.
+    bool observe(const BleAddress& address, int8_t rssi, uint32_t nowMs);
+
+    bool isPresent(const std::string& address, uint32_t nowMs) const;
+    // Exponentially smoothed RSSI in dBm; 0 if never heard.
+    int8_t rssi(const std::string& address) const;
+    // 0 if never heard.
+    uint32_t lastSeenMs(const std::string& address) const;
+
+private:
+    struct Entry {
+        BleAddress address;
+        uint32_t lastSeenMs = 0;
+        int16_t rssiX16 = 0;  // Smoothed RSSI, 1/16 dBm
+        bool heard = false;
+    };
+
+    Entry* findMutable(const BleAddress& address);
+    const Entry* find(const BleAddress& address) const;
+    const Entry* find(const std::string& address) const;
+
+    mutable std::mutex mutex_;
+    Entry entries_[CameraStore::MAX_CAMERAS];
+    size_t count_ = 0;
+};
@@ -0,0 +1,64 @@
+#include "transport/reconnect_supervisor.h"
+
+uint32_t ReconnectSupervisor::ceilingFor(uint16_t attempt, bool urgent) {
+    const uint32_t base = urgent ? URGENT_BASE_MS : BASE_MS;
+    const uint32_t max = urgent ? URGENT_MAX_MS : MAX_MS;
+    uint32_t wait = base;
+    for (uint16_t i = 1; i < attempt && wait < max; i++) {
+        wait *= 2;
+    }
+    return wait < max ? wait : max;
+}
+
+uint32_t ReconnectSupervisor::delayFor(uint16_t attempt, bool urgent, uint32_t entropy) {
+    const uint32_t ceiling = ceilingFor(attempt, urgent);
+    const uint32_t half = ceiling / 2;
+    return half + entropy % (ceiling - half + 1);
+}
+
+void ReconnectSupervisor::linkLost(uint32_t nowMs) {
+    active_ = true;
+    attempts_ = 0;
+    backoff_ = 0;
+    lostAtMs_ = nowMs;
+    lastAttemptMs_ = nowMs;
+    waitMs_ = 0;
+}
+
+bool ReconnectSupervisor::due(uint32_t nowMs, bool urgent) const {
+    if (!active_) {
+        return false;
+    }
+    uint32_t wait = urgent && waitMs_ > URGENT_MAX_MS ? URGENT_MAX_MS : waitMs_;
+    if (!present_ && attempts_ > 0) {
+        // The first attempt after the drop goes out regardless: the camera
+        // was there a moment ago.
+        const uint32_t blind = urgent ? URGENT_BLIND_MS : BLIND_MS;
+        wait = wait > blind ? wait : blind;
+    }
+    return nowMs - lastAttemptMs_ >= wait;
+}
+
+void ReconnectSupervisor::setTargetPresent(bool present) {
+    if (present && !present_) {
+        backoff_ = 0;
+        waitMs_ = 0;
+    }
+    present_ = present;
+}
+
+void ReconnectSupervisor::attempted(uint32_t nowMs, bool urgent, uint32_t entropy) {
+    if (attempts_ < UINT16_MAX) {
+        attempts_++;
+    }
+    if (backoff_ < UINT16_MAX) {
+        backoff_++;
+    }
+    lastAttemptMs_ = nowMs;
+    waitMs_ = delayFor(backoff_, urgent, entropy);
+}
+
+uint32_t ReconnectSupervisor::recovered(uint32_t nowMs) {
+    active_ = false;
+    return nowMs - lostAtMs_;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+
+// When to retry a camera link that dropped on its own. An outage starts with
+// linkLost() and ends with recovered() (or cancel(), when the user closes the
+// link); in between, due() says when the next connect attempt should start.
+//
+// Waits grow from BASE_MS, doubling per attempt up to MAX_MS, with "equal
+// jitter" (half the wait fixed, half random) so a camera that rebooted is not
+// hit in lockstep. It never gives up. Urgent mode is for a drop mid-exposure,
+// when the shutter cannot be closed until the link is back: the wait is
+// capped at URGENT_MAX_MS instead, applied at once to an outage already under
+// way.
+//
+// Where presence is known (presence_tracker.h), attempts wait for the camera
+// to advertise: while it is absent only a blind attempt every BLIND_MS goes
+// out (URGENT_BLIND_MS when urgent), in case its advertisements are missed.
+// When it reappears the backoff starts over and the next attempt is due at
+// once. Pure (no BLE types); BLEDeviceManager runs the attempts.
+class ReconnectSupervisor {
+public:
+    static constexpr uint32_t BASE_MS = 1000;
+    static constexpr uint32_t MAX_MS = 60000;
+    static constexpr uint32_t URGENT_BASE_MS = 250;
+    static constexpr uint32_t URGENT_MAX_MS = 2000;
+    static constexpr uint32_t BLIND_MS = 30000;
+    static constexpr uint32_t URGENT_BLIND_MS = 5000;
+
+    // Wait after the given attempt (1 = the first), before jitter: the upper
+    // bound of what delayFor() returns.
+    static uint32_t ceilingFor(uint16_t attempt, bool urgent);
+    // Jittered wait: half the ceiling plus entropy's share of the other half.
+    static uint32_t delayFor(uint16_t attempt, bool urgent, uint32_t entropy);
+
+    // A ready link dropped. The first attempt is due straight away.
+    void linkLost(uint32_t nowMs);
+    // Whether an attempt should start now. The caller checks that no connect
+    // is already under way.
+    bool due(uint32_t nowMs, bool urgent) const;
+    // Whether the target is advertising. Assumed so until told otherwise.
+    void setTargetPresent(bool present);
+    // An attempt was started; schedules the one after it.
+    void attempted(uint32_t nowMs, bool urgent, uint32_t entropy);
+    // The link is back: ends the outage and returns how long it lasted.
+    uint32_t recovered(uint32_t nowMs);
+    void cancel() { active_ = false; }
+
+    bool active() const { return active_; }
+    uint16_t attempts() const { return attempts_; }
+
+private:
+    bool active_ = false;
+    uint16_t attempts_ = 0;
+    uint16_t backoff_ = 0;  // Attempts since the target last (re)appeared
+    bool present_ = true;
+    uint32_t lostAtMs_ = 0;
+    uint32_t lastAttemptMs_ = 0;
+    uint32_t waitMs_ = 0;  // From lastAttemptMs_ to the next attempt
+};
@@ -4,6 +4,7 @@
 
 std::map<ButtonId, bool> RemoteControlManager::buttonStates;
 std::map<ButtonId, bool> RemoteControlManager::buttonProcessed;
+uint32_t RemoteControlManager::lastActivityMs = 0;
 
 void RemoteControlManager::init() {
     buttonStates.clear();
@@ -64,5 +65,6 @@ void RemoteControlManager::setButtonState(ButtonId button, bool pressed) {
     if (pressed) {
         // When a button is pressed, mark it as unprocessed so it can be detected
         buttonProcessed[button] = false;
+        lastActivityMs = millis();
     }
 }
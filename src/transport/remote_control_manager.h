@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <map>
 
 #include "transport/button_id.h"
@@ -8,6 +9,7 @@ class RemoteControlManager {
 private:
     static std::map<ButtonId, bool> buttonStates;
     static std::map<ButtonId, bool> buttonProcessed;
+    static uint32_t lastActivityMs;
 
 public:
     static void init();
@@ -15,6 +17,8 @@ public:
 
     static bool wasButtonPressed(ButtonId button);
     static bool isButtonPressed(ButtonId button);
+    // millis() of the last press from any source (0 if none since boot).
+    static uint32_t getLastActivityMs() { return lastActivityMs; }
 
     // Convenience methods for common buttons
     static bool wasConfirmPressed() { return wasButtonPressed(ButtonId::CONFIRM); }
@@ -0,0 +1,29 @@
+#include "transport/scan_plan.h"
+
+void ScanPlan::begin(Goal goal, const BleAddress& target, bool nameKnown, uint32_t durationMs,
+                     uint32_t nowMs) {
+    goal_ = goal;
+    target_ = target;
+    passive_ = goal == Goal::ADDRESS && nameKnown;
+    startMs_ = nowMs;
+    durationMs_ = durationMs;
+}
+
+ScanPlan::Duty ScanPlan::duty(uint32_t nowMs) const {
+    if (inBurst(nowMs)) {
+        return Duty{BURST_INTERVAL_MS, BURST_WINDOW_MS, !passive_};
+    }
+    return Duty{BACKOFF_INTERVAL_MS, BACKOFF_WINDOW_MS, !passive_};
+}
+
+bool ScanPlan::isTarget(const BleAddress& address, bool sonyCamera) const {
+    switch (goal_) {
+        case Goal::LIST:
+            return false;
+        case Goal::ADDRESS:
+            return address == target_;
+        case Goal::FIRST_SONY:
+            return sonyCamera;
+    }
+    return false;
+}
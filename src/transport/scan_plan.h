@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+
+#include "transport/ble_address.h"
+
+// How a discovery scan spends the radio, and when it may stop early. Every
+// scan opens with a short high-duty burst, which hears most cameras within
+// their first advertisement or two, then backs off to a low duty for the
+// rest of its time:
+//
+//   LIST        Everything for the scan screen; runs its full duration.
+//   ADDRESS     One known camera; stops the moment it is heard.
+//   FIRST_SONY  Any Sony camera; stops at the first one.
+//
+// Scans are active (scan requests, for the name in the scan response) unless
+// the target's name is already known: a saved camera is found from its
+// advertisements alone. Pure (no BLE types); BLEDeviceManager applies the
+// duty and feeds it what the scan hears.
+class ScanPlan {
+public:
+    enum class Goal : uint8_t { LIST, ADDRESS, FIRST_SONY };
+
+    // Scan timing, in ms.
+    static constexpr uint32_t BURST_MS = 1500;
+    static constexpr uint16_t BURST_INTERVAL_MS = 100;
+    static constexpr uint16_t BURST_WINDOW_MS = 90;  // 90% duty
+    static constexpr uint16_t BACKOFF_INTERVAL_MS = 400;
+    static constexpr uint16_t BACKOFF_WINDOW_MS = 100;  // 25% duty
+
+    struct Duty {
+        uint16_t intervalMs;
+        uint16_t windowMs;
+        bool active;  // Send scan requests
+    };
+
+    // `target` is used by ADDRESS only; `nameKnown` makes an ADDRESS scan
+    // passive.
+    void begin(Goal goal, const BleAddress& target, bool nameKnown, uint32_t durationMs,
+               uint32_t nowMs);
+
+    // What the scan should be running at now; changes once, when the burst
+    // ends.
+    Duty duty(uint32_t nowMs) const;
+    bool inBurst(uint32_t nowMs) const { return nowMs - startMs_ < BURST_MS; }
+
+    // Would hearing this device end the scan? Reads only what begin() set,
+    // so the BLE task may ask while the loop owns the plan.
+    bool isTarget(const BleAddress& address, bool sonyCamera) const;
+
+    // Out of time. A found target ends the scan through the caller.
+    bool expired(uint32_t nowMs) const { return nowMs - startMs_ >= durationMs_; }
+
+    Goal goal() const { return goal_; }
+    const BleAddress& target() const { return target_; }
+
+private:
+    Goal goal_ = Goal::LIST;
+    BleAddress target_;
+    bool passive_ = false;
+    uint32_t startMs_ = 0;
+    uint32_t durationMs_ = 0;
+};
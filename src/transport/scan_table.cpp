@@ -0,0 +1,167 @@
+#include "transport/scan_table.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+constexpr uint8_t AD_NAME_SHORT = 0x08;
+constexpr uint8_t AD_NAME_COMPLETE = 0x09;
+constexpr uint8_t AD_MANUFACTURER = 0xFF;
+
+void copyName(char (&dst)[AdvertisementInfo::NAME_BYTES], const char* src, size_t length) {
+    length = std::min(length, AdvertisementInfo::NAME_BYTES - 1);
+    memcpy(dst, src, length);
+    dst[length] = '\0';
+}
+}  // namespace
+
+bool parseAdvertisement(const uint8_t* payload, size_t length, AdvertisementInfo& out) {
+    bool found = false;
+    size_t i = 0;
+    // AD structures: u8 length (type + data) | u8 type | data.
+    while (i < length && payload[i] != 0) {
+        const size_t size = payload[i];
+        if (i + 1 + size > length) {
+            break;
+        }
+        const uint8_t type = payload[i + 1];
+        const uint8_t* data = payload + i + 2;
+        const size_t dataLength = size - 1;
+        if (type == AD_NAME_COMPLETE || (type == AD_NAME_SHORT && out.name[0] == '\0')) {
+            copyName(out.name, reinterpret_cast<const char*>(data), dataLength);
+            found = true;
+        } else if (type == AD_MANUFACTURER && dataLength >= 2) {
+            out.hasManufacturer = true;
+            out.companyId = static_cast<uint16_t>(data[0] | (data[1] << 8));
+            out.companyType = dataLength >= 3 ? data[2] : 0;
+            found = true;
+        }
+        i += 1 + size;
+    }
+    return found;
+}
+
+ScanTable::ScanTable() {
+    std::fill(std::begin(slots_), std::end(slots_), EMPTY);
+}
+
+size_t ScanTable::hash(const BleAddress& address) {
+    // FNV-1a over the six bytes.
+    uint32_t h = 2166136261u;
+    for (uint8_t b : address.bytes) {
+        h = (h ^ b) * 16777619u;
+    }
+    return h & (SLOTS - 1);
+}
+
+int16_t ScanTable::lookup(const BleAddress& address) const {
+    // Linear probing; never more than half full, so an empty slot ends it.
+    for (size_t slot = hash(address);; slot = (slot + 1) & (SLOTS - 1)) {
+        const int16_t index = slots_[slot];
+        if (index == EMPTY || entries_[index].address == address) {
+            return index;
+        }
+    }
+}
+
+ScanTable::Change ScanTable::observe(const BleAddress& address, const char* name, int8_t rssi,
+                                     uint32_t nowMs) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const bool hasName = name && name[0] != '\0';
+    int16_t index = lookup(address);
+    if (index == EMPTY) {
+        if (count_ == CAPACITY) {
+            dropped_++;
+            return Change::FULL;
+        }
+        size_t slot = hash(address);
+        while (slots_[slot] != EMPTY) {
+            slot = (slot + 1) & (SLOTS - 1);
+        }
+        index = static_cast<int16_t>(count_++);
+        slots_[slot] = index;
+        Entry& entry = entries_[index];
+        entry.address = address;
+        copyName(entry.name, hasName ? name : "", hasName ? strlen(name) : 0);
+        entry.rssi = rssi;
+        entry.firstSeenMs = nowMs;
+        entry.lastSeenMs = nowMs;
+        entry.version = ++version_;
+        rssiX16_[index] = static_cast<int16_t>(rssi * 16);
+        return Change::ADDED;
+    }
+
+    Entry& entry = entries_[index];
+    entry.lastSeenMs = nowMs;
+    // A quarter of each sample, as for saved cameras (presence_tracker.cpp).
+    int16_t& smoothed = rssiX16_[index];
+    smoothed = static_cast<int16_t>(smoothed + (rssi * 16 - smoothed) / 4);
+    const int8_t current = static_cast<int8_t>(smoothed / 16);
+    bool changed = abs(current - entry.rssi) >= RSSI_REPORT_DB;
+    if (changed) {
+        entry.rssi = current;
+    }
+    if (hasName && strncmp(entry.name, name, AdvertisementInfo::NAME_BYTES - 1) != 0) {
+        copyName(entry.name, name, strlen(name));
+        changed = true;
+    }
+    if (!changed) {
+        return Change::NONE;
+    }
+    entry.version = ++version_;
+    return Change::UPDATED;
+}
+
+void ScanTable::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::fill(std::begin(slots_), std::end(slots_), EMPTY);
+    count_ = 0;
+    dropped_ = 0;
+    clearedAt_ = ++version_;
+}
+
+size_t ScanTable::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return count_;
+}
+
+uint32_t ScanTable::version() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return version_;
+}
+
+uint32_t ScanTable::dropped() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return dropped_;
+}
+
+bool ScanTable::find(const BleAddress& address, Entry& out) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const int16_t index = lookup(address);
+    if (index == EMPTY) {
+        return false;
+    }
+    out = entries_[index];
+    return true;
+}
+
+size_t ScanTable::changedSince(uint32_t& version, Entry* out, size_t max, bool& reset) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    reset = version < clearedAt_;
+    const uint32_t since = reset ? clearedAt_ : version;
+    size_t copied = 0;
+    bool more = false;
+    for (size_t i = 0; i < count_; i++) {
+        if (entries_[i].version <= since) {
+            continue;
+        }
+        if (copied == max) {
+            more = true;
+            break;
+        }
+        out[copied++] = entries_[i];
+    }
+    // Short of room: hand the same window out again rather than skip any.
+    version = more ? since : version_;
+    return copied;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+#include "transport/ble_address.h"
+
+// What the scan needs out of one advertisement's AD structures, read in place
+// from the raw payload: the local name and the manufacturer-specific header.
+struct AdvertisementInfo {
+    static constexpr size_t NAME_BYTES = 30;  // A legacy advertisement's 31 bytes hold 29 chars
+
+    char name[NAME_BYTES] = {};  // Complete or shortened local name; "" if none
+    bool hasManufacturer = false;
+    uint16_t companyId = 0;
+    uint8_t companyType = 0;  // First byte after the company id (Sony: device type)
+};
+
+// Parse an advertisement (or scan response) payload. Malformed structures end
+// the parse; what was read before them is kept. False if nothing was found.
+bool parseAdvertisement(const uint8_t* payload, size_t length, AdvertisementInfo& out);
+
+// Results of a discovery scan: a fixed-capacity open-addressing table keyed by
+// the packed address, holding each device's name, smoothed RSSI and first /
+// last seen times. Nothing is allocated per advertisement; a full table
+// counts and ignores new devices. Entries keep their discovery order.
+//
+// Every new device and every name or noticeable RSSI change bumps the table
+// version; a reader asks changedSince() for just those entries, so a screen
+// can show devices as they are heard. observe() runs on the BLE task, the
+// rest on the loop; a mutex covers both. Pure (no BLE types).
+class ScanTable {
+public:
+    static constexpr size_t CAPACITY = 32;
+    static constexpr size_t SLOTS = 64;  // Power of two, at most half full
+    // Smoothed RSSI moves at least this far from what was last reported
+    // before it counts as a change.
+    static constexpr uint8_t RSSI_REPORT_DB = 3;
+
+    struct Entry {
+        BleAddress address;
+        char name[AdvertisementInfo::NAME_BYTES];
+        int8_t rssi;  // Smoothed, dBm
+        uint32_t firstSeenMs;
+        uint32_t lastSeenMs;
+        uint32_t version;  // Table version of its latest reported change
+    };
+
+    enum class Change : uint8_t { NONE, ADDED, UPDATED, FULL };
+
+    ScanTable();
+
+    // One advertisement. `name` may be empty (nullptr or ""): a known name is
+    // kept until a different non-empty one arrives.
+    Change observe(const BleAddress& address, const char* name, int8_t rssi, uint32_t nowMs);
+    void clear();
+
+    size_t size() const;
+    uint32_t version() const;
+    uint32_t dropped() const;  // New devices turned away while full
+    bool find(const BleAddress& address, Entry& out) const;
+
+    // Entries changed after `version` (the caller's last seen table version),
+    // in discovery order, up to `max` (CAPACITY takes them all); `version`
+    // is advanced to the current one, or left as it was if some did not fit.
+    // `reset` is set when the table was cleared since: drop what was read
+    // before.
+    size_t changedSince(uint32_t& version, Entry* out, size_t max, bool& reset) const;
+
+private:
+    static constexpr int16_t EMPTY = -1;
+
+    static size_t hash(const BleAddress& address);
+    int16_t lookup(const BleAddress& address) const;  // Entry index, or EMPTY
+
+    mutable std::mutex mutex_;
+    int16_t slots_[SLOTS];  // Entry index per slot, EMPTY when free
+    Entry entries_[CAPACITY];
+    int16_t rssiX16_[CAPACITY] = {};  // Smoothing state, 1/16 dBm
+    size_t count_ = 0;
+    uint32_t version_ = 0;
+    uint32_t clearedAt_ = 0;  // Table version when last cleared
+    uint32_t dropped_ = 0;
+};
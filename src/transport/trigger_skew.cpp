@@ -0,0 +1,68 @@
+#include "transport/trigger_skew.h"
+
+void TriggerSkew::begin(bool open, uint8_t cameras, uint32_t nowMs) {
+    if (measuring_) {
+        finish();
+    }
+    measuring_ = cameras != 0;
+    open_ = open;
+    expected_ = cameras;
+    reported_ = 0;
+    startMs_ = nowMs;
+}
+
+void TriggerSkew::onEdge(size_t camera, bool open, uint32_t atMs) {
+    if (camera >= MAX_CAMERAS) {
+        return;
+    }
+    const uint8_t bit = static_cast<uint8_t>(1u << camera);
+    if (!measuring_ || open != open_ || !(expected_ & bit) || (reported_ & bit)) {
+        return;
+    }
+    // Edges come in arrival order from one task, but compare anyway: the
+    // first report need not carry the earliest stamp.
+    if (!reported_) {
+        firstMs_ = lastMs_ = atMs;
+    } else if (static_cast<int32_t>(atMs - firstMs_) < 0) {
+        firstMs_ = atMs;
+    } else if (static_cast<int32_t>(atMs - lastMs_) > 0) {
+        lastMs_ = atMs;
+    }
+    reported_ |= bit;
+    if (reported_ == expected_) {
+        finish();
+    }
+}
+
+void TriggerSkew::poll(uint32_t nowMs) {
+    if (measuring_ && nowMs - startMs_ >= WINDOW_MS) {
+        finish();
+    }
+}
+
+void TriggerSkew::reset() {
+    *this = TriggerSkew{};
+}
+
+void TriggerSkew::finish() {
+    measuring_ = false;
+    Stats& stats = open_ ? opens_ : closes_;
+    if (reported_ != expected_) {
+        stats.incomplete++;
+    }
+    size_t reports = 0;
+    for (uint8_t bits = reported_; bits; bits &= bits - 1) {
+        reports++;
+    }
+    if (reports < 2) {
+        return;
+    }
+    const uint32_t spread = lastMs_ - firstMs_;
+    const uint16_t skewMs = spread > UINT16_MAX ? UINT16_MAX : static_cast<uint16_t>(spread);
+    stats.samples++;
+    stats.lastMs = skewMs;
+    if (skewMs > stats.maxMs) {
+        stats.maxMs = skewMs;
+    }
+    stats.totalMs += skewMs;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// How far apart the cameras of a rig actually moved on one bulb toggle: the
+// spread between the first and the last camera's shutter-status edge for the
+// toggle, all stamped on the remote's own clock as the notifications arrive.
+// Opens and closes are kept apart, each in a fixed accumulator (last, worst,
+// mean), so a night's skew costs a few words of RAM.
+//
+// One toggle is measured at a time: begin() names the cameras it went to
+// (bitmask by camera), onEdge() takes their reports, and the toggle is
+// folded in once every camera has reported or WINDOW_MS has passed. A toggle
+// only yields a sample when two or more cameras reported; one that some
+// camera never confirmed also counts as incomplete. Pure and unlocked; the
+// owner serialises access (CameraRig).
+class TriggerSkew {
+public:
+    static constexpr size_t MAX_CAMERAS = 8;  // Bits of the camera mask
+    static constexpr uint32_t WINDOW_MS = 3000;
+
+    struct Stats {
+        uint16_t samples = 0;
+        uint16_t incomplete = 0;  // Toggles a camera never confirmed
+        uint16_t lastMs = 0;      // Saturate at 65535
+        uint16_t maxMs = 0;
+        uint32_t totalMs = 0;
+
+        uint16_t meanMs() const { return samples ? totalMs / samples : 0; }
+    };
+
+    // A toggle heading `open` went out to `cameras`. One still being
+    // measured is folded in first.
+    void begin(bool open, uint8_t cameras, uint32_t nowMs);
+    // Camera `camera` reported its shutter at atMs. Only the first report
+    // of the toggle's edge from a camera it went to counts.
+    void onEdge(size_t camera, bool open, uint32_t atMs);
+    // Folds in a toggle whose window has passed.
+    void poll(uint32_t nowMs);
+    void reset();
+
+    bool measuring() const { return measuring_; }
+    const Stats& opens() const { return opens_; }
+    const Stats& closes() const { return closes_; }
+
+private:
+    void finish();
+
+    Stats opens_;
+    Stats closes_;
+    bool measuring_ = false;
+    bool open_ = false;
+    uint8_t expected_ = 0;
+    uint8_t reported_ = 0;
+    uint32_t startMs_ = 0;
+    uint32_t firstMs_ = 0;
+    uint32_t lastMs_ = 0;
+};
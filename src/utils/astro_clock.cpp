@@ -0,0 +1,179 @@
+#include "utils/astro_clock.h"
+
+#include <M5Unified.h>
+
+std::mutex AstroClock::mutex_;
+ClockDiscipline AstroClock::discipline_;
+bool AstroClock::rtcValid_ = false;
+bool AstroClock::synced_ = false;
+bool AstroClock::rtcWritePending_ = false;
+bool AstroClock::sampling_ = false;
+uint32_t AstroClock::lastRtcEpochSec_ = 0;
+uint32_t AstroClock::lastRtcReadMs_ = 0;
+uint32_t AstroClock::lastRtcSampleMs_ = 0;
+uint32_t AstroClock::bootRtcEpochSec_ = 0;
+uint32_t AstroClock::bootMs_ = 0;
+
+namespace {
+// Days since 1970-01-01 for a proleptic Gregorian date (H. Hinnant's
+// days_from_civil), and its inverse. The RTC holds UTC.
+int32_t daysFromCivil(int32_t y, uint32_t m, uint32_t d) {
+    y -= m <= 2;
+    const int32_t era = (y >= 0 ? y : y - 399) / 400;
+    const uint32_t yoe = static_cast<uint32_t>(y - era * 400);
+    const uint32_t doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+    const uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<int32_t>(doe) - 719468;
+}
+
+void civilFromDays(int32_t z, int32_t& y, uint32_t& m, uint32_t& d) {
+    z += 719468;
+    const int32_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const uint32_t doe = static_cast<uint32_t>(z - era * 146097);
+    const uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const uint32_t mp = (5 * doy + 2) / 153;
+    d = doy - (153 * mp + 2) / 5 + 1;
+    m = mp < 10 ? mp + 3 : mp - 9;
+    y = static_cast<int32_t>(yoe) + era * 400 + (m <= 2);
+}
+}  // namespace
+
+void AstroClock::init() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint32_t epochSec = 0;
+    rtcValid_ = readRtcEpochSec(epochSec);
+    bootRtcEpochSec_ = rtcValid_ ? epochSec : 0;
+    bootMs_ = millis();
+    // No reference yet: the RTC only counts whole seconds, so wait for the
+    // first second edge in update() rather than anchor up to 1 s off.
+    LOG_APP("[Clock] RTC %s (epoch %lu)", rtcValid_ ? "valid" : "not set",
+            static_cast<unsigned long>(epochSec));
+}
+
+void AstroClock::update() {
+    const uint32_t now = millis();
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (rtcWritePending_) {
+        // The RTC counts whole seconds from when it is written, so write on a
+        // second boundary to line its edges up with the synced time.
+        const uint64_t epoch = discipline_.epochMs(now);
+        if (epoch % 1000 < RTC_EDGE_MAX_GAP_MS) {
+            writeRtcEpochSec(static_cast<uint32_t>(epoch / 1000));
+            rtcWritePending_ = false;
+            rtcValid_ = true;
+            sampling_ = false;
+            lastRtcSampleMs_ = now;
+        }
+        return;
+    }
+
+    if (!rtcValid_) {
+        return;
+    }
+    if (sampling_ || !discipline_.hasReference() ||
+        now - lastRtcSampleMs_ >= RTC_SAMPLE_INTERVAL_MS) {
+        sampleRtcEdge(now);
+    }
+}
+
+void AstroClock::sampleRtcEdge(uint32_t localMs) {
+    uint32_t epochSec = 0;
+    if (!readRtcEpochSec(epochSec)) {
+        rtcValid_ = false;
+        sampling_ = false;
+        return;
+    }
+    if (sampling_ && epochSec != lastRtcEpochSec_ &&
+        localMs - lastRtcReadMs_ <= RTC_EDGE_MAX_GAP_MS) {
+        // The second rolled over between the previous read and this one.
+        const uint32_t edgeMs = localMs - (localMs - lastRtcReadMs_) / 2;
+        discipline_.addReference(edgeMs, static_cast<uint64_t>(epochSec) * 1000ULL);
+        sampling_ = false;
+        lastRtcSampleMs_ = localMs;
+        LOG_DEBUG("[Clock] RTC edge %lu, drift %ld ppb", static_cast<unsigned long>(epochSec),
+                  static_cast<long>(discipline_.ratePpb()));
+        return;
+    }
+    sampling_ = true;
+    lastRtcEpochSec_ = epochSec;
+    lastRtcReadMs_ = localMs;
+}
+
+void AstroClock::sync(uint64_t epochMs) {
+    const uint32_t now = millis();
+    std::lock_guard<std::mutex> lock(mutex_);
+    // The first remote sync may disagree with the RTC by whole seconds, so it
+    // starts a fresh rate baseline; later syncs extend it.
+    discipline_.addReference(now, epochMs, !synced_);
+    synced_ = true;
+    rtcWritePending_ = true;  // update() writes the RTC on the next second boundary
+    LOG_APP("[Clock] Remote sync, drift %ld ppb", static_cast<long>(discipline_.ratePpb()));
+}
+
+uint32_t AstroClock::nowMs() {
+    return fromMillis(millis());
+}
+
+uint32_t AstroClock::fromMillis(uint32_t localMs) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return discipline_.disciplinedMs(localMs);
+}
+
+uint64_t AstroClock::epochMs() {
+    const uint32_t now = millis();
+    std::lock_guard<std::mutex> lock(mutex_);
+    return discipline_.epochMs(now);
+}
+
+uint32_t AstroClock::coarseEpochSec() {
+    const uint32_t now = millis();
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (discipline_.hasReference()) {
+        return static_cast<uint32_t>(discipline_.epochMs(now) / 1000);
+    }
+    return bootRtcEpochSec_ ? bootRtcEpochSec_ + (now - bootMs_) / 1000 : 0;
+}
+
+bool AstroClock::isSynced() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return synced_;
+}
+
+int32_t AstroClock::driftPpb() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return discipline_.ratePpb();
+}
+
+bool AstroClock::readRtcEpochSec(uint32_t& epochSec) {
+    if (!M5.Rtc.isEnabled()) {
+        return false;
+    }
+    const m5::rtc_datetime_t dt = M5.Rtc.getDateTime();
+    if (dt.date.year < RTC_MIN_VALID_YEAR) {
+        return false;
+    }
+    const int32_t days = daysFromCivil(dt.date.year, dt.date.month, dt.date.date);
+    epochSec = static_cast<uint32_t>(days) * 86400UL + dt.time.hours * 3600UL +
+               dt.time.minutes * 60UL + dt.time.seconds;
+    return true;
+}
+
+void AstroClock::writeRtcEpochSec(uint32_t epochSec) {
+    int32_t year = 0;
+    uint32_t month = 0, day = 0;
+    const int32_t days = static_cast<int32_t>(epochSec / 86400UL);
+    civilFromDays(days, year, month, day);
+    const uint32_t secOfDay = epochSec % 86400UL;
+
+    m5::rtc_datetime_t dt;
+    dt.date.year = static_cast<int16_t>(year);
+    dt.date.month = static_cast<int8_t>(month);
+    dt.date.date = static_cast<int8_t>(day);
+    dt.date.weekDay = static_cast<int8_t>((days + 4) % 7);  // 1970-01-01 was a Thursday
+    dt.time.hours = static_cast<int8_t>(secOfDay / 3600);
+    dt.time.minutes = static_cast<int8_t>((secOfDay / 60) % 60);
+    dt.time.seconds = static_cast<int8_t>(secOfDay % 60);
+    M5.Rtc.setDateTime(dt);
+}
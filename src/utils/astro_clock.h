@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+
+#include "utils/clock_discipline.h"
+
+// Timebase for astro sequences. millis() free-runs off the ESP32 crystal,
+// which can be tens of ppm off (over a second across a night), and knows
+// nothing of wall-clock time. AstroClock disciplines it (ClockDiscipline)
+// against two references:
+//  - the M5StickC's BM8563 RTC, whose second rollovers are sampled every
+//    RTC_SAMPLE_INTERVAL_MS from the UI loop;
+//  - wall-clock syncs written by the remote (ASTRO_TIME_CHAR_UUID), which
+//    also set the RTC so the next boot starts from true time.
+//
+// nowMs() is what AstroProcess schedules on; epochSec()/epochMs() give true
+// Unix time (0 until the first reference). Safe to call from any task.
+class AstroClock {
+public:
+    static constexpr uint32_t RTC_SAMPLE_INTERVAL_MS = 10UL * 60UL * 1000UL;
+    // A second edge is only trusted if the two RTC reads around it were at
+    // most this far apart (the loop may have been stalled in between).
+    static constexpr uint32_t RTC_EDGE_MAX_GAP_MS = 50;
+    // RTC contents before this year mean it was never set (or lost power).
+    static constexpr int RTC_MIN_VALID_YEAR = 2024;
+
+    static void init();
+    // Drive from the UI loop: RTC edge sampling and the deferred RTC write
+    // after a remote sync.
+    static void update();
+
+    // Remote wall-clock sync: Unix time in ms at the moment of the write.
+    static void sync(uint64_t epochMs);
+
+    // Rate-corrected millis(); continuous, wraps like millis().
+    static uint32_t nowMs();
+    // Convert a raw millis() stamp (e.g. a BLE notification time) to nowMs().
+    static uint32_t fromMillis(uint32_t localMs);
+
+    static uint64_t epochMs();
+    static uint32_t epochSec() { return static_cast<uint32_t>(epochMs() / 1000); }
+    // epochSec(), or before the first reference the RTC reading taken at
+    // init() advanced by millis() (whole-second accurate). 0 if neither.
+    // For boot-time decisions such as the age of a sequence checkpoint.
+    static uint32_t coarseEpochSec();
+    static bool isSynced();        // A remote sync has been received since boot
+    static int32_t driftPpb();     // Current crystal rate estimate
+
+private:
+    static std::mutex mutex_;
+    static ClockDiscipline discipline_;
+    static bool rtcValid_;
+    static bool synced_;
+    static bool rtcWritePending_;    // Remote sync not yet written to the RTC
+    static bool sampling_;           // Hunting for the next RTC second edge
+    static uint32_t lastRtcEpochSec_;
+    static uint32_t lastRtcReadMs_;
+    static uint32_t lastRtcSampleMs_;
+    static uint32_t bootRtcEpochSec_;  // RTC at init(); 0 if not set
+    static uint32_t bootMs_;
+
+    static bool readRtcEpochSec(uint32_t& epochSec);
+    static void writeRtcEpochSec(uint32_t epochSec);
+    static void sampleRtcEdge(uint32_t localMs);
+};
@@ -0,0 +1,130 @@
+#include "utils/checkpoint_store.h"
+
+#include <Arduino.h>
+#include <esp_attr.h>
+
+#include <cstring>
+
+#include "debug.h"
+#include "utils/preferences.h"
+
+std::mutex CheckpointStore::mutex_;
+bool CheckpointStore::mirrorDue_ = false;
+bool CheckpointStore::cleared_ = false;
+bool CheckpointStore::nvsHolds_ = true;  // Unknown until load(); erase is cheap
+uint32_t CheckpointStore::mirroredSequence_ = 0;
+uint32_t CheckpointStore::lastMirrorMs_ = 0;
+
+namespace {
+constexpr uint32_t SLOT_MAGIC = 0x4B435341;  // "ASCK"
+
+// The same layout is the RTC slot and the NVS blob.
+struct Slot {
+    uint32_t magic;
+    uint32_t sequence;  // Bumped per save(), so service() can skip unchanged data
+    uint16_t length;
+    uint8_t data[CheckpointStore::CAPACITY];
+    uint32_t crc;  // Over everything above
+};
+
+// Left alone by the bootloader on anything but a power-on reset.
+RTC_NOINIT_ATTR Slot rtcSlot;
+
+uint32_t crc32(const uint8_t* data, size_t length) {
+    uint32_t crc = 0xFFFFFFFF;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+uint32_t slotCrc(const Slot& slot) {
+    return crc32(reinterpret_cast<const uint8_t*>(&slot), offsetof(Slot, crc));
+}
+
+bool slotValid(const Slot& slot, size_t length) {
+    return slot.magic == SLOT_MAGIC && slot.length == length && slot.crc == slotCrc(slot);
+}
+}  // namespace
+
+void CheckpointStore::save(const void* data, size_t length, bool mirrorNow) {
+    if (length > CAPACITY) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    const uint32_t sequence = rtcSlot.magic == SLOT_MAGIC ? rtcSlot.sequence + 1 : 1;
+    rtcSlot.magic = SLOT_MAGIC;
+    rtcSlot.sequence = sequence;
+    rtcSlot.length = static_cast<uint16_t>(length);
+    memcpy(rtcSlot.data, data, length);
+    rtcSlot.crc = slotCrc(rtcSlot);
+    cleared_ = false;
+    mirrorDue_ = mirrorDue_ || mirrorNow;
+}
+
+bool CheckpointStore::load(void* data, size_t length) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (slotValid(rtcSlot, length)) {
+        memcpy(data, rtcSlot.data, length);
+        LOG_APP("[Checkpoint] Loaded from RTC memory (reset reason %d)",
+                static_cast<int>(esp_reset_reason()));
+        return true;
+    }
+
+    Slot nvs;
+    if (PreferencesManager::loadCheckpoint(&nvs, sizeof(nvs)) && slotValid(nvs, length)) {
+        // Power was lost: reseed the RTC slot so a reset during recovery finds it.
+        rtcSlot = nvs;
+        mirroredSequence_ = nvs.sequence;
+        memcpy(data, nvs.data, length);
+        LOG_APP("[Checkpoint] Loaded NVS mirror (sequence %lu)",
+                static_cast<unsigned long>(nvs.sequence));
+        return true;
+    }
+    nvsHolds_ = false;
+    return false;
+}
+
+void CheckpointStore::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    rtcSlot.magic = 0;  // The next save() restarts the sequence at 1
+    cleared_ = true;
+    mirrorDue_ = false;
+    mirroredSequence_ = 0;
+}
+
+void CheckpointStore::service() {
+    Slot copy;
+    bool erase = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (cleared_) {
+            if (!nvsHolds_) {
+                return;
+            }
+            nvsHolds_ = false;
+            erase = true;
+        } else {
+            const uint32_t now = millis();
+            if (rtcSlot.magic != SLOT_MAGIC || rtcSlot.sequence == mirroredSequence_ ||
+                (!mirrorDue_ && now - lastMirrorMs_ < NVS_MIRROR_INTERVAL_MS)) {
+                return;
+            }
+            copy = rtcSlot;
+            mirroredSequence_ = rtcSlot.sequence;
+            mirrorDue_ = false;
+            lastMirrorMs_ = now;
+            nvsHolds_ = true;
+        }
+    }
+
+    // Flash I/O outside the lock, so the sequencer's save() never waits on it.
+    if (erase) {
+        PreferencesManager::clearCheckpoint();
+    } else {
+        PreferencesManager::saveCheckpoint(&copy, sizeof(copy));
+    }
+}
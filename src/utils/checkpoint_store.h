@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+// Crash-survivable storage for one small record (AstroProcess's sequence
+// checkpoint). Two tiers:
+//  - an RTC_NOINIT slot, which survives panics, watchdog and brownout resets
+//    but not power loss. save() only copies into it and stamps a CRC, so it is
+//    cheap enough to call from the sequencer on every phase transition;
+//  - an NVS mirror for full power loss, written from the UI loop by service()
+//    (flash writes can stall for milliseconds) at most every
+//    NVS_MIRROR_INTERVAL_MS, or on the next loop pass for a save(.., true).
+//
+// load() prefers the RTC slot and falls back to the mirror; both are CRC
+// checked, so a torn or uninitialised slot reads as "no checkpoint".
+class CheckpointStore {
+public:
+    static constexpr size_t CAPACITY = 192;
+    static constexpr uint32_t NVS_MIRROR_INTERVAL_MS = 5UL * 60UL * 1000UL;
+
+    // Copy `length` bytes (<= CAPACITY) into the RTC slot. With mirrorNow the
+    // NVS copy is refreshed on the next service() instead of when it is due.
+    static void save(const void* data, size_t length, bool mirrorNow = false);
+    // Boot: fill `data` from the newest valid tier. False if neither holds a
+    // record of exactly `length` bytes.
+    static bool load(void* data, size_t length);
+    // Forget the checkpoint (sequence finished). The NVS erase is deferred to
+    // service() like any other flash write.
+    static void clear();
+
+    // Drive from the UI loop: performs any due NVS write or erase.
+    static void service();
+
+private:
+    static std::mutex mutex_;
+    static bool mirrorDue_;
+    static bool cleared_;
+    static bool nvsHolds_;           // NVS may hold a record (erase on clear)
+    static uint32_t mirroredSequence_;
+    static uint32_t lastMirrorMs_;
+};
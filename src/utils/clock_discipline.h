@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstdint>
+
+// Disciplines the free-running millis() counter against an external wall
+// clock (RTC second edges, remote time syncs). Pure arithmetic, no hardware,
+// so it is unit-tested natively; AstroClock owns the instance on device.
+//
+// Two views of time come out of it:
+//  - disciplinedMs(): millis() corrected for the crystal's rate error. It is
+//    continuous (a new reference only changes the slope from that point on),
+//    so it can drive deadline scheduling like millis() does.
+//  - epochMs(): true Unix time in ms, re-anchored at every reference.
+//
+// The rate is estimated over the longest available baseline (from the first
+// reference of the current baseline to the latest one), so a few tens of ms
+// of reference jitter average out to a few ppm over a night.
+class ClockDiscipline {
+public:
+    // Below this the baseline is too short for the reference jitter to
+    // average out; keep the previous rate estimate until it grows.
+    static constexpr uint32_t MIN_BASELINE_MS = 20UL * 60UL * 1000UL;
+    // A reference further than this from the predicted time, or implying a
+    // rate beyond MAX_RATE_PPB, is not a crystal but a stepped reference
+    // (clock set by hand, RTC rewritten): start a fresh baseline instead.
+    static constexpr int32_t MAX_STEP_MS = 1000;
+    static constexpr int32_t MAX_RATE_PPB = 500000;  // 500 ppm
+
+    // Feed one reference: at local counter value localMs the true time was
+    // epochMs. newBaseline discards the rate baseline (use after the reference
+    // source itself changed, e.g. the RTC was just set from a remote sync).
+    void addReference(uint32_t localMs, uint64_t epochMs, bool newBaseline = false) {
+        // Freeze the corrected clock at this instant before touching the rate,
+        // so disciplinedMs() stays continuous across the update.
+        const uint32_t discNow = disciplinedMs(localMs);
+        rateBaseLocalMs_ = localMs;
+        rateBaseDiscMs_ = discNow;
+
+        if (hasReference_ && !newBaseline) {
+            const int64_t residual = static_cast<int64_t>(epochMs - this->epochMs(localMs));
+            newBaseline = residual > MAX_STEP_MS || residual < -MAX_STEP_MS;
+        }
+
+        if (!hasReference_ || newBaseline) {
+            baselineLocalMs_ = localMs;
+            baselineEpochMs_ = epochMs;
+        } else {
+            const uint32_t localSpan = localMs - baselineLocalMs_;
+            const int64_t trueSpan = static_cast<int64_t>(epochMs - baselineEpochMs_);
+            if (localSpan >= MIN_BASELINE_MS) {
+                const int64_t ppb =
+                    (trueSpan - static_cast<int64_t>(localSpan)) * 1000000000LL / localSpan;
+                if (ppb > MAX_RATE_PPB || ppb < -MAX_RATE_PPB) {
+                    baselineLocalMs_ = localMs;
+                    baselineEpochMs_ = epochMs;
+                } else {
+                    ratePpb_ = static_cast<int32_t>(ppb);
+                }
+            }
+        }
+
+        anchorDiscMs_ = discNow;
+        anchorEpochMs_ = epochMs;
+        hasReference_ = true;
+    }
+
+    bool hasReference() const { return hasReference_; }
+
+    // Estimated rate error of the local counter, in parts per billion
+    // (positive: the crystal runs slow and corrected time runs ahead of it).
+    int32_t ratePpb() const { return ratePpb_; }
+
+    // millis() corrected for rate. Equal to localMs until a rate is known.
+    // Stamps slightly older than the latest reference convert correctly too.
+    uint32_t disciplinedMs(uint32_t localMs) const {
+        const int32_t delta = static_cast<int32_t>(localMs - rateBaseLocalMs_);
+        const int64_t correction = static_cast<int64_t>(delta) * ratePpb_ / 1000000000LL;
+        return rateBaseDiscMs_ + delta + static_cast<int32_t>(correction);
+    }
+
+    // Unix time in ms at local counter value localMs; 0 before any reference.
+    uint64_t epochMs(uint32_t localMs) const {
+        if (!hasReference_) {
+            return 0;
+        }
+        const int32_t sinceAnchor = static_cast<int32_t>(disciplinedMs(localMs) - anchorDiscMs_);
+        return anchorEpochMs_ + sinceAnchor;
+    }
+
+private:
+    bool hasReference_ = false;
+    int32_t ratePpb_ = 0;
+
+    // Piecewise-linear corrected clock: disciplined = base + delta * (1 + rate).
+    uint32_t rateBaseLocalMs_ = 0;
+    uint32_t rateBaseDiscMs_ = 0;
+
+    // Start of the rate-estimation baseline.
+    uint32_t baselineLocalMs_ = 0;
+    uint64_t baselineEpochMs_ = 0;
+
+    // Latest reference, for epoch conversion.
+    uint32_t anchorDiscMs_ = 0;
+    uint64_t anchorEpochMs_ = 0;
+};
@@ -0,0 +1,18 @@
+#include "utils/deep_sleep.h"
+
+#include <M5Unified.h>
+#include <esp_sleep.h>
+
+#include "debug.h"
+
+void DeepSleep::sleepFor(uint32_t seconds) {
+    LOG_APP("[Sleep] Deep sleep for %lu s", static_cast<unsigned long>(seconds));
+    M5.Display.setBrightness(0);
+    M5.Display.sleep();
+    // M5.Power arms the timer and powers down; BLE and the display go with it.
+    M5.Power.deepSleep(static_cast<uint64_t>(seconds) * 1000000ULL, false);
+}
+
+bool DeepSleep::wokeFromTimer() {
+    return esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_TIMER;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+
+// Deep sleep while a scheduled astro start is pending. The stick wakes on the
+// ESP32's RTC timer, reboots, finds the armed start in the sequence
+// checkpoint (the RTC_NOINIT slot survives deep sleep) and either sleeps
+// again or stays up to reconnect the camera.
+//
+// The timer runs off the RC slow clock, which can be a few percent off over
+// hours, so a long wait is slept short and finished with another sleep
+// rather than trusted to land inside the wake lead.
+class DeepSleep {
+public:
+    static constexpr uint32_t WAKE_LEAD_SEC = 90;  // Awake this long before the start
+    static constexpr uint32_t SLOW_CLOCK_TOLERANCE_PERMILLE = 20;
+    static constexpr uint32_t MIN_SLEEP_SEC = 60;  // Shorter waits are not worth a reboot
+
+    // Seconds to sleep with `untilStartSec` to go; 0 means stay awake.
+    static uint32_t sleepSecFor(uint32_t untilStartSec) {
+        if (untilStartSec <= WAKE_LEAD_SEC) {
+            return 0;
+        }
+        const uint64_t sec = static_cast<uint64_t>(untilStartSec - WAKE_LEAD_SEC) *
+                             (1000 - SLOW_CLOCK_TOLERANCE_PERMILLE) / 1000;
+        return sec < MIN_SLEEP_SEC ? 0 : static_cast<uint32_t>(sec);
+    }
+
+    // Display off, radio down, timer wakeup. Does not return.
+    static void sleepFor(uint32_t seconds);
+    // This boot is a timer wakeup from sleepFor().
+    static bool wokeFromTimer();
+};
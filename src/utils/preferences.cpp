@@ -34,6 +34,23 @@ bool PreferencesManager::getAutoConnect() {
     return value;
 }
 
+void PreferencesManager::saveCheckpoint(const void* data, size_t length) {
+    size_t written = preferences.putBytes(KEY_CHECKPOINT, data, length);
+    LOG_DEBUG("[Preferences] Saving checkpoint (written: %d bytes)\n", written);
+}
+
+bool PreferencesManager::loadCheckpoint(void* data, size_t length) {
+    if (preferences.getBytesLength(KEY_CHECKPOINT) != length) {
+        return false;
+    }
+    return preferences.getBytes(KEY_CHECKPOINT, data, length) == length;
+}
+
+void PreferencesManager::clearCheckpoint() {
+    preferences.remove(KEY_CHECKPOINT);
+    LOG_DEBUG("[Preferences] Checkpoint cleared");
+}
+
 PreferencesManager::BrightnessLevel PreferencesManager::getNextBrightnessLevel(
     uint8_t currentBrightness) {
     // Find the next brightness level
@@ -19,6 +19,11 @@ public:
     static void setAutoConnect(bool enabled);
     static bool getAutoConnect();
 
+    // NVS mirror of the astro sequence checkpoint (see CheckpointStore).
+    static void saveCheckpoint(const void* data, size_t length);
+    static bool loadCheckpoint(void* data, size_t length);
+    static void clearCheckpoint();
+
     // Helper for cycling through brightness levels
     static BrightnessLevel getNextBrightnessLevel(uint8_t currentBrightness);
 
@@ -27,6 +32,7 @@ private:
     static constexpr const char* NAMESPACE = "m5remote";
     static constexpr const char* KEY_BRIGHTNESS = "brightness";
     static constexpr const char* KEY_AUTO_CONNECT = "autoconnect";
+    static constexpr const char* KEY_CHECKPOINT = "astro_ckpt";
     static constexpr uint8_t DEFAULT_BRIGHTNESS = static_cast<uint8_t>(BrightnessLevel::Level3);
     static constexpr bool DEFAULT_AUTO_CONNECT = true;
 };
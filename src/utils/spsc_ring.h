@@ -0,0 +1,56 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Bounded single-producer / single-consumer ring, lock-free: the producer
+// only writes head_, the consumer only writes tail_, and each publishes with
+// a release store the other side reads with acquire. Meant for handing events
+// out of a BLE callback without blocking it. A push into a full ring fails
+// and is counted rather than overwriting what the consumer has not seen.
+//
+// One producer and one consumer at a time. Several threads may take turns on
+// one side as long as something else orders them (e.g. a mutex they share).
+template <typename T, size_t N>
+class SpscRing {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "capacity must be a power of two");
+
+public:
+    static constexpr size_t CAPACITY = N;
+
+    bool push(const T& item) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) == N) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        slots_[head & (N - 1)] = item;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T& item) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = slots_[tail & (N - 1)];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side: forget everything pushed so far.
+    void clear() { tail_.store(head_.load(std::memory_order_acquire), std::memory_order_release); }
+
+    size_t size() const {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+    uint32_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    T slots_[N];
+    std::atomic<size_t> head_{0};  // Next slot to write; free-running
+    std::atomic<size_t> tail_{0};  // Next slot to read; free-running
+    std::atomic<uint32_t> dropped_{0};
+};
@@ -14,11 +14,26 @@ export const ASTRO_STATE = Object.freeze({
   ERROR: 6,
 });
 
-// Packed AstroStatusPacket size (ble_remote_server.h): 1 + 2 + 2 + 4*6 + 1 + 1.
-export const ASTRO_STATUS_PACKET_BYTES = 31;
+// Packed AstroStatusPacket size (ble_remote_server.h):
+// 1 + 2 + 2 + 4*6 + 1 + 1 + 2, then segment 1 + 1 + 2 + 2, then schedule 4 + 4,
+// then rig skew 4 x 2.
+export const ASTRO_STATUS_PACKET_BYTES = 55;
 
-// Packed AstroParamPacket size (ble_remote_server.h): 4 x uint16.
-export const ASTRO_PARAMS_PACKET_BYTES = 8;
+// Packed AstroTimeSyncPacket size (ble_remote_server.h): uint64 epoch ms.
+export const ASTRO_TIME_SYNC_PACKET_BYTES = 8;
+
+// Packed AstroParamPacket size (ble_remote_server.h): 4 x uint16 + uint8 + uint16.
+export const ASTRO_PARAMS_PACKET_BYTES = 11;
+
+// Sequence plan blob (AstroPlan, astro_plan.h): 7-byte header, then 8 bytes
+// per segment.
+export const ASTRO_PLAN_VERSION = 1;
+export const ASTRO_PLAN_HEADER_BYTES = 7;
+export const ASTRO_PLAN_SEGMENT_BYTES = 8;
+export const ASTRO_PLAN_MAX_SEGMENTS = 8;
+
+// Mirrors AstroPlan::FrameType.
+export const FRAME_TYPE = Object.freeze({ LIGHT: 0, DARK: 1, FLAT: 2, BIAS: 3 });
 
 const STATE_LABELS = Object.freeze({
   [ASTRO_STATE.IDLE]: "Idle",
@@ -57,9 +72,133 @@ export function decodeAstroStatus(view) {
     phaseTotalSec: view.getUint32(25, true),
     isCameraConnected: view.getUint8(29) !== 0,
     errorCode: view.getUint8(30),
+    framesPerHour: view.getUint16(31, true),
+    segmentIndex: view.getUint8(33),
+    segmentCount: view.getUint8(34),
+    segmentCompletedFrames: view.getUint16(35, true),
+    segmentTotalFrames: view.getUint16(37, true),
+    scheduledStartTime: view.getUint32(39, true),
+    wakeToFirstFrameMs: view.getUint32(43, true),
+    openSkewMs: view.getUint16(47, true),
+    maxOpenSkewMs: view.getUint16(49, true),
+    closeSkewMs: view.getUint16(51, true),
+    maxCloseSkewMs: view.getUint16(53, true),
   };
 }
 
+// Astro status v2 (AstroStatusStream, astro_status_stream.h), once the client
+// opts in: a 0xA2 marker (a v1 packet starts with its state, 0..6), then
+// records of u8 seq | u8 dt | LEB128 field mask | the fields present, each at
+// its v1 width in declaration order. Left-out elapsed / remaining / phase
+// remaining moved by +dt / -dt / -dt; every mask bit set is a full snapshot.
+export const ASTRO_STATUS_FRAME_V2 = 0xa2;
+export const ASTRO_STATUS_FORMAT_BATCH = 0x01;
+const V2_FIELD_BYTES = [1, 2, 2, 4, 4, 4, 4, 4, 4, 1, 1, 2, 1, 1, 2, 2, 4, 4, 2, 2, 2, 2];
+const V2_FULL_MASK = 2 ** V2_FIELD_BYTES.length - 1;
+const V2_DERIVED = Object.freeze({ 5: 1, 6: -1, 7: -1 }); // field index -> sign of dt
+
+// Folds v1 packets and v2 frames into the current status; read() returns it
+// decoded (null until the first snapshot). Deltas must follow on by seq: after
+// a missed one `needsResync` is set and deltas are ignored until a snapshot —
+// the characteristic's READ value always is one — comes in. Records older
+// than what is held (a batch overtaken by that READ) are skipped.
+export class AstroStatusReader {
+  constructor() {
+    this.reset();
+  }
+
+  reset() {
+    this.image = null; // v1 byte image of the current status
+    this.lastSeq = -1;
+    this.needsResync = false;
+  }
+
+  read(view) {
+    if (!view || view.byteLength === 0) {
+      throw new RangeError("empty astro status");
+    }
+    if (view.getUint8(0) !== ASTRO_STATUS_FRAME_V2) {
+      const status = decodeAstroStatus(view);
+      this.image = new Uint8Array(
+        view.buffer.slice(view.byteOffset, view.byteOffset + ASTRO_STATUS_PACKET_BYTES),
+      );
+      this.lastSeq = -1;
+      this.needsResync = false;
+      return status;
+    }
+    let o = 1;
+    while (o < view.byteLength) {
+      o = this.#record(view, o);
+    }
+    return this.image ? decodeAstroStatus(new DataView(this.image.buffer)) : null;
+  }
+
+  // Applies (or skips) the record at `o`; returns the offset after it.
+  #record(view, o) {
+    if (o + 3 > view.byteLength) {
+      throw new RangeError(`astro status record truncated at ${o}`);
+    }
+    const seq = view.getUint8(o);
+    const dt = view.getUint8(o + 1);
+    let p = o + 2;
+    let mask = 0;
+    for (let shift = 0; ; shift += 7) {
+      if (p >= view.byteLength || shift >= 28) {
+        throw new RangeError("astro status mask truncated");
+      }
+      const b = view.getUint8(p++);
+      mask += (b & 0x7f) * 2 ** shift;
+      if (!(b & 0x80)) break;
+    }
+    if (mask > V2_FULL_MASK) {
+      throw new RangeError(`unknown astro status fields 0x${mask.toString(16)}`);
+    }
+
+    const full = mask === V2_FULL_MASK;
+    let apply = true;
+    if (!full) {
+      const step = (seq - this.lastSeq) & 0xff;
+      if (!this.image) {
+        this.needsResync = true;
+        apply = false;
+      } else if (step === 0 || step >= 128) {
+        apply = false; // Behind what we hold
+      } else if (step !== 1) {
+        this.image = null; // Missed a record
+        this.needsResync = true;
+        apply = false;
+      }
+    }
+
+    let next = null;
+    if (apply) {
+      next = full ? new Uint8Array(ASTRO_STATUS_PACKET_BYTES) : this.image.slice();
+    }
+    const v = next ? new DataView(next.buffer) : null;
+    let offset = 0;
+    V2_FIELD_BYTES.forEach((width, i) => {
+      if (mask & (1 << i)) {
+        if (p + width > view.byteLength) {
+          throw new RangeError(`astro status field ${i} truncated`);
+        }
+        if (next) {
+          next.set(new Uint8Array(view.buffer, view.byteOffset + p, width), offset);
+        }
+        p += width;
+      } else if (v && i in V2_DERIVED) {
+        v.setUint32(offset, (v.getUint32(offset, true) + V2_DERIVED[i] * dt) >>> 0, true);
+      }
+      offset += width;
+    });
+    if (next) {
+      this.image = next;
+      this.lastSeq = seq;
+      if (full) this.needsResync = false;
+    }
+    return p;
+  }
+}
+
 export function stateLabel(state) {
   return STATE_LABELS[state] ?? "Unknown";
 }
@@ -127,10 +266,87 @@ export function decodeAstroParams(view) {
     exposureSec: view.getUint16(2, true),
     subframeCount: view.getUint16(4, true),
     intervalSec: view.getUint16(6, true),
+    adaptiveInterval: view.getUint8(8) !== 0,
+    settleMs: view.getUint16(9, true),
   };
 }
 
+// Encode a wall-clock sync (Unix ms, little-endian) for ASTRO_TIME_CHAR_UUID.
+export function encodeTimeSync(epochMs) {
+  const v = new DataView(new ArrayBuffer(ASTRO_TIME_SYNC_PACKET_BYTES));
+  v.setBigUint64(0, BigInt(Math.round(epochMs)), true);
+  return v;
+}
+
+// Encode a sequence plan for ASTRO_PLAN_CHAR_UUID. `plan` is
+// { initialDelaySec, adaptiveInterval, settleMs, segments: [{ type,
+// pauseBefore, exposureSec, count, intervalSec }] }. Limits are checked by the
+// device, which rejects an invalid plan with a feedback error.
+export function encodeAstroPlan(plan) {
+  const segments = plan.segments ?? [];
+  if (segments.length === 0 || segments.length > ASTRO_PLAN_MAX_SEGMENTS) {
+    throw new RangeError(`astro plan needs 1..${ASTRO_PLAN_MAX_SEGMENTS} segments`);
+  }
+  const v = new DataView(
+    new ArrayBuffer(ASTRO_PLAN_HEADER_BYTES + segments.length * ASTRO_PLAN_SEGMENT_BYTES),
+  );
+  v.setUint8(0, ASTRO_PLAN_VERSION);
+  v.setUint8(1, segments.length);
+  v.setUint16(2, plan.initialDelaySec ?? 0, true);
+  v.setUint8(4, plan.adaptiveInterval ? 1 : 0);
+  v.setUint16(5, plan.settleMs ?? 0, true);
+  segments.forEach((seg, i) => {
+    const o = ASTRO_PLAN_HEADER_BYTES + i * ASTRO_PLAN_SEGMENT_BYTES;
+    v.setUint8(o, seg.type ?? FRAME_TYPE.LIGHT);
+    v.setUint8(o + 1, seg.pauseBefore ? 1 : 0);
+    v.setUint16(o + 2, seg.exposureSec, true);
+    v.setUint16(o + 4, seg.count, true);
+    v.setUint16(o + 6, seg.intervalSec, true);
+  });
+  return v;
+}
+
+// Decode the device's current plan (same layout as encodeAstroPlan).
+export function decodeAstroPlan(view) {
+  if (!view || view.byteLength < ASTRO_PLAN_HEADER_BYTES) {
+    throw new RangeError(`astro plan too short: ${view ? view.byteLength : 0}`);
+  }
+  if (view.getUint8(0) !== ASTRO_PLAN_VERSION) {
+    throw new RangeError(`unknown astro plan version ${view.getUint8(0)}`);
+  }
+  const count = view.getUint8(1);
+  if (view.byteLength < ASTRO_PLAN_HEADER_BYTES + count * ASTRO_PLAN_SEGMENT_BYTES) {
+    throw new RangeError(`astro plan truncated: ${count} segments in ${view.byteLength} bytes`);
+  }
+  const segments = [];
+  for (let i = 0; i < count; i++) {
+    const o = ASTRO_PLAN_HEADER_BYTES + i * ASTRO_PLAN_SEGMENT_BYTES;
+    segments.push({
+      type: view.getUint8(o),
+      pauseBefore: (view.getUint8(o + 1) & 1) !== 0,
+      exposureSec: view.getUint16(o + 2, true),
+      count: view.getUint16(o + 4, true),
+      intervalSec: view.getUint16(o + 6, true),
+    });
+  }
+  return {
+    initialDelaySec: view.getUint16(2, true),
+    adaptiveInterval: (view.getUint8(4) & 1) !== 0,
+    settleMs: view.getUint16(5, true),
+    segments,
+  };
+}
+
+// Whole-plan duration — matches AstroPlan::getTotalDurationSec.
+export function planTotalSec(plan) {
+  return plan.segments.reduce(
+    (total, seg) => total + seg.count * (seg.exposureSec + seg.intervalSec),
+    plan.initialDelaySec,
+  );
+}
+
 // Whole-sequence duration from the plan — matches Parameters::getTotalDurationSec.
+// With an adaptive interval this is the upper bound.
 export function sequenceTotalSec(params) {
   return (
     params.initialDelaySec +
@@ -161,3 +377,203 @@ export function formatDuration(totalSec) {
   if (m > 0) return s > 0 ? `${m}m ${s}s` : `${m}m`;
   return `${s}s`;
 }
+
+// --- Bulk channel (BulkTransfer, bulk_transfer.h) ---------------------------
+// Windowed reads of larger device data over BULK_CONTROL (requests + events)
+// and BULK_DATA (chunks: u32 offset + payload). Each chunk spends one credit;
+// the client re-grants them as it consumes chunks.
+
+export const BULK_SOURCE = Object.freeze({ FRAME_JOURNAL: 0, LINK_STATS: 1 });
+export const BULK_OP = Object.freeze({
+  OPEN: 0x01,
+  CREDIT: 0x02,
+  ABORT: 0x03,
+  OPENED: 0x81,
+  DONE: 0x82,
+  ERROR: 0x83,
+});
+export const BULK_DATA_HEADER_BYTES = 4;
+
+export function encodeBulkOpen(sourceId, offset, credits) {
+  const v = new DataView(new ArrayBuffer(8));
+  v.setUint8(0, BULK_OP.OPEN);
+  v.setUint8(1, sourceId);
+  v.setUint32(2, offset, true);
+  v.setUint16(6, credits, true);
+  return v;
+}
+
+export function encodeBulkCredit(credits) {
+  const v = new DataView(new ArrayBuffer(3));
+  v.setUint8(0, BULK_OP.CREDIT);
+  v.setUint16(1, credits, true);
+  return v;
+}
+
+export function encodeBulkAbort() {
+  return new DataView(new Uint8Array([BULK_OP.ABORT]).buffer);
+}
+
+// Control-channel event -> { op, ... }.
+export function decodeBulkEvent(view) {
+  const op = view.getUint8(0);
+  switch (op) {
+    case BULK_OP.OPENED:
+      return {
+        op,
+        sourceId: view.getUint8(1),
+        totalBytes: view.getUint32(2, true),
+        chunkPayload: view.getUint16(6, true),
+      };
+    case BULK_OP.DONE:
+      return { op, totalBytes: view.getUint32(1, true) };
+    case BULK_OP.ERROR:
+      return { op, error: view.getUint8(1) };
+    default:
+      throw new RangeError(`unknown bulk event 0x${op.toString(16)}`);
+  }
+}
+
+// Reassembles one transfer. chunk() returns how many credits to grant now
+// (every half window, so the device never waits on the round trip), or
+// throws on a gap — the caller re-OPENs at `received`.
+export class BulkReceiver {
+  constructor(window = 32) {
+    this.window = window;
+    this.bytes = null;
+    this.received = 0;
+    this.unacked = 0;
+  }
+
+  opened(event) {
+    if (!this.bytes || this.bytes.length !== event.totalBytes) {
+      this.bytes = new Uint8Array(event.totalBytes);
+      this.received = 0;
+    }
+    this.unacked = 0;
+  }
+
+  chunk(view) {
+    const offset = view.getUint32(0, true);
+    if (offset !== this.received) {
+      throw new RangeError(`bulk gap: got ${offset}, expected ${this.received}`);
+    }
+    const payload = new Uint8Array(
+      view.buffer,
+      view.byteOffset + BULK_DATA_HEADER_BYTES,
+      view.byteLength - BULK_DATA_HEADER_BYTES,
+    );
+    this.bytes.set(payload, offset);
+    this.received += payload.length;
+    this.unacked++;
+    if (this.unacked < this.window / 2) return 0;
+    const grant = this.unacked;
+    this.unacked = 0;
+    return grant;
+  }
+
+  get complete() {
+    return this.bytes !== null && this.received === this.bytes.length;
+  }
+}
+
+// Frame journal records (FrameRecord::encode, frame_journal.h): six u32
+// times, u16 frame, then segment / flags / rssi (signed) / errorCode bytes.
+export const FRAME_RECORD_BYTES = 30;
+
+export function decodeFrameJournal(bytes) {
+  const v = new DataView(bytes.buffer, bytes.byteOffset, bytes.byteLength);
+  const records = [];
+  for (let o = 0; o + FRAME_RECORD_BYTES <= v.byteLength; o += FRAME_RECORD_BYTES) {
+    records.push({
+      plannedOpenMs: v.getUint32(o, true),
+      openSentMs: v.getUint32(o + 4, true),
+      openConfirmedMs: v.getUint32(o + 8, true),
+      plannedCloseMs: v.getUint32(o + 12, true),
+      closeSentMs: v.getUint32(o + 16, true),
+      closeConfirmedMs: v.getUint32(o + 20, true),
+      frame: v.getUint16(o + 24, true),
+      segment: v.getUint8(o + 26),
+      flags: v.getUint8(o + 27),
+      rssi: v.getInt8(o + 28),
+      errorCode: v.getUint8(o + 29),
+    });
+  }
+  return records;
+}
+
+// Camera-link telemetry (LinkStats::encode, link_stats.h): a 16-byte header
+// (RSSI, connect / drop counts) then, per command class, counters, max
+// latencies and two fixed-bucket histograms (submit -> ack, submit -> status);
+// version 2 appends reconnect recovery times.
+export const LINK_STATS_CLASSES = Object.freeze(["shutter", "focus", "zoom", "record"]);
+// Inclusive upper bound (ms) of each histogram bucket; the last is open-ended.
+export const LINK_STATS_BOUNDS_MS = Object.freeze([10, 20, 50, 100, 200, 500, 1000, Infinity]);
+
+function decodeHistogram(v, o, buckets, maxMs) {
+  const counts = [];
+  for (let i = 0; i < buckets; i++) counts.push(v.getUint16(o + i * 2, true));
+  return { counts, maxMs, samples: counts.reduce((a, b) => a + b, 0) };
+}
+
+// Upper bound of the bucket holding the pct-th percentile sample, capped at
+// the histogram's max (LatencyHistogram::percentileMs); 0 with no samples.
+export function histogramPercentileMs(h, pct) {
+  if (h.samples === 0) return 0;
+  const rank = Math.ceil((h.samples * pct) / 100);
+  let seen = 0;
+  for (let i = 0; i < h.counts.length - 1; i++) {
+    seen += h.counts[i];
+    if (seen >= rank) return Math.min(LINK_STATS_BOUNDS_MS[i], h.maxMs);
+  }
+  return h.maxMs;
+}
+
+export function decodeLinkStats(bytes) {
+  const v = new DataView(bytes.buffer, bytes.byteOffset, bytes.byteLength);
+  const version = v.getUint8(0);
+  if (version !== 1 && version !== 2) {
+    throw new RangeError(`unknown link stats version ${version}`);
+  }
+  const classes = v.getUint8(1);
+  const buckets = v.getUint8(2);
+  const stats = {
+    rssi: {
+      last: v.getInt8(3),
+      min: v.getInt8(4),
+      max: v.getInt8(5),
+      mean: v.getInt8(6),
+      samples: v.getUint16(8, true),
+    },
+    connects: v.getUint16(10, true),
+    connectFailures: v.getUint16(12, true),
+    drops: v.getUint16(14, true),
+    classes: {},
+  };
+  const classBytes = 10 + 4 * buckets;
+  for (let c = 0; c < classes; c++) {
+    const o = 16 + c * classBytes;
+    stats.classes[LINK_STATS_CLASSES[c] ?? `class${c}`] = {
+      sent: v.getUint16(o, true),
+      failed: v.getUint16(o + 2, true),
+      noStatus: v.getUint16(o + 4, true),
+      ack: decodeHistogram(v, o + 10, buckets, v.getUint16(o + 6, true)),
+      status: decodeHistogram(v, o + 10 + 2 * buckets, buckets, v.getUint16(o + 8, true)),
+    };
+  }
+  // Version 2: how long dropped links took to come back (null before that).
+  stats.recovery = null;
+  if (version >= 2) {
+    const o = 16 + classes * classBytes;
+    const count = v.getUint16(o, true);
+    const totalMs = v.getUint32(o + 12, true);
+    stats.recovery = {
+      count,
+      attempts: v.getUint16(o + 2, true),
+      lastMs: v.getUint32(o + 4, true),
+      maxMs: v.getUint32(o + 8, true),
+      meanMs: count ? Math.round(totalMs / count) : 0,
+    };
+  }
+  return stats;
+}
@@ -5,7 +5,11 @@ import {
   ASTRO_STATUS_PACKET_BYTES,
   ASTRO_PARAMS_PACKET_BYTES,
   decodeAstroStatus,
+  ASTRO_STATUS_FRAME_V2,
+  AstroStatusReader,
   decodeAstroParams,
+  encodeTimeSync,
+  ASTRO_TIME_SYNC_PACKET_BYTES,
   formatMMSS,
   formatDuration,
   barFraction,
@@ -14,6 +18,21 @@ import {
   isFinished,
   sequenceTotalSec,
   smoothProgress,
+  encodeAstroPlan,
+  decodeAstroPlan,
+  planTotalSec,
+  FRAME_TYPE,
+  BULK_SOURCE,
+  BULK_OP,
+  BULK_DATA_HEADER_BYTES,
+  encodeBulkOpen,
+  encodeBulkCredit,
+  decodeBulkEvent,
+  BulkReceiver,
+  FRAME_RECORD_BYTES,
+  decodeFrameJournal,
+  decodeLinkStats,
+  histogramPercentileMs,
 } from "./astro-status.js";
 
 // Build a packed little-endian AstroStatusPacket buffer for tests. Mirrors the
@@ -32,11 +51,22 @@ function packStatus(f = {}) {
   v.setUint32(25, f.phaseTotalSec ?? 0, true);
   v.setUint8(29, f.isCameraConnected ?? 0);
   v.setUint8(30, f.errorCode ?? 0);
+  v.setUint16(31, f.framesPerHour ?? 0, true);
+  v.setUint8(33, f.segmentIndex ?? 0);
+  v.setUint8(34, f.segmentCount ?? 1);
+  v.setUint16(35, f.segmentCompletedFrames ?? 0, true);
+  v.setUint16(37, f.segmentTotalFrames ?? 0, true);
+  v.setUint32(39, f.scheduledStartTime ?? 0, true);
+  v.setUint32(43, f.wakeToFirstFrameMs ?? 0, true);
+  v.setUint16(47, f.openSkewMs ?? 0, true);
+  v.setUint16(49, f.maxOpenSkewMs ?? 0, true);
+  v.setUint16(51, f.closeSkewMs ?? 0, true);
+  v.setUint16(53, f.maxCloseSkewMs ?? 0, true);
   return v;
 }
 
-test("packet size matches the 31-byte firmware struct", () => {
-  assert.equal(ASTRO_STATUS_PACKET_BYTES, 31);
+test("packet size matches the 55-byte firmware struct", () => {
+  assert.equal(ASTRO_STATUS_PACKET_BYTES, 55);
 });
 
 test("decodeAstroStatus reads every field little-endian", () => {
@@ -52,6 +82,17 @@ test("decodeAstroStatus reads every field little-endian", () => {
     phaseTotalSec: 30,
     isCameraConnected: 1,
     errorCode: 0,
+    framesPerHour: 116,
+    segmentIndex: 1,
+    segmentCount: 3,
+    segmentCompletedFrames: 2,
+    segmentTotalFrames: 300,
+    scheduledStartTime: 1700003600,
+    wakeToFirstFrameMs: 4200,
+    openSkewMs: 35,
+    maxOpenSkewMs: 120,
+    closeSkewMs: 28,
+    maxCloseSkewMs: 300,
   });
   const s = decodeAstroStatus(v);
   assert.equal(s.state, ASTRO_STATE.EXPOSING);
@@ -65,6 +106,92 @@ test("decodeAstroStatus reads every field little-endian", () => {
   assert.equal(s.phaseTotalSec, 30);
   assert.equal(s.isCameraConnected, true);
   assert.equal(s.errorCode, 0);
+  assert.equal(s.framesPerHour, 116);
+  assert.equal(s.segmentIndex, 1);
+  assert.equal(s.segmentCount, 3);
+  assert.equal(s.segmentCompletedFrames, 2);
+  assert.equal(s.segmentTotalFrames, 300);
+  assert.equal(s.scheduledStartTime, 1700003600);
+  assert.equal(s.wakeToFirstFrameMs, 4200);
+  assert.equal(s.openSkewMs, 35);
+  assert.equal(s.maxOpenSkewMs, 120);
+  assert.equal(s.closeSkewMs, 28);
+  assert.equal(s.maxCloseSkewMs, 300);
+});
+
+// One v2 frame from records of [seq, dt, ...LEB128 mask, ...field bytes].
+function v2Frame(...records) {
+  const bytes = [ASTRO_STATUS_FRAME_V2, ...records.flat()];
+  return new DataView(new Uint8Array(bytes).buffer);
+}
+
+// A full-snapshot record: all 22 mask bits, then the whole v1 packet.
+function v2Snapshot(seq, fields) {
+  const packet = packStatus(fields);
+  return [seq, 0, 0xff, 0xff, 0xff, 0x01, ...new Uint8Array(packet.buffer)];
+}
+
+const EXPOSING = {
+  state: 2,
+  completedFrames: 3,
+  totalFrames: 10,
+  elapsedSec: 100,
+  remainingSec: 230,
+  phaseRemainingSec: 20,
+  phaseTotalSec: 30,
+};
+
+test("AstroStatusReader: a v2 snapshot decodes like the v1 packet", () => {
+  const reader = new AstroStatusReader();
+  assert.deepEqual(
+    reader.read(v2Frame(v2Snapshot(7, EXPOSING))),
+    decodeAstroStatus(packStatus(EXPOSING)),
+  );
+  assert.equal(reader.needsResync, false);
+});
+
+test("AstroStatusReader: a bare tick moves the counters by dt", () => {
+  const reader = new AstroStatusReader();
+  reader.read(v2Frame(v2Snapshot(7, EXPOSING)));
+  const s = reader.read(v2Frame([8, 1, 0x00]));
+  assert.equal(s.elapsedSec, 101);
+  assert.equal(s.remainingSec, 229);
+  assert.equal(s.phaseRemainingSec, 19);
+  assert.equal(s.completedFrames, 3);
+});
+
+test("AstroStatusReader: deltas carry only the fields present, batched", () => {
+  const reader = new AstroStatusReader();
+  reader.read(v2Frame(v2Snapshot(7, EXPOSING)));
+  // completedFrames (bit 1) = 4; then phaseRemainingSec (bit 7, two mask bytes) = 3.
+  const s = reader.read(v2Frame([8, 1, 0x02, 4, 0], [9, 1, 0x80, 0x01, 3, 0, 0, 0]));
+  assert.equal(s.completedFrames, 4);
+  assert.equal(s.phaseRemainingSec, 3);
+  assert.equal(s.elapsedSec, 102);
+  assert.equal(s.remainingSec, 228);
+});
+
+test("AstroStatusReader: a missed record asks for a resync", () => {
+  const reader = new AstroStatusReader();
+  assert.equal(reader.read(v2Frame([3, 1, 0x00])), null); // Delta before any snapshot
+  assert.equal(reader.needsResync, true);
+
+  reader.read(v2Frame(v2Snapshot(7, EXPOSING)));
+  assert.equal(reader.needsResync, false);
+  assert.equal(reader.read(v2Frame([9, 1, 0x00])), null); // 8 went missing
+  assert.equal(reader.needsResync, true);
+  assert.equal(reader.read(v2Frame(v2Snapshot(9, EXPOSING))).elapsedSec, 100);
+  assert.equal(reader.needsResync, false);
+  // A batch overtaken by that snapshot is skipped, then deltas follow on.
+  const s = reader.read(v2Frame([8, 1, 0x00], [9, 1, 0x00], [10, 1, 0x00]));
+  assert.equal(s.elapsedSec, 101);
+});
+
+test("AstroStatusReader still reads v1 packets and rejects unknown fields", () => {
+  const reader = new AstroStatusReader();
+  assert.equal(reader.read(packStatus(EXPOSING)).elapsedSec, 100);
+  assert.throws(() => reader.read(v2Frame([1, 0, 0x80, 0x80, 0x80, 0x02])), /unknown/);
+  assert.throws(() => reader.read(v2Frame([1, 0, 0x02, 4])), /truncated/);
 });
 
 test("decodeAstroStatus rejects a short buffer", () => {
@@ -166,31 +293,83 @@ function packParams(f = {}) {
   v.setUint16(2, f.exposureSec ?? 0, true);
   v.setUint16(4, f.subframeCount ?? 0, true);
   v.setUint16(6, f.intervalSec ?? 0, true);
+  v.setUint8(8, f.adaptiveInterval ?? 0);
+  v.setUint16(9, f.settleMs ?? 0, true);
   return v;
 }
 
-test("params packet is 8 bytes (4 x uint16)", () => {
-  assert.equal(ASTRO_PARAMS_PACKET_BYTES, 8);
+test("params packet is 11 bytes (4 x uint16 + uint8 + uint16)", () => {
+  assert.equal(ASTRO_PARAMS_PACKET_BYTES, 11);
 });
 
-test("decodeAstroParams reads all four fields little-endian", () => {
+test("decodeAstroParams reads all fields little-endian", () => {
   const v = packParams({
     initialDelaySec: 10,
     exposureSec: 90,
     subframeCount: 30,
     intervalSec: 4,
+    adaptiveInterval: 1,
+    settleMs: 700,
   });
   const p = decodeAstroParams(v);
   assert.equal(p.initialDelaySec, 10);
   assert.equal(p.exposureSec, 90);
   assert.equal(p.subframeCount, 30);
   assert.equal(p.intervalSec, 4);
+  assert.equal(p.adaptiveInterval, true);
+  assert.equal(p.settleMs, 700);
 });
 
 test("decodeAstroParams rejects a short buffer", () => {
   assert.throws(() => decodeAstroParams(new DataView(new ArrayBuffer(4))));
 });
 
+test("encodeTimeSync packs Unix ms as little-endian uint64", () => {
+  const v = encodeTimeSync(1700000000123);
+  assert.equal(v.byteLength, ASTRO_TIME_SYNC_PACKET_BYTES);
+  assert.equal(v.getBigUint64(0, true), 1700000000123n);
+  assert.equal(v.getUint8(0), 1700000000123 % 256);
+});
+
+const lightsThenDarks = {
+  initialDelaySec: 300,
+  adaptiveInterval: true,
+  settleMs: 700,
+  segments: [
+    { type: FRAME_TYPE.LIGHT, pauseBefore: false, exposureSec: 120, count: 60, intervalSec: 5 },
+    { type: FRAME_TYPE.DARK, pauseBefore: true, exposureSec: 120, count: 20, intervalSec: 5 },
+  ],
+};
+
+test("encodeAstroPlan matches the firmware blob layout", () => {
+  const v = encodeAstroPlan(lightsThenDarks);
+  assert.equal(v.byteLength, 7 + 2 * 8);
+  const bytes = Array.from(new Uint8Array(v.buffer));
+  assert.deepEqual(bytes.slice(0, 7), [1, 2, 0x2c, 0x01, 1, 0xbc, 0x02]);
+  assert.deepEqual(bytes.slice(15), [1, 1, 120, 0, 20, 0, 5, 0]);
+});
+
+test("decodeAstroPlan round-trips encodeAstroPlan", () => {
+  assert.deepEqual(decodeAstroPlan(encodeAstroPlan(lightsThenDarks)), lightsThenDarks);
+});
+
+test("encodeAstroPlan rejects empty and oversized plans", () => {
+  assert.throws(() => encodeAstroPlan({ segments: [] }));
+  const seg = lightsThenDarks.segments[0];
+  assert.throws(() => encodeAstroPlan({ segments: Array(9).fill(seg) }));
+});
+
+test("decodeAstroPlan rejects a bad version or truncated blob", () => {
+  const v = encodeAstroPlan(lightsThenDarks);
+  assert.throws(() => decodeAstroPlan(new DataView(v.buffer, 0, 10)));
+  v.setUint8(0, 2);
+  assert.throws(() => decodeAstroPlan(v));
+});
+
+test("planTotalSec = delay + each segment's frames*(exposure+interval)", () => {
+  assert.equal(planTotalSec(lightsThenDarks), 300 + 60 * 125 + 20 * 125);
+});
+
 test("sequenceTotalSec = delay + frames*(exposure+interval)", () => {
   const p = { initialDelaySec: 10, exposureSec: 90, subframeCount: 30, intervalSec: 4 };
   assert.equal(sequenceTotalSec(p), 10 + 30 * (90 + 4)); // 2830
@@ -290,3 +469,134 @@ test("smoothProgress freezes when paused / not running", () => {
   const b = smoothProgress(s, 5000);
   assert.deepEqual(a, b); // no advance while paused
 });
+
+// Bulk data chunk: u32 offset + payload, as BulkTransfer sends it.
+function bulkChunk(offset, payload) {
+  const buf = new Uint8Array(BULK_DATA_HEADER_BYTES + payload.length);
+  new DataView(buf.buffer).setUint32(0, offset, true);
+  buf.set(payload, BULK_DATA_HEADER_BYTES);
+  return new DataView(buf.buffer);
+}
+
+test("bulk requests match the BulkTransfer layout", () => {
+  const open = encodeBulkOpen(BULK_SOURCE.FRAME_JOURNAL, 0x01020304, 32);
+  assert.deepEqual(
+    [...new Uint8Array(open.buffer)],
+    [BULK_OP.OPEN, 0, 0x04, 0x03, 0x02, 0x01, 32, 0],
+  );
+  assert.deepEqual([...new Uint8Array(encodeBulkCredit(300).buffer)], [BULK_OP.CREDIT, 44, 1]);
+});
+
+test("decodeBulkEvent reads OPENED / DONE / ERROR", () => {
+  const opened = new DataView(new ArrayBuffer(8));
+  opened.setUint8(0, BULK_OP.OPENED);
+  opened.setUint32(2, 15360, true);
+  opened.setUint16(6, 240, true);
+  assert.deepEqual(decodeBulkEvent(opened), {
+    op: BULK_OP.OPENED,
+    sourceId: 0,
+    totalBytes: 15360,
+    chunkPayload: 240,
+  });
+  const error = new DataView(new Uint8Array([BULK_OP.ERROR, 4]).buffer);
+  assert.equal(decodeBulkEvent(error).error, 4);
+  assert.throws(() => decodeBulkEvent(new DataView(new Uint8Array([0x7f]).buffer)));
+});
+
+test("BulkReceiver reassembles and grants credits every half window", () => {
+  const rx = new BulkReceiver(4);
+  rx.opened({ totalBytes: 10 });
+  assert.equal(rx.chunk(bulkChunk(0, [1, 2, 3])), 0);
+  assert.equal(rx.chunk(bulkChunk(3, [4, 5, 6])), 2);
+  assert.equal(rx.chunk(bulkChunk(6, [7, 8, 9])), 0);
+  assert.equal(rx.complete, false);
+  rx.chunk(bulkChunk(9, [10]));
+  assert.equal(rx.complete, true);
+  assert.deepEqual([...rx.bytes], [1, 2, 3, 4, 5, 6, 7, 8, 9, 10]);
+});
+
+test("BulkReceiver rejects a gap and resumes after a re-OPEN", () => {
+  const rx = new BulkReceiver();
+  rx.opened({ totalBytes: 6 });
+  rx.chunk(bulkChunk(0, [1, 2]));
+  assert.throws(() => rx.chunk(bulkChunk(4, [5, 6])), /gap/);
+  rx.opened({ totalBytes: 6 }); // re-OPEN at rx.received keeps what arrived
+  assert.equal(rx.received, 2);
+  rx.chunk(bulkChunk(2, [3, 4, 5, 6]));
+  assert.deepEqual([...rx.bytes], [1, 2, 3, 4, 5, 6]);
+});
+
+test("decodeFrameJournal reads FrameRecord::encode records", () => {
+  const bytes = new Uint8Array(FRAME_RECORD_BYTES * 2);
+  const v = new DataView(bytes.buffer);
+  v.setUint32(0, 10000, true);
+  v.setUint32(4, 10012, true);
+  v.setUint32(20, 41000, true);
+  v.setUint16(24, 7, true);
+  v.setUint8(26, 1);
+  v.setUint8(27, 0x05);
+  v.setInt8(28, -67);
+  v.setUint16(FRAME_RECORD_BYTES + 24, 8, true);
+  const records = decodeFrameJournal(bytes);
+  assert.equal(records.length, 2);
+  assert.equal(records[0].openSentMs - records[0].plannedOpenMs, 12);
+  assert.equal(records[0].closeConfirmedMs, 41000);
+  assert.equal(records[0].frame, 7);
+  assert.equal(records[0].segment, 1);
+  assert.equal(records[0].flags, 0x05);
+  assert.equal(records[0].rssi, -67);
+  assert.equal(records[1].frame, 8);
+});
+
+test("decodeLinkStats reads LinkStats::encode", () => {
+  const bytes = new Uint8Array(16 + 4 * 42);
+  const v = new DataView(bytes.buffer);
+  v.setUint8(0, 1);
+  v.setUint8(1, 4);
+  v.setUint8(2, 8);
+  v.setInt8(3, -66);
+  v.setInt8(4, -80);
+  v.setInt8(5, -55);
+  v.setInt8(6, -64);
+  v.setUint16(8, 12, true);
+  v.setUint16(10, 3, true);
+  v.setUint16(14, 1, true);
+  const zoom = 16 + 2 * 42;
+  v.setUint16(zoom, 20, true); // sent
+  v.setUint16(zoom + 2, 1, true); // failed
+  v.setUint16(zoom + 6, 700, true); // ackMaxMs
+  v.setUint16(zoom + 10 + 2 * 2, 19, true); // 19 acks <= 50 ms
+  v.setUint16(zoom + 10 + 2 * 6, 1, true); // one <= 1000 ms
+  const stats = decodeLinkStats(bytes);
+  assert.equal(stats.rssi.last, -66);
+  assert.equal(stats.rssi.min, -80);
+  assert.equal(stats.rssi.samples, 12);
+  assert.equal(stats.connects, 3);
+  assert.equal(stats.drops, 1);
+  const z = stats.classes.zoom;
+  assert.equal(z.sent, 20);
+  assert.equal(z.failed, 1);
+  assert.equal(z.ack.samples, 20);
+  assert.equal(histogramPercentileMs(z.ack, 95), 50);
+  assert.equal(histogramPercentileMs(z.ack, 100), 700);
+  assert.equal(histogramPercentileMs(stats.classes.shutter.status, 95), 0);
+  assert.equal(stats.recovery, null);
+  bytes[0] = 3;
+  assert.throws(() => decodeLinkStats(bytes), /version/);
+});
+
+test("decodeLinkStats reads the version 2 recovery trailer", () => {
+  const bytes = new Uint8Array(16 + 4 * 42 + 16);
+  const v = new DataView(bytes.buffer);
+  v.setUint8(0, 2);
+  v.setUint8(1, 4);
+  v.setUint8(2, 8);
+  const o = 16 + 4 * 42;
+  v.setUint16(o, 2, true); // recoveries
+  v.setUint16(o + 2, 6, true); // attempts
+  v.setUint32(o + 4, 4000, true); // last
+  v.setUint32(o + 8, 70000, true); // max
+  v.setUint32(o + 12, 74000, true); // total
+  const { recovery } = decodeLinkStats(bytes);
+  assert.deepEqual(recovery, { count: 2, attempts: 6, lastMs: 4000, maxMs: 70000, meanMs: 37000 });
+});
@@ -1,7 +1,12 @@
 import {
   ASTRO_STATE,
-  decodeAstroStatus,
+  AstroStatusReader,
+  ASTRO_STATUS_FORMAT_BATCH,
   decodeAstroParams,
+  encodeTimeSync,
+  encodeAstroPlan,
+  decodeAstroPlan,
+  planTotalSec,
   interpolate,
   formatMMSS,
   formatDuration,
@@ -10,6 +15,14 @@ import {
   isFinished,
   sequenceTotalSec,
   smoothProgress,
+  BULK_SOURCE,
+  BULK_OP,
+  encodeBulkOpen,
+  encodeBulkCredit,
+  decodeBulkEvent,
+  BulkReceiver,
+  decodeFrameJournal,
+  decodeLinkStats,
 } from "./astro-status.js";
 
 class M5RemoteClient {
@@ -20,10 +33,18 @@ class M5RemoteClient {
     this.FEEDBACK_CHAR_UUID = "180f1002-1234-5678-90ab-cdef12345678";
     this.ASTRO_STATUS_CHAR_UUID = "180f1003-1234-5678-90ab-cdef12345678";
     this.ASTRO_PARAMS_CHAR_UUID = "180f1005-1234-5678-90ab-cdef12345678";
+    this.ASTRO_TIME_CHAR_UUID = "180f1006-1234-5678-90ab-cdef12345678";
+    this.ASTRO_PLAN_CHAR_UUID = "180f1007-1234-5678-90ab-cdef12345678";
+    this.BULK_CONTROL_CHAR_UUID = "180f1008-1234-5678-90ab-cdef12345678";
+    this.BULK_DATA_CHAR_UUID = "180f1009-1234-5678-90ab-cdef12345678";
 
     // Button command words (0x01XX) + release, matching RemoteCmd.
     this.BUTTON_DOWN = 0x0100;
     this.BUTTON_UP = 0x0101;
+    // Astro "start at" (0x0205) + u32 Unix seconds; 0 cancels.
+    this.ASTRO_SCHEDULE = 0x0205;
+    // Astro status format (0x0206) + u8 version + u8 flags: v2 deltas, batched.
+    this.ASTRO_STATUS_FORMAT = 0x0206;
 
     this.device = null;
     this.server = null;
@@ -31,7 +52,15 @@ class M5RemoteClient {
     this.controlChar = null;
     this.feedbackChar = null;
     this.astroStatusChar = null;
+    this.astroStatusReader = new AstroStatusReader();
+    this.resyncing = false; // a resync READ in flight
     this.astroParamsChar = null;
+    this.astroTimeChar = null;
+    this.astroPlanChar = null;
+    this.bulkControlChar = null;
+    this.bulkDataChar = null;
+    this.bulk = null; // transfer in flight: { sourceId, receiver, resolve, reject }
+    this.bulkWrites = Promise.resolve(); // serialises bulk control writes
 
     this.currentButtonId = null; // Which button is held (null = none).
 
@@ -40,8 +69,10 @@ class M5RemoteClient {
     this.lastStatus = null;
     this.lastStatusAt = 0;
     this.lastParams = null; // configured sequence plan (delay/exposure/…)
+    this.lastPlan = null; // multi-segment plan (lights/darks/flats), if any
     this.tickTimer = null;
     this.pollTimer = null; // polls status while idle (no notifications then)
+    this.clockTimer = null; // periodic wall-clock sync to the device
 
     this.el = {
       deviceStatus: document.getElementById("status"),
@@ -252,6 +283,7 @@ class M5RemoteClient {
           (e) => this.handleAstroStatus(e.target.value),
         );
         await this.astroStatusChar.startNotifications();
+        await this.requestStatusFormat();
         // Prime with the current value so the panel isn't blank until the
         // next change.
         try {
@@ -281,6 +313,58 @@ class M5RemoteClient {
         console.warn("[BLE] astro-params characteristic unavailable:", err);
       }
 
+      // Multi-segment plan — READ to prime, NOTIFY on change, WRITE to load
+      // a new one (sendPlan).
+      try {
+        this.astroPlanChar = await this.service.getCharacteristic(
+          this.ASTRO_PLAN_CHAR_UUID,
+        );
+        this.astroPlanChar.addEventListener(
+          "characteristicvaluechanged",
+          (e) => this.handleAstroPlan(e.target.value),
+        );
+        await this.astroPlanChar.startNotifications();
+        try {
+          this.handleAstroPlan(await this.astroPlanChar.readValue());
+        } catch {}
+      } catch (err) {
+        console.warn("[BLE] astro-plan characteristic unavailable:", err);
+      }
+
+      // Bulk channel — windowed reads of larger data (readBulk). Both chars
+      // must be subscribed before the first OPEN.
+      try {
+        this.bulkControlChar = await this.service.getCharacteristic(
+          this.BULK_CONTROL_CHAR_UUID,
+        );
+        this.bulkDataChar = await this.service.getCharacteristic(
+          this.BULK_DATA_CHAR_UUID,
+        );
+        this.bulkControlChar.addEventListener("characteristicvaluechanged", (e) =>
+          this.handleBulkEvent(e.target.value),
+        );
+        this.bulkDataChar.addEventListener("characteristicvaluechanged", (e) =>
+          this.handleBulkData(e.target.value),
+        );
+        await this.bulkControlChar.startNotifications();
+        await this.bulkDataChar.startNotifications();
+      } catch (err) {
+        console.warn("[BLE] bulk characteristics unavailable:", err);
+        this.bulkControlChar = null;
+        this.bulkDataChar = null;
+      }
+
+      // Wall-clock sync — gives the device true epoch time and a drift
+      // reference. Re-sent periodically while connected.
+      try {
+        this.astroTimeChar = await this.service.getCharacteristic(
+          this.ASTRO_TIME_CHAR_UUID,
+        );
+        await this.syncClock();
+      } catch (err) {
+        console.warn("[BLE] astro-time characteristic unavailable:", err);
+      }
+
       this.setDeviceStatus("Connected to " + (device.name || "M5Remote"), "success");
       this.setConnectedUI(true);
       this.startTicker();
@@ -313,8 +397,16 @@ class M5RemoteClient {
     this.feedbackChar = null;
     this.astroStatusChar = null;
     this.astroParamsChar = null;
+    this.astroTimeChar = null;
+    this.astroPlanChar = null;
+    this.bulkControlChar = null;
+    this.bulkDataChar = null;
+    if (this.bulk) this.bulk.reject(new Error("disconnected"));
+    this.bulk = null;
+    this.astroStatusReader.reset();
     this.lastStatus = null;
     this.lastParams = null;
+    this.lastPlan = null;
     this.renderPlan(null);
     this.renderStatus(null);
   }
@@ -323,7 +415,10 @@ class M5RemoteClient {
 
   handleAstroStatus(value) {
     try {
-      this.lastStatus = decodeAstroStatus(value);
+      const status = this.astroStatusReader.read(value);
+      if (this.astroStatusReader.needsResync) this.resyncAstroStatus();
+      if (!status) return;
+      this.lastStatus = status;
       this.lastStatusAt = performance.now();
       this.renderStatus(this.lastStatus, 0);
     } catch (err) {
@@ -331,6 +426,35 @@ class M5RemoteClient {
     }
   }
 
+  // A v2 delta went missing: the READ value is always a full snapshot.
+  async resyncAstroStatus() {
+    if (this.resyncing || !this.astroStatusChar) return;
+    this.resyncing = true;
+    try {
+      this.handleAstroStatus(await this.astroStatusChar.readValue());
+    } catch {} finally {
+      this.resyncing = false;
+    }
+  }
+
+  // Ask for v2 status deltas, batched into MTU-sized notifications. Firmware
+  // without it answers "Invalid command" and keeps sending v1 packets, which
+  // the reader decodes as well.
+  async requestStatusFormat() {
+    if (!this.controlChar) return;
+    const data = new Uint8Array([
+      (this.ASTRO_STATUS_FORMAT >> 8) & 0xff,
+      this.ASTRO_STATUS_FORMAT & 0xff,
+      2,
+      ASTRO_STATUS_FORMAT_BATCH,
+    ]);
+    try {
+      await this.controlChar.writeValue(data);
+    } catch (err) {
+      console.warn("[BLE] status format write failed:", err);
+    }
+  }
+
   handleAstroParams(value) {
     try {
       this.lastParams = decodeAstroParams(value);
@@ -340,6 +464,122 @@ class M5RemoteClient {
     }
   }
 
+  handleAstroPlan(value) {
+    try {
+      this.lastPlan = decodeAstroPlan(value);
+      this.renderPlan(this.lastParams);
+    } catch (err) {
+      console.error("[BLE] bad astro plan blob:", err);
+    }
+  }
+
+  // Load a multi-segment plan (see encodeAstroPlan for the shape). The device
+  // answers on the feedback characteristic and re-notifies the plan.
+  async sendPlan(plan) {
+    if (!this.astroPlanChar) return;
+    try {
+      await this.astroPlanChar.writeValue(encodeAstroPlan(plan));
+    } catch (err) {
+      console.warn("[BLE] plan write failed:", err);
+    }
+  }
+
+  // Arm the current plan to start at `date` (a Date; null cancels). The stick
+  // deep-sleeps until shortly before, so sync the clock first. The device
+  // answers on the feedback characteristic.
+  async scheduleStart(date) {
+    if (!this.controlChar) return false;
+    const startSec = date ? Math.floor(date.getTime() / 1000) : 0;
+    const data = new Uint8Array(6);
+    data[0] = (this.ASTRO_SCHEDULE >> 8) & 0xff;
+    data[1] = this.ASTRO_SCHEDULE & 0xff;
+    new DataView(data.buffer).setUint32(2, startSec, true);
+    try {
+      await this.syncClock();
+      await this.controlChar.writeValue(data);
+      return true;
+    } catch (err) {
+      console.warn("[BLE] schedule write failed:", err);
+      return false;
+    }
+  }
+
+  // --- Bulk transfer -----------------------------------------------------
+
+  // Read a whole bulk source (BULK_SOURCE) as a Uint8Array. One at a time.
+  readBulk(sourceId) {
+    if (!this.bulkControlChar) {
+      return Promise.reject(new Error("bulk channel unavailable"));
+    }
+    if (this.bulk) return Promise.reject(new Error("bulk transfer in progress"));
+    return new Promise((resolve, reject) => {
+      const receiver = new BulkReceiver();
+      this.bulk = { sourceId, receiver, resolve, reject };
+      this.writeBulk(encodeBulkOpen(sourceId, 0, receiver.window));
+    });
+  }
+
+  // The frame journal of the current / last run (see decodeFrameJournal).
+  async fetchJournal() {
+    return decodeFrameJournal(await this.readBulk(BULK_SOURCE.FRAME_JOURNAL));
+  }
+
+  // Camera-link latency histograms, RSSI and drops (see decodeLinkStats).
+  async fetchLinkStats() {
+    return decodeLinkStats(await this.readBulk(BULK_SOURCE.LINK_STATS));
+  }
+
+  // Without-response writes keep credit grants off the round trip; chained
+  // so Web Bluetooth never sees two GATT operations at once.
+  writeBulk(request) {
+    this.bulkWrites = this.bulkWrites
+      .then(() => this.bulkControlChar?.writeValueWithoutResponse(request))
+      .catch((err) => console.warn("[BLE] bulk request failed:", err));
+  }
+
+  finishBulk(error, value) {
+    const bulk = this.bulk;
+    this.bulk = null;
+    if (!bulk) return;
+    if (error) bulk.reject(error);
+    else bulk.resolve(value);
+  }
+
+  handleBulkEvent(value) {
+    if (!this.bulk) return;
+    try {
+      const event = decodeBulkEvent(value);
+      if (event.op === BULK_OP.OPENED) {
+        this.bulk.receiver.opened(event);
+        this.bulk.resyncing = false;
+      } else if (event.op === BULK_OP.DONE) {
+        if (this.bulk.resyncing) return; // the abandoned stream's end
+        const { receiver } = this.bulk;
+        if (receiver.complete) this.finishBulk(null, receiver.bytes);
+        else this.finishBulk(new Error("bulk transfer ended short"));
+      } else {
+        this.finishBulk(new Error(`bulk transfer failed (error ${event.error})`));
+      }
+    } catch (err) {
+      this.finishBulk(err);
+    }
+  }
+
+  handleBulkData(value) {
+    // After a gap, drop the rest of the old stream until the re-OPEN lands.
+    if (!this.bulk || this.bulk.resyncing) return;
+    const { sourceId, receiver } = this.bulk;
+    try {
+      const grant = receiver.chunk(value);
+      if (grant) this.writeBulk(encodeBulkCredit(grant));
+    } catch (err) {
+      // A dropped notification: ask again from the first missing byte.
+      console.warn("[BLE]", err.message);
+      this.bulk.resyncing = true;
+      this.writeBulk(encodeBulkOpen(sourceId, receiver.received, receiver.window));
+    }
+  }
+
   // Local 1 Hz interpolation between packets; each real packet re-snaps.
   startTicker() {
     this.stopTicker();
@@ -370,6 +610,8 @@ class M5RemoteClient {
         this.handleAstroStatus(await this.astroStatusChar.readValue());
       } catch {}
     }, 1500);
+    // Repeated syncs give the device a long baseline to measure its drift.
+    this.clockTimer = setInterval(() => this.syncClock(), 10 * 60 * 1000);
   }
 
   stopPolling() {
@@ -377,6 +619,21 @@ class M5RemoteClient {
       clearInterval(this.pollTimer);
       this.pollTimer = null;
     }
+    if (this.clockTimer) {
+      clearInterval(this.clockTimer);
+      this.clockTimer = null;
+    }
+  }
+
+  // Write the current wall-clock time to the device (AstroClock). Stamped
+  // immediately before the write so only the BLE latency is uncorrected.
+  async syncClock() {
+    if (!this.astroTimeChar) return;
+    try {
+      await this.astroTimeChar.writeValue(encodeTimeSync(Date.now()));
+    } catch (err) {
+      console.warn("[BLE] clock sync failed:", err);
+    }
   }
 
   isRunningState(state) {
@@ -404,8 +661,19 @@ class M5RemoteClient {
     // Exposure/interval/delay in raw seconds (how astro exposures are set);
     // Total stays compact since a sequence can run for hours.
     e.planExposure.textContent = `${p.exposureSec}s`;
-    e.planInterval.textContent = `${p.intervalSec}s`;
+    // Adaptive: the interval is only a cap, the camera's readiness sets the gap.
+    e.planInterval.textContent = p.adaptiveInterval
+      ? `≤${p.intervalSec}s`
+      : `${p.intervalSec}s`;
     e.planDelay.textContent = `${p.initialDelaySec}s`;
+    // A loaded multi-segment plan overrides the single block: list each
+    // segment's frame count and total the whole plan.
+    const plan = this.lastPlan;
+    if (plan && plan.segments.length > 1) {
+      e.planFrames.textContent = plan.segments.map((seg) => seg.count).join(" + ");
+      e.planTotal.textContent = formatDuration(planTotalSec(plan));
+      return;
+    }
     e.planFrames.textContent = String(p.subframeCount);
     e.planTotal.textContent = formatDuration(sequenceTotalSec(p));
   }
@@ -436,7 +704,14 @@ class M5RemoteClient {
 
     // State label + dot colour. "Finished" (all frames done) is distinguished
     // from a user "Stopped" — the firmware reports STOPPED for both.
-    e.stateLabel.textContent = finished ? "Finished" : stateLabel(s.state);
+    e.stateLabel.textContent = finished
+      ? "Finished"
+      : s.scheduledStartTime && !running
+        ? `Starts ${new Date(s.scheduledStartTime * 1000).toLocaleTimeString([], {
+            hour: "2-digit",
+            minute: "2-digit",
+          })}`
+        : stateLabel(s.state);
     let dotTone =
       {
         [ASTRO_STATE.EXPOSING]: "bg-ok",
@@ -452,7 +727,14 @@ class M5RemoteClient {
       (running ? " bar-active" : "");
 
     // Frames.
-    e.frameCount.textContent = `${s.completedFrames} / ${s.totalFrames}`;
+    e.frameCount.textContent =
+      `${s.completedFrames} / ${s.totalFrames}` +
+      (s.segmentCount > 1
+        ? ` · S${s.segmentIndex + 1}/${s.segmentCount} ` +
+          `${s.segmentCompletedFrames}/${s.segmentTotalFrames}`
+        : "") +
+      (s.framesPerHour ? ` · ${s.framesPerHour}/h` : "") +
+      (s.maxOpenSkewMs ? ` · skew ${s.openSkewMs}/${s.maxOpenSkewMs} ms` : "");
 
     // A terminal, non-finished state (user Stopped, Error, Idle) has stale
     // leftover timings — don't draw them as live progress.
@@ -498,6 +780,9 @@ class M5RemoteClient {
       const msg = {
         1: "Invalid parameters — sequence cannot start.",
         2: "Camera not connected.",
+        3: "Could not send the shutter command to the camera.",
+        4: "Camera did not confirm the shutter opened.",
+        5: "Camera did not confirm the shutter closed — check it.",
       }[s.errorCode] || `Error code ${s.errorCode}.`;
       e.errorBanner.textContent = msg;
       e.errorBanner.classList.remove("hidden");
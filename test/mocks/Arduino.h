@@ -14,6 +14,7 @@ extern uint32_t g_fakeMillis;
 inline void setMillis(uint32_t ms) { g_fakeMillis = ms; }
 inline void advanceMillis(uint32_t ms) { g_fakeMillis += ms; }
 inline uint32_t millis() { return g_fakeMillis; }
+inline uint32_t micros() { return g_fakeMillis * 1000; }
 inline void delay(uint32_t) {}  // no-op under native tests
 
 // ---- Serial stub ------------------------------------------------------------
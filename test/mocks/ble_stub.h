@@ -56,8 +56,19 @@ public:
     BLEAdvertising* getAdvertising() { return nullptr; }
 };
 
+// ---- GATT client events -----------------------------------------------------
+typedef int esp_gattc_cb_event_t;
+typedef uint8_t esp_gatt_if_t;
+typedef uint8_t esp_bd_addr_t[6];
+union esp_ble_gattc_cb_param_t {
+    struct {
+        uint16_t mtu;
+    } cfg_mtu;
+};
+
 // ---- Callback base classes --------------------------------------------------
 struct esp_ble_auth_cmpl_t {
+    esp_bd_addr_t bd_addr;
     bool success;
 };
 class BLESecurityCallbacks {
@@ -77,8 +88,19 @@ public:
 };
 class BLECharacteristicCallbacks {
 public:
+    enum Status {
+        SUCCESS_INDICATE,
+        SUCCESS_NOTIFY,
+        ERROR_INDICATE_DISABLED,
+        ERROR_NOTIFY_DISABLED,
+        ERROR_GATT,
+        ERROR_NO_CLIENT,
+        ERROR_INDICATE_TIMEOUT,
+        ERROR_INDICATE_FAILURE
+    };
     virtual ~BLECharacteristicCallbacks() = default;
     virtual void onWrite(BLECharacteristic*) {}
+    virtual void onStatus(BLECharacteristic*, Status, uint32_t) {}
 };
 
 // ---- Device entry point -----------------------------------------------------
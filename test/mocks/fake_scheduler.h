@@ -0,0 +1,41 @@
+// Stubbed scheduler for the native tests. Stands in for FreeRTOS preemption:
+// periodic jobs (a task's per-period body) fire on their cadence while the
+// fake clock advances, whatever the "main loop" in the test is doing. Model a
+// loop stuck in a blocking call as advance(N) with no loop code in between.
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Arduino.h"
+
+class FakeScheduler {
+public:
+    using Job = void (*)();
+
+    void addPeriodic(Job job, uint32_t periodMs) {
+        jobs_.push_back({job, periodMs, millis() + periodMs});
+    }
+
+    // Advance the fake clock by `ms` in 1 ms steps, running each job whenever
+    // its next period boundary is reached.
+    void advance(uint32_t ms) {
+        for (uint32_t i = 0; i < ms; i++) {
+            advanceMillis(1);
+            for (auto& j : jobs_) {
+                if (static_cast<int32_t>(millis() - j.nextDueMs) >= 0) {
+                    j.nextDueMs += j.periodMs;
+                    j.job();
+                }
+            }
+        }
+    }
+
+private:
+    struct Entry {
+        Job job;
+        uint32_t periodMs;
+        uint32_t nextDueMs;
+    };
+    std::vector<Entry> jobs_;
+};
@@ -0,0 +1,11 @@
+// Native-build fake of the FreeRTOS queue header: enough for headers that
+// hold a queue handle to parse. Nothing is queued natively.
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+
+typedef void* QueueHandle_t;
+
+inline QueueHandle_t xQueueCreate(UBaseType_t, UBaseType_t) { return nullptr; }
+inline BaseType_t xQueueSend(QueueHandle_t, const void*, TickType_t) { return pdFAIL; }
+inline BaseType_t xQueueReceive(QueueHandle_t, void*, TickType_t) { return pdFAIL; }
@@ -0,0 +1,37 @@
+// Native-build fake of FreeRTOS task creation. Tasks are recorded, never run:
+// a task body is an endless loop, so tests step its per-period work through
+// FakeScheduler (fake_scheduler.h) instead, and assert on how the task was
+// created (priority, core) from the record here.
+#pragma once
+
+#include "Arduino.h"
+#include "freertos/FreeRTOS.h"
+
+struct FakeTaskRecord {
+    int created = 0;
+    TaskFunction_t fn = nullptr;
+    const char* name = nullptr;
+    uint32_t stackBytes = 0;
+    UBaseType_t priority = 0;
+    BaseType_t core = -1;
+};
+extern FakeTaskRecord g_fakeTask;
+
+inline BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char* name,
+                                          uint32_t stackBytes, void*, UBaseType_t priority,
+                                          TaskHandle_t* handle, BaseType_t core) {
+    g_fakeTask.created++;
+    g_fakeTask.fn = fn;
+    g_fakeTask.name = name;
+    g_fakeTask.stackBytes = stackBytes;
+    g_fakeTask.priority = priority;
+    g_fakeTask.core = core;
+    if (handle) {
+        *handle = &g_fakeTask;
+    }
+    return pdPASS;
+}
+
+inline TickType_t xTaskGetTickCount() { return millis(); }
+inline void vTaskDelayUntil(TickType_t*, TickType_t) {}
+inline void vTaskDelay(TickType_t) {}
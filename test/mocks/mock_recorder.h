@@ -3,16 +3,33 @@
 #pragma once
 
 #include <cstdint>
+#include <deque>
 #include <vector>
 
 #include "transport/ble_remote_server.h"  // real AstroStatusPacket definition
+#include "transport/camera_commands.h"    // ShutterLatency
 
 struct AstroMockState {
     // CameraCommands
     int triggerBulbCalls = 0;
     int emergencyStopCalls = 0;
+    int rigArmOpenCalls = 0;  // armRigToggle(true)
+    int rigArmCloseCalls = 0;
+    int rigDisarmCalls = 0;
+    CameraCommands::TriggerSkewReport skew{};  // Returned by getTriggerSkew()
     bool triggerBulbShouldFail = false;
     bool shutterActive = false;  // Simulated camera shutter state (toggled by triggerBulb).
+    std::vector<uint32_t> openTimesMs;   // millis() of each toggle that opened the shutter
+    std::vector<uint32_t> closeTimesMs;  // millis() of each toggle that closed it
+    // Simulated camera response: a toggle takes effect shutterLatencyMs after it
+    // is sent (0 = immediately); the first dropToggles toggles are ignored.
+    uint32_t shutterLatencyMs = 0;
+    int dropToggles = 0;
+    bool togglePending = false;
+    uint32_t toggleDueMs = 0;
+    uint32_t shutterChangedAt = 0;
+    std::deque<CameraCommands::ShutterEdge> edges;  // Returned by nextShutterEdge()
+    CameraCommands::ShutterLatency latency{};  // returned by getShutterLatency()
 
     // BLERemoteServer::sendAstroStatus capture
     int sendAstroStatusCalls = 0;
@@ -22,6 +39,25 @@ struct AstroMockState {
     int sendAstroParamsCalls = 0;
     AstroParamPacket lastParams{};
 
+    // BLERemoteServer::sendAstroPlan capture
+    int sendAstroPlanCalls = 0;
+    std::vector<uint8_t> lastPlan;  // The blob as published
+
+    // BLERemoteServer::setAstroStatusFormat capture
+    int statusFormatCalls = 0;
+    uint8_t statusVersion = 0;
+    uint8_t statusFlags = 0;
+    size_t statusPayload = 0;
+
+    // BLERemoteServer::sendFeedback capture, in order
+    std::vector<CommandStatus> feedback;
+
+    // CheckpointStore: the RTC slot, as bytes
+    std::vector<uint8_t> checkpoint;
+    int checkpointSaves = 0;
+    int checkpointMirrorRequests = 0;
+    int checkpointClears = 0;
+
     void reset() { *this = AstroMockState{}; }
 };
 
@@ -1,41 +1,140 @@
 // Native unit tests for AstroProcess (the bulb-sequence state machine).
 //
 // Strategy: unity-build. We #include the real astro.cpp so there is nothing to
-// link, and we supply mock definitions for its three collaborators
-// (CameraCommands::takeBulb / emergencyStop, BLERemoteServer::sendAstroStatus).
+// link, and we supply mock definitions for its collaborators
+// (CameraCommands::takeBulb / emergencyStop, BLERemoteServer::sendAstroStatus,
+// AstroClock, CheckpointStore).
 // The fake Arduino clock lets a multi-minute sequence run instantly.
 
 #include <unity.h>
 
+#include <cstring>
+
 #include "Arduino.h"  // fake clock + Serial before anything pulls it transitively
 #include "debug.h"    // LOG_* macros + DebugLevel
+#include "fake_scheduler.h"
+#include "freertos/task.h"
 #include "mock_recorder.h"
+#include "utils/astro_clock.h"
+#include "utils/checkpoint_store.h"
+#include "utils/deep_sleep.h"
 
 // ---- Global definitions the code-under-test expects -------------------------
 uint32_t g_fakeMillis = 0;
 SerialStub Serial;
 DebugLevel DEBUG_LEVEL = DebugLevel::APP;
 AstroMockState g_mock;
+FakeTaskRecord g_fakeTask;
 
 // ---- Mock collaborators -----------------------------------------------------
 namespace CameraCommands {
+// Applies a delayed toggle once the simulated camera latency has elapsed.
+static void applyPendingToggle() {
+    if (g_mock.togglePending && millis() >= g_mock.toggleDueMs) {
+        g_mock.togglePending = false;
+        g_mock.shutterActive = !g_mock.shutterActive;
+        g_mock.shutterChangedAt = g_mock.toggleDueMs;
+        g_mock.edges.push_back({g_mock.toggleDueMs, g_mock.shutterActive});
+    }
+}
 bool triggerBulb() {
     g_mock.triggerBulbCalls++;
     if (g_mock.triggerBulbShouldFail) {
         return false;
     }
-    g_mock.shutterActive = !g_mock.shutterActive;  // Toggle, like the real camera.
+    applyPendingToggle();
+    // Record against the state this toggle is heading for.
+    (g_mock.shutterActive ? g_mock.closeTimesMs : g_mock.openTimesMs).push_back(millis());
+    if (g_mock.dropToggles > 0) {
+        g_mock.dropToggles--;  // Lost on the way: the camera never reacts.
+        return true;
+    }
+    if (g_mock.shutterLatencyMs == 0) {
+        g_mock.shutterActive = !g_mock.shutterActive;  // Toggle, like the real camera.
+        g_mock.shutterChangedAt = millis();
+        g_mock.edges.push_back({millis(), g_mock.shutterActive});
+    } else {
+        g_mock.togglePending = true;
+        g_mock.toggleDueMs = millis() + g_mock.shutterLatencyMs;
+    }
     return true;
 }
 bool emergencyStop() {
     g_mock.emergencyStopCalls++;
     return true;
 }
+size_t armRigToggle(bool open) {
+    (open ? g_mock.rigArmOpenCalls : g_mock.rigArmCloseCalls)++;
+    return 0;
+}
+void disarmRigToggle() {
+    g_mock.rigDisarmCalls++;
+}
+TriggerSkewReport getTriggerSkew() {
+    return g_mock.skew;
+}
+void resetTriggerSkew() {
+    g_mock.skew = TriggerSkewReport{};
+}
 bool isShutterActive() {
+    applyPendingToggle();
     return g_mock.shutterActive;
 }
+uint32_t getShutterChangeTime() {
+    applyPendingToggle();
+    return g_mock.shutterChangedAt;
+}
+ShutterLatency getShutterLatency() {
+    return g_mock.latency;
+}
+size_t pollStatus() {
+    applyPendingToggle();
+    return 0;
+}
+bool nextShutterEdge(ShutterEdge& edge) {
+    applyPendingToggle();
+    if (g_mock.edges.empty()) {
+        return false;
+    }
+    edge = g_mock.edges.front();
+    g_mock.edges.pop_front();
+    return true;
+}
 }  // namespace CameraCommands
 
+// Undisciplined timebase: the fake millis() is the true clock here.
+uint32_t AstroClock::nowMs() {
+    return millis();
+}
+uint32_t AstroClock::fromMillis(uint32_t localMs) {
+    return localMs;
+}
+uint64_t AstroClock::epochMs() {
+    return 1700000000000ULL + millis();
+}
+uint32_t AstroClock::coarseEpochSec() {
+    return static_cast<uint32_t>(epochMs() / 1000);
+}
+
+// Checkpoint storage: one slot held in the mock, like the RTC slot.
+void CheckpointStore::save(const void* data, size_t length, bool mirrorNow) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    g_mock.checkpoint.assign(bytes, bytes + length);
+    g_mock.checkpointSaves++;
+    g_mock.checkpointMirrorRequests += mirrorNow ? 1 : 0;
+}
+bool CheckpointStore::load(void* data, size_t length) {
+    if (g_mock.checkpoint.size() != length) {
+        return false;
+    }
+    memcpy(data, g_mock.checkpoint.data(), length);
+    return true;
+}
+void CheckpointStore::clear() {
+    g_mock.checkpoint.clear();
+    g_mock.checkpointClears++;
+}
+
 void BLERemoteServer::sendAstroStatus(const AstroStatusPacket& status) {
     g_mock.sendAstroStatusCalls++;
     g_mock.lastStatus = status;
@@ -46,8 +145,27 @@ void BLERemoteServer::sendAstroParams(const AstroParamPacket& params) {
     g_mock.lastParams = params;
 }
 
+void BLERemoteServer::sendAstroPlan(const uint8_t* blob, size_t length) {
+    g_mock.sendAstroPlanCalls++;
+    g_mock.lastPlan.assign(blob, blob + length);
+}
+
+void BLERemoteServer::setAstroStatusFormat(uint8_t version, uint8_t flags, size_t payload) {
+    g_mock.statusFormatCalls++;
+    g_mock.statusVersion = version;
+    g_mock.statusFlags = flags;
+    g_mock.statusPayload = payload;
+}
+
+void BLERemoteServer::sendFeedback(CommandStatus status) {
+    g_mock.feedback.push_back(status);
+}
+
 // ---- Code under test (unity build) ------------------------------------------
 #include "processes/astro.cpp"
+#include "processes/astro_mailbox.cpp"
+#include "processes/astro_plan.cpp"
+#include "processes/astro_sequencer.cpp"
 // Observer under test too: it forwards process callbacks to the mocked
 // BLERemoteServer::send* above (header-only, safe to unity-include here).
 #include "transport/ble_astro_observer.h"
@@ -68,7 +186,8 @@ struct CountingObserver : public AstroProcess::Observer {
 };
 
 // Drive the state machine forward by `seconds`, ticking update() once per
-// simulated second (matches the 1 Hz granularity astro.cpp works at).
+// simulated second. astro.cpp schedules in ms; whole-second ticks land exactly
+// on the deadlines here, which keeps the phase assertions below simple.
 static void advanceSeconds(uint32_t seconds) {
     for (uint32_t i = 0; i < seconds; i++) {
         advanceMillis(1000);
@@ -80,7 +199,7 @@ void setUp() {
     g_mock.reset();
     setMillis(0);
     astro().reset();
-    // reset() leaves lastUpdateTime_ stale; prime it with one tick at t=0.
+    // Prime the sequencer with one tick at t=0.
     astro().update();
 }
 
@@ -171,6 +290,54 @@ void test_full_sequence_completes() {
                       static_cast<int>(astro().getStatus().state));
 }
 
+// The rig cameras follow every frame: armed to open ahead of each open toggle
+// and to close ahead of each close.
+void test_rig_armed_per_frame() {
+    AstroProcess::Parameters p;
+    p.initialDelaySec = 5;
+    p.exposureSec = 30;
+    p.subframeCount = 10;
+    p.intervalSec = 3;
+    astro().setParameters(p);
+    astro().setCameraConnected(true);
+
+    astro().start();
+    advanceSeconds(350);
+
+    TEST_ASSERT_EQUAL(10, g_mock.rigArmOpenCalls);
+    TEST_ASSERT_EQUAL(10, g_mock.rigArmCloseCalls);
+    TEST_ASSERT_EQUAL(0, g_mock.rigDisarmCalls);
+}
+
+// The rig's trigger skew is cleared when a sequence starts and reported from
+// the shutter confirmations on.
+void test_rig_skew_in_status() {
+    g_mock.skew.open.samples = 4;
+    g_mock.skew.open.maxMs = 900;  // Left from an earlier run
+    AstroProcess::Parameters p;
+    p.initialDelaySec = 5;
+    p.exposureSec = 30;
+    p.subframeCount = 10;
+    p.intervalSec = 3;
+    astro().setParameters(p);
+    astro().setCameraConnected(true);
+
+    astro().start();
+    TEST_ASSERT_EQUAL_UINT16(0, astro().getStatus().maxOpenSkewMs);
+
+    g_mock.skew.open.lastMs = 40;
+    g_mock.skew.open.maxMs = 55;
+    g_mock.skew.close.lastMs = 30;
+    g_mock.skew.close.maxMs = 30;
+    advanceSeconds(40);  // First frame opened and closed
+
+    const AstroProcess::Status& status = astro().getStatus();
+    TEST_ASSERT_EQUAL_UINT16(40, status.openSkewMs);
+    TEST_ASSERT_EQUAL_UINT16(55, status.maxOpenSkewMs);
+    TEST_ASSERT_EQUAL_UINT16(30, status.closeSkewMs);
+    TEST_ASSERT_EQUAL_UINT16(30, status.maxCloseSkewMs);
+}
+
 // phaseRemainingSec counts down the time left in the CURRENT phase (delay,
 // exposure, or interval) — distinct from remainingSec (whole series).
 void test_phase_remaining_counts_down_per_phase() {
@@ -396,6 +563,813 @@ void test_bulb_failure_errors() {
 
     TEST_ASSERT_EQUAL(static_cast<int>(AstroProcess::State::ERROR),
                       static_cast<int>(astro().getStatus().state));
+    TEST_ASSERT_EQUAL(1, g_mock.rigDisarmCalls);  // The rig does not open without it
+}
+
+// Frames open on absolute deadlines from the sequence start, so a jittery loop
+// delays a toggle by at most one tick and that error never carries into the
+// next frame. Full night: 480 x 600 s, ticks landing 1..997 ms apart with
+// occasional 1.5 s stalls. Every open must sit within one tick of its plan,
+// including the very last frame ~80 h in, and every close within one tick of
+// a full exposure after its confirmed open.
+void test_no_cumulative_drift_over_full_night() {
+    AstroProcess::Parameters p;
+    p.initialDelaySec = 5;
+    p.exposureSec = 600;
+    p.subframeCount = 480;
+    p.intervalSec = 3;
+    astro().setParameters(p);
+    astro().setCameraConnected(true);
+
+    astro().start();
+
+    const uint32_t maxStepMs = 1500;
+    uint32_t seed = 12345;  // fixed LCG seed: deterministic jitter
+    while (astro().getStatus().state != AstroProcess::State::STOPPED &&
+           millis() < p.getTotalDurationSec() * 1000UL + 60000UL) {
+        seed = seed * 1103515245UL + 12345UL;
+        uint32_t step = 1 + (seed >> 16) % 997;
+        if ((seed >> 8) % 500 == 0) {
+            step = maxStepMs;  // the loop got stuck in something slow
+        }
+        advanceMillis(step);
+        astro().update();
+    }
+
+    TEST_ASSERT_EQUAL(static_cast<int>(AstroProcess::State::STOPPED),
+                      static_cast<int>(astro().getStatus().state));
+    TEST_ASSERT_EQUAL_UINT16(480, astro().getStatus().completedFrames);
+    TEST_ASSERT_EQUAL(480, (int)g_mock.openTimesMs.size());
+    TEST_ASSERT_EQUAL(480, (int)g_mock.closeTimesMs.size());
+
+    for (uint32_t k = 0; k < 480; k++) {
+        const uint32_t plannedOpen = 5000 + k * p.getFramePeriodMs();
+        const uint32_t plannedClose = g_mock.openTimesMs[k] + 600000;
+        TEST_ASSERT_TRUE(g_mock.openTimesMs[k] >= plannedOpen);
+        TEST_ASSERT_TRUE(g_mock.openTimesMs[k] - plannedOpen <= maxStepMs);
+        TEST_ASSERT_TRUE(g_mock.closeTimesMs[k] >= plannedClose);
+        TEST_ASSERT_TRUE(g_mock.closeTimesMs[k] - plannedClose <= maxStepMs);
+    }
+    TEST_ASSERT_TRUE(astro().getStatus().maxOpenErrorMs <= maxStepMs);
+}
+
+// phaseRemainingMs / phaseTotalMs track the deadline at ms resolution, and the
+// whole-second figures round up (a countdown reads 1 until it reaches 0).
+void test_phase_timing_has_ms_resolution() {
+    AstroProcess::Parameters p;
+    p.initialDelaySec = 5;
+    p.exposureSec = 30;
+    p.subframeCount = 10;
+    p.intervalSec = 3;
+    astro().setParameters(p);
+    astro().setCameraConnected(true);
+
+    astro().start();
+    advanceMillis(1250);
+    astro().update();
+    TEST_ASSERT_EQUAL_UINT32(5000, astro().getStatus().phaseTotalMs);
+    TEST_ASSERT_EQUAL_UINT32(3750, astro().getStatus().phaseRemainingMs);
+    TEST_ASSERT_EQUAL_UINT32(4, astro().getStatus().phaseRemainingSec);
+
+    // First frame opens 40 ms late (tick at 5040); the close is planned from
+    // the on-time open until the camera confirms, and the error is reported.
+    advanceMillis(3790);
+    astro().update();
+    TEST_ASSERT_EQUAL(static_cast<int>(AstroProcess::State::EXPOSING),
+                      static_cast<int>(astro().getStatus().state));
+    TEST_ASSERT_EQUAL_INT32(40, astro().getStatus().openErrorMs);
+    TEST_ASSERT_EQUAL_UINT32(40, astro().getStatus().maxOpenErrorMs);
+    TEST_ASSERT_EQUAL_UINT32(29960, astro().getStatus().phaseRemainingMs);
+
+    // Next tick sees the open confirmed at 5040: a full 30 s from there.
+    advanceMillis(10);
+    astro().update();
+    TEST_ASSERT_EQUAL_UINT32(29990, astro().getStatus().phaseRemainingMs);
+}
+
+// The sequencer task is pinned to the app core at a priority above the Arduino
+// loop task (1), so it preempts a busy UI. start() is idempotent.
+void test_sequencer_task_outranks_loop_task() {
+    AstroSequencer::start();
+    AstroSequencer::start();
+    TEST_ASSERT_EQUAL(1, g_fakeTask.created);
+    TEST_ASSERT_TRUE(g_fakeTask.priority > 1);
+    TEST_ASSERT_EQUAL(1, g_fakeTask.core);
+    TEST_ASSERT_TRUE(AstroSequencer::isStarted());
+}
+
+// A UI loop stuck for 37 s (e.g. in a blocking reconnect) across a whole frame
+// must not stretch it: the sequencer task keeps ticking, so both toggles still
+// land within one sequencer tick of their deadlines.
+void test_blocked_ui_does_not_stretch_exposure() {
+    AstroProcess::Parameters p;
+    p.initialDelaySec = 5;
+    p.exposureSec = 30;
+    p.subframeCount = 10;
+    p.intervalSec = 3;
+    astro().setParameters(p);
+    astro().setCameraConnected(true);
+
+    FakeScheduler scheduler;
+    scheduler.addPeriodic(AstroSequencer::tick, AstroSequencer::TICK_MS);
+    astro().start();
+    scheduler.advance(37000);  // no UI code runs in this window
+
+    TEST_ASSERT_EQUAL(1, (int)g_mock.openTimesMs.size());
+    TEST_ASSERT_EQUAL(1, (int)g_mock.closeTimesMs.size());
+    TEST_ASSERT_UINT32_WITHIN(AstroSequencer::TICK_MS, 5000, g_mock.openTimesMs[0]);
+    TEST_ASSERT_UINT32_WITHIN(AstroSequencer::TICK_MS, 35000, g_mock.closeTimesMs[0]);
+    // The UI's view is the published snapshot, current as of the last tick.
+    TEST_ASSERT_EQUAL(static_cast<int>(AstroProcess::State::INTERVAL),
+                      static_cast<int>(astro().getStatus().state));
+}
+
+// Ticks update() every sequencer period for ms milliseconds.
+static void tickFor(uint32_t ms) {
+    for (uint32_t t = 0; t < ms; t += AstroSequencer::TICK_MS) {
+        advanceMillis(AstroSequencer::TICK_MS);
+        astro().update();
+    }
+}
+
+// With a camera that reports each toggle 150 ms late, the close is timed from
+// the confirmed open and sent one close-latency early, so the shutter is open
+// for the requested 30 s rather than 30 s plus a round trip.
+void test_close_compensates_shutter_latency() {
+    AstroProcess::Parameters p;
+    p.initialDelaySec = 5;
+    p.exposureSec = 30;
+    p.subframeCount = 10;
+    p.intervalSec = 3;
+    astro().setParameters(p);
+    astro().setCameraConnected(true);
+    g_mock.shutterLatencyMs = 150;
+    g_mock.latency = {150, 150, 4, 4};
+
+    astro().start();
+    tickFor(36000);
+
+    TEST_ASSERT_EQUAL(1, (int)g_mock.openTimesMs.size());
+    TEST_ASSERT_EQUAL(1, (int)g_mock.closeTimesMs.size());
+    TEST_ASSERT_EQUAL_UINT32(5000, g_mock.openTimesMs[0]);
+    TEST_ASSERT_EQUAL_UINT32(35000, g_mock.closeTimesMs[0]);  // 5150 + 30000 - 150
+    TEST_ASSERT_EQUAL_UINT32(30000, astro().getStatus().measuredExposureMs);
+    TEST_ASSERT_EQUAL_UINT32(150, astro().getStatus().openLatencyMs);
+    TEST_ASSERT_EQUAL_UINT32(150, astro().getStatus().closeLatencyMs);
+    TEST_ASSERT_EQUAL(static_cast<int>(AstroProcess::State::INTERVAL),
+                      static_cast<int>(astro().getStatus().state));
+}
+
+// A toggle the camera never acts on is retried once after CONFIRM_TIMEOUT_MS;
+// the retry landing recovers the frame without any extra toggle.
+void test_lost_open_toggle_is_retried() {
+    AstroProcess::Parameters p;
+    p.initialDelaySec = 5;
+    p.exposureSec = 30;
+    p.subframeCount = 10;
+    p.intervalSec = 3;
+    astro().setParameters(p);
+    astro().setCameraConnected(true);
+    g_mock.dropToggles = 1;
+
+    astro().start();
+    tickFor(5000 + AstroProcess::CONFIRM_TIMEOUT_MS + 100);
+
+    TEST_ASSERT_EQUAL(2, g_mock.triggerBulbCalls);
+    TEST_ASSERT_TRUE(g_mock.shutterActive);
+    TEST_ASSERT_EQUAL(static_cast<int>(AstroProcess::State::EXPOSING),
+                      static_cast<int>(astro().getStatus().state));
+    TEST_ASSERT_EQUAL(0, astro().getStatus().errorCode);
+}
+
+// An open confirmed only after its close deadline (lost toggle, slow
+// retry) is closed as soon as it confirms, not taken as already closed and
+// left open.
+void test_open_confirmed_after_close_deadline_is_closed() {
+    AstroPlan plan;
+    plan.initialDelaySec = 5;
+    plan.segmentCount = 1;
+    plan.segments[0] = {AstroPlan::FrameType::FLAT, false, 2, 1, 3};
+    TEST_ASSERT_TRUE(astro().setPlan(plan));
+    astro().setCameraConnected(true);
+    g_mock.dropToggles = 1;
+    g_mock.shutterLatencyMs = 900;
+
+    // Open lost at 5 s, retried at 6.2 s, on at 7.1 s; the close was due at 7 s.
+    astro().start();
+    tickFor(7050);
+    TEST_ASSERT_EQUAL(static_cast<int>(AstroProcess::State::STOPPED),
+                      static_cast<int>(astro().getStatus().state));
+    TEST_ASSERT_EQUAL(2, g_mock.triggerBulbCalls);
+    TEST_ASSERT_TRUE(g_mock.closeTimesMs.empty());
+
+    tickFor(1000);
+    TEST_ASSERT_EQUAL(3, g_mock.triggerBulbCalls);
+    TEST_ASSERT_EQUAL(1, (int)g_mock.closeTimesMs.size());
+    TEST_ASSERT_TRUE(g_mock.closeTimesMs[0] >= 7100);
+    tickFor(2000);
+    TEST_ASSERT_FALSE(g_mock.shutterActive);
+    TEST_ASSERT_EQUAL(3, g_mock.triggerBulbCalls);
+    TEST_ASSERT_EQUAL(0, astro().getStatus().errorCode);
+}
+
+// An open that never confirms drops the close it was holding back.
+void test_pending_close_dropped_when_open_gives_up() {
+    AstroPlan plan;
+    plan.initialDelaySec = 5;
+    plan.segmentCount = 1;
+    plan.segments[0] = {AstroPlan::FrameType::FLAT, false, 2, 1, 3};
+    TEST_ASSERT_TRUE(astro().setPlan(plan));
+    astro().setCameraConnected(true);
+    g_mock.dropToggles = 2;  // The open and its retry
+
+    astro().start();
+    tickFor(10000);
+    TEST_ASSERT_EQUAL(2, g_mock.triggerBulbCalls);
+    TEST_ASSERT_FALSE(g_mock.shutterActive);
+    TEST_ASSERT_EQUAL(4, astro().getStatus().errorCode);
+}
+
+// An open the camera reports and takes back within one tick (it aborted the
+// exposure) is still confirmed from its edge: the level alone would read
+// "closed" and re-toggle, opening a frame nobody planned.
+void test_short_open_is_confirmed_from_edge() {
+    AstroProcess::Parameters p;
+    p.initialDelaySec = 5;
+    p.exposureSec = 30;
+    p.subframeCount = 10;
+    p.intervalSec = 3;
+    astro().setParameters(p);
+    astro().setCameraConnected(true);
+    g_mock.dropToggles = 1;  // The camera's own reports stand in for this toggle
+
+    astro().start();
+    tickFor(5000);
+    TEST_ASSERT_EQUAL(1, g_mock.triggerBulbCalls);
+    g_mock.edges.push_back({5003, true});
+    g_mock.edges.push_back({5006, false});
+    tickFor(AstroProcess::CONFIRM_TIMEOUT_MS + 100);
+
+    TEST_ASSERT_EQUAL(1, g_mock.triggerBulbCalls);  // No retry toggle
+    TEST_ASSERT_EQUAL(0, astro().getStatus().errorCode);
+    std::vector<FrameRecord> records;
+    astro().forEachJournalRecord([&](const FrameRecord& r) { records.push_back(r); });
+    TEST_ASSERT_EQUAL(1, (int)records.size());
+    TEST_ASSERT_EQUAL_UINT32(5003, records[0].openConfirmedMs);
+}
+
+// With every toggle lost the open is never confirmed: after the retry budget
+// the sequence errors out with errorCode 4 instead of counting blank frames.
+void test_unconfirmed_open_errors() {
+    AstroProcess::Parameters p;
+    p.initialDelaySec = 5;
+    p.exposureSec = 30;
+    p.subframeCount = 10;
+    p.intervalSec = 3;
+    astro().setParameters(p);
+    astro().setCameraConnected(true);
+    g_mock.dropToggles = 100;
+
+    astro().start();
+    tickFor(5000 + (AstroProcess::CONFIRM_MAX_RETRIES + 1) * AstroProcess::CONFIRM_TIMEOUT_MS +
+            100);
+
+    TEST_ASSERT_EQUAL(1 + AstroProcess::CONFIRM_MAX_RETRIES, g_mock.triggerBulbCalls);
+    TEST_ASSERT_EQUAL(static_cast<int>(AstroProcess::State::ERROR),
+                      static_cast<int>(astro().getStatus().state));
+    TEST_ASSERT_EQUAL(4, astro().getStatus().errorCode);
+    TEST_ASSERT_EQUAL_UINT16(0, astro().getStatus().completedFrames);
+}
+
+// The closing toggle of a stop is still confirmed once the sequence is
+// STOPPED: a lost one is retried, so the camera is not left exposing.
+void test_close_is_confirmed_after_stop() {
+    AstroProcess::Parameters p;
+    p.initialDelaySec = 5;
+    p.exposureSec = 30;
+    p.subframeCount = 10;
+    p.intervalSec = 3;
+    astro().setParameters(p);
+    astro().setCameraConnected(true);
+
+    astro().start();
+    tickFor(6000);
+    TEST_ASSERT_TRUE(g_mock.shutterActive);
+    g_mock.dropToggles = 1;  // lose the closing toggle
+    astro().stop();
+    tickFor(100);
+    TEST_ASSERT_EQUAL(static_cast<int>(AstroProcess::State::STOPPED),
+                      static_cast<int>(astro().getStatus().state));
+    TEST_ASSERT_TRUE(g_mock.shutterActive);
+
+    tickFor(AstroProcess::CONFIRM_TIMEOUT_MS);
+    TEST_ASSERT_FALSE(g_mock.shutterActive);
+    TEST_ASSERT_EQUAL(3, g_mock.triggerBulbCalls);  // open, lost close, retry
+}
+
+// Adaptive interval: the next frame opens settleMs after the camera confirms
+// the close (SHUTTER_READY), not after the full fixed interval, and the
+// achieved cadence is reported in frames per hour.
+void test_adaptive_interval_opens_on_shutter_ready() {
+    AstroProcess::Parameters p;
+    p.initialDelaySec = 5;
+    p.exposureSec = 30;
+    p.subframeCount = 10;
+    p.intervalSec = 10;
+    p.adaptiveInterval = true;
+    p.settleMs = 500;
+    astro().setParameters(p);
+    astro().setCameraConnected(true);
+    g_mock.shutterLatencyMs = 200;
+
+    astro().start();
+    tickFor(36000);
+
+    // Open 5000 (confirmed 5200), close 35200 (confirmed 35400), next open at
+    // 35900 — 9.1 s earlier than the fixed grid's 45000.
+    TEST_ASSERT_EQUAL(2, (int)g_mock.openTimesMs.size());
+    TEST_ASSERT_EQUAL_UINT32(35200, g_mock.closeTimesMs[0]);
+    TEST_ASSERT_UINT32_WITHIN(AstroSequencer::TICK_MS, 35900, g_mock.openTimesMs[1]);
+    TEST_ASSERT_EQUAL_UINT16(116, astro().getStatus().framesPerHour);  // 3600 / 30.9
+    // Remaining is still an upper bound (capped 40 s slots) but starts from the
+    // pulled-in grid: ends at 395900, not the fixed 405000.
+    TEST_ASSERT_EQUAL_UINT32(359, astro().getStatus().remainingSec);
+}
+
+// A camera slower than the fixed interval does not stretch it: intervalSec
+// stays the upper bound on the gap, so cadence falls back to the fixed grid.
+void test_adaptive_interval_capped_by_fixed_interval() {
+    AstroProcess::Parameters p;
+    p.initialDelaySec = 5;
+    p.exposureSec = 30;
+    p.subframeCount = 10;
+    p.intervalSec = 3;
+    p.adaptiveInterval = true;
+    p.settleMs = 3000;
+    astro().setParameters(p);
+    astro().setCameraConnected(true);
+
+    astro().start();
+    tickFor(39000);
+
+    TEST_ASSERT_EQUAL(2, (int)g_mock.openTimesMs.size());
+    TEST_ASSERT_UINT32_WITHIN(AstroSequencer::TICK_MS, 38000, g_mock.openTimesMs[1]);
+    TEST_ASSERT_EQUAL_UINT16(109, astro().getStatus().framesPerHour);  // 3600 / 33
+}
+
+// Status timestamps are Unix time from AstroClock, not seconds since boot.
+void test_timestamps_are_epoch_time() {
+    AstroProcess::Parameters p;
+    p.initialDelaySec = 5;
+    p.exposureSec = 30;
+    p.subframeCount = 10;
+    p.intervalSec = 3;
+    astro().setParameters(p);
+    astro().setCameraConnected(true);
+
+    setMillis(2000);
+    astro().start();
+    tickFor(6000);
+    TEST_ASSERT_EQUAL_UINT32(1700000002, astro().getStatus().sequenceStartTime);
+    TEST_ASSERT_EQUAL_UINT32(1700000007, astro().getStatus().currentFrameStartTime);
+}
+
+// Lights then darks: the second segment opens one (first-segment) interval
+// after the last light closes, on its own grid, and status tracks the segment.
+static AstroPlan lightsThenDarks() {
+    AstroPlan plan;
+    plan.initialDelaySec = 5;
+    plan.segmentCount = 2;
+    plan.segments[0] = {AstroPlan::FrameType::LIGHT, false, 30, 2, 3};
+    plan.segments[1] = {AstroPlan::FrameType::DARK, false, 60, 2, 5};
+    return plan;
+}
+
+void test_plan_runs_segments_back_to_back() {
+    astro().setCameraConnected(true);
+    TEST_ASSERT_TRUE(astro().setPlan(lightsThenDarks()));
+    TEST_ASSERT_EQUAL_UINT16(4, astro().getStatus().totalFrames);
+
+    astro().start();
+    tickFor(70000);
+    TEST_ASSERT_EQUAL_UINT8(1, astro().getStatus().segmentIndex);
+    TEST_ASSERT_EQUAL_UINT8(2, astro().getStatus().segmentCount);
+    TEST_ASSERT_EQUAL_UINT16(0, astro().getStatus().segmentCompletedFrames);
+    TEST_ASSERT_EQUAL_UINT16(2, astro().getStatus().segmentTotalFrames);
+    TEST_ASSERT_EQUAL_UINT16(2, astro().getStatus().completedFrames);
+    // Remaining: 1 s to the first dark, then two 65 s dark slots.
+    TEST_ASSERT_EQUAL_UINT32(131, astro().getStatus().remainingSec);
+
+    tickFor(130000);
+    TEST_ASSERT_EQUAL(static_cast<int>(AstroProcess::State::STOPPED),
+                      static_cast<int>(astro().getStatus().state));
+    TEST_ASSERT_EQUAL_UINT16(4, astro().getStatus().completedFrames);
+
+    const uint32_t opens[] = {5000, 38000, 71000, 136000};
+    const uint32_t closes[] = {35000, 68000, 131000, 196000};
+    TEST_ASSERT_EQUAL(4, (int)g_mock.openTimesMs.size());
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT_UINT32_WITHIN(AstroSequencer::TICK_MS, opens[i], g_mock.openTimesMs[i]);
+        TEST_ASSERT_UINT32_WITHIN(AstroSequencer::TICK_MS, closes[i], g_mock.closeTimesMs[i]);
+    }
+}
+
+// A pause-for-user segment parks in PAUSED once the previous segment is done
+// (e.g. to cap the lens); resume opens after the new segment's interval.
+void test_plan_pauses_before_marked_segment() {
+    AstroPlan plan = lightsThenDarks();
+    plan.segments[1].pauseBefore = true;
+    astro().setCameraConnected(true);
+    TEST_ASSERT_TRUE(astro().setPlan(plan));
+
+    astro().start();
+    tickFor(75000);
+    TEST_ASSERT_EQUAL(static_cast<int>(AstroProcess::State::PAUSED),
+                      static_cast<int>(astro().getStatus().state));
+    TEST_ASSERT_EQUAL_UINT8(1, astro().getStatus().segmentIndex);
+    TEST_ASSERT_EQUAL(2, (int)g_mock.openTimesMs.size());
+
+    astro().resume();  // at 75000
+    tickFor(6000);
+    TEST_ASSERT_EQUAL(3, (int)g_mock.openTimesMs.size());
+    TEST_ASSERT_UINT32_WITHIN(AstroSequencer::TICK_MS, 80000, g_mock.openTimesMs[2]);
+}
+
+// Plans load only while idle, and editing the on-device parameters drops a
+// loaded plan back to the single block they describe.
+void test_plan_load_rules() {
+    astro().setCameraConnected(true);
+    AstroPlan bad = lightsThenDarks();
+    bad.segments[1].count = 0;
+    TEST_ASSERT_FALSE(astro().setPlan(bad));
+
+    TEST_ASSERT_TRUE(astro().setPlan(lightsThenDarks()));
+    TEST_ASSERT_TRUE(astro().hasCustomPlan());
+    astro().start();
+    TEST_ASSERT_FALSE(astro().setPlan(lightsThenDarks()));
+    astro().stop();
+
+    TEST_ASSERT_TRUE(astro().setParameter("subframeCount", 20));
+    TEST_ASSERT_FALSE(astro().hasCustomPlan());
+    TEST_ASSERT_EQUAL_UINT8(1, astro().getPlan().segmentCount);
+    TEST_ASSERT_EQUAL_UINT16(20, astro().getStatus().totalFrames);
+}
+
+// The journal keeps one record per frame with the planned and actual edges,
+// the camera's confirmations and the link RSSI, and feeds the run stats.
+void test_journal_records_each_frame() {
+    AstroProcess::Parameters p;
+    p.initialDelaySec = 5;
+    p.exposureSec = 30;
+    p.subframeCount = 10;
+    p.intervalSec = 3;
+    astro().setParameters(p);
+    astro().setCameraConnected(true);
+    astro().setLinkRssi(-67);
+    g_mock.shutterLatencyMs = 150;
+    g_mock.latency = {150, 150, 1, 1};  // close is sent 150 ms early
+
+    astro().start();
+    tickFor(72000);  // two frames done, the third opened at 71 s
+
+    std::vector<FrameRecord> records;
+    astro().forEachJournalRecord([&](const FrameRecord& r) { records.push_back(r); });
+    TEST_ASSERT_EQUAL(3, (int)records.size());
+
+    const FrameRecord& first = records[0];
+    TEST_ASSERT_EQUAL_UINT16(0, first.frame);
+    TEST_ASSERT_EQUAL_UINT32(5000, first.plannedOpenMs);
+    TEST_ASSERT_UINT32_WITHIN(AstroSequencer::TICK_MS, 5000, first.openSentMs);
+    TEST_ASSERT_UINT32_WITHIN(AstroSequencer::TICK_MS, 5150, first.openConfirmedMs);
+    TEST_ASSERT_UINT32_WITHIN(AstroSequencer::TICK_MS, 35000, first.closeSentMs);
+    TEST_ASSERT_UINT32_WITHIN(AstroSequencer::TICK_MS, 35150, first.closeConfirmedMs);
+    TEST_ASSERT_EQUAL_INT8(-67, first.rssi);
+    TEST_ASSERT_EQUAL_UINT8(0, first.errorCode);
+    TEST_ASSERT_TRUE(first.flags & FrameRecord::OPENED);
+
+    TEST_ASSERT_EQUAL_UINT32(38000, records[1].plannedOpenMs);
+    TEST_ASSERT_EQUAL_UINT32(0, records[2].closeSentMs);  // still exposing
+
+    const FrameJournal::Stats stats = astro().getJournalStats();
+    TEST_ASSERT_EQUAL_UINT16(3, stats.frames);
+    TEST_ASSERT_TRUE(stats.maxOpenErrorMs <= AstroSequencer::TICK_MS);
+    TEST_ASSERT_UINT32_WITHIN(AstroSequencer::TICK_MS, 30000, stats.meanExposureMs);
+
+    // A new run starts a fresh journal.
+    astro().stop();
+    tickFor(1000);
+    astro().start();
+    TEST_ASSERT_EQUAL_UINT16(0, astro().getJournalStats().frames);
+}
+
+// A frame whose open is never confirmed is journalled with the error code.
+void test_journal_records_failed_frame() {
+    AstroProcess::Parameters p;
+    p.initialDelaySec = 5;
+    p.exposureSec = 30;
+    p.subframeCount = 10;
+    p.intervalSec = 3;
+    astro().setParameters(p);
+    astro().setCameraConnected(true);
+    g_mock.dropToggles = 2;  // open and its retry both lost
+
+    astro().start();
+    tickFor(5000 + 2 * AstroProcess::CONFIRM_TIMEOUT_MS + 100);
+
+    const FrameJournal::Stats stats = astro().getJournalStats();
+    TEST_ASSERT_EQUAL_UINT16(1, stats.failed);
+    uint8_t flags = 0, error = 0;
+    astro().forEachJournalRecord([&](const FrameRecord& r) {
+        flags = r.flags;
+        error = r.errorCode;
+    });
+    TEST_ASSERT_EQUAL_UINT8(4, error);
+    TEST_ASSERT_TRUE(flags & FrameRecord::OPEN_RETRIED);
+}
+
+// ---- Reboot recovery ---------------------------------------------------------
+
+static void startTenFrames() {
+    AstroProcess::Parameters p;
+    p.initialDelaySec = 5;
+    p.exposureSec = 30;
+    p.subframeCount = 10;
+    p.intervalSec = 3;
+    astro().setParameters(p);
+    astro().setCameraConnected(true);
+    astro().start();
+}
+
+static AstroProcess::Checkpoint storedCheckpoint() {
+    AstroProcess::Checkpoint cp;
+    TEST_ASSERT_EQUAL(sizeof(cp), g_mock.checkpoint.size());
+    memcpy(&cp, g_mock.checkpoint.data(), sizeof(cp));
+    return cp;
+}
+
+// Simulates a reset 3 s long: the checkpoint slot survives, the process and
+// the camera link do not. The camera's shutter is left as given.
+static void rebootKeepingCheckpoint(bool shutterStillOpen) {
+    const std::vector<uint8_t> slot = g_mock.checkpoint;
+    g_mock.shutterActive = false;  // so reset() below sends no toggle
+    astro().setCameraConnected(false);
+    astro().reset();
+    g_mock.checkpoint = slot;
+    g_mock.shutterActive = shutterStillOpen;
+    advanceMillis(3000);
+}
+
+// Every transition rewrites the checkpoint; start asks for a flash mirror;
+// the end of the run clears it.
+void test_checkpoint_tracks_transitions() {
+    startTenFrames();
+    TEST_ASSERT_EQUAL(static_cast<int>(AstroProcess::State::INITIAL_DELAY),
+                      static_cast<int>(storedCheckpoint().state));
+    TEST_ASSERT_TRUE(g_mock.checkpointMirrorRequests > 0);
+
+    advanceSeconds(5);
+    AstroProcess::Checkpoint cp = storedCheckpoint();
+    TEST_ASSERT_EQUAL(static_cast<int>(AstroProcess::State::EXPOSING),
+                      static_cast<int>(cp.state));
+    TEST_ASSERT_TRUE(cp.shutterOpen);
+    TEST_ASSERT_EQUAL_UINT16(0, cp.completedFrames);
+
+    advanceSeconds(30);
+    cp = storedCheckpoint();
+    TEST_ASSERT_EQUAL(static_cast<int>(AstroProcess::State::INTERVAL),
+                      static_cast<int>(cp.state));
+    TEST_ASSERT_FALSE(cp.shutterOpen);
+    TEST_ASSERT_EQUAL_UINT16(1, cp.completedFrames);
+    TEST_ASSERT_EQUAL_UINT32(35000, cp.elapsedMs);
+
+    astro().stop();
+    TEST_ASSERT_TRUE(g_mock.checkpoint.empty());
+}
+
+// Reset mid-exposure with the camera still holding the shutter open: the
+// recovered sequence waits for the camera, closes the orphaned exposure, and
+// resumes at the interrupted frame (which does not count).
+void test_recovery_closes_orphaned_exposure_and_resumes() {
+    startTenFrames();
+    advanceSeconds(48);  // frame 2 opened at 38 s
+    TEST_ASSERT_EQUAL_UINT16(1, astro().getStatus().completedFrames);
+    rebootKeepingCheckpoint(true);
+
+    TEST_ASSERT_TRUE(astro().restoreCheckpoint());
+    TEST_ASSERT_TRUE(astro().isRecovering());
+    TEST_ASSERT_EQUAL(static_cast<int>(AstroProcess::State::PAUSED),
+                      static_cast<int>(astro().getStatus().state));
+    TEST_ASSERT_EQUAL_UINT16(1, astro().getStatus().completedFrames);
+    TEST_ASSERT_EQUAL_UINT16(10, astro().getStatus().totalFrames);
+
+    const int calls = g_mock.triggerBulbCalls;
+    tickFor(1000);  // no camera yet
+    TEST_ASSERT_TRUE(astro().isRecovering());
+    TEST_ASSERT_EQUAL(calls, g_mock.triggerBulbCalls);
+
+    astro().setCameraConnected(true);
+    tickFor(AstroSequencer::TICK_MS);
+    TEST_ASSERT_EQUAL(calls + 1, g_mock.triggerBulbCalls);  // the close
+    TEST_ASSERT_FALSE(g_mock.shutterActive);
+    TEST_ASSERT_FALSE(astro().isRecovering());
+    TEST_ASSERT_EQUAL(static_cast<int>(AstroProcess::State::INTERVAL),
+                      static_cast<int>(astro().getStatus().state));
+
+    tickFor(3000);
+    TEST_ASSERT_EQUAL(static_cast<int>(AstroProcess::State::EXPOSING),
+                      static_cast<int>(astro().getStatus().state));
+    advanceSeconds(9 * 33);
+    TEST_ASSERT_EQUAL(static_cast<int>(AstroProcess::State::STOPPED),
+                      static_cast<int>(astro().getStatus().state));
+    TEST_ASSERT_EQUAL_UINT16(10, astro().getStatus().completedFrames);
+    TEST_ASSERT_TRUE(g_mock.checkpoint.empty());
+}
+
+// The camera ended the exposure itself while we were down: the shutter-status
+// guard means no toggle is sent (it would open the shutter again).
+void test_recovery_sends_no_toggle_when_shutter_closed() {
+    startTenFrames();
+    advanceSeconds(48);
+    rebootKeepingCheckpoint(false);
+    TEST_ASSERT_TRUE(astro().restoreCheckpoint());
+
+    const int calls = g_mock.triggerBulbCalls;
+    astro().setCameraConnected(true);
+    tickFor(AstroProcess::RECOVERY_STATUS_WAIT_MS - 100);
+    TEST_ASSERT_TRUE(astro().isRecovering());
+    tickFor(200);
+    TEST_ASSERT_FALSE(astro().isRecovering());
+    TEST_ASSERT_EQUAL(calls, g_mock.triggerBulbCalls);
+    TEST_ASSERT_EQUAL(static_cast<int>(AstroProcess::State::INTERVAL),
+                      static_cast<int>(astro().getStatus().state));
+}
+
+// A run the user had paused comes back paused, and waits for Resume.
+void test_recovered_user_pause_stays_paused() {
+    startTenFrames();
+    advanceSeconds(40);  // interval after frame 1
+    astro().pause();
+    rebootKeepingCheckpoint(false);
+    TEST_ASSERT_TRUE(astro().restoreCheckpoint());
+
+    astro().setCameraConnected(true);
+    tickFor(2000);
+    TEST_ASSERT_FALSE(astro().isRecovering());
+    TEST_ASSERT_EQUAL(static_cast<int>(AstroProcess::State::PAUSED),
+                      static_cast<int>(astro().getStatus().state));
+
+    astro().resume();
+    TEST_ASSERT_EQUAL(static_cast<int>(AstroProcess::State::INTERVAL),
+                      static_cast<int>(astro().getStatus().state));
+    TEST_ASSERT_EQUAL_UINT16(1, astro().getStatus().completedFrames);
+}
+
+// A checkpoint from long ago (power was off) is dropped, not resumed.
+void test_stale_checkpoint_is_discarded() {
+    startTenFrames();
+    advanceSeconds(40);
+    rebootKeepingCheckpoint(false);
+    advanceMillis((AstroProcess::RECOVERY_MAX_AGE_SEC + 60) * 1000UL);
+
+    TEST_ASSERT_FALSE(astro().restoreCheckpoint());
+    TEST_ASSERT_EQUAL(static_cast<int>(AstroProcess::State::IDLE),
+                      static_cast<int>(astro().getStatus().state));
+    TEST_ASSERT_TRUE(g_mock.checkpoint.empty());
+}
+
+// Mock epoch: 1700000000 s at millis() 0.
+static constexpr uint32_t EPOCH0_SEC = 1700000000;
+
+static void configureTenFrames() {
+    AstroProcess::Parameters p;
+    p.initialDelaySec = 5;
+    p.exposureSec = 30;
+    p.subframeCount = 10;
+    p.intervalSec = 3;
+    astro().setParameters(p);
+}
+
+// An armed start is held in the checkpoint (IDLE + start time) and fires at
+// its time; a run started without sleeping reports no wake timing.
+void test_scheduled_start_fires_on_time() {
+    configureTenFrames();
+    astro().setCameraConnected(true);
+    const uint32_t startSec = EPOCH0_SEC + 600;
+    TEST_ASSERT_TRUE(astro().scheduleStart(startSec));
+    TEST_ASSERT_EQUAL_UINT32(startSec, astro().getScheduledStart());
+    TEST_ASSERT_EQUAL_UINT32(600, astro().secondsUntilScheduledStart());
+    AstroProcess::Checkpoint cp = storedCheckpoint();
+    TEST_ASSERT_EQUAL(static_cast<int>(AstroProcess::State::IDLE), static_cast<int>(cp.state));
+    TEST_ASSERT_EQUAL_UINT32(startSec, cp.scheduledStartSec);
+    TEST_ASSERT_TRUE(g_mock.checkpointMirrorRequests > 0);
+
+    advanceSeconds(599);
+    TEST_ASSERT_EQUAL(static_cast<int>(AstroProcess::State::IDLE),
+                      static_cast<int>(astro().getStatus().state));
+    TEST_ASSERT_EQUAL(0, g_mock.triggerBulbCalls);
+    advanceSeconds(1);
+    TEST_ASSERT_EQUAL(static_cast<int>(AstroProcess::State::INITIAL_DELAY),
+                      static_cast<int>(astro().getStatus().state));
+    TEST_ASSERT_EQUAL_UINT32(0, astro().getScheduledStart());
+    TEST_ASSERT_EQUAL_UINT32(0, storedCheckpoint().scheduledStartSec);
+
+    advanceSeconds(6);
+    TEST_ASSERT_EQUAL(1, g_mock.triggerBulbCalls);
+    TEST_ASSERT_EQUAL_UINT32(0, astro().getStatus().wakeToFirstFrameMs);
+}
+
+// The link-profile hint: the current phase's deadline while running, the
+// armed start while waiting, nothing otherwise.
+void test_next_toggle_follows_timeline() {
+    configureTenFrames();
+    astro().setCameraConnected(true);
+    TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, astro().msUntilNextToggle());
+    TEST_ASSERT_TRUE(astro().scheduleStart(EPOCH0_SEC + 600));
+    TEST_ASSERT_EQUAL_UINT32(600000, astro().msUntilNextToggle());
+    TEST_ASSERT_TRUE(astro().scheduleStart(0));
+    TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, astro().msUntilNextToggle());
+
+    astro().start();
+    advanceMillis(1250);
+    astro().update();
+    TEST_ASSERT_EQUAL_UINT32(astro().getStatus().phaseRemainingMs, astro().msUntilNextToggle());
+    TEST_ASSERT_TRUE(astro().msUntilNextToggle() < 5000);
+}
+
+// Deep sleep is a reboot: the schedule comes back from the checkpoint, waits
+// (within the grace period) for the camera, and reports boot -> first open.
+void test_scheduled_start_survives_sleep() {
+    configureTenFrames();
+    astro().setCameraConnected(true);
+    const uint32_t startSec = EPOCH0_SEC + 600;
+    TEST_ASSERT_TRUE(astro().scheduleStart(startSec));
+    rebootKeepingCheckpoint(false);
+
+    TEST_ASSERT_FALSE(astro().restoreCheckpoint());  // Nothing to recover
+    TEST_ASSERT_FALSE(astro().isRecovering());
+    TEST_ASSERT_EQUAL_UINT32(startSec, astro().getScheduledStart());
+    TEST_ASSERT_EQUAL_UINT16(10, astro().getStatus().totalFrames);
+    TEST_ASSERT_EQUAL_UINT16(30, astro().getParameters().exposureSec);
+
+    advanceSeconds(600 - 3);  // Due, but the camera is not back yet
+    TEST_ASSERT_EQUAL(static_cast<int>(AstroProcess::State::IDLE),
+                      static_cast<int>(astro().getStatus().state));
+    advanceSeconds(10);
+    TEST_ASSERT_EQUAL_UINT32(startSec, astro().getScheduledStart());
+
+    astro().setCameraConnected(true);  // 10 s late
+    advanceSeconds(1);
+    TEST_ASSERT_EQUAL(static_cast<int>(AstroProcess::State::INITIAL_DELAY),
+                      static_cast<int>(astro().getStatus().state));
+    advanceSeconds(5);
+    TEST_ASSERT_EQUAL(1, g_mock.triggerBulbCalls);
+    // The mock boot is millis() 0, so the wake time is the open's timestamp.
+    TEST_ASSERT_EQUAL_UINT32(616000, astro().getStatus().wakeToFirstFrameMs);
+}
+
+void test_schedule_rules() {
+    configureTenFrames();
+    astro().setCameraConnected(true);
+    TEST_ASSERT_FALSE(astro().scheduleStart(EPOCH0_SEC + 10));  // Too soon
+    TEST_ASSERT_FALSE(
+        astro().scheduleStart(EPOCH0_SEC + AstroProcess::SCHEDULE_MAX_AHEAD_SEC + 60));
+    TEST_ASSERT_EQUAL_UINT32(0, astro().getScheduledStart());
+
+    // Cancel clears the checkpoint; so does reset().
+    TEST_ASSERT_TRUE(astro().scheduleStart(EPOCH0_SEC + 3600));
+    TEST_ASSERT_TRUE(astro().scheduleStart(0));
+    TEST_ASSERT_EQUAL_UINT32(0, astro().getScheduledStart());
+    TEST_ASSERT_TRUE(g_mock.checkpoint.empty());
+    TEST_ASSERT_TRUE(astro().scheduleStart(EPOCH0_SEC + 3600));
+    astro().reset();
+    TEST_ASSERT_EQUAL_UINT32(0, astro().getScheduledStart());
+    TEST_ASSERT_TRUE(g_mock.checkpoint.empty());
+
+    // Not while running.
+    astro().start();
+    TEST_ASSERT_FALSE(astro().scheduleStart(EPOCH0_SEC + 3600));
+}
+
+// Woken (or powered on) well past the start time: the schedule is dropped
+// rather than starting a run nobody expects.
+void test_missed_schedule_is_discarded() {
+    configureTenFrames();
+    TEST_ASSERT_TRUE(astro().scheduleStart(EPOCH0_SEC + 600));
+    rebootKeepingCheckpoint(false);
+    advanceMillis((600 + AstroProcess::SCHEDULE_GRACE_SEC + 1) * 1000UL);
+
+    TEST_ASSERT_FALSE(astro().restoreCheckpoint());
+    TEST_ASSERT_EQUAL_UINT32(0, astro().getScheduledStart());
+    TEST_ASSERT_TRUE(g_mock.checkpoint.empty());
+}
+
+// Sleep stops WAKE_LEAD_SEC short, shortened again for slow-clock drift; a
+// wait too short to be worth a reboot is spent awake.
+void test_deep_sleep_duration() {
+    TEST_ASSERT_EQUAL_UINT32(0, DeepSleep::sleepSecFor(DeepSleep::WAKE_LEAD_SEC));
+    TEST_ASSERT_EQUAL_UINT32(0, DeepSleep::sleepSecFor(DeepSleep::WAKE_LEAD_SEC + 50));
+    TEST_ASSERT_EQUAL_UINT32(98, DeepSleep::sleepSecFor(DeepSleep::WAKE_LEAD_SEC + 100));
+    TEST_ASSERT_EQUAL_UINT32(3439, DeepSleep::sleepSecFor(3600));
 }
 
 // Periodic status notifications throttle to 1 Hz, but state transitions always
@@ -472,15 +1446,155 @@ void test_set_parameters_broadcasts_params() {
     TEST_ASSERT_EQUAL_UINT16(90, g_mock.lastParams.exposureSec);
     TEST_ASSERT_EQUAL_UINT16(30, g_mock.lastParams.subframeCount);
     TEST_ASSERT_EQUAL_UINT16(4, g_mock.lastParams.intervalSec);
+    // Along with the one-segment plan start() will run.
+    AstroPlan plan;
+    TEST_ASSERT_TRUE(plan.decode(g_mock.lastPlan.data(), g_mock.lastPlan.size()));
+    TEST_ASSERT_EQUAL_UINT16(10, plan.initialDelaySec);
+    TEST_ASSERT_EQUAL_UINT8(1, plan.segmentCount);
+    TEST_ASSERT_EQUAL_UINT16(90, plan.segments[0].exposureSec);
+    TEST_ASSERT_EQUAL_UINT16(30, plan.segments[0].count);
+    TEST_ASSERT_EQUAL_UINT16(4, plan.segments[0].intervalSec);
     astro().removeObserver(&obs);
 }
 
+static AstroMailbox::Command remote(uint16_t cmd) {
+    AstroMailbox::Command command;
+    command.cmd = cmd;
+    return command;
+}
+
+// Remote commands only take effect on the sequencer's tick, in order, and
+// each answers with what actually happened.
+void test_remote_commands_run_on_sequencer_tick() {
+    AstroMailbox::Command params = remote(RemoteCmd::ASTRO_SET_PARAMS);
+    params.params.initialDelaySec = 5;
+    params.params.exposureSec = 30;
+    params.params.subframeCount = 10;
+    params.params.intervalSec = 3;
+    astro().setCameraConnected(true);
+    TEST_ASSERT_TRUE(AstroMailbox::post(params));
+    TEST_ASSERT_TRUE(AstroMailbox::post(remote(RemoteCmd::ASTRO_START)));
+    TEST_ASSERT_EQUAL(static_cast<int>(AstroProcess::State::IDLE),
+                      static_cast<int>(astro().getStatus().state));
+    TEST_ASSERT_TRUE(g_mock.feedback.empty());
+
+    advanceMillis(AstroSequencer::TICK_MS);
+    AstroSequencer::tick();
+    TEST_ASSERT_EQUAL(static_cast<int>(AstroProcess::State::INITIAL_DELAY),
+                      static_cast<int>(astro().getStatus().state));
+    TEST_ASSERT_EQUAL_UINT16(30, astro().getParameters().exposureSec);
+    TEST_ASSERT_EQUAL(2, (int)g_mock.feedback.size());
+    TEST_ASSERT_TRUE(g_mock.feedback[0] == CommandStatus::SUCCESS);
+    TEST_ASSERT_TRUE(g_mock.feedback[1] == CommandStatus::SUCCESS);
+    TEST_ASSERT_EQUAL_UINT32(AstroSequencer::TICK_MS * 1000, AstroMailbox::stats().lastLatencyUs);
+}
+
+// Parameters are refused while running, and a second start does not restart.
+void test_remote_command_outcomes() {
+    configureTenFrames();
+    astro().setCameraConnected(true);
+    TEST_ASSERT_TRUE(AstroMailbox::apply(remote(RemoteCmd::ASTRO_PAUSE)) ==
+                     CommandStatus::INVALID);  // Nothing to pause
+    TEST_ASSERT_TRUE(AstroMailbox::apply(remote(RemoteCmd::ASTRO_START)) ==
+                     CommandStatus::SUCCESS);
+
+    AstroMailbox::Command params = remote(RemoteCmd::ASTRO_SET_PARAMS);
+    params.params.exposureSec = 120;
+    TEST_ASSERT_TRUE(AstroMailbox::apply(params) == CommandStatus::BUSY);
+    TEST_ASSERT_EQUAL_UINT16(30, astro().getParameters().exposureSec);
+    TEST_ASSERT_TRUE(AstroMailbox::apply(remote(RemoteCmd::ASTRO_START)) == CommandStatus::BUSY);
+
+    // Start picks a paused run back up.
+    TEST_ASSERT_TRUE(AstroMailbox::apply(remote(RemoteCmd::ASTRO_PAUSE)) ==
+                     CommandStatus::SUCCESS);
+    TEST_ASSERT_EQUAL(static_cast<int>(AstroProcess::State::PAUSED),
+                      static_cast<int>(astro().getStatus().state));
+    TEST_ASSERT_TRUE(AstroMailbox::apply(remote(RemoteCmd::ASTRO_START)) ==
+                     CommandStatus::SUCCESS);
+    TEST_ASSERT_EQUAL(static_cast<int>(AstroProcess::State::INTERVAL),
+                      static_cast<int>(astro().getStatus().state));
+
+    TEST_ASSERT_TRUE(AstroMailbox::apply(remote(RemoteCmd::ASTRO_STOP)) == CommandStatus::SUCCESS);
+    TEST_ASSERT_TRUE(AstroMailbox::apply(remote(RemoteCmd::ASTRO_STOP)) == CommandStatus::INVALID);
+    TEST_ASSERT_TRUE(AstroMailbox::apply(params) == CommandStatus::SUCCESS);  // Stopped: allowed
+    params.params.exposureSec = 45;
+    TEST_ASSERT_TRUE(AstroMailbox::apply(params) == CommandStatus::INVALID);
+    TEST_ASSERT_TRUE(AstroMailbox::apply(remote(RemoteCmd::ASTRO_RESET)) == CommandStatus::SUCCESS);
+
+    astro().setCameraConnected(false);
+    TEST_ASSERT_TRUE(AstroMailbox::apply(remote(RemoteCmd::ASTRO_START)) ==
+                     CommandStatus::ASTRO_ERROR);
+}
+
+// A full mailbox refuses the next post rather than overwrite.
+void test_remote_mailbox_full() {
+    const uint32_t droppedBefore = AstroMailbox::stats().dropped;
+    for (size_t i = 0; i < AstroMailbox::CAPACITY; i++) {
+        TEST_ASSERT_TRUE(AstroMailbox::post(remote(RemoteCmd::ASTRO_RESET)));
+    }
+    TEST_ASSERT_FALSE(AstroMailbox::post(remote(RemoteCmd::ASTRO_RESET)));
+    TEST_ASSERT_EQUAL_UINT32(droppedBefore + 1, AstroMailbox::stats().dropped);
+    TEST_ASSERT_EQUAL_size_t(AstroMailbox::CAPACITY, AstroMailbox::drain());
+    TEST_ASSERT_EQUAL(AstroMailbox::CAPACITY, g_mock.feedback.size());
+}
+
+// A plan written to its characteristic loads on the sequencer's tick; a
+// refused one puts the active plan back on the characteristic.
+void test_remote_plan_runs_on_sequencer_tick() {
+    AstroMailbox::Command load = remote(RemoteCmd::ASTRO_SET_PLAN);
+    load.plan = lightsThenDarks();
+    TEST_ASSERT_TRUE(AstroMailbox::post(load));
+    TEST_ASSERT_EQUAL_UINT8(1, astro().getPlan().segmentCount);  // Still the parameters' block
+
+    TEST_ASSERT_EQUAL_size_t(1, AstroMailbox::drain());
+    TEST_ASSERT_EQUAL_UINT8(2, astro().getPlan().segmentCount);
+    TEST_ASSERT_EQUAL_UINT16(4, astro().getStatus().totalFrames);
+    TEST_ASSERT_TRUE(g_mock.feedback.back() == CommandStatus::SUCCESS);
+
+    // Undecodable: the empty plan posted in its place.
+    const int published = g_mock.sendAstroPlanCalls;
+    TEST_ASSERT_TRUE(AstroMailbox::apply(remote(RemoteCmd::ASTRO_SET_PLAN)) ==
+                     CommandStatus::INVALID);
+    TEST_ASSERT_EQUAL(published + 1, g_mock.sendAstroPlanCalls);
+    TEST_ASSERT_EQUAL_UINT8(2, astro().getPlan().segmentCount);
+    AstroPlan restored;
+    TEST_ASSERT_TRUE(restored.decode(g_mock.lastPlan.data(), g_mock.lastPlan.size()));
+    TEST_ASSERT_EQUAL_UINT8(2, restored.segmentCount);
+
+    astro().setCameraConnected(true);
+    astro().start();
+    load.plan.segments[0].count = 5;
+    TEST_ASSERT_TRUE(AstroMailbox::apply(load) == CommandStatus::BUSY);
+    TEST_ASSERT_EQUAL(published + 2, g_mock.sendAstroPlanCalls);
+    TEST_ASSERT_EQUAL_UINT16(2, astro().getPlan().segments[0].count);
+}
+
+// A status-format switch is applied by the sequencer, not the BLE task.
+void test_remote_status_format_runs_on_sequencer_tick() {
+    AstroMailbox::Command format = remote(RemoteCmd::ASTRO_STATUS_FORMAT);
+    format.statusVersion = 2;
+    format.statusFlags = RemoteCmd::STATUS_FLAG_BATCH;
+    format.statusPayload = 244;
+    TEST_ASSERT_TRUE(AstroMailbox::post(format));
+    TEST_ASSERT_EQUAL(0, g_mock.statusFormatCalls);
+
+    TEST_ASSERT_EQUAL_size_t(1, AstroMailbox::drain());
+    TEST_ASSERT_EQUAL(1, g_mock.statusFormatCalls);
+    TEST_ASSERT_EQUAL_UINT8(2, g_mock.statusVersion);
+    TEST_ASSERT_EQUAL_UINT8(RemoteCmd::STATUS_FLAG_BATCH, g_mock.statusFlags);
+    TEST_ASSERT_EQUAL_size_t(244, g_mock.statusPayload);
+    TEST_ASSERT_EQUAL(1, (int)g_mock.feedback.size());
+    TEST_ASSERT_TRUE(g_mock.feedback[0] == CommandStatus::SUCCESS);
+}
+
 int main(int, char**) {
     UNITY_BEGIN();
     RUN_TEST(test_start_rejects_invalid_params);
     RUN_TEST(test_start_requires_camera);
     RUN_TEST(test_setParameter_validation);
     RUN_TEST(test_full_sequence_completes);
+    RUN_TEST(test_rig_armed_per_frame);
+    RUN_TEST(test_rig_skew_in_status);
     RUN_TEST(test_phase_remaining_counts_down_per_phase);
     RUN_TEST(test_pause_during_exposure_defers_until_frame_done);
     RUN_TEST(test_pause_during_interval_is_immediate);
@@ -489,8 +1603,43 @@ int main(int, char**) {
     RUN_TEST(test_stop_does_not_reopen_closed_shutter);
     RUN_TEST(test_start_does_not_close_open_shutter);
     RUN_TEST(test_bulb_failure_errors);
+    RUN_TEST(test_no_cumulative_drift_over_full_night);
+    RUN_TEST(test_phase_timing_has_ms_resolution);
+    RUN_TEST(test_sequencer_task_outranks_loop_task);
+    RUN_TEST(test_blocked_ui_does_not_stretch_exposure);
+    RUN_TEST(test_close_compensates_shutter_latency);
+    RUN_TEST(test_lost_open_toggle_is_retried);
+    RUN_TEST(test_short_open_is_confirmed_from_edge);
+    RUN_TEST(test_unconfirmed_open_errors);
+    RUN_TEST(test_close_is_confirmed_after_stop);
+    RUN_TEST(test_adaptive_interval_opens_on_shutter_ready);
+    RUN_TEST(test_adaptive_interval_capped_by_fixed_interval);
+    RUN_TEST(test_timestamps_are_epoch_time);
+    RUN_TEST(test_plan_runs_segments_back_to_back);
+    RUN_TEST(test_plan_pauses_before_marked_segment);
+    RUN_TEST(test_plan_load_rules);
+    RUN_TEST(test_open_confirmed_after_close_deadline_is_closed);
+    RUN_TEST(test_pending_close_dropped_when_open_gives_up);
+    RUN_TEST(test_journal_records_each_frame);
+    RUN_TEST(test_journal_records_failed_frame);
+    RUN_TEST(test_checkpoint_tracks_transitions);
+    RUN_TEST(test_recovery_closes_orphaned_exposure_and_resumes);
+    RUN_TEST(test_recovery_sends_no_toggle_when_shutter_closed);
+    RUN_TEST(test_recovered_user_pause_stays_paused);
+    RUN_TEST(test_stale_checkpoint_is_discarded);
+    RUN_TEST(test_scheduled_start_fires_on_time);
+    RUN_TEST(test_next_toggle_follows_timeline);
+    RUN_TEST(test_scheduled_start_survives_sleep);
+    RUN_TEST(test_schedule_rules);
+    RUN_TEST(test_missed_schedule_is_discarded);
+    RUN_TEST(test_deep_sleep_duration);
     RUN_TEST(test_status_notification_throttled);
     RUN_TEST(test_camera_change_notifies_when_idle);
     RUN_TEST(test_set_parameters_broadcasts_params);
+    RUN_TEST(test_remote_commands_run_on_sequencer_tick);
+    RUN_TEST(test_remote_command_outcomes);
+    RUN_TEST(test_remote_mailbox_full);
+    RUN_TEST(test_remote_plan_runs_on_sequencer_tick);
+    RUN_TEST(test_remote_status_format_runs_on_sequencer_tick);
     return UNITY_END();
 }
@@ -0,0 +1,134 @@
+// Native unit tests for AstroPlan (multi-segment sequence plan and its blob
+// codec).
+//
+// Strategy: AstroPlan has no hardware dependencies, so we include the
+// implementation directly and check the blob layout byte for byte against the
+// format documented in astro_plan.h (the webclient's encoder mirrors it).
+
+#include <unity.h>
+
+#include <cstdint>
+#include <cstring>
+
+#include "processes/astro_plan.cpp"
+
+namespace {
+AstroPlan lightsDarksFlats() {
+    AstroPlan plan;
+    plan.initialDelaySec = 300;
+    plan.adaptiveInterval = true;
+    plan.settleMs = 700;
+    plan.segmentCount = 3;
+    plan.segments[0] = {AstroPlan::FrameType::LIGHT, false, 120, 60, 5};
+    plan.segments[1] = {AstroPlan::FrameType::DARK, true, 120, 20, 5};
+    plan.segments[2] = {AstroPlan::FrameType::FLAT, true, 2, 30, 3};
+    return plan;
+}
+}  // namespace
+
+void setUp() {}
+void tearDown() {}
+
+void test_totals() {
+    const AstroPlan plan = lightsDarksFlats();
+    TEST_ASSERT_TRUE(plan.validate());
+    TEST_ASSERT_EQUAL_UINT16(110, plan.totalFrames());
+    // 300 + 60*125 + 20*125 + 30*5
+    TEST_ASSERT_EQUAL_UINT32(10450, plan.getTotalDurationSec());
+}
+
+// An exposure must outlast the open confirmation (1.2 s), so a lost open
+// toggle is retried within the frame: 2 s is the shortest accepted.
+void test_exposure_outlasts_open_confirmation() {
+    AstroPlan plan = lightsDarksFlats();
+    plan.segments[2].exposureSec = AstroPlan::EXPOSURE_MIN;
+    TEST_ASSERT_TRUE(plan.validate());
+    plan.segments[2].exposureSec = 1;
+    TEST_ASSERT_FALSE(plan.validate());
+}
+
+void test_encode_layout() {
+    uint8_t blob[AstroPlan::MAX_BLOB_BYTES];
+    const size_t length = lightsDarksFlats().encode(blob, sizeof(blob));
+    TEST_ASSERT_EQUAL(AstroPlan::HEADER_BYTES + 3 * AstroPlan::SEGMENT_BYTES, length);
+
+    const uint8_t header[] = {AstroPlan::BLOB_VERSION, 3, 0x2C, 0x01, 0x01, 0xBC, 0x02};
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(header, blob, sizeof(header));
+    const uint8_t darks[] = {1, 1, 120, 0, 20, 0, 5, 0};
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(darks, blob + AstroPlan::HEADER_BYTES + AstroPlan::SEGMENT_BYTES,
+                                  sizeof(darks));
+}
+
+void test_round_trip() {
+    const AstroPlan original = lightsDarksFlats();
+    uint8_t blob[AstroPlan::MAX_BLOB_BYTES];
+    const size_t length = original.encode(blob, sizeof(blob));
+
+    AstroPlan decoded;
+    TEST_ASSERT_TRUE(decoded.decode(blob, length));
+    TEST_ASSERT_EQUAL_UINT16(original.initialDelaySec, decoded.initialDelaySec);
+    TEST_ASSERT_TRUE(decoded.adaptiveInterval);
+    TEST_ASSERT_EQUAL_UINT16(original.settleMs, decoded.settleMs);
+    TEST_ASSERT_EQUAL_UINT8(original.segmentCount, decoded.segmentCount);
+    for (uint8_t i = 0; i < original.segmentCount; i++) {
+        const AstroPlan::Segment& a = original.segments[i];
+        const AstroPlan::Segment& b = decoded.segments[i];
+        TEST_ASSERT_EQUAL(static_cast<int>(a.type), static_cast<int>(b.type));
+        TEST_ASSERT_EQUAL(a.pauseBefore, b.pauseBefore);
+        TEST_ASSERT_EQUAL_UINT16(a.exposureSec, b.exposureSec);
+        TEST_ASSERT_EQUAL_UINT16(a.count, b.count);
+        TEST_ASSERT_EQUAL_UINT16(a.intervalSec, b.intervalSec);
+    }
+}
+
+void test_encode_rejects_small_buffer() {
+    uint8_t blob[AstroPlan::HEADER_BYTES + AstroPlan::SEGMENT_BYTES];
+    TEST_ASSERT_EQUAL(0, lightsDarksFlats().encode(blob, sizeof(blob)));
+}
+
+// Malformed or out-of-range blobs are rejected and leave the plan as it was.
+void test_decode_rejects_bad_blobs() {
+    uint8_t good[AstroPlan::MAX_BLOB_BYTES];
+    const size_t length = lightsDarksFlats().encode(good, sizeof(good));
+    uint8_t blob[AstroPlan::MAX_BLOB_BYTES];
+
+    AstroPlan plan;
+    plan.segmentCount = 1;
+    plan.segments[0] = {AstroPlan::FrameType::LIGHT, false, 30, 10, 3};
+
+    memcpy(blob, good, length);
+    blob[0] = AstroPlan::BLOB_VERSION + 1;
+    TEST_ASSERT_FALSE(plan.decode(blob, length));
+
+    TEST_ASSERT_FALSE(plan.decode(good, length - 1));  // truncated segment
+    TEST_ASSERT_FALSE(plan.decode(good, 3));           // truncated header
+    TEST_ASSERT_FALSE(plan.decode(nullptr, length));
+
+    memcpy(blob, good, length);
+    blob[1] = 0;  // no segments
+    TEST_ASSERT_FALSE(plan.decode(blob, AstroPlan::HEADER_BYTES));
+
+    memcpy(blob, good, length);
+    blob[AstroPlan::HEADER_BYTES + 4] = 0;  // segment 0 count
+    blob[AstroPlan::HEADER_BYTES + 5] = 0;
+    TEST_ASSERT_FALSE(plan.decode(blob, length));
+
+    memcpy(blob, good, length);
+    blob[AstroPlan::HEADER_BYTES + 2 * AstroPlan::SEGMENT_BYTES] = 7;  // unknown frame type
+    TEST_ASSERT_FALSE(plan.decode(blob, length));
+
+    TEST_ASSERT_EQUAL_UINT8(1, plan.segmentCount);
+    TEST_ASSERT_EQUAL_UINT16(30, plan.segments[0].exposureSec);
+    TEST_ASSERT_EQUAL_UINT16(10, plan.segments[0].count);
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_totals);
+    RUN_TEST(test_exposure_outlasts_open_confirmation);
+    RUN_TEST(test_encode_layout);
+    RUN_TEST(test_round_trip);
+    RUN_TEST(test_encode_rejects_small_buffer);
+    RUN_TEST(test_decode_rejects_bad_blobs);
+    return UNITY_END();
+}
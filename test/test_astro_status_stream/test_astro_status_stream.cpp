@@ -0,0 +1,331 @@
+// Native unit tests for AstroStatusStream — the v2 astro-status records, the
+// deltas a client folds back into a full status, and batching — plus a
+// benchmark of a night's notifications against the v1 packet.
+//
+// Strategy: unity-build. A simulated sequence produces the statuses the
+// sequencer would push once a second; frames are decoded as the client would.
+
+#include <unity.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "transport/astro_status_stream.cpp"
+
+void setUp() {}
+void tearDown() {}
+
+// ---- Simulated sequence -----------------------------------------------------
+
+static constexpr uint32_t EPOCH0 = 1700000000;
+
+// One status a second through delay, then frames of exposure + interval,
+// as AstroProcess reports them (states: 1 delay, 2 exposing, 3 interval, 5 stopped).
+static std::vector<AstroStatusPacket> simulate(uint16_t frames, uint32_t delaySec,
+                                               uint32_t exposureSec, uint32_t intervalSec) {
+    std::vector<AstroStatusPacket> out;
+    const uint32_t period = exposureSec + intervalSec;
+    const uint32_t total = delaySec + frames * period;
+    for (uint32_t t = 0; t <= total; t++) {
+        AstroStatusPacket p = {};
+        p.totalFrames = frames;
+        p.segmentCount = 1;
+        p.segmentTotalFrames = frames;
+        p.isCameraConnected = 1;
+        p.sequenceStartTime = EPOCH0;
+        p.elapsedSec = t;
+        p.remainingSec = total - t;
+        if (t == total) {
+            p.state = 5;
+            p.completedFrames = frames;
+        } else if (t < delaySec) {
+            p.state = 1;
+            p.phaseTotalSec = delaySec;
+            p.phaseRemainingSec = delaySec - t;
+        } else {
+            const uint32_t frame = (t - delaySec) / period;
+            const uint32_t into = (t - delaySec) % period;
+            p.completedFrames = frame;
+            p.currentFrameStartTime = EPOCH0 + delaySec + frame * period;
+            p.framesPerHour = frame ? 3600 / period : 0;
+            p.openSkewMs = frame ? 40 + frame % 7 : 0;
+            p.maxOpenSkewMs = frame ? 46 : 0;
+            const bool exposing = into < exposureSec;
+            p.state = exposing ? 2 : 3;
+            p.phaseTotalSec = exposing ? exposureSec : intervalSec;
+            p.phaseRemainingSec = exposing ? exposureSec - into : period - into;
+        }
+        p.segmentCompletedFrames = p.completedFrames;
+        out.push_back(p);
+    }
+    return out;
+}
+
+// ---- Client side ------------------------------------------------------------
+
+struct Client {
+    AstroStatusPacket status = {};
+    bool hasBase = false;
+    int lastSeq = -1;
+    int resyncs = 0;
+
+    // Folds in one notification, as astro-status.js does; false if it asked
+    // for a resync. Records already covered by a snapshot are skipped.
+    bool receive(const uint8_t* frame, size_t length) {
+        TEST_ASSERT_EQUAL_HEX8(AstroStatusStream::FRAME_V2, frame[0]);
+        size_t n = 1;
+        while (n < length) {
+            const uint8_t seq = frame[n];
+            AstroStatusPacket next = status;
+            const size_t used =
+                AstroStatusStream::decodeRecord(frame + n, length - n, next, hasBase);
+            if (!used) {
+                TEST_ASSERT_FALSE(hasBase);  // Only a delta with nothing to apply it to
+                return false;
+            }
+            n += used;
+            const bool full = used == AstroStatusStream::MAX_RECORD_BYTES;
+            const uint8_t step = static_cast<uint8_t>(seq - lastSeq);
+            if (!full && step != 1) {
+                if (step == 0 || step >= 128) {
+                    continue;  // Behind what we hold
+                }
+                resyncs++;
+                hasBase = false;
+                return false;
+            }
+            status = next;
+            hasBase = true;
+            lastSeq = seq;
+        }
+        return true;
+    }
+};
+
+static void assertSameStatus(const AstroStatusPacket& expected, const AstroStatusPacket& actual) {
+    TEST_ASSERT_EQUAL_MEMORY(&expected, &actual, sizeof(expected));
+}
+
+// ---- Tests ------------------------------------------------------------------
+
+// Each notification decodes back to exactly the status pushed.
+void test_round_trip_per_status() {
+    AstroStatusStream stream;
+    Client client;
+    uint8_t frame[AstroStatusStream::MAX_FRAME_BYTES];
+    uint32_t now = 0;
+    for (const AstroStatusPacket& status : simulate(10, 5, 30, 3)) {
+        const size_t length = stream.push(status, now += 1000, frame);
+        TEST_ASSERT_TRUE(length > 0);
+        TEST_ASSERT_TRUE(client.receive(frame, length));
+        assertSameStatus(status, client.status);
+    }
+    TEST_ASSERT_EQUAL_INT(0, client.resyncs);
+}
+
+// Mid-exposure the counters move by exactly a second: a bare 4-byte frame.
+// A state change is a full snapshot.
+void test_tick_is_a_few_bytes_and_transition_is_full() {
+    const std::vector<AstroStatusPacket> night = simulate(10, 5, 30, 3);
+    AstroStatusStream stream;
+    uint8_t frame[AstroStatusStream::MAX_FRAME_BYTES];
+    TEST_ASSERT_EQUAL_size_t(1 + 2 + 4 + AstroStatusStream::V1_BYTES,
+                             stream.push(night[6], 0, frame));  // First: full
+    TEST_ASSERT_EQUAL_size_t(4, stream.push(night[7], 1000, frame));
+    TEST_ASSERT_EQUAL_UINT8(1, frame[2]);  // dt
+    TEST_ASSERT_EQUAL_UINT8(0, frame[3]);  // No fields
+    // 35 is the first interval second: new state, full snapshot.
+    for (size_t t = 8; t < 35; t++) {
+        stream.push(night[t], t * 1000, frame);
+    }
+    TEST_ASSERT_EQUAL_size_t(1 + 2 + 4 + AstroStatusStream::V1_BYTES,
+                             stream.push(night[35], 35000, frame));
+    TEST_ASSERT_EQUAL_UINT32(2, stream.stats().snapshots);
+}
+
+// Counters that do not follow dt (a pause shifting the timeline) are sent.
+void test_derived_fields_sent_when_they_diverge() {
+    AstroStatusPacket a = {};
+    a.state = 2;
+    a.elapsedSec = 100;
+    a.remainingSec = 200;
+    a.phaseRemainingSec = 20;
+    AstroStatusPacket b = a;
+    b.elapsedSec = 101;
+    b.remainingSec = 199;
+    b.phaseRemainingSec = 25;  // Did not count down
+    uint8_t record[AstroStatusStream::MAX_RECORD_BYTES];
+    const size_t length = AstroStatusStream::encodeRecord(b, &a, 7, record);
+    TEST_ASSERT_EQUAL_size_t(2 + 2 + 4, length);  // seq, dt, mask, phaseRemainingSec
+    TEST_ASSERT_EQUAL_HEX8(0x80, record[2]);  // Bit 7: a second varint byte
+    TEST_ASSERT_EQUAL_HEX8(0x01, record[3]);
+
+    AstroStatusPacket decoded = a;
+    TEST_ASSERT_EQUAL_size_t(length,
+                             AstroStatusStream::decodeRecord(record, length, decoded, true));
+    assertSameStatus(b, decoded);
+    // A delta means nothing without the status it is relative to.
+    TEST_ASSERT_EQUAL_size_t(0, AstroStatusStream::decodeRecord(record, length, decoded, false));
+    TEST_ASSERT_EQUAL_size_t(0, AstroStatusStream::decodeRecord(record, 2, decoded, true));
+}
+
+// Batched: deltas are held for the window or until the payload is full, and a
+// snapshot goes out at once in place of whatever was held.
+void test_batching() {
+    const std::vector<AstroStatusPacket> night = simulate(10, 5, 30, 3);
+    AstroStatusStream stream;
+    stream.configure(true, 20);
+    uint8_t frame[AstroStatusStream::MAX_FRAME_BYTES];
+    TEST_ASSERT_TRUE(stream.push(night[6], 0, frame) > 0);  // Full: immediate
+    TEST_ASSERT_EQUAL_size_t(0, stream.push(night[7], 1000, frame));
+    const uint32_t due = 1000 + AstroStatusStream::BATCH_WINDOW_MS;
+    TEST_ASSERT_EQUAL_size_t(0, stream.flush(due - 1, frame));
+    TEST_ASSERT_EQUAL_size_t(4, stream.flush(due, frame));
+
+    // 20-byte payload: six 3-byte records fit after the marker, the seventh
+    // sends them.
+    uint32_t now = 10000;
+    for (size_t t = 8; t < 14; t++) {
+        TEST_ASSERT_EQUAL_size_t(0, stream.push(night[t], now += 100, frame));
+    }
+    TEST_ASSERT_EQUAL_size_t(19, stream.push(night[14], now += 100, frame));
+
+    Client client;
+    client.status = night[7];
+    client.hasBase = true;
+    client.lastSeq = 1;
+    TEST_ASSERT_TRUE(client.receive(frame, 19));
+    assertSameStatus(night[13], client.status);
+
+    TEST_ASSERT_EQUAL_size_t(1 + 2 + 4 + AstroStatusStream::V1_BYTES,
+                             stream.push(night[35], now += 100, frame));
+    TEST_ASSERT_EQUAL_size_t(0, stream.flush(now + AstroStatusStream::BATCH_WINDOW_MS, frame));
+}
+
+// A client that missed a record notices and resyncs from the READ snapshot,
+// which continues the numbering.
+void test_gap_forces_resync_from_snapshot() {
+    const std::vector<AstroStatusPacket> night = simulate(10, 5, 30, 3);
+    AstroStatusStream stream;
+    Client client;
+    uint8_t frame[AstroStatusStream::MAX_FRAME_BYTES];
+    client.receive(frame, stream.push(night[6], 0, frame));
+    stream.push(night[7], 1000, frame);  // Lost
+    TEST_ASSERT_FALSE(client.receive(frame, stream.push(night[8], 2000, frame)));
+
+    TEST_ASSERT_TRUE(client.receive(frame, stream.snapshot(frame)));
+    assertSameStatus(night[8], client.status);
+    TEST_ASSERT_TRUE(client.receive(frame, stream.push(night[9], 3000, frame)));
+    assertSameStatus(night[9], client.status);
+
+    stream.restart();  // A new client: snapshot first
+    TEST_ASSERT_EQUAL_size_t(1 + 2 + 4 + AstroStatusStream::V1_BYTES,
+                             stream.push(night[10], 4000, frame));
+}
+
+// ---- Benchmark ----------------------------------------------------------------
+
+// Radio time of one notification on LE 1M PHY with data length extension: a
+// single data PDU (preamble 1, access address 4, header 2, L2CAP 4, ATT 3,
+// payload, CRC 3) at 8 us a byte, then T_IFS, the peer's empty PDU and T_IFS.
+static uint32_t airtimeUs(size_t payload) {
+    return static_cast<uint32_t>((1 + 4 + 2 + 4 + 3 + payload + 3) * 8 + 150 + 80 + 150);
+}
+
+struct Tally {
+    uint32_t notifications = 0;
+    uint32_t bytes = 0;
+    uint32_t airtimeUs = 0;
+    void add(size_t length) {
+        notifications++;
+        bytes += length;
+        airtimeUs += ::airtimeUs(length);
+    }
+};
+
+// Two hours of 60 s frames with a 5 s interval: status bytes and radio time
+// of the v1 packet, v2 per status, and v2 batched into a 244-byte payload.
+void test_benchmark_night() {
+    const std::vector<AstroStatusPacket> night = simulate(110, 5, 60, 5);
+    uint8_t frame[AstroStatusStream::MAX_FRAME_BYTES];
+
+    Tally v1;
+    for (size_t i = 0; i < night.size(); i++) {
+        v1.add(sizeof(AstroStatusPacket));
+    }
+
+    Tally v2;
+    AstroStatusStream stream;
+    Client client;
+    uint32_t now = 0;
+    for (const AstroStatusPacket& status : night) {
+        const size_t length = stream.push(status, now += 1000, frame);
+        v2.add(length);
+        client.receive(frame, length);
+    }
+    assertSameStatus(night.back(), client.status);
+
+    Tally batched;
+    AstroStatusStream batchStream;
+    batchStream.configure(true, AstroStatusStream::MAX_FRAME_BYTES);
+    Client batchClient;
+    now = 0;
+    for (const AstroStatusPacket& status : night) {
+        const size_t length = batchStream.push(status, now += 1000, frame);
+        if (length) {
+            batched.add(length);
+            batchClient.receive(frame, length);
+        }
+    }
+    TEST_ASSERT_EQUAL_INT(0, batchClient.resyncs);
+    assertSameStatus(night.back(), batchClient.status);
+
+    // Encode cost: the whole night's records, repeated.
+    constexpr int ROUNDS = 200;
+    uint8_t record[AstroStatusStream::MAX_RECORD_BYTES];
+    size_t sink = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < ROUNDS; round++) {
+        for (size_t i = 1; i < night.size(); i++) {
+            sink += AstroStatusStream::encodeRecord(night[i], &night[i - 1], 0, record);
+        }
+    }
+    const double nsPerRecord =
+        std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start)
+            .count() /
+        (ROUNDS * (night.size() - 1));
+    TEST_ASSERT_TRUE(sink > 0);
+
+    char line[160];
+    snprintf(line, sizeof(line), "v1: %u notifications, %u B, %u us on air",
+             (unsigned)v1.notifications, (unsigned)v1.bytes, (unsigned)v1.airtimeUs);
+    TEST_MESSAGE(line);
+    snprintf(line, sizeof(line), "v2: %u notifications, %u B, %u us on air",
+             (unsigned)v2.notifications, (unsigned)v2.bytes, (unsigned)v2.airtimeUs);
+    TEST_MESSAGE(line);
+    snprintf(line, sizeof(line), "v2 batched: %u notifications, %u B, %u us on air",
+             (unsigned)batched.notifications, (unsigned)batched.bytes,
+             (unsigned)batched.airtimeUs);
+    TEST_MESSAGE(line);
+    snprintf(line, sizeof(line), "encode: %.0f ns/record (host)", nsPerRecord);
+    TEST_MESSAGE(line);
+
+    TEST_ASSERT_TRUE(v2.bytes * 5 < v1.bytes);
+    TEST_ASSERT_TRUE(v2.airtimeUs < v1.airtimeUs);
+    TEST_ASSERT_TRUE(batched.notifications * 3 < v2.notifications);
+    TEST_ASSERT_TRUE(batched.airtimeUs * 2 < v2.airtimeUs);
+    TEST_ASSERT_TRUE(nsPerRecord < 20000);  // Far below a 10 ms sequencer tick
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_round_trip_per_status);
+    RUN_TEST(test_tick_is_a_few_bytes_and_transition_is_full);
+    RUN_TEST(test_derived_fields_sent_when_they_diverge);
+    RUN_TEST(test_batching);
+    RUN_TEST(test_gap_forces_resync_from_snapshot);
+    RUN_TEST(test_benchmark_night);
+    return UNITY_END();
+}
@@ -0,0 +1,356 @@
+// Native unit tests for BulkTransfer — the windowed bulk channel of the
+// remote link (chunking to the MTU, credit flow control, resume, errors).
+//
+// Strategy: unity-build. BulkTransfer only talks to its two send callbacks,
+// so a loopback link stands in for BLE: it accepts a fixed number of
+// notifications per connection event (the link's capacity) and hands them to
+// a client stub that reassembles the stream and grants credits back, the way
+// the web client does.
+
+#include <unity.h>
+
+#include <cstring>
+#include <vector>
+
+#include "transport/bulk_transfer.cpp"
+
+// ---- Loopback link + client stub --------------------------------------------
+
+namespace {
+using Packet = std::vector<uint8_t>;
+
+// Deterministic content: byte i is a hash of i, so misplaced chunks show.
+class PatternSource : public BulkSource {
+public:
+    explicit PatternSource(uint32_t length) : length_(length) {}
+    uint32_t open() override {
+        opens++;
+        return length_;
+    }
+    size_t read(uint32_t offset, uint8_t* out, size_t max) override {
+        if (failReads) {
+            return 0;
+        }
+        for (size_t i = 0; i < max; i++) {
+            out[i] = byteAt(offset + i);
+        }
+        return max;
+    }
+    static uint8_t byteAt(uint32_t i) { return static_cast<uint8_t>((i * 2654435761u) >> 24); }
+
+    int opens = 0;
+    bool failReads = false;
+
+private:
+    uint32_t length_;
+};
+
+struct Loopback {
+    size_t capacityPerEvent = 6;  // Notifications the link carries per event
+    size_t sentThisEvent = 0;
+    int rejectEvery = 0;  // >0: every Nth offered notification is congested
+    int offered = 0;
+    std::vector<Packet> data;
+    std::vector<Packet> control;
+
+    bool accept(const uint8_t* bytes, size_t length, std::vector<Packet>& into) {
+        offered++;
+        if (sentThisEvent >= capacityPerEvent || (rejectEvery && offered % rejectEvery == 0)) {
+            return false;
+        }
+        sentThisEvent++;
+        into.emplace_back(bytes, bytes + length);
+        return true;
+    }
+};
+
+Loopback link;
+
+BulkTransfer makeTransfer() {
+    return BulkTransfer(
+        [](const uint8_t* d, size_t n) { return link.accept(d, n, link.data); },
+        [](const uint8_t* d, size_t n) { return link.accept(d, n, link.control); });
+}
+
+uint32_t u32At(const uint8_t* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+// Reassembles one transfer; re-grants credits every half window, as the web
+// client does.
+struct Client {
+    uint16_t window = 16;
+    uint16_t unacked = 0;
+    bool opened = false;
+    bool done = false;
+    uint8_t error = 0;
+    uint32_t total = 0;
+    uint16_t chunkPayload = 0;
+    std::vector<uint8_t> bytes;
+    std::vector<size_t> chunkSizes;
+
+    void open(BulkTransfer& bulk, uint8_t source, uint32_t offset, uint16_t mtu) {
+        const uint8_t req[8] = {BulkTransfer::OP_OPEN,
+                                source,
+                                static_cast<uint8_t>(offset),
+                                static_cast<uint8_t>(offset >> 8),
+                                static_cast<uint8_t>(offset >> 16),
+                                static_cast<uint8_t>(offset >> 24),
+                                static_cast<uint8_t>(window),
+                                static_cast<uint8_t>(window >> 8)};
+        bulk.post(req, sizeof(req), mtu);
+        bytes.resize(offset);
+    }
+
+    void grant(BulkTransfer& bulk, uint16_t credits, uint16_t mtu) {
+        const uint8_t req[3] = {BulkTransfer::OP_CREDIT, static_cast<uint8_t>(credits),
+                                static_cast<uint8_t>(credits >> 8)};
+        bulk.post(req, sizeof(req), mtu);
+    }
+
+    // Consume what the link delivered this event and answer with credits.
+    void drain(BulkTransfer& bulk, uint16_t mtu) {
+        for (const Packet& p : link.control) {
+            if (p[0] == BulkTransfer::EVT_OPENED) {
+                opened = true;
+                total = u32At(&p[2]);
+                chunkPayload = static_cast<uint16_t>(p[6] | (p[7] << 8));
+            } else if (p[0] == BulkTransfer::EVT_DONE) {
+                done = true;
+            } else if (p[0] == BulkTransfer::EVT_ERROR) {
+                error = p[1];
+            }
+        }
+        link.control.clear();
+        for (const Packet& p : link.data) {
+            TEST_ASSERT_TRUE(opened);  // OPENED always precedes data
+            TEST_ASSERT_EQUAL_UINT32(bytes.size(), u32At(p.data()));  // In order, no gaps
+            bytes.insert(bytes.end(), p.begin() + BulkTransfer::DATA_HEADER_BYTES, p.end());
+            chunkSizes.push_back(p.size() - BulkTransfer::DATA_HEADER_BYTES);
+            unacked++;
+        }
+        link.data.clear();
+        if (unacked >= window / 2 && !done) {
+            grant(bulk, unacked, mtu);
+            unacked = 0;
+        }
+    }
+};
+
+// One connection event: the client answers what arrived, the stick pumps.
+size_t runEvents(BulkTransfer& bulk, Client& client, uint16_t mtu, int maxEvents,
+                 size_t chunksPerPump = 6) {
+    int events = 0;
+    while (!client.done && !client.error && events < maxEvents) {
+        link.sentThisEvent = 0;
+        bulk.pump(chunksPerPump);
+        client.drain(bulk, mtu);
+        events++;
+    }
+    return events;
+}
+
+void verifyContent(const Client& client, uint32_t length) {
+    TEST_ASSERT_EQUAL_UINT32(length, client.bytes.size());
+    for (uint32_t i = 0; i < length; i++) {
+        if (client.bytes[i] != PatternSource::byteAt(i)) {
+            TEST_FAIL_MESSAGE("content mismatch");
+        }
+    }
+}
+}  // namespace
+
+void setUp() {
+    link = Loopback{};
+}
+void tearDown() {}
+
+// ---- Throughput ---------------------------------------------------------------
+
+// 20 KB at a 247-byte MTU: every chunk but the last is full (240 bytes), and
+// the transfer takes no more connection events than the link's capacity
+// allows — credits are re-granted in time to never leave an event idle.
+void test_streams_at_link_capacity() {
+    const uint16_t mtu = 247;
+    const uint32_t length = 20000;
+    PatternSource source(length);
+    BulkTransfer bulk = makeTransfer();
+    bulk.setSource(0, &source);
+    Client client;
+    client.open(bulk, 0, 0, mtu);
+
+    const size_t events = runEvents(bulk, client, mtu, 1000);
+
+    TEST_ASSERT_TRUE(client.done);
+    TEST_ASSERT_EQUAL_UINT16(240, client.chunkPayload);
+    verifyContent(client, length);
+    const size_t chunks = (length + 239) / 240;
+    TEST_ASSERT_EQUAL(chunks, client.chunkSizes.size());
+    for (size_t i = 0; i + 1 < chunks; i++) {
+        TEST_ASSERT_EQUAL(240, client.chunkSizes[i]);
+    }
+    // Event 1 carries OPENED plus five chunks, each later one six chunks (or
+    // DONE at the end): the data rides at full capacity after the first event.
+    TEST_ASSERT_UINT32_WITHIN(1, (chunks + 1 + 5) / 6, events);
+}
+
+// The chunk size follows the negotiated MTU, clamped to the BLE range.
+void test_chunk_size_follows_mtu() {
+    PatternSource source(1000);
+    BulkTransfer bulk = makeTransfer();
+    bulk.setSource(0, &source);
+
+    const uint16_t mtus[] = {23, 185, 517, 10, 1000};
+    const uint16_t payloads[] = {16, 178, 510, 16, 510};
+    for (size_t i = 0; i < 5; i++) {
+        link = Loopback{};
+        Client client;
+        client.open(bulk, 0, 0, mtus[i]);
+        runEvents(bulk, client, mtus[i], 1000);
+        TEST_ASSERT_EQUAL_UINT16(payloads[i], client.chunkPayload);
+        verifyContent(client, 1000);
+    }
+}
+
+// ---- Flow control -----------------------------------------------------------
+
+// Without credit grants the stick stops after the initial window; a grant
+// lets exactly that many more chunks out.
+void test_stops_at_credit_window() {
+    PatternSource source(10000);
+    BulkTransfer bulk = makeTransfer();
+    bulk.setSource(0, &source);
+    link.capacityPerEvent = 100;
+    Client client;
+    client.window = 5;
+    client.open(bulk, 0, 0, 185);
+
+    TEST_ASSERT_EQUAL(5, bulk.pump(100));
+    TEST_ASSERT_EQUAL(0, bulk.pump(100));
+    TEST_ASSERT_EQUAL(5, link.data.size());
+
+    client.grant(bulk, 3, 185);
+    TEST_ASSERT_EQUAL(3, bulk.pump(100));
+    TEST_ASSERT_TRUE(bulk.isActive());
+}
+
+// A congested notification is offered again, not skipped, and costs no
+// credit: the stream still arrives whole and in order.
+void test_congested_chunks_are_resent() {
+    const uint32_t length = 8000;
+    PatternSource source(length);
+    BulkTransfer bulk = makeTransfer();
+    bulk.setSource(0, &source);
+    link.rejectEvery = 3;
+    Client client;
+    client.open(bulk, 0, 0, 185);
+
+    runEvents(bulk, client, 185, 1000);
+
+    TEST_ASSERT_TRUE(client.done);
+    verifyContent(client, length);
+}
+
+// A client that lost part of a stream re-OPENs at the first byte it lacks.
+void test_open_at_offset_resumes() {
+    const uint32_t length = 5000;
+    PatternSource source(length);
+    BulkTransfer bulk = makeTransfer();
+    bulk.setSource(0, &source);
+
+    Client first;
+    first.open(bulk, 0, 0, 185);
+    runEvents(bulk, first, 185, 3);
+    TEST_ASSERT_FALSE(first.done);
+    const uint32_t have = first.bytes.size();
+    TEST_ASSERT_TRUE(have > 0);
+
+    Client second;
+    second.bytes = first.bytes;
+    second.open(bulk, 0, have, 185);
+    runEvents(bulk, second, 185, 1000);
+    TEST_ASSERT_TRUE(second.done);
+    TEST_ASSERT_EQUAL_UINT32(length, second.total);
+    verifyContent(second, length);
+}
+
+// ---- Errors -----------------------------------------------------------------
+
+void test_unknown_source_and_bad_offset() {
+    PatternSource source(100);
+    BulkTransfer bulk = makeTransfer();
+    bulk.setSource(0, &source);
+
+    Client unknown;
+    unknown.open(bulk, 2, 0, 185);
+    runEvents(bulk, unknown, 185, 5);
+    TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(BulkTransfer::Error::UNKNOWN_SOURCE),
+                            unknown.error);
+
+    Client pastEnd;
+    pastEnd.open(bulk, 0, 101, 185);
+    runEvents(bulk, pastEnd, 185, 5);
+    TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(BulkTransfer::Error::BAD_OFFSET), pastEnd.error);
+    TEST_ASSERT_FALSE(bulk.isActive());
+}
+
+void test_malformed_request_and_failed_source() {
+    PatternSource source(4000);
+    BulkTransfer bulk = makeTransfer();
+    bulk.setSource(0, &source);
+    Client client;
+    client.open(bulk, 0, 0, 185);
+    runEvents(bulk, client, 185, 2);
+    TEST_ASSERT_TRUE(bulk.isActive());
+
+    // The content goes away under the transfer (journal overwritten).
+    source.failReads = true;
+    runEvents(bulk, client, 185, 5);
+    TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(BulkTransfer::Error::SOURCE_FAILED),
+                            client.error);
+    TEST_ASSERT_FALSE(bulk.isActive());
+
+    const uint8_t junk[2] = {0x7F, 0};
+    bulk.post(junk, sizeof(junk), 185);
+    link.sentThisEvent = 0;
+    bulk.pump(6);
+    TEST_ASSERT_EQUAL(1, link.control.size());
+    TEST_ASSERT_EQUAL_HEX8(BulkTransfer::EVT_ERROR, link.control[0][0]);
+    TEST_ASSERT_EQUAL_UINT8(static_cast<uint8_t>(BulkTransfer::Error::BAD_REQUEST),
+                            link.control[0][1]);
+}
+
+// ABORT and a client disconnect (reset) both end the transfer silently.
+void test_abort_and_reset() {
+    PatternSource source(10000);
+    BulkTransfer bulk = makeTransfer();
+    bulk.setSource(0, &source);
+    Client client;
+    client.open(bulk, 0, 0, 185);
+    runEvents(bulk, client, 185, 1);
+
+    const uint8_t abort[1] = {BulkTransfer::OP_ABORT};
+    bulk.post(abort, sizeof(abort), 185);
+    link.data.clear();
+    TEST_ASSERT_EQUAL(0, bulk.pump(6));
+    TEST_ASSERT_FALSE(bulk.isActive());
+    TEST_ASSERT_EQUAL(0, link.data.size());
+
+    client.open(bulk, 0, 0, 185);
+    bulk.reset();
+    TEST_ASSERT_EQUAL(0, bulk.pump(6));
+    TEST_ASSERT_EQUAL(1, source.opens);  // The queued OPEN was dropped too
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_streams_at_link_capacity);
+    RUN_TEST(test_chunk_size_follows_mtu);
+    RUN_TEST(test_stops_at_credit_window);
+    RUN_TEST(test_congested_chunks_are_resent);
+    RUN_TEST(test_open_at_offset_resumes);
+    RUN_TEST(test_unknown_source_and_bad_offset);
+    RUN_TEST(test_malformed_request_and_failed_source);
+    RUN_TEST(test_abort_and_reset);
+    return UNITY_END();
+}
@@ -0,0 +1,159 @@
+// Native unit tests for CameraRig — rig membership, which cameras an armed
+// toggle reaches, and each camera's confirmations and failures kept apart.
+//
+// Strategy: unity-build. The rig is pure; time is passed in.
+
+#include <unity.h>
+
+#include "transport/camera_rig.cpp"
+#include "transport/trigger_skew.cpp"
+
+void setUp() {}
+void tearDown() {}
+
+void test_membership() {
+    CameraRig rig;
+    TEST_ASSERT_TRUE(rig.add("aa"));
+    TEST_ASSERT_FALSE(rig.add("aa"));
+    TEST_ASSERT_TRUE(rig.add("bb"));
+    TEST_ASSERT_FALSE(rig.add("cc"));  // Full
+    TEST_ASSERT_EQUAL_size_t(2, rig.size());
+    TEST_ASSERT_EQUAL_INT(1, rig.indexOf("bb"));
+
+    TEST_ASSERT_TRUE(rig.remove("aa"));
+    TEST_ASSERT_FALSE(rig.remove("aa"));
+    TEST_ASSERT_EQUAL_INT(0, rig.indexOf("bb"));  // Shifted down
+    TEST_ASSERT_EQUAL_INT(-1, rig.indexOf("aa"));
+    TEST_ASSERT_EQUAL_STRING("bb", rig.camera(0).address.c_str());
+}
+
+// Only linked cameras whose shutter is not already there; an unknown shutter
+// counts as closed, so it is opened but never closed blind.
+void test_arm_picks_cameras_by_shutter() {
+    CameraRig rig;
+    rig.add("aa");
+    rig.add("bb");
+    TEST_ASSERT_EQUAL_size_t(0, rig.arm(true, 0));  // Neither linked
+    TEST_ASSERT_EQUAL_HEX8(0, rig.takePress(0, true));
+
+    rig.setLinked(0, true);
+    rig.setLinked(1, true);
+    rig.onShutter(1, true, 0);
+    TEST_ASSERT_EQUAL_size_t(1, rig.arm(true, 10));
+    TEST_ASSERT_EQUAL_HEX8(0x01, rig.takePress(20, true));
+    TEST_ASSERT_EQUAL_HEX8(0, rig.takePress(20, true));  // Taken once
+
+    TEST_ASSERT_EQUAL_size_t(1, rig.arm(false, 30));  // 0 is still unknown
+    TEST_ASSERT_EQUAL_HEX8(0x02, rig.takePress(30, true));
+}
+
+// A press is released once, and the camera's status confirms its toggle.
+void test_press_release_and_confirm() {
+    CameraRig rig;
+    rig.add("aa");
+    rig.setLinked(0, true);
+    rig.arm(true, 1000);
+    TEST_ASSERT_EQUAL_HEX8(0x01, rig.takePress(1000, true));
+    TEST_ASSERT_EQUAL_HEX8(0x01, rig.takeRelease());
+    TEST_ASSERT_EQUAL_HEX8(0, rig.takeRelease());
+    TEST_ASSERT_TRUE(rig.camera(0).awaiting);
+
+    rig.onShutter(0, false, 1100);  // Not the edge the toggle is heading for
+    TEST_ASSERT_TRUE(rig.camera(0).awaiting);
+    rig.onShutter(0, true, 1240);
+    const CameraRig::Camera camera = rig.camera(0);
+    TEST_ASSERT_FALSE(camera.awaiting);
+    TEST_ASSERT_TRUE(camera.shutter == CameraRig::Shutter::OPEN);
+    TEST_ASSERT_EQUAL_UINT32(240, camera.latencyMs);
+    TEST_ASSERT_EQUAL_UINT16(1, camera.toggles);
+    TEST_ASSERT_EQUAL_UINT16(0, camera.failures);
+    TEST_ASSERT_EQUAL_size_t(0, rig.poll(1000 + CameraRig::CONFIRM_TIMEOUT_MS));
+}
+
+// One camera failing does not touch the other's record.
+void test_failures_per_camera() {
+    CameraRig rig;
+    rig.add("aa");
+    rig.add("bb");
+    rig.setLinked(0, true);
+    rig.setLinked(1, true);
+    rig.arm(true, 0);
+    TEST_ASSERT_EQUAL_HEX8(0x03, rig.takePress(0, true));
+    rig.writeFailed(0);
+    rig.onShutter(1, true, 100);
+    TEST_ASSERT_EQUAL_size_t(0, rig.poll(CameraRig::CONFIRM_TIMEOUT_MS));
+    TEST_ASSERT_EQUAL_UINT16(1, rig.camera(0).failures);
+    TEST_ASSERT_EQUAL_UINT16(0, rig.camera(1).failures);
+
+    // Unconfirmed: counted once, at the timeout.
+    rig.arm(false, 5000);
+    TEST_ASSERT_EQUAL_HEX8(0x02, rig.takePress(5000, true));
+    TEST_ASSERT_EQUAL_size_t(0, rig.poll(5000 + CameraRig::CONFIRM_TIMEOUT_MS - 1));
+    TEST_ASSERT_EQUAL_size_t(1, rig.poll(5000 + CameraRig::CONFIRM_TIMEOUT_MS));
+    TEST_ASSERT_EQUAL_size_t(0, rig.poll(5000 + 2 * CameraRig::CONFIRM_TIMEOUT_MS));
+    TEST_ASSERT_EQUAL_UINT16(1, rig.camera(1).failures);
+}
+
+// An armed toggle no press carried expires; a lost link or a disarm drops it.
+void test_arm_expiry_and_link_loss() {
+    CameraRig rig;
+    rig.add("aa");
+    rig.setLinked(0, true);
+    rig.arm(true, 100);
+    TEST_ASSERT_FALSE(rig.armExpired(100 + CameraRig::ARM_TIMEOUT_MS - 1));
+    TEST_ASSERT_TRUE(rig.armExpired(100 + CameraRig::ARM_TIMEOUT_MS));
+    rig.disarm();
+    TEST_ASSERT_FALSE(rig.armExpired(100 + CameraRig::ARM_TIMEOUT_MS));
+
+    rig.arm(true, 500);
+    rig.takePress(500, true);
+    rig.setLinked(0, false);
+    TEST_ASSERT_FALSE(rig.camera(0).awaiting);
+    TEST_ASSERT_EQUAL_HEX8(0, rig.takeRelease());
+    TEST_ASSERT_EQUAL_size_t(0, rig.arm(true, 600));
+}
+
+// The active camera's edge counts in the skew only when the press went out
+// with its own.
+void test_skew_includes_leader() {
+    CameraRig rig;
+    rig.add("aa");
+    rig.setLinked(0, true);
+    rig.arm(true, 0);
+    rig.takePress(0, true);
+    rig.onLeaderShutter(true, 180);
+    rig.onShutter(0, true, 250);
+    TEST_ASSERT_EQUAL_UINT16(1, rig.openSkew().samples);
+    TEST_ASSERT_EQUAL_UINT16(70, rig.openSkew().lastMs);
+
+    // Solo: one camera, no sample, and the leader's close is not its.
+    rig.arm(false, 1000);
+    rig.takePress(1000, false);
+    rig.onLeaderShutter(false, 1100);
+    rig.onShutter(0, false, 1150);
+    TEST_ASSERT_EQUAL_UINT16(0, rig.closeSkew().samples);
+    TEST_ASSERT_EQUAL_UINT16(0, rig.closeSkew().incomplete);
+
+    rig.resetSkew();
+    TEST_ASSERT_EQUAL_UINT16(0, rig.openSkew().samples);
+}
+
+void test_burst_spread() {
+    CameraRig rig;
+    rig.recordBurst(800);
+    rig.recordBurst(300);
+    TEST_ASSERT_EQUAL_UINT32(300, rig.lastSpreadUs());
+    TEST_ASSERT_EQUAL_UINT32(800, rig.maxSpreadUs());
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_membership);
+    RUN_TEST(test_arm_picks_cameras_by_shutter);
+    RUN_TEST(test_press_release_and_confirm);
+    RUN_TEST(test_failures_per_camera);
+    RUN_TEST(test_arm_expiry_and_link_loss);
+    RUN_TEST(test_skew_includes_leader);
+    RUN_TEST(test_burst_spread);
+    return UNITY_END();
+}
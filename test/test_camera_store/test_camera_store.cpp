@@ -129,6 +129,50 @@ void test_forget_missing_is_noop() {
     TEST_ASSERT_EQUAL_UINT(1, s.count());
 }
 
+// ---- GATT handles -----------------------------------------------------------
+
+void test_new_camera_has_no_handles() {
+    CameraStore s = makeStore();
+    s.add("AA:BB", "A");
+    TEST_ASSERT_FALSE(s.find("AA:BB")->handles.valid());
+}
+
+void test_set_handles_reports_change_only() {
+    CameraStore s = makeStore();
+    s.add("AA:BB", "A");
+    GattHandles h;
+    h.control = 0x2A;
+    h.status = 0x2C;
+    h.statusCccd = 0x2D;
+    TEST_ASSERT_TRUE(s.setHandles("AA:BB", h));
+    TEST_ASSERT_TRUE(s.find("AA:BB")->handles.valid());
+    TEST_ASSERT_EQUAL_UINT16(0x2D, s.find("AA:BB")->handles.statusCccd);
+    // Same handles again: nothing to persist.
+    TEST_ASSERT_FALSE(s.setHandles("AA:BB", h));
+    // Dropping stale handles is a change.
+    TEST_ASSERT_TRUE(s.setHandles("AA:BB", GattHandles{}));
+    TEST_ASSERT_FALSE(s.find("AA:BB")->handles.valid());
+}
+
+void test_set_handles_unknown_camera_is_ignored() {
+    CameraStore s = makeStore();
+    GattHandles h;
+    h.control = 1;
+    h.status = 2;
+    h.statusCccd = 3;
+    TEST_ASSERT_FALSE(s.setHandles("NOPE", h));
+    TEST_ASSERT_NULL(s.find("NOPE"));
+}
+
+void test_handles_need_control_status_and_cccd() {
+    GattHandles h;
+    h.control = 1;
+    h.status = 2;
+    TEST_ASSERT_FALSE(h.valid());
+    h.statusCccd = 3;
+    TEST_ASSERT_TRUE(h.valid());  // The 0xCC05 read handle is optional
+}
+
 // ---- test runner ------------------------------------------------------------
 
 void setUp() {}
@@ -150,5 +194,9 @@ int main(int, char**) {
     RUN_TEST(test_forget_active_clears_active);
     RUN_TEST(test_forget_non_active_leaves_active);
     RUN_TEST(test_forget_missing_is_noop);
+    RUN_TEST(test_new_camera_has_no_handles);
+    RUN_TEST(test_set_handles_reports_change_only);
+    RUN_TEST(test_set_handles_unknown_camera_is_ignored);
+    RUN_TEST(test_handles_need_control_status_and_cccd);
     return UNITY_END();
 }
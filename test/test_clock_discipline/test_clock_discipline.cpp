@@ -0,0 +1,137 @@
+// Native unit tests for ClockDiscipline (millis() disciplined against RTC /
+// remote wall-clock references).
+//
+// Strategy: ClockDiscipline is header-only pure arithmetic, so we include it
+// directly and simulate a whole night: a crystal running a fixed number of
+// ppm off true time, sampled against exact references every 10 minutes with a
+// sequencer tick's worth of jitter on the local side.
+
+#include <unity.h>
+
+#include <cstdint>
+
+#include "utils/clock_discipline.h"
+
+namespace {
+constexpr uint64_t EPOCH_START_MS = 1700000000000ULL;  // 2023-11-14 22:13:20 UTC
+constexpr uint32_t REFERENCE_PERIOD_MS = 10UL * 60UL * 1000UL;
+constexpr uint32_t NIGHT_MS = 8UL * 3600UL * 1000UL;
+
+// Local millis() reading at true time trueMs for a crystal `ppm` off (a fast
+// crystal counts more local ms per true ms). Starts 1234 ms after boot.
+uint32_t localAt(uint64_t trueMs, int32_t ppm) {
+    return 1234 + static_cast<uint32_t>(trueMs + static_cast<int64_t>(trueMs) * ppm / 1000000);
+}
+
+// Feeds references every REFERENCE_PERIOD_MS up to `untilMs` of true time.
+// The local stamp is late by 0..9 ms (edge seen on the next tick).
+void feedNight(ClockDiscipline& clock, int32_t ppm, uint64_t untilMs) {
+    uint32_t seed = 42;
+    for (uint64_t t = 0; t <= untilMs; t += REFERENCE_PERIOD_MS) {
+        seed = seed * 1103515245UL + 12345UL;
+        const uint32_t jitterMs = (seed >> 16) % 10;
+        clock.addReference(localAt(t, ppm) + jitterMs, EPOCH_START_MS + t);
+    }
+}
+}  // namespace
+
+void setUp() {}
+void tearDown() {}
+
+// Before any reference the disciplined clock is plain millis() and there is
+// no wall-clock time.
+void test_passthrough_without_reference() {
+    ClockDiscipline clock;
+    TEST_ASSERT_FALSE(clock.hasReference());
+    TEST_ASSERT_EQUAL_UINT32(123456, clock.disciplinedMs(123456));
+    TEST_ASSERT_EQUAL_UINT64(0, clock.epochMs(123456));
+}
+
+// One reference anchors epoch time; millis() advances it 1:1 until a rate is
+// known.
+void test_single_reference_anchors_epoch() {
+    ClockDiscipline clock;
+    clock.addReference(5000, EPOCH_START_MS);
+    TEST_ASSERT_TRUE(clock.hasReference());
+    TEST_ASSERT_EQUAL_UINT64(EPOCH_START_MS + 2500, clock.epochMs(7500));
+    TEST_ASSERT_EQUAL_INT32(0, clock.ratePpb());
+}
+
+// A 60 ppm fast crystal over 8 h is ~1.7 s of error undisciplined. With
+// references every 10 min the disciplined clock measures the night to well
+// under a second, and the rate estimate lands within a few ppm.
+void test_disciplined_clock_tracks_drifting_crystal() {
+    const int32_t ppm = 60;
+    ClockDiscipline clock;
+    feedNight(clock, ppm, NIGHT_MS);
+
+    TEST_ASSERT_INT32_WITHIN(5000, -ppm * 1000, clock.ratePpb());
+
+    // Next hour (after the last reference): a frame boundary 3600 s of true
+    // time later must land within 50 ms on the disciplined clock.
+    const uint32_t start = clock.disciplinedMs(localAt(NIGHT_MS, ppm));
+    const uint32_t end = clock.disciplinedMs(localAt(NIGHT_MS + 3600000ULL, ppm));
+    TEST_ASSERT_UINT32_WITHIN(50, 3600000, end - start);
+
+    // Undisciplined, the same hour reads 216 ms long.
+    TEST_ASSERT_EQUAL_UINT32(3600216,
+                             localAt(NIGHT_MS + 3600000ULL, ppm) - localAt(NIGHT_MS, ppm));
+
+    // Epoch time stays within a tick of truth between references.
+    const uint64_t trueMs = NIGHT_MS + REFERENCE_PERIOD_MS / 2;
+    const uint64_t epoch = clock.epochMs(localAt(trueMs, ppm));
+    TEST_ASSERT_UINT64_WITHIN(20, EPOCH_START_MS + trueMs, epoch);
+}
+
+// Rate updates bend the disciplined clock but never step it: a scheduler
+// waiting on a deadline must not see time jump or run backwards.
+void test_rate_update_is_continuous() {
+    const int32_t ppm = -80;
+    ClockDiscipline clock;
+    uint32_t prev = 0;
+    for (uint64_t t = 0; t <= NIGHT_MS; t += REFERENCE_PERIOD_MS) {
+        const uint32_t local = localAt(t, ppm);
+        const uint32_t before = clock.disciplinedMs(local);
+        clock.addReference(local, EPOCH_START_MS + t);
+        TEST_ASSERT_EQUAL_UINT32(before, clock.disciplinedMs(local));
+        TEST_ASSERT_TRUE(before >= prev);
+        prev = before;
+    }
+}
+
+// A reference that disagrees by seconds (RTC set by hand, remote sync against
+// an unset RTC) is a step, not a crystal: it restarts the baseline and the
+// previous rate estimate survives.
+void test_stepped_reference_restarts_baseline() {
+    const int32_t ppm = 40;
+    ClockDiscipline clock;
+    feedNight(clock, ppm, 2UL * 3600UL * 1000UL);
+    const int32_t rateBefore = clock.ratePpb();
+
+    const uint64_t t = 2UL * 3600UL * 1000UL + REFERENCE_PERIOD_MS;
+    clock.addReference(localAt(t, ppm), EPOCH_START_MS + t + 3000);  // 3 s step
+    TEST_ASSERT_EQUAL_INT32(rateBefore, clock.ratePpb());
+    TEST_ASSERT_UINT64_WITHIN(1, EPOCH_START_MS + t + 3000, clock.epochMs(localAt(t, ppm)));
+}
+
+// Stamps taken just before the latest reference (a BLE notification time
+// converted after an RTC sample) still convert sensibly.
+void test_converts_stamps_older_than_reference() {
+    const int32_t ppm = 60;
+    ClockDiscipline clock;
+    feedNight(clock, ppm, NIGHT_MS);
+    const uint32_t local = localAt(NIGHT_MS, ppm);
+    TEST_ASSERT_UINT32_WITHIN(1, clock.disciplinedMs(local) - 100,
+                              clock.disciplinedMs(local - 100));
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_passthrough_without_reference);
+    RUN_TEST(test_single_reference_anchors_epoch);
+    RUN_TEST(test_disciplined_clock_tracks_drifting_crystal);
+    RUN_TEST(test_rate_update_is_continuous);
+    RUN_TEST(test_stepped_reference_restarts_baseline);
+    RUN_TEST(test_converts_stamps_older_than_reference);
+    return UNITY_END();
+}
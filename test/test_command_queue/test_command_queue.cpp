@@ -0,0 +1,293 @@
+// Native unit tests for CommandQueue — the camera command queue in front of
+// the control characteristic (lane priority, FIFO order, timed releases, the
+// single write-with-response slot, completions).
+//
+// Strategy: unity-build. The queue only sees a write function, so a fake link
+// records every write and the tests deliver the acks by hand.
+
+#include <unity.h>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "transport/command_queue.cpp"
+
+using Lane = CommandQueue::Lane;
+using Outcome = CommandQueue::Outcome;
+using Command = CommandQueue::Command;
+
+// ---- Fake link --------------------------------------------------------------
+struct Write {
+    uint16_t cmd;
+    bool withResponse;
+};
+static std::vector<Write> g_writes;
+static bool g_linkUp = true;
+static uint32_t g_writeCostUs = 0;  // Time the stub link spends per write
+
+static bool fakeWrite(const uint8_t* data, size_t length, bool withResponse) {
+    if (!g_linkUp) {
+        return false;
+    }
+    if (g_writeCostUs) {
+        std::this_thread::sleep_for(std::chrono::microseconds(g_writeCostUs));
+    }
+    TEST_ASSERT_TRUE(length >= 2);
+    g_writes.push_back({static_cast<uint16_t>(data[0] << 8 | data[1]), withResponse});
+    return true;
+}
+
+static Command cmd(uint16_t code, uint16_t holdMs = 0, bool withResponse = true) {
+    Command c;
+    c.bytes[0] = static_cast<uint8_t>(code >> 8);
+    c.bytes[1] = static_cast<uint8_t>(code);
+    c.length = 2;
+    c.holdMs = holdMs;
+    c.withResponse = withResponse;
+    return c;
+}
+
+static void assertWrites(const std::vector<uint16_t>& expected) {
+    TEST_ASSERT_EQUAL_UINT(expected.size(), g_writes.size());
+    for (size_t i = 0; i < expected.size(); i++) {
+        TEST_ASSERT_EQUAL_HEX16(expected[i], g_writes[i].cmd);
+    }
+}
+
+void setUp() {
+    g_writes.clear();
+    g_linkUp = true;
+    g_writeCostUs = 0;
+}
+void tearDown() {}
+
+// ---- Tests ------------------------------------------------------------------
+
+// Writes with response go one at a time, in order, each on the previous ack —
+// no fixed wait between them.
+void test_lane_is_fifo_and_paced_by_acks() {
+    CommandQueue q(fakeWrite);
+    const Command pair[] = {cmd(0x0109), cmd(0x0108)};
+    TEST_ASSERT_TRUE(q.submit(Lane::SHUTTER, pair, 2, 0));
+    assertWrites({0x0109});  // Sent from submit(), no pump needed
+    TEST_ASSERT_TRUE(q.awaitingAck());
+
+    TEST_ASSERT_EQUAL_UINT(0, q.pump(5));  // Still waiting on the ack
+    q.onWriteAck(true, 8);
+    assertWrites({0x0109, 0x0108});  // Released from the ack itself
+    q.onWriteAck(true, 15);
+    TEST_ASSERT_FALSE(q.awaitingAck());
+    TEST_ASSERT_EQUAL_UINT(0, q.pending());
+}
+
+// Shutter commands jump focus/zoom steps that are still queued.
+void test_shutter_preempts_queued_lens_steps() {
+    CommandQueue q(fakeWrite);
+    const Command focus[] = {cmd(0x026b), cmd(0x026a, 30)};
+    const Command zoom[] = {cmd(0x0245), cmd(0x0244, 30)};
+    q.submit(Lane::LENS, focus, 2, 0);  // Press goes straight out
+    q.submit(Lane::LENS, zoom, 2, 0);
+    const Command toggle[] = {cmd(0x0109), cmd(0x0108)};
+    q.submit(Lane::SHUTTER, toggle, 2, 1);
+
+    q.onWriteAck(true, 10);  // Focus press acked: the shutter goes next
+    q.onWriteAck(true, 12);
+    q.onWriteAck(true, 14);
+    assertWrites({0x026b, 0x0109, 0x0108});
+
+    q.pump(29);  // Focus release still holding
+    TEST_ASSERT_EQUAL_UINT(3, g_writes.size());
+    q.pump(30);
+    q.onWriteAck(true, 33);  // Zoom press is not held; its release is
+    q.onWriteAck(true, 36);
+    q.pump(62);
+    assertWrites({0x026b, 0x0109, 0x0108, 0x026a, 0x0245});
+    q.onWriteAck(true, 65);
+    q.pump(66);
+    assertWrites({0x026b, 0x0109, 0x0108, 0x026a, 0x0245, 0x0244});
+}
+
+// A release's hold runs from when its press actually went out, and a lane
+// that is holding does not block the others.
+void test_hold_is_timed_by_queue_not_caller() {
+    CommandQueue q(fakeWrite);
+    const Command record[] = {cmd(0x010F, 0, false), cmd(0x010E, 100, false)};
+    q.submit(Lane::CONTROL, record, 2, 1000);
+    assertWrites({0x010F});
+    q.submit(Lane::SHUTTER, cmd(0x0107, 0, false), 1040);  // Not held up by the record hold
+    assertWrites({0x010F, 0x0107});
+    TEST_ASSERT_EQUAL_UINT(0, q.pump(1099));
+    TEST_ASSERT_EQUAL_UINT(1, q.pump(1100));
+    assertWrites({0x010F, 0x0107, 0x010E});
+}
+
+// Without response, a press/release pair leaves back to back, even while a
+// write with response holds the request slot.
+void test_no_response_pairs_pipeline() {
+    CommandQueue q(fakeWrite);
+    q.submit(Lane::LENS, cmd(0x026d), 0);  // Holds the request slot
+    const Command toggle[] = {cmd(0x0109, 0, false), cmd(0x0108, 0, false)};
+    q.submit(Lane::SHUTTER, toggle, 2, 1);
+    assertWrites({0x026d, 0x0109, 0x0108});
+    TEST_ASSERT_FALSE(g_writes[1].withResponse);
+    TEST_ASSERT_TRUE(q.awaitingAck());
+}
+
+// Every command completes exactly once: written, failed (refused, rejected
+// or never acked) or dropped with the link.
+void test_completions() {
+    CommandQueue q(fakeWrite);
+    std::vector<Outcome> outcomes;
+    auto record = [&outcomes](Outcome o) { outcomes.push_back(o); };
+
+    Command a = cmd(0x0109);
+    a.done = record;
+    Command b = cmd(0x0108);
+    b.done = record;
+    q.submit(Lane::SHUTTER, a, 0);
+    q.submit(Lane::SHUTTER, b, 0);
+    q.onWriteAck(false, 5);  // Camera rejected the press; the release still goes
+    TEST_ASSERT_EQUAL_UINT(1, outcomes.size());
+    TEST_ASSERT_EQUAL(static_cast<int>(Outcome::FAILED), static_cast<int>(outcomes[0]));
+    q.pump(5 + CommandQueue::ACK_TIMEOUT_MS);  // ...and its ack never comes
+    TEST_ASSERT_EQUAL_UINT(2, outcomes.size());
+    TEST_ASSERT_EQUAL(static_cast<int>(Outcome::FAILED), static_cast<int>(outcomes[1]));
+    TEST_ASSERT_FALSE(q.awaitingAck());
+    q.onWriteAck(true, 2000);  // A straggler ack changes nothing
+    TEST_ASSERT_EQUAL_UINT(2, outcomes.size());
+
+    Command c = cmd(0x010F, 0, false);
+    c.done = record;
+    q.submit(Lane::CONTROL, c, 3000);
+    TEST_ASSERT_EQUAL(static_cast<int>(Outcome::WRITTEN), static_cast<int>(outcomes[2]));
+
+    g_linkUp = false;
+    Command d = cmd(0x0107);
+    d.done = record;
+    q.submit(Lane::SHUTTER, d, 3001);
+    TEST_ASSERT_EQUAL(static_cast<int>(Outcome::FAILED), static_cast<int>(outcomes[3]));
+
+    g_linkUp = true;
+    Command e = cmd(0x026b);
+    e.done = record;
+    Command f = cmd(0x026a, 30);
+    f.done = record;
+    q.submit(Lane::LENS, e, 4000);
+    q.submit(Lane::LENS, f, 4000);
+    q.clear();
+    TEST_ASSERT_EQUAL_UINT(6, outcomes.size());
+    TEST_ASSERT_EQUAL(static_cast<int>(Outcome::DROPPED), static_cast<int>(outcomes[4]));
+    TEST_ASSERT_EQUAL(static_cast<int>(Outcome::DROPPED), static_cast<int>(outcomes[5]));
+    TEST_ASSERT_EQUAL_UINT(0, q.pending());
+    TEST_ASSERT_FALSE(q.awaitingAck());
+}
+
+// A full lane refuses the whole group rather than splitting a press from its
+// release; other lanes still take commands.
+void test_full_lane_rejects_whole_group() {
+    CommandQueue q(fakeWrite);
+    g_linkUp = true;
+    q.submit(Lane::LENS, cmd(0x026b), 0);  // In flight, no longer queued
+    for (size_t i = 0; i < CommandQueue::LANE_CAPACITY - 1; i++) {
+        TEST_ASSERT_TRUE(q.submit(Lane::LENS, cmd(0x026b), 0));
+    }
+    const Command pair[] = {cmd(0x026d), cmd(0x026c, 30)};
+    TEST_ASSERT_FALSE(q.submit(Lane::LENS, pair, 2, 0));
+    TEST_ASSERT_EQUAL_UINT(CommandQueue::LANE_CAPACITY - 1, q.pending());
+    TEST_ASSERT_TRUE(q.submit(Lane::SHUTTER, cmd(0x0109), 0));
+}
+
+// expedite() cuts a hold short (a photo's release once the camera reports
+// the capture, rather than at the fallback time).
+void test_expedite_releases_early() {
+    CommandQueue q(fakeWrite);
+    const Command photo[] = {cmd(0x0109, 0, false), cmd(0x0108, 2000, false)};
+    q.submit(Lane::SHUTTER, photo, 2, 0);
+    TEST_ASSERT_EQUAL_UINT(0, q.pump(300));
+    q.expedite(Lane::SHUTTER);
+    TEST_ASSERT_EQUAL_UINT(1, q.pump(301));
+    assertWrites({0x0109, 0x0108});
+}
+
+// The emergency path: every release on air within 50 ms, ahead of whatever
+// was queued and without waiting on the write in flight.
+void test_preempt_fires_releases_at_once() {
+    CommandQueue q(fakeWrite);
+    std::vector<Outcome> outcomes;
+    Command focus = cmd(0x026b);
+    focus.done = [&outcomes](Outcome o) { outcomes.push_back(o); };
+    q.submit(Lane::LENS, focus, 0);  // In flight, holding the request slot
+    const Command zoom[] = {cmd(0x0245), cmd(0x0244, 30)};
+    q.submit(Lane::LENS, zoom, 2, 0);
+    q.submit(Lane::SHUTTER, cmd(0x0109), 0);
+    g_writes.clear();
+
+    const uint16_t releases[] = {0x0108, 0x0106, 0x010E, 0x0114, 0x0120,
+                                 0x0244, 0x0246, 0x026a, 0x026c};
+    Command frames[9];
+    for (size_t i = 0; i < 9; i++) {
+        frames[i] = cmd(releases[i], 0, false);
+    }
+    g_writeCostUs = 2000;  // A slow controller: 2 ms per write
+    const auto start = std::chrono::steady_clock::now();
+    TEST_ASSERT_EQUAL_UINT(9, q.preempt(frames, 9, 10));
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    TEST_ASSERT_TRUE(elapsed < std::chrono::milliseconds(50));
+
+    assertWrites({0x0108, 0x0106, 0x010E, 0x0114, 0x0120, 0x0244, 0x0246, 0x026a, 0x026c});
+    for (const Write& w : g_writes) {
+        TEST_ASSERT_FALSE(w.withResponse);
+    }
+    TEST_ASSERT_EQUAL_UINT(0, q.pending());  // Queued zoom and shutter dropped
+    TEST_ASSERT_FALSE(q.awaitingAck());
+    TEST_ASSERT_EQUAL_UINT(1, outcomes.size());
+    TEST_ASSERT_EQUAL(static_cast<int>(Outcome::DROPPED), static_cast<int>(outcomes[0]));
+}
+
+// Releases the camera only takes with response still go back to back; their
+// acks, and the abandoned one's, do not free the slot of a later command.
+void test_preempt_swallows_stale_acks() {
+    CommandQueue q(fakeWrite);
+    g_writeCostUs = 0;
+    q.submit(Lane::LENS, cmd(0x026b), 0);
+    const Command frames[] = {cmd(0x0108), cmd(0x0106)};
+    TEST_ASSERT_EQUAL_UINT(2, q.preempt(frames, 2, 10));
+    assertWrites({0x026b, 0x0108, 0x0106});
+
+    std::vector<Outcome> outcomes;
+    Command next = cmd(0x0109);
+    next.done = [&outcomes](Outcome o) { outcomes.push_back(o); };
+    Command after = cmd(0x0108);
+    q.submit(Lane::SHUTTER, next, 11);
+    q.submit(Lane::SHUTTER, after, 11);
+    assertWrites({0x026b, 0x0108, 0x0106, 0x0109});
+    q.onWriteAck(true, 12);  // The abandoned focus press
+    q.onWriteAck(true, 13);  // The two releases
+    q.onWriteAck(true, 14);
+    TEST_ASSERT_EQUAL_UINT(0, outcomes.size());
+    TEST_ASSERT_EQUAL_UINT(4, g_writes.size());
+    q.onWriteAck(true, 15);  // Finally the new press's own
+    TEST_ASSERT_EQUAL_UINT(1, outcomes.size());
+    assertWrites({0x026b, 0x0108, 0x0106, 0x0109, 0x0108});
+
+    // Stale acks that never came stop being expected after the ack timeout.
+    q.preempt(frames, 2, 100);
+    q.submit(Lane::SHUTTER, cmd(0x0109), 100);
+    q.onWriteAck(true, 100 + CommandQueue::ACK_TIMEOUT_MS);
+    TEST_ASSERT_FALSE(q.awaitingAck());
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_lane_is_fifo_and_paced_by_acks);
+    RUN_TEST(test_shutter_preempts_queued_lens_steps);
+    RUN_TEST(test_hold_is_timed_by_queue_not_caller);
+    RUN_TEST(test_no_response_pairs_pipeline);
+    RUN_TEST(test_completions);
+    RUN_TEST(test_full_lane_rejects_whole_group);
+    RUN_TEST(test_expedite_releases_early);
+    RUN_TEST(test_preempt_fires_releases_at_once);
+    RUN_TEST(test_preempt_swallows_stale_acks);
+    return UNITY_END();
+}
@@ -0,0 +1,172 @@
+// Native unit tests for ConnectSequence — the camera link bring-up state
+// machine (step order, event-driven completion, timeouts, late events).
+//
+// Strategy: unity-build. The sequence only sees Events and the time it is
+// given, so the tests play the radio's part by hand.
+
+#include <unity.h>
+
+#include "transport/connect_sequence.cpp"
+
+using Step = ConnectSequence::Step;
+using Event = ConnectSequence::Event;
+using Action = ConnectSequence::Action;
+
+void setUp() {}
+void tearDown() {}
+
+static void assertStep(Step expected, const ConnectSequence& seq) {
+    TEST_ASSERT_EQUAL_MESSAGE(static_cast<int>(expected), static_cast<int>(seq.step()),
+                              ConnectSequence::stepName(seq.step()));
+}
+
+// A bonded camera: open, MTU, discovery — each step starts the moment the
+// previous one's event arrives, so the connect takes what the radio takes.
+void test_reconnect_runs_steps_on_events() {
+    ConnectSequence seq;
+    TEST_ASSERT_EQUAL(static_cast<int>(Action::OPEN), static_cast<int>(seq.begin(false, 1000)));
+    TEST_ASSERT_TRUE(seq.busy());
+    TEST_ASSERT_EQUAL(static_cast<int>(Action::REQUEST_MTU),
+                      static_cast<int>(seq.handle(Event::OPENED, 1180)));
+    assertStep(Step::EXCHANGING_MTU, seq);
+    TEST_ASSERT_EQUAL(static_cast<int>(Action::DISCOVER),
+                      static_cast<int>(seq.handle(Event::MTU_DONE, 1240)));
+    TEST_ASSERT_EQUAL(static_cast<int>(Action::COMPLETE),
+                      static_cast<int>(seq.handle(Event::DISCOVERED, 1700)));
+    assertStep(Step::READY, seq);
+    TEST_ASSERT_FALSE(seq.busy());
+    TEST_ASSERT_EQUAL_UINT32(700, seq.connectMs());
+}
+
+// Pairing adds the encryption step between MTU and discovery.
+void test_pairing_encrypts_before_discovery() {
+    ConnectSequence seq;
+    seq.begin(true, 0);
+    seq.handle(Event::OPENED, 100);
+    TEST_ASSERT_EQUAL(static_cast<int>(Action::ENCRYPT),
+                      static_cast<int>(seq.handle(Event::MTU_DONE, 150)));
+    assertStep(Step::ENCRYPTING, seq);
+    // Discovery must not start on an unrelated event.
+    TEST_ASSERT_EQUAL(static_cast<int>(Action::NONE),
+                      static_cast<int>(seq.handle(Event::DISCOVERED, 200)));
+    TEST_ASSERT_EQUAL(static_cast<int>(Action::DISCOVER),
+                      static_cast<int>(seq.handle(Event::ENCRYPTED, 900)));
+    TEST_ASSERT_EQUAL(static_cast<int>(Action::COMPLETE),
+                      static_cast<int>(seq.handle(Event::DISCOVERED, 1200)));
+}
+
+// An unanswered MTU exchange is not fatal; a silent open is.
+void test_timeouts() {
+    ConnectSequence seq;
+    seq.begin(false, 0);
+    seq.handle(Event::OPENED, 100);
+    TEST_ASSERT_EQUAL(static_cast<int>(Action::NONE),
+                      static_cast<int>(seq.poll(100 + ConnectSequence::MTU_TIMEOUT_MS - 1)));
+    TEST_ASSERT_EQUAL(static_cast<int>(Action::DISCOVER),
+                      static_cast<int>(seq.poll(100 + ConnectSequence::MTU_TIMEOUT_MS)));
+
+    seq.begin(false, 50000);
+    TEST_ASSERT_EQUAL(static_cast<int>(Action::NONE), static_cast<int>(seq.poll(50000 + 9000)));
+    TEST_ASSERT_EQUAL(static_cast<int>(Action::ABORT),
+                      static_cast<int>(seq.poll(50000 + ConnectSequence::OPEN_TIMEOUT_MS)));
+    assertStep(Step::FAILED, seq);
+    TEST_ASSERT_EQUAL(static_cast<int>(Step::OPENING), static_cast<int>(seq.failedStep()));
+}
+
+// Failures abort from any step; events arriving after the sequence gave up
+// (a connect() that returns after its timeout) change nothing.
+void test_failures_and_late_events() {
+    ConnectSequence seq;
+    seq.begin(true, 0);
+    seq.handle(Event::OPENED, 10);
+    seq.handle(Event::MTU_DONE, 20);
+    TEST_ASSERT_EQUAL(static_cast<int>(Action::ABORT),
+                      static_cast<int>(seq.handle(Event::AUTH_FAILED, 30)));
+    TEST_ASSERT_EQUAL(static_cast<int>(Step::ENCRYPTING), static_cast<int>(seq.failedStep()));
+    TEST_ASSERT_EQUAL(static_cast<int>(Action::NONE),
+                      static_cast<int>(seq.handle(Event::ENCRYPTED, 40)));
+    assertStep(Step::FAILED, seq);
+
+    // The open timed out, then connect() came back connected after all.
+    seq.begin(false, 0);
+    seq.poll(ConnectSequence::OPEN_TIMEOUT_MS);
+    TEST_ASSERT_EQUAL(static_cast<int>(Action::ABORT),
+                      static_cast<int>(seq.handle(Event::OPENED, 12000)));
+    assertStep(Step::FAILED, seq);
+
+    seq.begin(false, 100);
+    TEST_ASSERT_EQUAL(static_cast<int>(Action::ABORT),
+                      static_cast<int>(seq.handle(Event::DISCONNECTED, 150)));
+    TEST_ASSERT_EQUAL(static_cast<int>(Step::OPENING), static_cast<int>(seq.failedStep()));
+}
+
+// A ready link that drops goes back to IDLE, ready for the next begin().
+void test_ready_link_drop_returns_to_idle() {
+    ConnectSequence seq;
+    seq.begin(false, 0);
+    seq.handle(Event::OPENED, 1);
+    seq.handle(Event::MTU_DONE, 2);
+    seq.handle(Event::DISCOVERED, 3);
+    TEST_ASSERT_EQUAL(static_cast<int>(Action::NONE),
+                      static_cast<int>(seq.handle(Event::DISCONNECTED, 10)));
+    assertStep(Step::IDLE, seq);
+    TEST_ASSERT_EQUAL(static_cast<int>(Action::NONE), static_cast<int>(seq.poll(100000)));
+}
+
+// Saved handles: bind by handle instead of discovering.
+void test_cached_handles_skip_discovery() {
+    ConnectSequence seq;
+    seq.begin(false, 0, true);
+    seq.handle(Event::OPENED, 150);
+    TEST_ASSERT_EQUAL(static_cast<int>(Action::BIND),
+                      static_cast<int>(seq.handle(Event::MTU_DONE, 200)));
+    assertStep(Step::BINDING, seq);
+    TEST_ASSERT_EQUAL(static_cast<int>(Action::NONE),
+                      static_cast<int>(seq.handle(Event::DISCOVERED, 210)));
+    TEST_ASSERT_EQUAL(static_cast<int>(Action::COMPLETE),
+                      static_cast<int>(seq.handle(Event::BOUND, 260)));
+    TEST_ASSERT_TRUE(seq.usedCache());
+    TEST_ASSERT_FALSE(seq.cacheMissed());
+    TEST_ASSERT_EQUAL_UINT32(260, seq.connectMs());
+}
+
+// Handles that no longer match (rejected, or no answer) fall back to a full
+// discovery on the same link rather than failing the connect.
+void test_stale_handles_fall_back_to_discovery() {
+    ConnectSequence seq;
+    seq.begin(false, 0, true);
+    seq.handle(Event::OPENED, 100);
+    seq.handle(Event::MTU_DONE, 150);
+    TEST_ASSERT_EQUAL(static_cast<int>(Action::DISCOVER),
+                      static_cast<int>(seq.handle(Event::BIND_FAILED, 180)));
+    assertStep(Step::DISCOVERING, seq);
+    TEST_ASSERT_FALSE(seq.usedCache());
+    TEST_ASSERT_TRUE(seq.cacheMissed());
+    TEST_ASSERT_EQUAL(static_cast<int>(Action::COMPLETE),
+                      static_cast<int>(seq.handle(Event::DISCOVERED, 700)));
+
+    seq.begin(false, 0, true);
+    seq.handle(Event::OPENED, 100);
+    seq.handle(Event::MTU_DONE, 150);
+    TEST_ASSERT_EQUAL(static_cast<int>(Action::NONE),
+                      static_cast<int>(seq.poll(150 + ConnectSequence::BIND_TIMEOUT_MS - 1)));
+    TEST_ASSERT_EQUAL(static_cast<int>(Action::DISCOVER),
+                      static_cast<int>(seq.poll(150 + ConnectSequence::BIND_TIMEOUT_MS)));
+    TEST_ASSERT_TRUE(seq.cacheMissed());
+
+    // The next connect starts clean.
+    seq.begin(false, 0, false);
+    TEST_ASSERT_FALSE(seq.cacheMissed());
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_reconnect_runs_steps_on_events);
+    RUN_TEST(test_pairing_encrypts_before_discovery);
+    RUN_TEST(test_timeouts);
+    RUN_TEST(test_failures_and_late_events);
+    RUN_TEST(test_ready_link_drop_returns_to_idle);
+    RUN_TEST(test_cached_handles_skip_discovery);
+    RUN_TEST(test_stale_handles_fall_back_to_discovery);
+    return UNITY_END();
+}
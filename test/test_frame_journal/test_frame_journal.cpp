@@ -0,0 +1,148 @@
+// Native unit tests for FrameJournal (the per-frame timing ring buffer).
+//
+// Strategy: FrameJournal is header-only and hardware-free, so we include it
+// directly and fill it with hand-built records.
+
+#include <unity.h>
+
+#include <cstdint>
+
+#include "processes/frame_journal.h"
+
+namespace {
+// A frame opened `errorMs` after plan and exposed for exposureMs (both edges
+// confirmed 100 ms after their toggles).
+void addFrame(FrameJournal& journal, uint16_t frame, int32_t errorMs, uint32_t exposureMs) {
+    FrameRecord& r = journal.append();
+    r.frame = frame;
+    r.plannedOpenMs = 10000 + frame * 33000;
+    r.openSentMs = r.plannedOpenMs + errorMs;
+    r.openConfirmedMs = r.openSentMs + 100;
+    r.closeSentMs = r.openConfirmedMs + exposureMs - 100;
+    r.closeConfirmedMs = r.openConfirmedMs + exposureMs;
+    r.flags = FrameRecord::OPENED;
+}
+}  // namespace
+
+// Static, like AstroProcess's: the ring is 16 KB. Cleared before each test.
+static FrameJournal journal;
+
+void setUp() {
+    journal.clear();
+}
+void tearDown() {}
+
+void test_empty_journal() {
+    TEST_ASSERT_TRUE(journal.empty());
+    const FrameJournal::Stats s = journal.stats();
+    TEST_ASSERT_EQUAL_UINT16(0, s.frames);
+    TEST_ASSERT_EQUAL_INT32(0, s.meanOpenErrorMs);
+    TEST_ASSERT_EQUAL_UINT32(0, s.maxOpenErrorMs);
+}
+
+void test_iterates_oldest_first() {
+    for (uint16_t i = 0; i < 5; i++) {
+        addFrame(journal, i, 0, 30000);
+    }
+    uint16_t expected = 0;
+    journal.forEach([&](const FrameRecord& r) { TEST_ASSERT_EQUAL_UINT16(expected++, r.frame); });
+    TEST_ASSERT_EQUAL_UINT16(5, expected);
+    TEST_ASSERT_EQUAL_UINT16(4, journal.back().frame);
+}
+
+// Past CAPACITY the oldest records are overwritten; iteration still runs
+// oldest to newest over the last CAPACITY frames.
+void test_wraps_at_capacity() {
+    const uint16_t total = FrameJournal::CAPACITY + 10;
+    for (uint16_t i = 0; i < total; i++) {
+        addFrame(journal, i, 0, 30000);
+    }
+    TEST_ASSERT_EQUAL(FrameJournal::CAPACITY, journal.size());
+    TEST_ASSERT_EQUAL_UINT16(10, journal.at(0).frame);
+    TEST_ASSERT_EQUAL_UINT16(total - 1, journal.at(FrameJournal::CAPACITY - 1).frame);
+}
+
+// Mean open error is signed, max is the worst magnitude; frames that never
+// opened and failures are counted apart.
+void test_stats() {
+    addFrame(journal, 0, 10, 30000);
+    addFrame(journal, 1, -40, 30020);
+    addFrame(journal, 2, 0, 29980);
+    FrameRecord& failed = journal.append();
+    failed.frame = 3;
+    failed.errorCode = 3;  // open toggle could not be sent
+
+    const FrameJournal::Stats s = journal.stats();
+    TEST_ASSERT_EQUAL_UINT16(3, s.frames);
+    TEST_ASSERT_EQUAL_UINT16(1, s.failed);
+    TEST_ASSERT_EQUAL_INT32(-10, s.meanOpenErrorMs);
+    TEST_ASSERT_EQUAL_UINT32(40, s.maxOpenErrorMs);
+    TEST_ASSERT_EQUAL_UINT32(30000, s.meanExposureMs);
+}
+
+// An exposure missing either confirmation does not skew the mean exposure.
+void test_unconfirmed_exposure_excluded() {
+    addFrame(journal, 0, 0, 30000);
+    addFrame(journal, 1, 0, 60000);
+    journal.back().closeConfirmedMs = 0;
+    TEST_ASSERT_EQUAL_UINT32(0, journal.back().exposureMs());
+    TEST_ASSERT_EQUAL_UINT32(30000, journal.stats().meanExposureMs);
+}
+
+// Sequence numbers survive wraps and clears: an overwritten or cleared
+// record is reported gone rather than aliased to whatever took its slot.
+void test_sequence_addressing() {
+    const uint32_t base = journal.endSequence();
+    TEST_ASSERT_EQUAL_UINT32(base, journal.firstSequence());
+    for (uint16_t i = 0; i < FrameJournal::CAPACITY + 3; i++) {
+        addFrame(journal, i, 0, 30000);
+    }
+    TEST_ASSERT_EQUAL_UINT32(base + 3, journal.firstSequence());
+    TEST_ASSERT_NULL(journal.find(base + 2));
+    TEST_ASSERT_EQUAL_UINT16(3, journal.find(base + 3)->frame);
+    TEST_ASSERT_EQUAL_UINT16(FrameJournal::CAPACITY + 2,
+                             journal.find(journal.endSequence() - 1)->frame);
+    TEST_ASSERT_NULL(journal.find(journal.endSequence()));
+
+    const uint32_t end = journal.endSequence();
+    journal.clear();
+    TEST_ASSERT_NULL(journal.find(end - 1));
+    addFrame(journal, 0, 0, 30000);
+    TEST_ASSERT_EQUAL_UINT32(end, journal.firstSequence());
+    TEST_ASSERT_NOT_NULL(journal.find(end));
+}
+
+void test_wire_encoding() {
+    FrameRecord r;
+    r.plannedOpenMs = 0x04030201;
+    r.closeConfirmedMs = 0xA0B0C0D0;
+    r.frame = 0x0102;
+    r.segment = 3;
+    r.flags = FrameRecord::OPENED | FrameRecord::CLOSE_RETRIED;
+    r.rssi = -67;
+    r.errorCode = 4;
+    uint8_t out[FrameRecord::WIRE_BYTES];
+    r.encode(out);
+    TEST_ASSERT_EQUAL_HEX8(0x01, out[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x04, out[3]);
+    TEST_ASSERT_EQUAL_HEX8(0xD0, out[20]);
+    TEST_ASSERT_EQUAL_HEX8(0xA0, out[23]);
+    TEST_ASSERT_EQUAL_HEX8(0x02, out[24]);
+    TEST_ASSERT_EQUAL_HEX8(0x01, out[25]);
+    TEST_ASSERT_EQUAL_UINT8(3, out[26]);
+    TEST_ASSERT_EQUAL_HEX8(0x09, out[27]);
+    TEST_ASSERT_EQUAL_INT8(-67, static_cast<int8_t>(out[28]));
+    TEST_ASSERT_EQUAL_UINT8(4, out[29]);
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_empty_journal);
+    RUN_TEST(test_iterates_oldest_first);
+    RUN_TEST(test_wraps_at_capacity);
+    RUN_TEST(test_stats);
+    RUN_TEST(test_unconfirmed_exposure_excluded);
+    RUN_TEST(test_sequence_addressing);
+    RUN_TEST(test_wire_encoding);
+    return UNITY_END();
+}
@@ -0,0 +1,142 @@
+// Native unit tests for LinkProfilePolicy — which connection parameters the
+// camera link asks for around bulb toggles, command bursts and long phases.
+//
+// Strategy: unity-build. The policy is pure; the tests walk a simulated
+// sequence timeline in 10 ms steps, the way the app loop feeds it.
+
+#include <unity.h>
+
+#include "transport/link_profile.cpp"
+
+void setUp() {}
+void tearDown() {}
+
+static constexpr uint32_t NONE = LinkProfilePolicy::NO_TOGGLE;
+
+// Apply whatever the policy asks for at `now`; returns the profile in effect.
+static LinkProfile step(LinkProfilePolicy& policy, uint32_t now, uint32_t lastCommandMs,
+                        uint32_t nextToggleInMs, int* requests = nullptr) {
+    LinkProfile next;
+    if (policy.next(now, lastCommandMs, nextToggleInMs, next)) {
+        policy.requested(next, now);
+        if (requests) {
+            (*requests)++;
+        }
+    }
+    return policy.current();
+}
+
+void test_desired_by_phase() {
+    LinkProfilePolicy policy;
+    policy.reset(0);
+    TEST_ASSERT_EQUAL(static_cast<int>(LinkProfile::BALANCED),
+                      static_cast<int>(policy.desired(10000, 0, NONE)));
+    TEST_ASSERT_EQUAL(static_cast<int>(LinkProfile::POWER_SAVE),
+                      static_cast<int>(policy.desired(10000, 0, 280000)));
+    TEST_ASSERT_EQUAL(static_cast<int>(LinkProfile::LOW_LATENCY),
+                      static_cast<int>(policy.desired(10000, 0, 4000)));
+    // A command a moment ago (focus step, toggle awaiting its confirmation).
+    TEST_ASSERT_EQUAL(static_cast<int>(LinkProfile::LOW_LATENCY),
+                      static_cast<int>(policy.desired(10000, 9000, 280000)));
+    TEST_ASSERT_EQUAL(static_cast<int>(LinkProfile::LOW_LATENCY),
+                      static_cast<int>(policy.desired(10000, 9000, NONE)));
+    // In between the lead and the power-save floor: stay put.
+    TEST_ASSERT_EQUAL(static_cast<int>(LinkProfile::BALANCED),
+                      static_cast<int>(policy.desired(10000, 0, 10000)));
+}
+
+// Switching up is never held back; other switches wait MIN_SWITCH_MS.
+void test_rate_limit_spares_low_latency() {
+    LinkProfilePolicy policy;
+    policy.reset(0);
+    LinkProfile out;
+    TEST_ASSERT_FALSE(policy.next(500, 0, 280000, out));  // Just connected
+    TEST_ASSERT_TRUE(policy.next(500, 0, 3000, out));
+    TEST_ASSERT_EQUAL(static_cast<int>(LinkProfile::LOW_LATENCY), static_cast<int>(out));
+    policy.requested(out, 500);
+    TEST_ASSERT_FALSE(policy.next(600, 0, 280000, out));
+    TEST_ASSERT_TRUE(policy.next(2500, 0, 280000, out));
+    TEST_ASSERT_EQUAL(static_cast<int>(LinkProfile::POWER_SAVE), static_cast<int>(out));
+}
+
+// Three 5-minute frames with 5 s intervals: every toggle goes out on the
+// low-latency profile, the link spends most of the night in power save, and
+// the connection-event rate (radio duty) is well under a third of the old
+// fixed 20-40 ms link's.
+void test_five_minute_exposures() {
+    LinkProfilePolicy policy;
+    policy.reset(0);
+    const uint32_t exposureMs = 300000;
+    const uint32_t intervalMs = 5000;
+    const uint32_t firstOpenMs = 5000;
+    const uint32_t frameMs = exposureMs + intervalMs;
+    const uint32_t endMs = firstOpenMs + 3 * frameMs;
+
+    uint32_t lastCommandMs = 0;
+    uint32_t powerSaveMs = 0;
+    uint64_t events = 0;  // Connection events per minute, summed per 10 ms step
+    int requests = 0;
+    for (uint32_t now = 0; now < endMs; now += 10) {
+        // Next toggle: the frame's open or close, whichever comes first.
+        uint32_t nextToggleMs;
+        if (now < firstOpenMs) {
+            nextToggleMs = firstOpenMs;
+        } else {
+            const uint32_t inFrame = (now - firstOpenMs) % frameMs;
+            const uint32_t frameStart = now - inFrame;
+            nextToggleMs = inFrame < exposureMs ? frameStart + exposureMs : frameStart + frameMs;
+        }
+        const bool toggleNow = now >= firstOpenMs && (now - firstOpenMs) % frameMs == 0;
+        const bool closeNow = now >= firstOpenMs && (now - firstOpenMs) % frameMs == exposureMs;
+        if (toggleNow || closeNow) {
+            TEST_ASSERT_EQUAL(static_cast<int>(LinkProfile::LOW_LATENCY),
+                              static_cast<int>(policy.current()));
+            lastCommandMs = now;  // triggerBulb()
+        }
+        const LinkProfile profile = step(policy, now, lastCommandMs, nextToggleMs - now, &requests);
+        if (profile == LinkProfile::POWER_SAVE) {
+            powerSaveMs += 10;
+        }
+        events += LinkProfilePolicy::eventsPerMinute(profile);
+    }
+    TEST_ASSERT_TRUE(powerSaveMs * 100 / endMs >= 90);
+    const uint64_t averageEvents = events / (endMs / 10);
+    TEST_ASSERT_TRUE(averageEvents * 3 < LinkProfilePolicy::eventsPerMinute(LinkProfile::BALANCED));
+    TEST_ASSERT_TRUE(requests <= 3 * 2 + 1);  // Up and down once per exposure, plus the first
+}
+
+// A run of focus steps stays low-latency between steps, then settles back.
+void test_command_burst_holds_low_latency() {
+    LinkProfilePolicy policy;
+    policy.reset(0);
+    uint32_t lastCommandMs = 0;
+    for (uint32_t now = 10000; now < 12000; now += 10) {
+        if (now % 400 == 0) {
+            lastCommandMs = now;
+        }
+        step(policy, now, lastCommandMs, NONE);
+        if (lastCommandMs) {
+            TEST_ASSERT_EQUAL(static_cast<int>(LinkProfile::LOW_LATENCY),
+                              static_cast<int>(policy.current()));
+        }
+    }
+    step(policy, 11600 + LinkProfilePolicy::ACTIVITY_HOLD_MS, lastCommandMs, NONE);
+    TEST_ASSERT_EQUAL(static_cast<int>(LinkProfile::BALANCED), static_cast<int>(policy.current()));
+}
+
+// Worst case before a queued write (an emergency stop's releases) goes on air.
+void test_max_event_gap() {
+    TEST_ASSERT_EQUAL_UINT32(15, LinkProfilePolicy::maxEventGapMs(LinkProfile::LOW_LATENCY));
+    TEST_ASSERT_EQUAL_UINT32(40, LinkProfilePolicy::maxEventGapMs(LinkProfile::BALANCED));
+    TEST_ASSERT_EQUAL_UINT32(400, LinkProfilePolicy::maxEventGapMs(LinkProfile::POWER_SAVE));
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_desired_by_phase);
+    RUN_TEST(test_rate_limit_spares_low_latency);
+    RUN_TEST(test_five_minute_exposures);
+    RUN_TEST(test_command_burst_holds_low_latency);
+    RUN_TEST(test_max_event_gap);
+    return UNITY_END();
+}
@@ -0,0 +1,176 @@
+// Native unit tests for LinkStats — camera-link latency histograms, status
+// matching, RSSI / connect counters and the LINK_STATS wire form.
+//
+// Strategy: unity-build. LinkStats is pure; the tests feed it samples with
+// explicit timestamps.
+
+#include <unity.h>
+
+#include "transport/link_stats.cpp"
+
+using Class = LinkStats::CommandClass;
+
+void setUp() {}
+void tearDown() {}
+
+static uint16_t readU16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+// Samples land in the first bucket whose bound they do not exceed.
+void test_histogram_buckets() {
+    LatencyHistogram h;
+    h.add(0);
+    h.add(10);    // Inclusive bound
+    h.add(11);
+    h.add(150);
+    h.add(5000);  // Open-ended bucket
+    TEST_ASSERT_EQUAL_UINT16(2, h.counts[0]);
+    TEST_ASSERT_EQUAL_UINT16(1, h.counts[1]);
+    TEST_ASSERT_EQUAL_UINT16(1, h.counts[4]);
+    TEST_ASSERT_EQUAL_UINT16(1, h.counts[LatencyHistogram::BUCKETS - 1]);
+    TEST_ASSERT_EQUAL_UINT32(5, h.samples());
+    TEST_ASSERT_EQUAL_UINT16(5000, h.maxMs);
+    h.add(100000);
+    TEST_ASSERT_EQUAL_UINT16(UINT16_MAX, h.maxMs);
+}
+
+void test_percentiles() {
+    LatencyHistogram h;
+    TEST_ASSERT_EQUAL_UINT32(0, h.percentileMs(95));
+    for (int i = 0; i < 19; i++) {
+        h.add(40);  // <= 50 ms
+    }
+    h.add(700);  // <= 1000 ms
+    TEST_ASSERT_EQUAL_UINT32(50, h.percentileMs(50));
+    TEST_ASSERT_EQUAL_UINT32(50, h.percentileMs(95));   // 19th of 20
+    TEST_ASSERT_EQUAL_UINT32(700, h.percentileMs(100));  // Capped at the real max
+
+    LatencyHistogram slow;
+    slow.add(3000);
+    TEST_ASSERT_EQUAL_UINT32(3000, slow.percentileMs(50));
+}
+
+// A status notification times the command awaiting it; one that never came
+// is counted when the next command takes its place.
+void test_status_matching() {
+    LinkStats stats;
+    stats.recordSubmit(Class::SHUTTER, 1000, true);
+    stats.recordWrite(Class::SHUTTER, true, 18);
+    stats.recordStatus(Class::SHUTTER, 1240);
+    stats.recordStatus(Class::SHUTTER, 1300);  // Not ours: ignored
+
+    stats.recordSubmit(Class::FOCUS, 2000, true);
+    stats.recordSubmit(Class::FOCUS, 2500, true);  // First never acquired focus
+    stats.recordStatus(Class::FOCUS, 2600);
+
+    stats.recordSubmit(Class::ZOOM, 3000, false);
+    stats.recordWrite(Class::ZOOM, false, 1000);
+
+    const LinkStats::Data d = stats.snapshot();
+    const auto& shutter = d.of(Class::SHUTTER);
+    TEST_ASSERT_EQUAL_UINT16(1, shutter.sent);
+    TEST_ASSERT_EQUAL_UINT32(1, shutter.ack.samples());
+    TEST_ASSERT_EQUAL_UINT32(1, shutter.status.samples());
+    TEST_ASSERT_EQUAL_UINT16(240, shutter.status.maxMs);
+    TEST_ASSERT_EQUAL_UINT16(2, d.of(Class::FOCUS).sent);
+    TEST_ASSERT_EQUAL_UINT16(1, d.of(Class::FOCUS).noStatus);
+    TEST_ASSERT_EQUAL_UINT16(100, d.of(Class::FOCUS).status.maxMs);
+    TEST_ASSERT_EQUAL_UINT16(1, d.of(Class::ZOOM).failed);
+    TEST_ASSERT_EQUAL_UINT32(0, d.of(Class::ZOOM).ack.samples());
+}
+
+// A failed write or a dropped link leaves nothing awaiting a status.
+void test_failures_clear_awaiting() {
+    LinkStats stats;
+    stats.recordSubmit(Class::RECORD, 0, true);
+    stats.recordWrite(Class::RECORD, false, 5);
+    stats.recordStatus(Class::RECORD, 50);
+    stats.recordSubmit(Class::SHUTTER, 100, true);
+    stats.recordDrop();
+    stats.recordStatus(Class::SHUTTER, 400);
+    const LinkStats::Data d = stats.snapshot();
+    TEST_ASSERT_EQUAL_UINT32(0, d.of(Class::RECORD).status.samples());
+    TEST_ASSERT_EQUAL_UINT32(0, d.of(Class::SHUTTER).status.samples());
+    TEST_ASSERT_EQUAL_UINT16(1, d.drops);
+}
+
+void test_rssi_and_link_counters() {
+    LinkStats stats;
+    stats.recordRssi(-60);
+    stats.recordRssi(-80);
+    stats.recordRssi(-70);
+    stats.recordConnect();
+    stats.recordConnect();
+    stats.recordConnectFailure();
+    LinkStats::Data d = stats.snapshot();
+    TEST_ASSERT_EQUAL_INT8(-70, d.rssiLast);
+    TEST_ASSERT_EQUAL_INT8(-80, d.rssiMin);
+    TEST_ASSERT_EQUAL_INT8(-60, d.rssiMax);
+    TEST_ASSERT_EQUAL_INT8(-70, d.rssiMean());
+    TEST_ASSERT_EQUAL_UINT16(2, d.connects);
+    TEST_ASSERT_EQUAL_UINT16(1, d.connectFailures);
+
+    stats.reset();
+    d = stats.snapshot();
+    TEST_ASSERT_EQUAL_UINT16(0, d.rssiSamples);
+    TEST_ASSERT_EQUAL_UINT16(0, d.connects);
+}
+
+// The wire form the web remote decodes (decodeLinkStats in astro-status.js).
+void test_encode_layout() {
+    LinkStats stats;
+    stats.recordRssi(-66);
+    stats.recordConnect();
+    stats.recordDrop();
+    stats.recordSubmit(Class::ZOOM, 0, false);
+    stats.recordWrite(Class::ZOOM, true, 35);  // Bucket 2 (<= 50 ms)
+    stats.recordRecovery(70000, 5);
+
+    uint8_t wire[LinkStats::WIRE_BYTES];
+    LinkStats::encode(stats.snapshot(), wire);
+    TEST_ASSERT_EQUAL_UINT(16 + 4 * 42 + 16, LinkStats::WIRE_BYTES);
+    TEST_ASSERT_EQUAL_UINT8(LinkStats::WIRE_VERSION, wire[0]);
+    TEST_ASSERT_EQUAL_UINT8(4, wire[1]);
+    TEST_ASSERT_EQUAL_UINT8(LatencyHistogram::BUCKETS, wire[2]);
+    TEST_ASSERT_EQUAL_INT8(-66, static_cast<int8_t>(wire[3]));
+    TEST_ASSERT_EQUAL_UINT16(1, readU16(wire + 8));
+    TEST_ASSERT_EQUAL_UINT16(1, readU16(wire + 10));
+    TEST_ASSERT_EQUAL_UINT16(1, readU16(wire + 14));
+
+    const uint8_t* zoom = wire + LinkStats::HEADER_BYTES + 2 * LinkStats::CLASS_BYTES;
+    TEST_ASSERT_EQUAL_UINT16(1, readU16(zoom));       // sent
+    TEST_ASSERT_EQUAL_UINT16(35, readU16(zoom + 6));  // ackMaxMs
+    TEST_ASSERT_EQUAL_UINT16(1, readU16(zoom + 10 + 2 * 2));
+
+    const uint8_t* recovery = wire + LinkStats::HEADER_BYTES + 4 * LinkStats::CLASS_BYTES;
+    TEST_ASSERT_EQUAL_UINT16(1, readU16(recovery));
+    TEST_ASSERT_EQUAL_UINT16(5, readU16(recovery + 2));
+    TEST_ASSERT_EQUAL_UINT32(70000, readU16(recovery + 4) | readU16(recovery + 6) << 16);
+}
+
+// Time-to-recover of dropped links: last, worst and total (for the mean).
+void test_recoveries() {
+    LinkStats stats;
+    stats.recordRecovery(1200, 1);
+    stats.recordRecovery(9000, 4);
+    stats.recordRecovery(3000, 2);
+    const LinkStats::Data d = stats.snapshot();
+    TEST_ASSERT_EQUAL_UINT16(3, d.recoveries);
+    TEST_ASSERT_EQUAL_UINT16(7, d.recoveryAttempts);
+    TEST_ASSERT_EQUAL_UINT32(3000, d.lastRecoveryMs);
+    TEST_ASSERT_EQUAL_UINT32(9000, d.maxRecoveryMs);
+    TEST_ASSERT_EQUAL_UINT32(13200, d.totalRecoveryMs);
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_histogram_buckets);
+    RUN_TEST(test_percentiles);
+    RUN_TEST(test_status_matching);
+    RUN_TEST(test_failures_clear_awaiting);
+    RUN_TEST(test_rssi_and_link_counters);
+    RUN_TEST(test_encode_layout);
+    RUN_TEST(test_recoveries);
+    return UNITY_END();
+}
@@ -0,0 +1,79 @@
+// Native unit tests for PresenceTracker — which saved cameras are
+// advertising, their smoothed RSSI, and following changes to the saved list.
+//
+// Strategy: unity-build. The tracker is pure; advertisements are fed with
+// explicit timestamps.
+
+#include <unity.h>
+
+#include "transport/presence_tracker.cpp"
+
+void setUp() {}
+void tearDown() {}
+
+static const std::string CAM_A = "aa:bb:cc:dd:ee:01";
+static const std::string CAM_B = "aa:bb:cc:dd:ee:02";
+
+static BleAddress addr(const std::string& text) {
+    BleAddress address;
+    BleAddress::parse(text, address);
+    return address;
+}
+
+static std::vector<SavedCamera> saved(std::initializer_list<std::string> addresses) {
+    std::vector<SavedCamera> cameras;
+    for (const std::string& address : addresses) {
+        cameras.push_back(SavedCamera{address, "", GattHandles{}});
+    }
+    return cameras;
+}
+
+// Present for PRESENT_TTL_MS after the last advertisement; strangers ignored.
+void test_presence_expires() {
+    PresenceTracker tracker;
+    tracker.track(saved({CAM_A}));
+    TEST_ASSERT_FALSE(tracker.isPresent(CAM_A, 0));
+    TEST_ASSERT_FALSE(tracker.observe(addr("11:22:33:44:55:66"), -50, 100));
+    TEST_ASSERT_TRUE(tracker.observe(addr(CAM_A), -60, 1000));
+    TEST_ASSERT_TRUE(tracker.isPresent(CAM_A, 1000));
+    TEST_ASSERT_TRUE(tracker.isPresent(CAM_A, 1000 + PresenceTracker::PRESENT_TTL_MS - 1));
+    TEST_ASSERT_FALSE(tracker.isPresent(CAM_A, 1000 + PresenceTracker::PRESENT_TTL_MS));
+    TEST_ASSERT_EQUAL_UINT32(1000, tracker.lastSeenMs(CAM_A));
+    TEST_ASSERT_FALSE(tracker.isPresent(CAM_B, 1000));
+}
+
+// One faded advertisement moves the estimate a quarter of the way.
+void test_rssi_is_smoothed() {
+    PresenceTracker tracker;
+    tracker.track(saved({CAM_A}));
+    TEST_ASSERT_EQUAL_INT8(0, tracker.rssi(CAM_A));
+    tracker.observe(addr(CAM_A), -60, 0);
+    TEST_ASSERT_EQUAL_INT8(-60, tracker.rssi(CAM_A));
+    tracker.observe(addr(CAM_A), -80, 100);
+    TEST_ASSERT_EQUAL_INT8(-65, tracker.rssi(CAM_A));
+    for (uint32_t t = 200; t < 5000; t += 100) {
+        tracker.observe(addr(CAM_A), -80, t);
+    }
+    TEST_ASSERT_INT_WITHIN(1, -80, tracker.rssi(CAM_A));
+}
+
+// Re-tracking keeps what is known about cameras still saved.
+void test_track_follows_saved_list() {
+    PresenceTracker tracker;
+    tracker.track(saved({CAM_A, CAM_B}));
+    tracker.observe(addr(CAM_A), -55, 500);
+    tracker.observe(addr(CAM_B), -70, 500);
+    tracker.track(saved({CAM_B}));
+    TEST_ASSERT_FALSE(tracker.isPresent(CAM_A, 600));
+    TEST_ASSERT_FALSE(tracker.observe(addr(CAM_A), -55, 700));
+    TEST_ASSERT_TRUE(tracker.isPresent(CAM_B, 600));
+    TEST_ASSERT_EQUAL_INT8(-70, tracker.rssi(CAM_B));
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_presence_expires);
+    RUN_TEST(test_rssi_is_smoothed);
+    RUN_TEST(test_track_follows_saved_list);
+    return UNITY_END();
+}
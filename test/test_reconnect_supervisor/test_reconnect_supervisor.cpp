@@ -0,0 +1,126 @@
+// Native unit tests for ReconnectSupervisor — when a dropped camera link is
+// retried: jittered exponential backoff, the urgent (mid-exposure) cap,
+// waiting for the camera to advertise, and the outage length reported on
+// recovery.
+//
+// Strategy: unity-build. The supervisor is pure; entropy is passed in.
+
+#include <unity.h>
+
+#include "transport/reconnect_supervisor.cpp"
+
+using RS = ReconnectSupervisor;
+
+void setUp() {}
+void tearDown() {}
+
+void test_backoff_doubles_to_cap() {
+    TEST_ASSERT_EQUAL_UINT32(1000, RS::ceilingFor(1, false));
+    TEST_ASSERT_EQUAL_UINT32(2000, RS::ceilingFor(2, false));
+    TEST_ASSERT_EQUAL_UINT32(32000, RS::ceilingFor(6, false));
+    TEST_ASSERT_EQUAL_UINT32(RS::MAX_MS, RS::ceilingFor(7, false));
+    TEST_ASSERT_EQUAL_UINT32(RS::MAX_MS, RS::ceilingFor(UINT16_MAX, false));
+    TEST_ASSERT_EQUAL_UINT32(250, RS::ceilingFor(1, true));
+    TEST_ASSERT_EQUAL_UINT32(RS::URGENT_MAX_MS, RS::ceilingFor(5, true));
+}
+
+// Equal jitter: never under half the ceiling, never over it.
+void test_jitter_stays_in_range() {
+    const uint32_t entropies[] = {0, 1, 499, 500, 501, 12345, UINT32_MAX};
+    for (uint16_t attempt = 1; attempt < 10; attempt++) {
+        const uint32_t ceiling = RS::ceilingFor(attempt, false);
+        for (uint32_t entropy : entropies) {
+            const uint32_t delay = RS::delayFor(attempt, false, entropy);
+            TEST_ASSERT_TRUE(delay >= ceiling / 2);
+            TEST_ASSERT_TRUE(delay <= ceiling);
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(500, RS::delayFor(1, false, 0));
+    TEST_ASSERT_EQUAL_UINT32(1000, RS::delayFor(1, false, 500));
+}
+
+// First attempt straight away, then the jittered waits; it never gives up.
+void test_attempts_follow_backoff() {
+    RS rs;
+    TEST_ASSERT_FALSE(rs.due(0, false));
+    rs.linkLost(1000);
+    TEST_ASSERT_TRUE(rs.active());
+    TEST_ASSERT_TRUE(rs.due(1000, false));
+
+    uint32_t now = 1000;
+    for (uint16_t attempt = 1; attempt <= 20; attempt++) {
+        rs.attempted(now, false, 0);  // Entropy 0: half the ceiling
+        const uint32_t wait = RS::ceilingFor(attempt, false) / 2;
+        TEST_ASSERT_FALSE(rs.due(now + wait - 1, false));
+        TEST_ASSERT_TRUE(rs.due(now + wait, false));
+        now += wait;
+    }
+    TEST_ASSERT_EQUAL_UINT16(20, rs.attempts());
+    TEST_ASSERT_TRUE(rs.active());
+}
+
+// A frame starts exposing during a long wait: the next attempt comes at once.
+void test_urgent_cuts_pending_wait() {
+    RS rs;
+    rs.linkLost(0);
+    for (int i = 0; i < 8; i++) {
+        rs.attempted(0, false, UINT32_MAX);
+    }
+    TEST_ASSERT_FALSE(rs.due(10000, false));
+    TEST_ASSERT_TRUE(rs.due(RS::URGENT_MAX_MS, true));
+
+    // Urgent throughout: never more than URGENT_MAX_MS between attempts.
+    rs.linkLost(0);
+    for (int i = 0; i < 10; i++) {
+        rs.attempted(0, true, UINT32_MAX);
+        TEST_ASSERT_TRUE(rs.due(RS::URGENT_MAX_MS, true));
+    }
+}
+
+void test_recovery_reports_outage() {
+    RS rs;
+    rs.linkLost(5000);
+    rs.attempted(5000, false, 0);
+    rs.attempted(5600, false, 0);
+    TEST_ASSERT_EQUAL_UINT32(2400, rs.recovered(7400));
+    TEST_ASSERT_FALSE(rs.active());
+    TEST_ASSERT_FALSE(rs.due(100000, true));
+
+    rs.linkLost(0);
+    rs.cancel();
+    TEST_ASSERT_FALSE(rs.due(100000, true));
+}
+
+// Camera off: after the first try, only a blind attempt every BLIND_MS. It
+// comes back: the next attempt goes out at once, with the backoff reset.
+void test_absent_target_waits_for_advertising() {
+    RS rs;
+    rs.setTargetPresent(false);
+    rs.linkLost(0);
+    TEST_ASSERT_TRUE(rs.due(0, false));
+    rs.attempted(0, false, 0);
+    TEST_ASSERT_FALSE(rs.due(RS::BLIND_MS - 1, false));
+    TEST_ASSERT_TRUE(rs.due(RS::URGENT_BLIND_MS, true));
+    TEST_ASSERT_TRUE(rs.due(RS::BLIND_MS, false));
+    for (int i = 0; i < 6; i++) {
+        rs.attempted(0, false, 0);
+    }
+    TEST_ASSERT_FALSE(rs.due(RS::BLIND_MS - 1, false));
+
+    rs.setTargetPresent(true);
+    TEST_ASSERT_TRUE(rs.due(1, false));
+    rs.attempted(1, false, 0);
+    TEST_ASSERT_TRUE(rs.due(1 + RS::ceilingFor(1, false) / 2, false));
+    TEST_ASSERT_EQUAL_UINT16(8, rs.attempts());
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_backoff_doubles_to_cap);
+    RUN_TEST(test_jitter_stays_in_range);
+    RUN_TEST(test_attempts_follow_backoff);
+    RUN_TEST(test_urgent_cuts_pending_wait);
+    RUN_TEST(test_recovery_reports_outage);
+    RUN_TEST(test_absent_target_waits_for_advertising);
+    return UNITY_END();
+}
@@ -0,0 +1,86 @@
+// Native unit tests for ScanPlan — the burst-then-back-off scan duty, when a
+// scan listens passively, and which devices end a targeted scan.
+//
+// Strategy: unity-build. The plan is pure; time is passed in.
+
+#include <unity.h>
+
+#include "transport/scan_plan.cpp"
+
+void setUp() {}
+void tearDown() {}
+
+static BleAddress addr(uint8_t last) {
+    const uint8_t native[BleAddress::BYTES] = {0xaa, 0xbb, 0xcc, 0xdd, 0xee, last};
+    return BleAddress::fromNative(native);
+}
+
+void test_burst_then_backoff() {
+    ScanPlan plan;
+    plan.begin(ScanPlan::Goal::LIST, BleAddress(), false, 5000, 1000);
+    ScanPlan::Duty duty = plan.duty(1000);
+    TEST_ASSERT_TRUE(plan.inBurst(1000));
+    TEST_ASSERT_EQUAL_UINT16(ScanPlan::BURST_INTERVAL_MS, duty.intervalMs);
+    TEST_ASSERT_EQUAL_UINT16(ScanPlan::BURST_WINDOW_MS, duty.windowMs);
+    TEST_ASSERT_TRUE(duty.active);
+
+    TEST_ASSERT_TRUE(plan.inBurst(1000 + ScanPlan::BURST_MS - 1));
+    duty = plan.duty(1000 + ScanPlan::BURST_MS);
+    TEST_ASSERT_FALSE(plan.inBurst(1000 + ScanPlan::BURST_MS));
+    TEST_ASSERT_EQUAL_UINT16(ScanPlan::BACKOFF_INTERVAL_MS, duty.intervalMs);
+    TEST_ASSERT_EQUAL_UINT16(ScanPlan::BACKOFF_WINDOW_MS, duty.windowMs);
+    TEST_ASSERT_TRUE(duty.active);
+    TEST_ASSERT_TRUE(duty.windowMs * 4 <= duty.intervalMs);  // At most a quarter
+
+    TEST_ASSERT_FALSE(plan.expired(5999));
+    TEST_ASSERT_TRUE(plan.expired(6000));
+}
+
+// Scan requests only when the name is still wanted.
+void test_passive_when_name_known() {
+    ScanPlan plan;
+    plan.begin(ScanPlan::Goal::ADDRESS, addr(1), true, 4000, 0);
+    TEST_ASSERT_FALSE(plan.duty(0).active);
+    TEST_ASSERT_FALSE(plan.duty(ScanPlan::BURST_MS).active);
+
+    plan.begin(ScanPlan::Goal::ADDRESS, addr(1), false, 4000, 0);
+    TEST_ASSERT_TRUE(plan.duty(0).active);
+
+    // A first Sony camera is wanted with its name, for the list.
+    plan.begin(ScanPlan::Goal::FIRST_SONY, BleAddress(), true, 4000, 0);
+    TEST_ASSERT_TRUE(plan.duty(0).active);
+}
+
+void test_targets_by_goal() {
+    ScanPlan plan;
+    plan.begin(ScanPlan::Goal::LIST, BleAddress(), false, 5000, 0);
+    TEST_ASSERT_FALSE(plan.isTarget(addr(1), true));
+
+    plan.begin(ScanPlan::Goal::ADDRESS, addr(2), true, 4000, 0);
+    TEST_ASSERT_FALSE(plan.isTarget(addr(1), true));
+    TEST_ASSERT_TRUE(plan.isTarget(addr(2), false));  // Scan response: no Sony header
+
+    plan.begin(ScanPlan::Goal::FIRST_SONY, BleAddress(), false, 30000, 0);
+    TEST_ASSERT_FALSE(plan.isTarget(addr(3), false));
+    TEST_ASSERT_TRUE(plan.isTarget(addr(3), true));
+}
+
+// Time runs from begin(), across the uint32 wrap too.
+void test_restart_resets_timing() {
+    ScanPlan plan;
+    plan.begin(ScanPlan::Goal::LIST, BleAddress(), false, 5000, 0);
+    TEST_ASSERT_TRUE(plan.expired(10000));
+    plan.begin(ScanPlan::Goal::LIST, BleAddress(), false, 5000, UINT32_MAX - 100);
+    TEST_ASSERT_TRUE(plan.inBurst(100));
+    TEST_ASSERT_FALSE(plan.expired(100));
+    TEST_ASSERT_TRUE(plan.expired(4900));
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_burst_then_backoff);
+    RUN_TEST(test_passive_when_name_known);
+    RUN_TEST(test_targets_by_goal);
+    RUN_TEST(test_restart_resets_timing);
+    return UNITY_END();
+}
@@ -0,0 +1,165 @@
+// Native unit tests for the discovery scan table — reading names and the
+// manufacturer header out of raw advertisements, de-duplicating devices by
+// address, and handing a screen only what changed since it last looked.
+//
+// Strategy: unity-build. The table and parser are pure; advertisements are
+// fed as byte arrays with explicit timestamps.
+
+#include <unity.h>
+
+#include "transport/scan_table.cpp"
+
+void setUp() {}
+void tearDown() {}
+
+static BleAddress addr(uint8_t last) {
+    const uint8_t native[BleAddress::BYTES] = {0xaa, 0xbb, 0xcc, 0xdd, 0xee, last};
+    return BleAddress::fromNative(native);
+}
+
+void test_address_round_trip() {
+    BleAddress address;
+    TEST_ASSERT_TRUE(BleAddress::parse("AA:bb:0C:dd:ee:f1", address));
+    TEST_ASSERT_EQUAL_STRING("aa:bb:0c:dd:ee:f1", address.toString().c_str());
+    BleAddress same;
+    TEST_ASSERT_TRUE(BleAddress::parse(address.toString(), same));
+    TEST_ASSERT_TRUE(address == same);
+    TEST_ASSERT_FALSE(BleAddress::parse("aa:bb:cc:dd:ee", same));
+    TEST_ASSERT_FALSE(BleAddress::parse("aa:bb:cc:dd:ee:fg", same));
+    TEST_ASSERT_FALSE(BleAddress::parse("aa-bb-cc-dd-ee-ff", same));
+}
+
+// Flags, complete name, Sony manufacturer data (company 0x012D, camera 0x03).
+void test_parse_name_and_manufacturer() {
+    const uint8_t payload[] = {0x02, 0x01, 0x06,                                 // Flags
+                               0x06, 0x09, 'I',  'L',  'C',  'E', '7',           // Name
+                               0x05, 0xFF, 0x2D, 0x01, 0x03, 0x00, 0x00, 0x00};  // + padding
+    AdvertisementInfo info;
+    TEST_ASSERT_TRUE(parseAdvertisement(payload, sizeof(payload), info));
+    TEST_ASSERT_EQUAL_STRING("ILCE7", info.name);
+    TEST_ASSERT_TRUE(info.hasManufacturer);
+    TEST_ASSERT_EQUAL_HEX16(0x012D, info.companyId);
+    TEST_ASSERT_EQUAL_HEX8(0x03, info.companyType);
+
+    // A shortened name only when there is no complete one.
+    const uint8_t both[] = {0x04, 0x09, 'A', 'B', 'C', 0x03, 0x08, 'X', 'Y'};
+    AdvertisementInfo named;
+    TEST_ASSERT_TRUE(parseAdvertisement(both, sizeof(both), named));
+    TEST_ASSERT_EQUAL_STRING("ABC", named.name);
+    TEST_ASSERT_FALSE(named.hasManufacturer);
+}
+
+// A structure running past the payload ends the parse; earlier ones stay.
+// Names longer than the buffer are cut.
+void test_parse_malformed_and_long() {
+    const uint8_t truncated[] = {0x03, 0x09, 'O', 'K', 0x09, 0xFF, 0x2D};
+    AdvertisementInfo info;
+    TEST_ASSERT_TRUE(parseAdvertisement(truncated, sizeof(truncated), info));
+    TEST_ASSERT_EQUAL_STRING("OK", info.name);
+    TEST_ASSERT_FALSE(info.hasManufacturer);
+
+    const uint8_t flagsOnly[] = {0x02, 0x01, 0x06};
+    AdvertisementInfo none;
+    TEST_ASSERT_FALSE(parseAdvertisement(flagsOnly, sizeof(flagsOnly), none));
+    TEST_ASSERT_FALSE(parseAdvertisement(flagsOnly, 0, none));
+
+    uint8_t longName[2 + 40] = {41, 0x09};
+    memset(longName + 2, 'n', 40);
+    AdvertisementInfo cut;
+    TEST_ASSERT_TRUE(parseAdvertisement(longName, sizeof(longName), cut));
+    TEST_ASSERT_EQUAL_size_t(AdvertisementInfo::NAME_BYTES - 1, strlen(cut.name));
+}
+
+// Repeats of one address stay one entry; small RSSI wobble is not a change.
+void test_observe_deduplicates() {
+    ScanTable table;
+    TEST_ASSERT_EQUAL(ScanTable::Change::ADDED, table.observe(addr(1), "ILCE-7M4", -60, 100));
+    TEST_ASSERT_EQUAL(ScanTable::Change::ADDED, table.observe(addr(2), "", -70, 150));
+    TEST_ASSERT_EQUAL(ScanTable::Change::NONE, table.observe(addr(1), "", -64, 200));
+    TEST_ASSERT_EQUAL_size_t(2, table.size());
+
+    ScanTable::Entry entry;
+    TEST_ASSERT_TRUE(table.find(addr(1), entry));
+    TEST_ASSERT_EQUAL_STRING("ILCE-7M4", entry.name);  // Kept through a nameless repeat
+    TEST_ASSERT_EQUAL_INT8(-60, entry.rssi);
+    TEST_ASSERT_EQUAL_UINT32(100, entry.firstSeenMs);
+    TEST_ASSERT_EQUAL_UINT32(200, entry.lastSeenMs);
+
+    // Smoothed: -61 after the -64 above, then -65 after -77; 5 dB off -60.
+    TEST_ASSERT_EQUAL(ScanTable::Change::UPDATED, table.observe(addr(1), nullptr, -77, 300));
+    TEST_ASSERT_TRUE(table.find(addr(1), entry));
+    TEST_ASSERT_EQUAL_INT8(-65, entry.rssi);
+
+    // The scan response brings the name of a device first heard without one.
+    TEST_ASSERT_EQUAL(ScanTable::Change::UPDATED, table.observe(addr(2), "ZV-E10", -70, 400));
+    TEST_ASSERT_TRUE(table.find(addr(2), entry));
+    TEST_ASSERT_EQUAL_STRING("ZV-E10", entry.name);
+    TEST_ASSERT_FALSE(table.find(addr(3), entry));
+}
+
+void test_full_table_drops_new_devices() {
+    ScanTable table;
+    for (uint8_t i = 0; i < ScanTable::CAPACITY; i++) {
+        TEST_ASSERT_EQUAL(ScanTable::Change::ADDED, table.observe(addr(i), "", -50, i));
+    }
+    TEST_ASSERT_EQUAL(ScanTable::Change::FULL, table.observe(addr(200), "", -50, 100));
+    TEST_ASSERT_EQUAL(ScanTable::Change::FULL, table.observe(addr(201), "", -50, 100));
+    TEST_ASSERT_EQUAL_UINT32(2, table.dropped());
+    // Known devices still update.
+    TEST_ASSERT_EQUAL(ScanTable::Change::UPDATED, table.observe(addr(7), "A7", -50, 100));
+
+    table.clear();
+    TEST_ASSERT_EQUAL_size_t(0, table.size());
+    TEST_ASSERT_EQUAL_UINT32(0, table.dropped());
+    TEST_ASSERT_EQUAL(ScanTable::Change::ADDED, table.observe(addr(200), "", -50, 200));
+}
+
+// A reader gets each change once, in discovery order, and a reset after clear.
+void test_changed_since_is_incremental() {
+    ScanTable table;
+    ScanTable::Entry out[ScanTable::CAPACITY];
+    uint32_t version = 0;
+    bool reset = false;
+    TEST_ASSERT_EQUAL_size_t(0, table.changedSince(version, out, ScanTable::CAPACITY, reset));
+
+    table.observe(addr(1), "A", -60, 0);
+    table.observe(addr(2), "B", -60, 0);
+    TEST_ASSERT_EQUAL_size_t(2, table.changedSince(version, out, ScanTable::CAPACITY, reset));
+    TEST_ASSERT_TRUE(out[0].address == addr(1));
+    TEST_ASSERT_TRUE(out[1].address == addr(2));
+    TEST_ASSERT_EQUAL_size_t(0, table.changedSince(version, out, ScanTable::CAPACITY, reset));
+
+    table.observe(addr(3), "C", -60, 10);
+    table.observe(addr(1), "A2", -60, 10);
+    TEST_ASSERT_EQUAL_size_t(2, table.changedSince(version, out, ScanTable::CAPACITY, reset));
+    TEST_ASSERT_FALSE(reset);
+    TEST_ASSERT_EQUAL_STRING("A2", out[0].name);  // Discovery order, not change order
+    TEST_ASSERT_EQUAL_STRING("C", out[1].name);
+
+    // Short of room: nothing is skipped, the window comes again.
+    table.observe(addr(4), "D", -60, 20);
+    table.observe(addr(5), "E", -60, 20);
+    const uint32_t before = version;
+    TEST_ASSERT_EQUAL_size_t(1, table.changedSince(version, out, 1, reset));
+    TEST_ASSERT_EQUAL_UINT32(before, version);
+    TEST_ASSERT_EQUAL_size_t(2, table.changedSince(version, out, ScanTable::CAPACITY, reset));
+
+    table.clear();
+    table.observe(addr(9), "Z", -60, 30);
+    TEST_ASSERT_EQUAL_size_t(1, table.changedSince(version, out, ScanTable::CAPACITY, reset));
+    TEST_ASSERT_TRUE(reset);
+    TEST_ASSERT_EQUAL_STRING("Z", out[0].name);
+    table.changedSince(version, out, ScanTable::CAPACITY, reset);
+    TEST_ASSERT_FALSE(reset);
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_address_round_trip);
+    RUN_TEST(test_parse_name_and_manufacturer);
+    RUN_TEST(test_parse_malformed_and_long);
+    RUN_TEST(test_observe_deduplicates);
+    RUN_TEST(test_full_table_drops_new_devices);
+    RUN_TEST(test_changed_since_is_incremental);
+    return UNITY_END();
+}
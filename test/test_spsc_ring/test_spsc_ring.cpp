@@ -0,0 +1,96 @@
+// Native unit tests for SpscRing — the lock-free hand-off used for camera
+// status notifications (FIFO order, full / empty, wrap-around, drop count,
+// and one producer thread against one consumer thread).
+//
+// Strategy: the ring is header-only; the threaded test runs real std::threads.
+
+#include <unity.h>
+
+#include <thread>
+
+#include "utils/spsc_ring.h"
+
+void setUp() {}
+void tearDown() {}
+
+void test_fifo_and_empty() {
+    SpscRing<int, 4> ring;
+    int out = 0;
+    TEST_ASSERT_FALSE(ring.pop(out));
+    TEST_ASSERT_TRUE(ring.push(1));
+    TEST_ASSERT_TRUE(ring.push(2));
+    TEST_ASSERT_EQUAL_UINT(2, ring.size());
+    TEST_ASSERT_TRUE(ring.pop(out));
+    TEST_ASSERT_EQUAL_INT(1, out);
+    TEST_ASSERT_TRUE(ring.pop(out));
+    TEST_ASSERT_EQUAL_INT(2, out);
+    TEST_ASSERT_FALSE(ring.pop(out));
+}
+
+// A full ring refuses (and counts) new items instead of overwriting unread ones.
+void test_full_ring_drops_newest() {
+    SpscRing<int, 4> ring;
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT_TRUE(ring.push(i));
+    }
+    TEST_ASSERT_FALSE(ring.push(99));
+    TEST_ASSERT_EQUAL_UINT32(1, ring.dropped());
+    int out = -1;
+    TEST_ASSERT_TRUE(ring.pop(out));
+    TEST_ASSERT_EQUAL_INT(0, out);
+    TEST_ASSERT_TRUE(ring.push(4));  // Room again, wrapping around
+    for (int expected = 1; expected <= 4; expected++) {
+        TEST_ASSERT_TRUE(ring.pop(out));
+        TEST_ASSERT_EQUAL_INT(expected, out);
+    }
+}
+
+void test_clear() {
+    SpscRing<int, 8> ring;
+    ring.push(1);
+    ring.push(2);
+    ring.clear();
+    int out = 0;
+    TEST_ASSERT_FALSE(ring.pop(out));
+    TEST_ASSERT_EQUAL_UINT(0, ring.size());
+}
+
+// Every item arrives exactly once and in order across threads.
+void test_threads_keep_order() {
+    static SpscRing<uint32_t, 16> ring;
+    constexpr uint32_t COUNT = 20000;
+    // Yield when blocked: on a single core a spinning side would otherwise
+    // hold the CPU for its whole time slice.
+    std::thread producer([] {
+        for (uint32_t i = 0; i < COUNT;) {
+            if (ring.push(i)) {
+                i++;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+    uint32_t expected = 0;
+    bool ordered = true;
+    while (expected < COUNT) {
+        uint32_t item;
+        if (ring.pop(item)) {
+            ordered = ordered && item == expected;
+            expected++;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    TEST_ASSERT_TRUE(ordered);
+    TEST_ASSERT_EQUAL_UINT(0, ring.size());
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_fifo_and_empty);
+    RUN_TEST(test_full_ring_drops_newest);
+    RUN_TEST(test_clear);
+    RUN_TEST(test_threads_keep_order);
+    return UNITY_END();
+}
@@ -0,0 +1,137 @@
+// Native unit tests for TriggerSkew — the spread between cameras' shutter
+// edges on one toggle, and the accumulators that keep it across a night.
+//
+// Strategy: unity-build. Fake camera endpoints each answer a toggle with a
+// shutter edge after their own injected latency; their reports are fed back
+// in arrival order, as the BLE task would.
+
+#include <unity.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "transport/trigger_skew.cpp"
+
+void setUp() {}
+void tearDown() {}
+
+// A camera answering every toggle `latencyMs` after it, or never.
+struct FakeCamera {
+    uint32_t latencyMs;
+    bool answers = true;
+};
+
+struct Report {
+    size_t camera;
+    uint32_t atMs;
+};
+
+// Sends one toggle to every camera at `sentMs` and delivers their edges.
+static void toggle(TriggerSkew& skew, const std::vector<FakeCamera>& cameras, bool open,
+                   uint32_t sentMs) {
+    uint8_t mask = 0;
+    std::vector<Report> reports;
+    for (size_t i = 0; i < cameras.size(); i++) {
+        mask |= 1u << i;
+        if (cameras[i].answers) {
+            reports.push_back({i, sentMs + cameras[i].latencyMs});
+        }
+    }
+    std::sort(reports.begin(), reports.end(),
+              [](const Report& a, const Report& b) { return a.atMs < b.atMs; });
+    skew.begin(open, mask, sentMs);
+    for (const Report& report : reports) {
+        skew.onEdge(report.camera, open, report.atMs);
+    }
+}
+
+void test_spread_of_three_cameras() {
+    TriggerSkew skew;
+    const std::vector<FakeCamera> cameras = {{120}, {95}, {160}};
+    toggle(skew, cameras, true, 1000);
+    TEST_ASSERT_FALSE(skew.measuring());  // Everyone reported
+    TEST_ASSERT_EQUAL_UINT16(1, skew.opens().samples);
+    TEST_ASSERT_EQUAL_UINT16(65, skew.opens().lastMs);  // 160 - 95
+    TEST_ASSERT_EQUAL_UINT16(0, skew.closes().samples);
+
+    toggle(skew, cameras, false, 31000);
+    TEST_ASSERT_EQUAL_UINT16(1, skew.closes().samples);
+    TEST_ASSERT_EQUAL_UINT16(65, skew.closes().lastMs);
+}
+
+// Last, worst and mean over several frames with drifting latencies.
+void test_accumulates_across_frames() {
+    TriggerSkew skew;
+    const uint32_t spreads[] = {10, 40, 25};
+    uint32_t t = 0;
+    for (uint32_t spread : spreads) {
+        toggle(skew, {{100}, {100 + spread}}, true, t);
+        t += 60000;
+    }
+    const TriggerSkew::Stats& opens = skew.opens();
+    TEST_ASSERT_EQUAL_UINT16(3, opens.samples);
+    TEST_ASSERT_EQUAL_UINT16(25, opens.lastMs);
+    TEST_ASSERT_EQUAL_UINT16(40, opens.maxMs);
+    TEST_ASSERT_EQUAL_UINT16(25, opens.meanMs());
+
+    skew.reset();
+    TEST_ASSERT_EQUAL_UINT16(0, skew.opens().samples);
+    TEST_ASSERT_EQUAL_UINT16(0, skew.opens().maxMs);
+}
+
+// A silent camera leaves the toggle to the window; the others still count.
+void test_silent_camera_times_out() {
+    TriggerSkew skew;
+    std::vector<FakeCamera> cameras = {{80}, {130}, {0, false}};
+    toggle(skew, cameras, true, 0);
+    TEST_ASSERT_TRUE(skew.measuring());
+    skew.poll(TriggerSkew::WINDOW_MS - 1);
+    TEST_ASSERT_TRUE(skew.measuring());
+    skew.poll(TriggerSkew::WINDOW_MS);
+    TEST_ASSERT_FALSE(skew.measuring());
+    TEST_ASSERT_EQUAL_UINT16(1, skew.opens().samples);
+    TEST_ASSERT_EQUAL_UINT16(50, skew.opens().lastMs);
+    TEST_ASSERT_EQUAL_UINT16(1, skew.opens().incomplete);
+
+    // Only one camera heard: incomplete, and no sample.
+    cameras = {{80}, {0, false}};
+    toggle(skew, cameras, true, 10000);
+    skew.begin(false, 0x03, 20000);  // The next toggle folds it in
+    TEST_ASSERT_EQUAL_UINT16(1, skew.opens().samples);
+    TEST_ASSERT_EQUAL_UINT16(2, skew.opens().incomplete);
+}
+
+// Stray edges are ignored: the other direction, cameras the toggle did not
+// go to, repeats, and anything outside a toggle.
+void test_ignores_stray_edges() {
+    TriggerSkew skew;
+    skew.onEdge(0, true, 5);
+    skew.begin(true, 0x05, 100);  // Cameras 0 and 2
+    skew.onEdge(0, false, 150);
+    skew.onEdge(1, true, 160);
+    skew.onEdge(0, true, 200);
+    skew.onEdge(0, true, 500);  // Repeat
+    skew.onEdge(TriggerSkew::MAX_CAMERAS, true, 210);
+    TEST_ASSERT_TRUE(skew.measuring());
+    skew.onEdge(2, true, 230);
+    TEST_ASSERT_EQUAL_UINT16(1, skew.opens().samples);
+    TEST_ASSERT_EQUAL_UINT16(30, skew.opens().lastMs);
+    TEST_ASSERT_EQUAL_UINT16(0, skew.opens().incomplete);
+}
+
+// Stamps straddling the uint32 millis() wrap.
+void test_across_clock_wrap() {
+    TriggerSkew skew;
+    toggle(skew, {{10}, {90}}, false, UINT32_MAX - 50);
+    TEST_ASSERT_EQUAL_UINT16(80, skew.closes().lastMs);
+}
+
+int main(int, char**) {
+    UNITY_BEGIN();
+    RUN_TEST(test_spread_of_three_cameras);
+    RUN_TEST(test_accumulates_across_frames);
+    RUN_TEST(test_silent_camera_times_out);
+    RUN_TEST(test_ignores_stray_edges);
+    RUN_TEST(test_across_clock_wrap);
+    return UNITY_END();
+}